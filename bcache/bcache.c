@@ -25,6 +25,13 @@
  * @page bcache_bcache Body Caching - local copies of email bodies
  *
  * Body Caching - local copies of email bodies
+ *
+ * Each mailbox has a directory in `$message_cachedir`.  To keep the
+ * directories small, the emails are spread over 256 hidden subdirectories,
+ * chosen by a hash of the email's id, e.g. `INBOX/.3f/1234-56`.
+ *
+ * Files written by older versions, directly in the mailbox directory, are
+ * still found.  They're moved into place when they're next read.
  */
 
 #include "config.h"
@@ -40,6 +47,7 @@
 #include "core/lib.h"
 #include "lib.h"
 #include "mutt_account.h"
+#include "private.h"
 #include "muttlib.h"
 
 struct ConnAccount;
@@ -49,9 +57,80 @@ struct ConnAccount;
  */
 struct BodyCache
 {
-  char *path;
+  char *path;                ///< Directory of the mailbox's cache
+  char *dir;                 ///< Directory, relative to $message_cachedir
+  struct BcacheIndex *index; ///< Index of the cache, may be NULL
 };
 
+/**
+ * bcache_shard - Choose a subdirectory for a file
+ * @param id Per-mailbox unique identifier for the message
+ * @retval num Subdirectory number, 0-255
+ */
+static unsigned int bcache_shard(const char *id)
+{
+  /* FNV-1a */
+  unsigned int hash = 2166136261U;
+  for (; *id; id++)
+    hash = (hash ^ (unsigned char) *id) * 16777619U;
+
+  return hash & 0xff;
+}
+
+/**
+ * bcache_file - Get the path of a file in the Body Cache
+ * @param bcache Body cache
+ * @param id     Per-mailbox unique identifier for the message
+ * @param key    If true, make the path relative to $message_cachedir
+ * @param buf    Buffer for the result
+ */
+static void bcache_file(struct BodyCache *bcache, const char *id, bool key, struct Buffer *buf)
+{
+  mutt_buffer_printf(buf, "%s.%02x/%s", key ? bcache->dir : bcache->path,
+                     bcache_shard(id), id);
+}
+
+/**
+ * bcache_stat - Does a file exist in the Body Cache?
+ * @param[in]  bcache Body cache
+ * @param[in]  id     Per-mailbox unique identifier for the message
+ * @param[out] size   Size of the file
+ * @retval true The file exists, and isn't empty
+ */
+static bool bcache_stat(struct BodyCache *bcache, const char *id, long *size)
+{
+  struct Buffer *path = mutt_buffer_pool_get();
+  bcache_file(bcache, id, false, path);
+
+  struct stat st;
+  bool found = (stat(mutt_buffer_string(path), &st) == 0) &&
+               S_ISREG(st.st_mode) && (st.st_size != 0);
+  if (found && size)
+    *size = st.st_size;
+
+  mutt_buffer_pool_release(&path);
+  return found;
+}
+
+/**
+ * bcache_index_stat - Add a file to the index, if it exists
+ * @param bcache Body cache
+ * @param id     Per-mailbox unique identifier for the message
+ * @retval true The file exists
+ */
+static bool bcache_index_stat(struct BodyCache *bcache, const char *id)
+{
+  long size = 0;
+  if (!bcache_stat(bcache, id, &size))
+    return false;
+
+  struct Buffer *key = mutt_buffer_pool_get();
+  bcache_file(bcache, id, true, key);
+  bcache_index_add(bcache->index, mutt_buffer_string(key), size);
+  mutt_buffer_pool_release(&key);
+  return true;
+}
+
 /**
  * bcache_path - Create the cache path for a given account/mailbox
  * @param account Account info
@@ -99,37 +178,16 @@ static int bcache_path(struct ConnAccount *account, const char *mailbox, struct
   mutt_debug(LL_DEBUG3, "path: '%s'\n", mutt_buffer_string(dst));
   bcache->path = mutt_buffer_strdup(dst);
 
+  const char *dir = bcache->path + mutt_str_len(c_message_cachedir);
+  while (*dir == '/')
+    dir++;
+  bcache->dir = mutt_str_dup(dir);
+
   mutt_buffer_pool_release(&path);
   mutt_buffer_pool_release(&dst);
   return 0;
 }
 
-/**
- * mutt_bcache_move - Change the id of a message in the cache
- * @param bcache Body cache
- * @param id     Per-mailbox unique identifier for the message
- * @param newid  New id for the message
- */
-static int mutt_bcache_move(struct BodyCache *bcache, const char *id, const char *newid)
-{
-  if (!bcache || !id || (*id == '\0') || !newid || (*newid == '\0'))
-    return -1;
-
-  struct Buffer *path = mutt_buffer_pool_get();
-  struct Buffer *newpath = mutt_buffer_pool_get();
-
-  mutt_buffer_printf(path, "%s%s", bcache->path, id);
-  mutt_buffer_printf(newpath, "%s%s", bcache->path, newid);
-
-  mutt_debug(LL_DEBUG3, "bcache: mv: '%s' '%s'\n", mutt_buffer_string(path),
-             mutt_buffer_string(newpath));
-
-  int rc = rename(mutt_buffer_string(path), mutt_buffer_string(newpath));
-  mutt_buffer_pool_release(&path);
-  mutt_buffer_pool_release(&newpath);
-  return rc;
-}
-
 /**
  * mutt_bcache_open - Open an Email-Body Cache
  * @param account current mailbox' account (required)
@@ -152,6 +210,10 @@ struct BodyCache *mutt_bcache_open(struct ConnAccount *account, const char *mail
     return NULL;
   }
 
+  const char *const c_message_cachedir =
+      cs_subset_path(NeoMutt->sub, "message_cachedir");
+  bcache->index = bcache_index_open(c_message_cachedir);
+
   return bcache;
 }
 
@@ -165,7 +227,9 @@ void mutt_bcache_close(struct BodyCache **bcache)
 {
   if (!bcache || !*bcache)
     return;
+  bcache_index_close(&(*bcache)->index);
   FREE(&(*bcache)->path);
+  FREE(&(*bcache)->dir);
   FREE(bcache);
 }
 
@@ -182,15 +246,40 @@ FILE *mutt_bcache_get(struct BodyCache *bcache, const char *id)
     return NULL;
 
   struct Buffer *path = mutt_buffer_pool_get();
-  mutt_buffer_addstr(path, bcache->path);
-  mutt_buffer_addstr(path, id);
+  struct Buffer *key = mutt_buffer_pool_get();
+  bcache_file(bcache, id, false, path);
+  bcache_file(bcache, id, true, key);
 
   FILE *fp = mutt_file_fopen(mutt_buffer_string(path), "r");
+  if (fp)
+  {
+    if (!bcache_index_touch(bcache->index, mutt_buffer_string(key)))
+      bcache_index_stat(bcache, id);
+  }
+  else
+  {
+    /* Move a file from an older version into place */
+    struct Buffer *old = mutt_buffer_pool_get();
+    mutt_buffer_printf(old, "%s%s", bcache->path, id);
+    fp = mutt_file_fopen(mutt_buffer_string(old), "r");
+    if (fp)
+    {
+      mutt_buffer_printf(path, "%s.%02x", bcache->path, bcache_shard(id));
+      if (mutt_file_mkdir(mutt_buffer_string(path), S_IRWXU | S_IRWXG | S_IRWXO) == 0)
+      {
+        bcache_file(bcache, id, false, path);
+        if (rename(mutt_buffer_string(old), mutt_buffer_string(path)) == 0)
+          bcache_index_stat(bcache, id);
+      }
+    }
+    mutt_buffer_pool_release(&old);
+  }
 
   mutt_debug(LL_DEBUG3, "bcache: get: '%s': %s\n", mutt_buffer_string(path),
              fp ? "yes" : "no");
 
   mutt_buffer_pool_release(&path);
+  mutt_buffer_pool_release(&key);
   return fp;
 }
 
@@ -209,9 +298,6 @@ FILE *mutt_bcache_put(struct BodyCache *bcache, const char *id)
   if (!id || (*id == '\0') || !bcache)
     return NULL;
 
-  struct Buffer *path = mutt_buffer_pool_get();
-  mutt_buffer_printf(path, "%s%s%s", bcache->path, id, ".tmp");
-
   struct stat sb;
   if (stat(bcache->path, &sb) == 0)
   {
@@ -221,16 +307,20 @@ FILE *mutt_bcache_put(struct BodyCache *bcache, const char *id)
       return NULL;
     }
   }
-  else
+
+  struct Buffer *path = mutt_buffer_pool_get();
+  mutt_buffer_printf(path, "%s.%02x", bcache->path, bcache_shard(id));
+  if (mutt_file_mkdir(mutt_buffer_string(path), S_IRWXU | S_IRWXG | S_IRWXO) < 0)
   {
-    if (mutt_file_mkdir(bcache->path, S_IRWXU | S_IRWXG | S_IRWXO) < 0)
-    {
-      mutt_error(_("Can't create %s: %s"), bcache->path, strerror(errno));
-      return NULL;
-    }
+    mutt_error(_("Can't create %s: %s"), mutt_buffer_string(path), strerror(errno));
+    mutt_buffer_pool_release(&path);
+    return NULL;
   }
 
-  mutt_debug(LL_DEBUG3, "bcache: put: '%s'\n", path);
+  bcache_file(bcache, id, false, path);
+  mutt_buffer_addstr(path, ".tmp");
+
+  mutt_debug(LL_DEBUG3, "bcache: put: '%s'\n", mutt_buffer_string(path));
 
   FILE *fp = mutt_file_fopen(mutt_buffer_string(path), "w+");
   mutt_buffer_pool_release(&path);
@@ -243,14 +333,29 @@ FILE *mutt_bcache_put(struct BodyCache *bcache, const char *id)
  * @param id     Per-mailbox unique identifier for the message
  * @retval  0 Success
  * @retval -1 Failure
+ *
+ * If the cache is now larger than $message_cache_size, the least recently
+ * used files are deleted.
  */
 int mutt_bcache_commit(struct BodyCache *bcache, const char *id)
 {
-  struct Buffer *tmpid = mutt_buffer_pool_get();
-  mutt_buffer_printf(tmpid, "%s.tmp", id);
+  if (!bcache || !id || (*id == '\0'))
+    return -1;
+
+  struct Buffer *path = mutt_buffer_pool_get();
+  struct Buffer *tmp = mutt_buffer_pool_get();
+  bcache_file(bcache, id, false, path);
+  mutt_buffer_printf(tmp, "%s.tmp", mutt_buffer_string(path));
+
+  mutt_debug(LL_DEBUG3, "bcache: mv: '%s' '%s'\n", mutt_buffer_string(tmp),
+             mutt_buffer_string(path));
 
-  int rc = mutt_bcache_move(bcache, mutt_buffer_string(tmpid), id);
-  mutt_buffer_pool_release(&tmpid);
+  int rc = rename(mutt_buffer_string(tmp), mutt_buffer_string(path));
+  if (rc == 0)
+    bcache_index_stat(bcache, id);
+
+  mutt_buffer_pool_release(&path);
+  mutt_buffer_pool_release(&tmp);
   return rc;
 }
 
@@ -260,6 +365,8 @@ int mutt_bcache_commit(struct BodyCache *bcache, const char *id)
  * @param id     Per-mailbox unique identifier for the message
  * @retval  0 Success
  * @retval -1 Failure
+ *
+ * An unfinished file, from mutt_bcache_put(), is deleted too.
  */
 int mutt_bcache_del(struct BodyCache *bcache, const char *id)
 {
@@ -267,12 +374,25 @@ int mutt_bcache_del(struct BodyCache *bcache, const char *id)
     return -1;
 
   struct Buffer *path = mutt_buffer_pool_get();
-  mutt_buffer_addstr(path, bcache->path);
-  mutt_buffer_addstr(path, id);
+  bcache_file(bcache, id, true, path);
+  bcache_index_del(bcache->index, mutt_buffer_string(path));
 
+  bcache_file(bcache, id, false, path);
   mutt_debug(LL_DEBUG3, "bcache: del: '%s'\n", mutt_buffer_string(path));
 
+  struct Buffer *tmp = mutt_buffer_pool_get();
+  mutt_buffer_printf(tmp, "%s.tmp", mutt_buffer_string(path));
+  unlink(mutt_buffer_string(tmp));
+  mutt_buffer_pool_release(&tmp);
+
   int rc = unlink(mutt_buffer_string(path));
+  if ((rc < 0) && (errno == ENOENT))
+  {
+    /* A file from an older version */
+    mutt_buffer_printf(path, "%s%s", bcache->path, id);
+    rc = unlink(mutt_buffer_string(path));
+  }
+
   mutt_buffer_pool_release(&path);
   return rc;
 }
@@ -283,6 +403,9 @@ int mutt_bcache_del(struct BodyCache *bcache, const char *id)
  * @param id     Per-mailbox unique identifier for the message
  * @retval  0 Success
  * @retval -1 Failure
+ *
+ * Once a mailbox's directory has been listed, files that aren't in the index
+ * are known not to exist.
  */
 int mutt_bcache_exists(struct BodyCache *bcache, const char *id)
 {
@@ -290,23 +413,94 @@ int mutt_bcache_exists(struct BodyCache *bcache, const char *id)
     return -1;
 
   struct Buffer *path = mutt_buffer_pool_get();
-  mutt_buffer_addstr(path, bcache->path);
-  mutt_buffer_addstr(path, id);
+  bcache_file(bcache, id, true, path);
 
-  int rc = 0;
-  struct stat st;
-  if (stat(mutt_buffer_string(path), &st) < 0)
-    rc = -1;
-  else
-    rc = (S_ISREG(st.st_mode) && (st.st_size != 0)) ? 0 : -1;
+  bool found = false;
+  if (bcache_index_find(bcache->index, mutt_buffer_string(path)))
+  {
+    /* Files may be removed by hand */
+    found = bcache_stat(bcache, id, NULL);
+    if (!found)
+      bcache_index_del(bcache->index, mutt_buffer_string(path));
+  }
+  else if (!bcache_index_dir_complete(bcache->index, bcache->dir))
+  {
+    found = bcache_index_stat(bcache, id);
+  }
+
+  if (!found)
+  {
+    /* A file from an older version */
+    mutt_buffer_printf(path, "%s%s", bcache->path, id);
+    struct stat st;
+    found = (stat(mutt_buffer_string(path), &st) == 0) &&
+            S_ISREG(st.st_mode) && (st.st_size != 0);
+  }
 
-  mutt_debug(LL_DEBUG3, "bcache: exists: '%s': %s\n", mutt_buffer_string(path),
-             (rc == 0) ? "yes" : "no");
+  mutt_debug(LL_DEBUG3, "bcache: exists: '%s': %s\n", id, found ? "yes" : "no");
 
   mutt_buffer_pool_release(&path);
+  return found ? 0 : -1;
+}
+
+/**
+ * bcache_list_dir - List the files in one directory
+ * @param bcache  Body Cache from mutt_bcache_open()
+ * @param dir     Directory to list
+ * @param want_id Callback function called for each file
+ * @param data    Data to pass to the callback function
+ * @param count   Number of files listed so far
+ * @retval  0 Success
+ * @retval  1 The callback stopped the listing
+ * @retval -1 The directory couldn't be read
+ *
+ * Hidden files, including the subdirectories, and temporary files are skipped.
+ */
+static int bcache_list_dir(struct BodyCache *bcache, const char *dir,
+                           bcache_list_t want_id, void *data, int *count)
+{
+  DIR *d = opendir(dir);
+  if (!d)
+    return -1;
+
+  mutt_debug(LL_DEBUG3, "bcache: list: dir: '%s'\n", dir);
+
+  int rc = 0;
+  struct dirent *de = NULL;
+  while ((de = readdir(d)))
+  {
+    const size_t len = mutt_str_len(de->d_name);
+    if ((de->d_name[0] == '.') || ((len > 4) && mutt_str_equal(de->d_name + len - 4, ".tmp")))
+    {
+      continue;
+    }
+
+    mutt_debug(LL_DEBUG3, "bcache: list: dir: '%s', id :'%s'\n", dir, de->d_name);
+
+    if (want_id && (want_id(de->d_name, bcache, data) != 0))
+    {
+      rc = 1;
+      break;
+    }
+
+    (*count)++;
+  }
+
+  if (closedir(d) < 0)
+    rc = -1;
   return rc;
 }
 
+/**
+ * bcache_adopt - Add a file to the index - Implements ::bcache_list_t
+ * @retval 0 Always
+ */
+static int bcache_adopt(const char *id, struct BodyCache *bcache, void *data)
+{
+  bcache_index_stat(bcache, id);
+  return 0;
+}
+
 /**
  * mutt_bcache_list - Find matching entries in the Body Cache
  * @param bcache Body Cache from mutt_bcache_open()
@@ -325,41 +519,51 @@ int mutt_bcache_exists(struct BodyCache *bcache, const char *id)
  * listing is aborted and continued otherwise. The callback is optional
  * so that this function can be used to count the items in the cache
  * (see below for return value).
+ *
+ * The first time a mailbox is listed, its subdirectories are scanned and
+ * the files are added to the index.  After that, only the index is used.
  */
 int mutt_bcache_list(struct BodyCache *bcache, bcache_list_t want_id, void *data)
 {
-  DIR *d = NULL;
-  struct dirent *de = NULL;
-  int rc = -1;
+  if (!bcache)
+    return -1;
 
-  if (!bcache || !(d = opendir(bcache->path)))
+  /* Files from older versions, or other files, e.g. a header cache */
+  int count = 0;
+  int rc = bcache_list_dir(bcache, bcache->path, want_id, data, &count);
+  if (rc != 0)
     goto out;
 
-  rc = 0;
-
-  mutt_debug(LL_DEBUG3, "bcache: list: dir: '%s'\n", bcache->path);
-
-  while ((de = readdir(d)))
+  struct Buffer *path = mutt_buffer_pool_get();
+  if (bcache->index)
   {
-    if (mutt_str_startswith(de->d_name, ".") || mutt_str_startswith(de->d_name, ".."))
+    if (!bcache_index_dir_complete(bcache->index, bcache->dir))
     {
-      continue;
+      int adopted = 0;
+      for (int i = 0; i < 256; i++)
+      {
+        mutt_buffer_printf(path, "%s.%02x", bcache->path, i);
+        bcache_list_dir(bcache, mutt_buffer_string(path), bcache_adopt, NULL, &adopted);
+      }
+      bcache_index_dir_set_complete(bcache->index, bcache->dir);
     }
 
-    mutt_debug(LL_DEBUG3, "bcache: list: dir: '%s', id :'%s'\n", bcache->path, de->d_name);
-
-    if (want_id && (want_id(de->d_name, bcache, data) != 0))
-      goto out;
-
-    rc++;
+    count += bcache_index_list(bcache->index, bcache->dir, want_id, bcache, data);
   }
-
-out:
-  if (d)
+  else
   {
-    if (closedir(d) < 0)
-      rc = -1;
+    for (int i = 0; i < 256; i++)
+    {
+      mutt_buffer_printf(path, "%s.%02x", bcache->path, i);
+      if (bcache_list_dir(bcache, mutt_buffer_string(path), want_id, data, &count) == 1)
+        break;
+    }
   }
-  mutt_debug(LL_DEBUG3, "bcache: list: did %d entries\n", rc);
-  return rc;
+  mutt_buffer_pool_release(&path);
+
+out:
+  if (rc < 0)
+    count = -1;
+  mutt_debug(LL_DEBUG3, "bcache: list: did %d entries\n", count);
+  return count;
 }
@@ -0,0 +1,592 @@
+/**
+ * @file
+ * Index of the Body Cache
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page bcache_index Index of the Body Cache
+ *
+ * The index records the size and time of last access of every file in the
+ * Body Cache.  It's shared by all the mailboxes in `$message_cachedir`.
+ *
+ * It allows the cache to be limited to `$message_cache_size` bytes, by
+ * deleting the least recently used files, without having to scan the
+ * directories.
+ *
+ * The index is stored in `$message_cachedir/.bcache-index` as a journal of
+ * text records, one per line, which is replayed when the index is opened:
+ *
+ * | Record                    | Meaning                                   |
+ * | :------------------------ | :---------------------------------------- |
+ * | `+ <size> <atime> <key>`  | File added, or replaced                   |
+ * | `a <atime> <key>`         | File read                                 |
+ * | `- <key>`                 | File deleted                              |
+ * | `d <dir>`                 | All the files in a directory are indexed  |
+ *
+ * Keys are file paths, relative to `$message_cachedir`.  When the journal has
+ * grown too large, it's rewritten.
+ *
+ * Several NeoMutts may share the cache.  Files added by another process may
+ * be missing from the index, until the index is rewritten and the directories
+ * are scanned again.
+ */
+
+#include "config.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "private.h"
+
+/// Name of the journal file, in $message_cachedir
+#define BCACHE_INDEX_FILE ".bcache-index"
+/// First line of the journal file
+#define BCACHE_INDEX_MAGIC "neomutt bcache index 1"
+
+/**
+ * struct BcacheEntry - A file in the Body Cache
+ */
+struct BcacheEntry
+{
+  char *key;                             ///< Path, relative to $message_cachedir
+  struct BcacheDir *dir;                 ///< Directory containing the file
+  long size;                             ///< Size of the file in bytes
+  time_t atime;                          ///< Time of last access
+  TAILQ_ENTRY(BcacheEntry) lru;          ///< Linked list, least recently used first
+  TAILQ_ENTRY(BcacheEntry) siblings;     ///< Linked list of files in the same directory
+};
+TAILQ_HEAD(BcacheEntryList, BcacheEntry);
+
+/**
+ * struct BcacheDir - A mailbox directory in the Body Cache
+ */
+struct BcacheDir
+{
+  char *name;                            ///< Path, relative to $message_cachedir
+  bool complete;                         ///< Every file in the directory is indexed
+  struct BcacheEntryList entries;        ///< Files in the directory
+};
+
+/**
+ * struct BcacheIndex - Index of the Body Cache
+ */
+struct BcacheIndex
+{
+  char *cachedir;                        ///< $message_cachedir when the index was opened
+  FILE *fp;                              ///< Journal, open for appending
+  int refs;                              ///< Number of open Body Caches using the index
+  struct HashTable *entries;             ///< Hash Table: key -> BcacheEntry
+  struct HashTable *dirs;                ///< Hash Table: name -> BcacheDir
+  struct BcacheEntryList lru;            ///< All the files, least recently used first
+  long long total;                       ///< Total size of the files in bytes
+  size_t count;                          ///< Number of files
+  size_t records;                        ///< Number of records in the journal
+};
+
+/// The index is shared by all the Body Caches
+static struct BcacheIndex *Index = NULL;
+
+/**
+ * dir_free - Free a BcacheDir - Implements ::hash_hdata_free_t
+ */
+static void dir_free(int type, void *obj, intptr_t data)
+{
+  struct BcacheDir *dir = obj;
+  FREE(&dir->name);
+  FREE(&dir);
+}
+
+/**
+ * dir_get - Get the BcacheDir for a directory
+ * @param idx    Body Cache Index
+ * @param name   Path, relative to $message_cachedir
+ * @param create Create the BcacheDir, if it doesn't exist
+ * @retval ptr  Directory
+ * @retval NULL Directory isn't known
+ */
+static struct BcacheDir *dir_get(struct BcacheIndex *idx, const char *name, bool create)
+{
+  struct BcacheDir *dir = mutt_hash_find(idx->dirs, name);
+  if (dir || !create)
+    return dir;
+
+  dir = mutt_mem_calloc(1, sizeof(*dir));
+  dir->name = mutt_str_dup(name);
+  TAILQ_INIT(&dir->entries);
+  mutt_hash_insert(idx->dirs, dir->name, dir);
+  return dir;
+}
+
+/**
+ * key_dir - Get the directory part of a key
+ * @param key Key, e.g. `imap:user@host/INBOX/.3f/1234-56`
+ * @param buf Buffer for the result, e.g. `imap:user@host/INBOX/`
+ * @retval true Success
+ *
+ * The directory excludes the shard subdirectory.
+ */
+static bool key_dir(const char *key, struct Buffer *buf)
+{
+  const char *slash = strrchr(key, '/');
+  if (!slash || ((slash - key) < 3) || (slash[-3] != '.'))
+    return false;
+
+  mutt_buffer_strcpy_n(buf, key, slash - key - 3);
+  return true;
+}
+
+/**
+ * entry_remove - Remove an entry from the index
+ * @param idx Body Cache Index
+ * @param e   Entry to remove
+ */
+static void entry_remove(struct BcacheIndex *idx, struct BcacheEntry *e)
+{
+  mutt_hash_delete(idx->entries, e->key, e);
+  TAILQ_REMOVE(&idx->lru, e, lru);
+  TAILQ_REMOVE(&e->dir->entries, e, siblings);
+  idx->total -= e->size;
+  idx->count--;
+  FREE(&e->key);
+  FREE(&e);
+}
+
+/**
+ * entry_set - Add or update an entry in the index
+ * @param idx   Body Cache Index
+ * @param key   Path, relative to $message_cachedir
+ * @param size  Size of the file, -1 to leave it unchanged
+ * @param atime Time of last access
+ * @retval ptr  Entry
+ * @retval NULL Key isn't valid, or a size is needed
+ *
+ * The entry becomes the most recently used.
+ */
+static struct BcacheEntry *entry_set(struct BcacheIndex *idx, const char *key,
+                                     long size, time_t atime)
+{
+  struct BcacheEntry *e = mutt_hash_find(idx->entries, key);
+  if (!e)
+  {
+    if (size < 0)
+      return NULL;
+
+    struct Buffer *name = mutt_buffer_pool_get();
+    if (!key_dir(key, name))
+    {
+      mutt_buffer_pool_release(&name);
+      return NULL;
+    }
+
+    e = mutt_mem_calloc(1, sizeof(*e));
+    e->key = mutt_str_dup(key);
+    e->dir = dir_get(idx, mutt_buffer_string(name), true);
+    mutt_buffer_pool_release(&name);
+
+    mutt_hash_insert(idx->entries, e->key, e);
+    TAILQ_INSERT_TAIL(&e->dir->entries, e, siblings);
+    idx->count++;
+  }
+  else
+  {
+    TAILQ_REMOVE(&idx->lru, e, lru);
+  }
+
+  if (size >= 0)
+  {
+    idx->total += size - e->size;
+    e->size = size;
+  }
+  e->atime = atime;
+  TAILQ_INSERT_TAIL(&idx->lru, e, lru);
+  return e;
+}
+
+/**
+ * journal_add - Add a record to the journal
+ * @param idx Body Cache Index
+ * @param fmt printf-like format string
+ * @param ... Arguments
+ */
+static void journal_add(struct BcacheIndex *idx, const char *fmt, ...)
+{
+  if (!idx->fp)
+    return;
+
+  va_list ap;
+  va_start(ap, fmt);
+  vfprintf(idx->fp, fmt, ap);
+  va_end(ap);
+  fflush(idx->fp);
+  idx->records++;
+}
+
+/**
+ * journal_replay - Read the journal into the index
+ * @param idx  Body Cache Index
+ * @param file Journal file
+ * @retval true The journal is valid
+ */
+static bool journal_replay(struct BcacheIndex *idx, const char *file)
+{
+  FILE *fp = fopen(file, "r");
+  if (!fp)
+    return false;
+
+  size_t len = 0;
+  int line = 0;
+  char *buf = mutt_file_read_line(NULL, &len, fp, &line, MUTT_RL_NO_FLAGS);
+  bool valid = mutt_str_equal(buf, BCACHE_INDEX_MAGIC);
+
+  while (valid && (buf = mutt_file_read_line(buf, &len, fp, &line, MUTT_RL_NO_FLAGS)))
+  {
+    long size = 0;
+    long long atime = 0;
+    int n = 0;
+
+    idx->records++;
+    if ((sscanf(buf, "+ %ld %lld %n", &size, &atime, &n) == 2) && (n > 0))
+    {
+      entry_set(idx, buf + n, size, atime);
+    }
+    else if ((sscanf(buf, "a %lld %n", &atime, &n) == 1) && (n > 0))
+    {
+      entry_set(idx, buf + n, -1, atime);
+    }
+    else if (mutt_str_startswith(buf, "- "))
+    {
+      struct BcacheEntry *e = mutt_hash_find(idx->entries, buf + 2);
+      if (e)
+        entry_remove(idx, e);
+    }
+    else if (mutt_str_startswith(buf, "d "))
+    {
+      dir_get(idx, buf + 2, true)->complete = true;
+    }
+    else
+    {
+      mutt_debug(LL_DEBUG1, "bcache: index: bad record %d: %s\n", line, buf);
+    }
+  }
+
+  FREE(&buf);
+  mutt_file_fclose(&fp);
+  return valid;
+}
+
+/**
+ * journal_rewrite - Replace the journal with the contents of the index
+ * @param idx  Body Cache Index
+ * @param file Journal file
+ *
+ * The directories will need to be scanned again, in case another process has
+ * added files that weren't recorded.
+ */
+static void journal_rewrite(struct BcacheIndex *idx, const char *file)
+{
+  struct Buffer *tmp = mutt_buffer_pool_get();
+  mutt_buffer_printf(tmp, "%s.tmp", file);
+
+  FILE *fp = mutt_file_fopen(mutt_buffer_string(tmp), "w");
+  if (!fp)
+  {
+    mutt_debug(LL_DEBUG1, "bcache: index: can't write %s: %s\n",
+               mutt_buffer_string(tmp), strerror(errno));
+    mutt_buffer_pool_release(&tmp);
+    return;
+  }
+
+  fprintf(fp, "%s\n", BCACHE_INDEX_MAGIC);
+  struct BcacheEntry *e = NULL;
+  TAILQ_FOREACH(e, &idx->lru, lru)
+  {
+    fprintf(fp, "+ %ld %lld %s\n", e->size, (long long) e->atime, e->key);
+  }
+
+  struct HashWalkState state = { 0 };
+  struct HashElem *he = NULL;
+  while ((he = mutt_hash_walk(idx->dirs, &state)))
+  {
+    struct BcacheDir *dir = he->data;
+    dir->complete = false;
+  }
+
+  if ((mutt_file_fclose(&fp) == 0) && (rename(mutt_buffer_string(tmp), file) == 0))
+    idx->records = idx->count;
+  else
+    unlink(mutt_buffer_string(tmp));
+
+  mutt_buffer_pool_release(&tmp);
+}
+
+/**
+ * index_free - Free the Body Cache Index
+ * @param ptr Body Cache Index to free
+ */
+static void index_free(struct BcacheIndex **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct BcacheIndex *idx = *ptr;
+  struct BcacheEntry *e = NULL;
+  struct BcacheEntry *tmp = NULL;
+  TAILQ_FOREACH_SAFE(e, &idx->lru, lru, tmp)
+  {
+    FREE(&e->key);
+    FREE(&e);
+  }
+
+  mutt_hash_free(&idx->entries);
+  mutt_hash_free(&idx->dirs);
+  mutt_file_fclose(&idx->fp);
+  FREE(&idx->cachedir);
+  FREE(ptr);
+}
+
+/**
+ * bcache_index_open - Open the Body Cache Index
+ * @param cachedir Body Cache directory, $message_cachedir
+ * @retval ptr  Body Cache Index
+ * @retval NULL The index is already in use for another directory
+ *
+ * The index is shared.  Each call must be matched by bcache_index_close().
+ */
+struct BcacheIndex *bcache_index_open(const char *cachedir)
+{
+  if (Index)
+  {
+    if (!mutt_str_equal(Index->cachedir, cachedir))
+      return NULL;
+    Index->refs++;
+    return Index;
+  }
+
+  struct Buffer *file = mutt_buffer_pool_get();
+  mutt_buffer_printf(file, "%s/%s", cachedir, BCACHE_INDEX_FILE);
+
+  /* Size the hash tables for the journal, assuming short records */
+  size_t num_elems = 1024;
+  struct stat st = { 0 };
+  if (stat(mutt_buffer_string(file), &st) == 0)
+    num_elems += st.st_size / 64;
+
+  struct BcacheIndex *idx = mutt_mem_calloc(1, sizeof(*idx));
+  idx->cachedir = mutt_str_dup(cachedir);
+  idx->refs = 1;
+  idx->entries = mutt_hash_new(num_elems, MUTT_HASH_NO_FLAGS);
+  idx->dirs = mutt_hash_new(128, MUTT_HASH_NO_FLAGS);
+  mutt_hash_set_destructor(idx->dirs, dir_free, 0);
+  TAILQ_INIT(&idx->lru);
+
+  if (!journal_replay(idx, mutt_buffer_string(file)) ||
+      (idx->records > ((2 * idx->count) + 1024)))
+  {
+    journal_rewrite(idx, mutt_buffer_string(file));
+  }
+
+  idx->fp = mutt_file_fopen(mutt_buffer_string(file), "a");
+  mutt_debug(LL_DEBUG2, "bcache: index: %zu files, %lld bytes\n", idx->count, idx->total);
+
+  mutt_buffer_pool_release(&file);
+  Index = idx;
+  return idx;
+}
+
+/**
+ * bcache_index_close - Close the Body Cache Index
+ * @param[out] ptr Body Cache Index
+ *
+ * When the last user closes the index, it's freed.
+ */
+void bcache_index_close(struct BcacheIndex **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct BcacheIndex *idx = *ptr;
+  *ptr = NULL;
+
+  if (--idx->refs > 0)
+    return;
+
+  if (idx == Index)
+    Index = NULL;
+  index_free(&idx);
+}
+
+/**
+ * bcache_index_find - Is a file in the index?
+ * @param idx Body Cache Index
+ * @param key Path, relative to $message_cachedir
+ * @retval true The file is in the index
+ */
+bool bcache_index_find(struct BcacheIndex *idx, const char *key)
+{
+  return idx && mutt_hash_find(idx->entries, key);
+}
+
+/**
+ * bcache_index_add - Add a file to the index
+ * @param idx  Body Cache Index
+ * @param key  Path, relative to $message_cachedir
+ * @param size Size of the file in bytes
+ *
+ * If the cache is now larger than $message_cache_size, the least recently
+ * used files are deleted.  The new file is never deleted.
+ */
+void bcache_index_add(struct BcacheIndex *idx, const char *key, long size)
+{
+  if (!idx || !key)
+    return;
+
+  struct BcacheEntry *e_new = entry_set(idx, key, size, mutt_date_epoch());
+  if (!e_new)
+    return;
+  journal_add(idx, "+ %ld %lld %s\n", e_new->size, (long long) e_new->atime, e_new->key);
+
+  const long c_message_cache_size = cs_subset_long(NeoMutt->sub, "message_cache_size");
+  if (c_message_cache_size <= 0)
+    return;
+
+  struct Buffer *path = mutt_buffer_pool_get();
+  struct BcacheEntry *e = NULL;
+  while ((idx->total > c_message_cache_size) &&
+         ((e = TAILQ_FIRST(&idx->lru)) != e_new))
+  {
+    mutt_buffer_printf(path, "%s/%s", idx->cachedir, e->key);
+    mutt_debug(LL_DEBUG3, "bcache: index: evict '%s'\n", mutt_buffer_string(path));
+    if ((unlink(mutt_buffer_string(path)) < 0) && (errno != ENOENT))
+    {
+      mutt_debug(LL_DEBUG1, "bcache: index: can't delete %s: %s\n",
+                 mutt_buffer_string(path), strerror(errno));
+    }
+    journal_add(idx, "- %s\n", e->key);
+    entry_remove(idx, e);
+  }
+  mutt_buffer_pool_release(&path);
+}
+
+/**
+ * bcache_index_touch - Mark a file as recently used
+ * @param idx Body Cache Index
+ * @param key Path, relative to $message_cachedir
+ * @retval true The file is in the index
+ */
+bool bcache_index_touch(struct BcacheIndex *idx, const char *key)
+{
+  if (!idx || !key)
+    return false;
+
+  struct BcacheEntry *e = entry_set(idx, key, -1, mutt_date_epoch());
+  if (!e)
+    return false;
+
+  journal_add(idx, "a %lld %s\n", (long long) e->atime, e->key);
+  return true;
+}
+
+/**
+ * bcache_index_del - Remove a file from the index
+ * @param idx Body Cache Index
+ * @param key Path, relative to $message_cachedir
+ */
+void bcache_index_del(struct BcacheIndex *idx, const char *key)
+{
+  if (!idx || !key)
+    return;
+
+  struct BcacheEntry *e = mutt_hash_find(idx->entries, key);
+  if (!e)
+    return;
+
+  journal_add(idx, "- %s\n", e->key);
+  entry_remove(idx, e);
+}
+
+/**
+ * bcache_index_dir_complete - Are all the files in a directory indexed?
+ * @param idx Body Cache Index
+ * @param dir Path, relative to $message_cachedir
+ * @retval true The directory has been scanned
+ */
+bool bcache_index_dir_complete(struct BcacheIndex *idx, const char *dir)
+{
+  if (!idx || !dir)
+    return false;
+
+  struct BcacheDir *bd = dir_get(idx, dir, false);
+  return bd && bd->complete;
+}
+
+/**
+ * bcache_index_dir_set_complete - Record that all the files in a directory are indexed
+ * @param idx Body Cache Index
+ * @param dir Path, relative to $message_cachedir
+ */
+void bcache_index_dir_set_complete(struct BcacheIndex *idx, const char *dir)
+{
+  if (!idx || !dir)
+    return;
+
+  dir_get(idx, dir, true)->complete = true;
+  journal_add(idx, "d %s\n", dir);
+}
+
+/**
+ * bcache_index_list - List the indexed files in a directory
+ * @param idx     Body Cache Index
+ * @param dir     Path, relative to $message_cachedir
+ * @param want_id Callback function called for each file
+ * @param bcache  Body Cache to pass to the callback function
+ * @param data    Data to pass to the callback function
+ * @retval num Number of files listed
+ *
+ * The callback may delete the file it's given.  If the callback returns
+ * non-zero, the listing is stopped.
+ */
+int bcache_index_list(struct BcacheIndex *idx, const char *dir,
+                      bcache_list_t want_id, struct BodyCache *bcache, void *data)
+{
+  struct BcacheDir *bd = idx ? dir_get(idx, dir, false) : NULL;
+  if (!bd)
+    return 0;
+
+  int count = 0;
+  struct BcacheEntry *e = NULL;
+  struct BcacheEntry *tmp = NULL;
+  TAILQ_FOREACH_SAFE(e, &bd->entries, siblings, tmp)
+  {
+    const char *id = strrchr(e->key, '/') + 1;
+    if (want_id && (want_id(id, bcache, data) != 0))
+      break;
+    count++;
+  }
+
+  return count;
+}
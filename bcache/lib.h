@@ -29,6 +29,7 @@
  * | File                | Description                |
  * | :------------------ | :------------------------- |
  * | bcache/bcache.c     | @subpage bcache_bcache     |
+ * | bcache/index.c      | @subpage bcache_index      |
  */
 
 #ifndef MUTT_BCACHE_LIB_H
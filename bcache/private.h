@@ -0,0 +1,42 @@
+/**
+ * @file
+ * Shared functions that are private to the Body Cache
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_BCACHE_PRIVATE_H
+#define MUTT_BCACHE_PRIVATE_H
+
+#include <stdbool.h>
+#include "lib.h"
+
+struct BcacheIndex;
+struct BodyCache;
+
+void                bcache_index_add         (struct BcacheIndex *idx, const char *key, long size);
+void                bcache_index_close       (struct BcacheIndex **ptr);
+void                bcache_index_del         (struct BcacheIndex *idx, const char *key);
+bool                bcache_index_dir_complete(struct BcacheIndex *idx, const char *dir);
+void                bcache_index_dir_set_complete(struct BcacheIndex *idx, const char *dir);
+bool                bcache_index_find        (struct BcacheIndex *idx, const char *key);
+int                 bcache_index_list        (struct BcacheIndex *idx, const char *dir, bcache_list_t want_id, struct BodyCache *bcache, void *data);
+struct BcacheIndex *bcache_index_open        (const char *cachedir);
+bool                bcache_index_touch       (struct BcacheIndex *idx, const char *key);
+
+#endif /* MUTT_BCACHE_PRIVATE_H */
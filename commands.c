@@ -342,7 +342,7 @@ int mutt_display_message(struct MuttWindow *win_index, struct MuttWindow *win_ib
 
     /* Remove color cache for this message, in case there
      * are color patterns for both ~g and ~V */
-    e->pair = 0;
+    e->pair_valid = false;
 
     /* Process protected headers and autocrypt gossip headers */
     process_protected_headers(m, e);
@@ -42,11 +42,16 @@
  * Usage with Compression Level set to X:
  * - open(level X) -> N times compress() -> close()
  * - open(level X) -> N times decompress() -> close()
+ *
+ * Backends that support dictionaries can be primed with one:
+ * - train(samples) -> dictionary
+ * - open(level X) -> set_dict(dictionary) -> N times compress() -> close()
  */
 
 #ifndef MUTT_COMPRESS_LIB_H
 #define MUTT_COMPRESS_LIB_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 /**
@@ -82,16 +87,47 @@ struct ComprOps
 
   /**
    * decompress - Decompress header cache data
-   * @param[in] cctx Compression context
-   * @param[in] cbuf Data to be decompressed
-   * @param[in] clen Length of the compressed input data
+   * @param[in]  cctx Compression context
+   * @param[in]  cbuf Data to be decompressed
+   * @param[in]  clen Length of the compressed input data
+   * @param[out] dlen Length of the decompressed data
    * @retval ptr  Success, pointer to decompressed data
    * @retval NULL Otherwise
    *
    * @note This function returns a pointer to data, which will be freed by the
    *       close() function.
    */
-  void *(*decompress)(void *cctx, const char *cbuf, size_t clen);
+  void *(*decompress)(void *cctx, const char *cbuf, size_t clen, size_t *dlen);
+
+  /**
+   * train - Create a dictionary from some sample data
+   * @param[in]  samples Sample data, one after another
+   * @param[in]  sizes   Size of each sample
+   * @param[in]  num     Number of samples
+   * @param[in]  max_len Maximum size of the dictionary
+   * @param[out] dlen    Size of the dictionary
+   * @retval ptr  Success, the dictionary, which must be freed by the caller
+   * @retval NULL Otherwise
+   *
+   * @note This function is optional, but must be present if set_dict() is.
+   */
+  void *(*train)(const void *samples, const size_t *sizes, size_t num,
+                 size_t max_len, size_t *dlen);
+
+  /**
+   * set_dict - Use a dictionary for compression and decompression
+   * @param[in] cctx Compression context
+   * @param[in] dict Dictionary, created by train()
+   * @param[in] dlen Size of the dictionary
+   * @retval true  Success
+   * @retval false The dictionary isn't valid
+   *
+   * Data compressed without a dictionary can still be decompressed.
+   * Data compressed with a different dictionary can't.
+   *
+   * @note This function is optional.
+   */
+  bool (*set_dict)(void *cctx, const void *dict, size_t dlen);
 
   /**
    * close - Close a compression context
@@ -103,7 +103,7 @@ static void *compr_zlib_compress(void *cctx, const char *data, size_t dlen, size
 /**
  * compr_zlib_decompress - Implements ComprOps::decompress()
  */
-static void *compr_zlib_decompress(void *cctx, const char *cbuf, size_t clen)
+static void *compr_zlib_decompress(void *cctx, const char *cbuf, size_t clen, size_t *dlen)
 {
   if (!cctx)
     return NULL;
@@ -123,6 +123,9 @@ static void *compr_zlib_decompress(void *cctx, const char *cbuf, size_t clen)
   if (ret != Z_OK)
     return NULL;
 
+  if (dlen)
+    *dlen = ulen;
+
   return ubuf;
 }
 
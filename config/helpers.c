@@ -24,6 +24,9 @@
  * @page config_helpers Helper functions to get config values
  *
  * Helper functions to get config values
+ *
+ * The `cs_subset_*()` functions look up a config item by name.
+ * The `cs_handle_*()` functions use a ConfigHandle to skip the lookup.
  */
 
 #include "config.h"
@@ -307,3 +310,169 @@ const char *cs_subset_string(const struct ConfigSubset *sub, const char *name)
 
   return (const char *) value;
 }
+
+/**
+ * handle_get - Get the value of a config item using a ConfigHandle
+ * @param sub  Config Subset
+ * @param h    Handle of config item
+ * @param type Expected type of config item, e.g. #DT_BOOL
+ * @retval num Native value
+ */
+static intptr_t handle_get(const struct ConfigSubset *sub, struct ConfigHandle *h, int type)
+{
+  assert(sub && sub->cs && h && h->name);
+
+  if ((h->sub == sub) && (h->generation == sub->cs->generation))
+    return h->value;
+
+  struct HashElem *he = cs_subset_create_inheritance(sub, h->name);
+  assert(he);
+
+  struct HashElem *he_base = cs_get_base(he);
+  assert(DTYPE(he_base->type) == type);
+
+  intptr_t value = cs_subset_he_native_get(sub, he, NULL);
+  assert(value != INT_MIN);
+
+  h->sub = sub;
+  h->generation = sub->cs->generation;
+  h->value = value;
+  return value;
+}
+
+/**
+ * cs_handle_address - Get an Address config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval ptr  Address
+ * @retval NULL Empty address
+ */
+const struct Address *cs_handle_address(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (const struct Address *) handle_get(sub, h, DT_ADDRESS);
+}
+
+/**
+ * cs_handle_bool - Get a boolean config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval bool  Boolean value
+ */
+bool cs_handle_bool(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (bool) handle_get(sub, h, DT_BOOL);
+}
+
+/**
+ * cs_handle_enum - Get an enumeration config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval num  Enumeration
+ */
+unsigned char cs_handle_enum(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (unsigned char) handle_get(sub, h, DT_ENUM);
+}
+
+/**
+ * cs_handle_long - Get a long config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval num Long value
+ */
+long cs_handle_long(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (long) handle_get(sub, h, DT_LONG);
+}
+
+/**
+ * cs_handle_mbtable - Get a Multibyte table config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval ptr Multibyte table
+ */
+struct MbTable *cs_handle_mbtable(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (struct MbTable *) handle_get(sub, h, DT_MBTABLE);
+}
+
+/**
+ * cs_handle_number - Get a number config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval num Number
+ */
+short cs_handle_number(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (short) handle_get(sub, h, DT_NUMBER);
+}
+
+/**
+ * cs_handle_path - Get a path config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval ptr  Path
+ * @retval NULL Empty path
+ */
+const char *cs_handle_path(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (const char *) handle_get(sub, h, DT_PATH);
+}
+
+/**
+ * cs_handle_quad - Get a quad-value config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval num Quad-value
+ */
+enum QuadOption cs_handle_quad(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (enum QuadOption) handle_get(sub, h, DT_QUAD);
+}
+
+/**
+ * cs_handle_regex - Get a regex config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval ptr  Regex
+ * @retval NULL Empty regex
+ */
+const struct Regex *cs_handle_regex(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (const struct Regex *) handle_get(sub, h, DT_REGEX);
+}
+
+/**
+ * cs_handle_slist - Get a string-list config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval ptr  String list
+ * @retval NULL Empty string list
+ */
+const struct Slist *cs_handle_slist(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (const struct Slist *) handle_get(sub, h, DT_SLIST);
+}
+
+/**
+ * cs_handle_sort - Get a sort config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval num Sort
+ */
+short cs_handle_sort(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (short) handle_get(sub, h, DT_SORT);
+}
+
+/**
+ * cs_handle_string - Get a string config item using a ConfigHandle
+ * @param sub   Config Subset
+ * @param h     Handle of config item
+ * @retval ptr  String
+ * @retval NULL Empty string
+ */
+const char *cs_handle_string(const struct ConfigSubset *sub, struct ConfigHandle *h)
+{
+  return (const char *) handle_get(sub, h, DT_STRING);
+}
@@ -24,10 +24,38 @@
 #define MUTT_CONFIG_HELPERS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "quad.h"
 
 struct ConfigSubset;
 
+/**
+ * struct ConfigHandle - A config item that has been looked up in advance
+ *
+ * Looking up a config item by name means building its scoped name and hashing
+ * it.  A ConfigHandle remembers the value, so that code that's run once per
+ * Email can read the config without a lookup.
+ *
+ * The value is looked up again whenever any config changes, or when it's read
+ * from a different Subset.
+ *
+ * Handles are usually declared `static`, so they must only be used by the
+ * main thread.
+ *
+ * @code
+ * static struct ConfigHandle h_weed = { "weed" };
+ * const bool c_weed = cs_handle_bool(NeoMutt->sub, &h_weed);
+ * @endcode
+ */
+struct ConfigHandle
+{
+  const char *name;               ///< Name of config item
+  const struct ConfigSubset *sub; ///< Subset the value was read from
+  size_t generation;              ///< ConfigSet generation when the value was read
+  intptr_t value;                 ///< Native value of the config item
+};
+
 const struct Address *cs_subset_address(const struct ConfigSubset *sub, const char *name);
 bool                  cs_subset_bool   (const struct ConfigSubset *sub, const char *name);
 unsigned char         cs_subset_enum   (const struct ConfigSubset *sub, const char *name);
@@ -41,5 +69,18 @@ const struct Slist *  cs_subset_slist  (const struct ConfigSubset *sub, const ch
 short                 cs_subset_sort   (const struct ConfigSubset *sub, const char *name);
 const char *          cs_subset_string (const struct ConfigSubset *sub, const char *name);
 
+const struct Address *cs_handle_address(const struct ConfigSubset *sub, struct ConfigHandle *h);
+bool                  cs_handle_bool   (const struct ConfigSubset *sub, struct ConfigHandle *h);
+unsigned char         cs_handle_enum   (const struct ConfigSubset *sub, struct ConfigHandle *h);
+long                  cs_handle_long   (const struct ConfigSubset *sub, struct ConfigHandle *h);
+struct MbTable       *cs_handle_mbtable(const struct ConfigSubset *sub, struct ConfigHandle *h);
+short                 cs_handle_number (const struct ConfigSubset *sub, struct ConfigHandle *h);
+const char *          cs_handle_path   (const struct ConfigSubset *sub, struct ConfigHandle *h);
+enum QuadOption       cs_handle_quad   (const struct ConfigSubset *sub, struct ConfigHandle *h);
+const struct Regex *  cs_handle_regex  (const struct ConfigSubset *sub, struct ConfigHandle *h);
+const struct Slist *  cs_handle_slist  (const struct ConfigSubset *sub, struct ConfigHandle *h);
+short                 cs_handle_sort   (const struct ConfigSubset *sub, struct ConfigHandle *h);
+const char *          cs_handle_string (const struct ConfigSubset *sub, struct ConfigHandle *h);
+
 #endif /* MUTT_CONFIG_HELPERS_H */
 
@@ -128,6 +128,10 @@ void cs_subset_free(struct ConfigSubset **ptr)
     FREE(&list);
   }
 
+  /* A new Subset could reuse this address, so invalidate any ConfigHandles */
+  if (sub->cs)
+    sub->cs->generation++;
+
   notify_free(&sub->notify);
   FREE(&sub->name);
   FREE(ptr);
@@ -233,6 +237,10 @@ void cs_subset_notify_observers(const struct ConfigSubset *sub,
   if (!sub || !he)
     return;
 
+  /* Invalidate any ConfigHandles */
+  if (sub->cs)
+    sub->cs->generation++;
+
   struct HashElem *he_base = cs_get_base(he);
   struct EventConfig ev_c = { sub, he_base->key.strkey, he };
   mutt_debug(LL_NOTIFY, "%s: %s\n",
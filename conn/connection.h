@@ -35,10 +35,11 @@ struct Connection
 {
   struct ConnAccount account; ///< Account details: username, password, etc
   unsigned int ssf;           ///< Security strength factor, in bits (see below)
-  char inbuf[1024];           ///< Buffer for incoming traffic
+  char *inbuf;                ///< Buffer for incoming traffic
+  size_t inbuf_size;          ///< Size of the incoming buffer
   int bufpos;                 ///< Current position in the buffer
   int fd;                     ///< Socket file descriptor
-  int available;              ///< Amount of data waiting to be read
+  int available;              ///< End of the data in the buffer
   void *sockdata;             ///< Backend-specific socket data
 
   /**
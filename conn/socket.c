@@ -42,6 +42,8 @@
 #include "protos.h"
 #include "ssl.h"
 
+#define SOCKET_BUFSIZE (64 * 1024) ///< Initial size of a Connection's read buffer
+
 /**
  * socket_preconnect - Execute a command before opening a socket
  * @retval 0  Success
@@ -110,6 +112,8 @@ int mutt_socket_close(struct Connection *conn)
   conn->ssf = 0;
   conn->bufpos = 0;
   conn->available = 0;
+  FREE(&conn->inbuf);
+  conn->inbuf_size = 0;
 
   return rc;
 }
@@ -201,7 +205,59 @@ int mutt_socket_poll(struct Connection *conn, time_t wait_secs)
 }
 
 /**
- * mutt_socket_readchar - simple read buffering to speed things up
+ * socket_fill - Read more data into a Connection's buffer
+ * @param conn Connection to a server
+ * @retval >0 Success, number of bytes read
+ * @retval -1 Error, the Connection has been closed
+ *
+ * Any unread data is moved to the start of the buffer, to make room.  If the
+ * buffer is full of unread data, e.g. part of a very long line, it is grown.
+ */
+static int socket_fill(struct Connection *conn)
+{
+  if (conn->fd < 0)
+  {
+    mutt_debug(LL_DEBUG1, "attempt to read from closed connection\n");
+    return -1;
+  }
+
+  if (conn->bufpos > 0)
+  {
+    memmove(conn->inbuf, conn->inbuf + conn->bufpos, conn->available - conn->bufpos);
+    conn->available -= conn->bufpos;
+    conn->bufpos = 0;
+  }
+
+  if (conn->available == conn->inbuf_size)
+  {
+    conn->inbuf_size = MAX(conn->inbuf_size * 2, SOCKET_BUFSIZE);
+    mutt_mem_realloc(&conn->inbuf, conn->inbuf_size);
+  }
+  else if ((conn->available == 0) && (conn->inbuf_size > SOCKET_BUFSIZE))
+  {
+    /* don't let one large line make the buffer hog memory forever */
+    conn->inbuf_size = SOCKET_BUFSIZE;
+    mutt_mem_realloc(&conn->inbuf, conn->inbuf_size);
+  }
+
+  const int rc = conn->read(conn, conn->inbuf + conn->available,
+                            conn->inbuf_size - conn->available);
+  if (rc == 0)
+  {
+    mutt_error(_("Connection to %s closed"), conn->account.host);
+  }
+  if (rc <= 0)
+  {
+    mutt_socket_close(conn);
+    return -1;
+  }
+
+  conn->available += rc;
+  return rc;
+}
+
+/**
+ * mutt_socket_readchar - Read a single character from a socket
  * @param[in]  conn Connection to a server
  * @param[out] c    Character that was read
  * @retval  1 Success
@@ -209,29 +265,81 @@ int mutt_socket_poll(struct Connection *conn, time_t wait_secs)
  */
 int mutt_socket_readchar(struct Connection *conn, char *c)
 {
-  if (conn->bufpos >= conn->available)
+  if ((conn->bufpos >= conn->available) && (socket_fill(conn) < 0))
+    return -1;
+
+  *c = conn->inbuf[conn->bufpos];
+  conn->bufpos++;
+  return 1;
+}
+
+/**
+ * mutt_socket_read_span - Read some data from a socket, without copying it
+ * @param[in]  conn Connection to a server
+ * @param[out] span Start of the data, inside the Connection's buffer
+ * @param[in]  max  Maximum number of bytes wanted
+ * @retval >0 Success, number of bytes at span
+ * @retval -1 Error
+ *
+ * Data that is already buffered is returned first.  Only if the buffer is
+ * empty, will the socket be read.  The span is only valid until the next read
+ * from the Connection.
+ */
+int mutt_socket_read_span(struct Connection *conn, char **span, size_t max)
+{
+  if ((conn->bufpos >= conn->available) && (socket_fill(conn) < 0))
+    return -1;
+
+  const int len = MIN(conn->available - conn->bufpos, max);
+  *span = conn->inbuf + conn->bufpos;
+  conn->bufpos += len;
+  return len;
+}
+
+/**
+ * mutt_socket_readln_span - Read a line from a socket, without copying it
+ * @param[in]  conn Connection to a server
+ * @param[out] line Start of the line, inside the Connection's buffer
+ * @param[in]  dbg  Debug level for logging
+ * @retval >=0 Success, length of the line
+ * @retval  -1 Error
+ *
+ * The `\r\n` termination is replaced by a NUL.  The line is only valid until
+ * the next read from the Connection, but the caller may modify it.
+ */
+int mutt_socket_readln_span(struct Connection *conn, char **line, int dbg)
+{
+  size_t scanned = 0;
+  char *nl = NULL;
+
+  while (true)
   {
-    if (conn->fd >= 0)
-      conn->available = conn->read(conn, conn->inbuf, sizeof(conn->inbuf));
-    else
-    {
-      mutt_debug(LL_DEBUG1, "attempt to read from closed connection\n");
-      return -1;
-    }
-    conn->bufpos = 0;
-    if (conn->available == 0)
+    const size_t avail = conn->available - conn->bufpos;
+    if (avail > scanned)
     {
-      mutt_error(_("Connection to %s closed"), conn->account.host);
+      nl = memchr(conn->inbuf + conn->bufpos + scanned, '\n', avail - scanned);
+      if (nl)
+        break;
+      scanned = avail;
     }
-    if (conn->available <= 0)
-    {
-      mutt_socket_close(conn);
+
+    if (socket_fill(conn) < 0)
       return -1;
-    }
   }
-  *c = conn->inbuf[conn->bufpos];
-  conn->bufpos++;
-  return 1;
+
+  char *start = conn->inbuf + conn->bufpos;
+  size_t len = nl - start;
+  conn->bufpos += len + 1;
+
+  /* strip \r from \r\n termination */
+  if ((len > 0) && (start[len - 1] == '\r'))
+    len--;
+  start[len] = '\0';
+
+  mutt_debug(dbg, "%d< %s\n", conn->fd, start);
+
+  *line = start;
+  return len;
 }
 
 /**
@@ -242,23 +350,37 @@ int mutt_socket_readchar(struct Connection *conn, char *c)
  * @param dbg    Debug level for logging
  * @retval >0 Success, number of bytes read
  * @retval -1 Error
+ *
+ * If the line doesn't fit, as much as possible is read.  The rest of the line
+ * will be returned by the next call.
  */
 int mutt_socket_readln_d(char *buf, size_t buflen, struct Connection *conn, int dbg)
 {
-  char ch;
-  int i;
+  size_t i = 0;
 
-  for (i = 0; i < buflen - 1; i++)
+  while (i < (buflen - 1))
   {
-    if (mutt_socket_readchar(conn, &ch) != 1)
+    if ((conn->bufpos >= conn->available) && (socket_fill(conn) < 0))
     {
       buf[i] = '\0';
       return -1;
     }
 
-    if (ch == '\n')
+    const char *start = conn->inbuf + conn->bufpos;
+    size_t len = MIN(conn->available - conn->bufpos, buflen - 1 - i);
+    const char *nl = memchr(start, '\n', len);
+    if (nl)
+      len = nl - start;
+
+    memcpy(buf + i, start, len);
+    i += len;
+    conn->bufpos += len;
+
+    if (nl)
+    {
+      conn->bufpos++;
       break;
-    buf[i] = ch;
+    }
   }
 
   /* strip \r from \r\n termination */
@@ -318,6 +440,9 @@ void mutt_socket_empty(struct Connection *conn)
   char buf[1024];
   int bytes;
 
+  /* drop anything that's already buffered */
+  conn->bufpos = conn->available;
+
   while ((bytes = mutt_socket_poll(conn, 0)) > 0)
   {
     mutt_socket_read(conn, buf, MIN(bytes, sizeof(buf)));
@@ -128,8 +128,14 @@ void ctx_update(struct Context *ctx)
 
   struct Mailbox *m = ctx->mailbox;
 
-  mutt_hash_free(&m->subj_hash);
-  mutt_hash_free(&m->id_hash);
+  /* If Emails have only been added, they can be linked into the existing
+   * threads, rather than rethreading the whole Mailbox */
+  const bool update = mutt_thread_can_update(ctx->threads);
+  if (!update)
+  {
+    mutt_hash_free(&m->subj_hash);
+    mutt_hash_free(&m->id_hash);
+  }
 
   /* reset counters */
   m->msg_unread = 0;
@@ -140,7 +146,8 @@ void ctx_update(struct Context *ctx)
   m->vcount = 0;
   m->changed = false;
 
-  mutt_clear_threads(ctx->threads);
+  if (!update)
+    mutt_clear_threads(ctx->threads);
 
   const bool c_score = cs_subset_bool(NeoMutt->sub, "score");
   struct Email *e = NULL;
@@ -184,10 +191,13 @@ void ctx_update(struct Context *ctx)
     }
 
     /* add this message to the hash tables */
-    if (m->id_hash && e->env->message_id)
-      mutt_hash_insert(m->id_hash, e->env->message_id, e);
-    if (m->subj_hash && e->env->real_subj)
-      mutt_hash_insert(m->subj_hash, e->env->real_subj, e);
+    if (!update || !e->thread)
+    {
+      if (m->id_hash && e->env->message_id)
+        mutt_hash_insert(m->id_hash, e->env->message_id, e);
+      if (m->subj_hash && e->env->real_subj)
+        mutt_hash_insert(m->subj_hash, e->env->real_subj, e);
+    }
     mutt_label_hash_add(m, e);
 
     if (c_score)
@@ -209,8 +219,8 @@ void ctx_update(struct Context *ctx)
     }
   }
 
-  /* rethread from scratch */
-  mutt_sort_headers(ctx->mailbox, ctx->threads, true, &ctx->vsize);
+  /* rethread from scratch, unless the new Emails can just be linked in */
+  mutt_sort_headers(ctx->mailbox, ctx->threads, !update, &ctx->vsize);
 }
 
 /**
@@ -103,6 +103,7 @@ struct MxOps
   enum MailboxType type;  ///< Mailbox type, e.g. #MUTT_IMAP
   const char *name;       ///< Mailbox name, e.g. "imap"
   bool is_local;          ///< True, if Mailbox type has local files/dirs
+  bool stats_threadsafe;  ///< True, if mbox_check_stats() may be run in a worker thread
 
   /**
    * ac_owns_path - Check whether an Account owns a Mailbox path
@@ -258,6 +259,22 @@ struct MxOps
    */
   int (*msg_padding_size)(struct Mailbox *m);
 
+  /**
+   * msg_prefetch - Download an email into the body cache, ahead of time
+   * @param m Mailbox
+   * @param e Email
+   * @retval >0 Number of bytes downloaded
+   * @retval  0 The email was already cached
+   * @retval -1 Failure
+   *
+   * The email must not be marked as read on the server.
+   *
+   * **Contract**
+   * - @a m is not NULL
+   * - @a e is not NULL
+   */
+  long (*msg_prefetch)(struct Mailbox *m, struct Email *e);
+
   /**
    * msg_save_hcache - Save message to the header cache
    * @param m Mailbox
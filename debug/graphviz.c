@@ -741,13 +741,13 @@ static void dot_connection(FILE *fp, struct Connection *c, struct ListHead *link
   dot_type_number(fp, "fd", c->fd);
   dot_object_footer(fp);
 
-  dot_object_header(fp, c->inbuf, "ConnAccount", "#ff8080");
+  dot_object_header(fp, &c->account, "ConnAccount", "#ff8080");
   dot_type_string(fp, "user", c->account.user, true);
   dot_type_string(fp, "host", c->account.host, true);
   dot_type_number(fp, "port", c->account.port);
   dot_object_footer(fp);
 
-  dot_add_link(links, c, c->inbuf, "Connection.ConnAccount", false, NULL);
+  dot_add_link(links, c, &c->account, "Connection.ConnAccount", false, NULL);
 }
 
 static void dot_account_imap(FILE *fp, struct ImapAccountData *adata, struct ListHead *links)
@@ -1506,8 +1506,8 @@
 ** all folders.
 ** By default it is \fIunset\fP so no header caching will be used.
 ** .pp
-** Header caching can greatly improve speed when opening POP, IMAP
-** MH or Maildir folders, see "$caching" for details.
+** Header caching can greatly improve speed when opening POP, IMAP,
+** MH, Maildir, mbox or MMDF folders, see "$caching" for details.
 */
 
 { "header_cache_backend", DT_STRING, 0 },
@@ -1518,6 +1518,16 @@
 */
 
 #ifdef USE_HCACHE_COMPRESSION
+{ "header_cache_compress_dictionary", DT_BOOL, true },
+/*
+** .pp
+** When \fIset\fP, and $$header_cache_compress_method supports it (zstd),
+** NeoMutt trains a compression dictionary from the first headers that it
+** writes to a folder's cache.  The dictionary is saved in the cache and used
+** for all later headers.  Email headers are small and similar to each other,
+** so this makes the cache much smaller.
+*/
+
 { "header_cache_compress_level", DT_NUMBER, 1 },
 /*
 ** .pp
@@ -1779,6 +1789,21 @@
 ** headers.
 */
 
+{ "imap_fetch_connections", DT_NUMBER, 0 },
+/*
+** .pp
+** When opening a large mailbox for the first time, NeoMutt can download the
+** headers over several connections at once.  This variable sets how many
+** extra connections to open.  Each one examines the mailbox read-only and
+** fetches a share of the messages.  The results are added to the mailbox,
+** and the header cache, in order.
+** .pp
+** A value of 0 uses only the mailbox's own connection.  Extra connections
+** are only opened if each of them will have at least a few hundred headers to
+** fetch.  Many servers limit the number of connections per user, so keep
+** this number small.
+*/
+
 { "imap_headers", DT_STRING, 0 },
 /*
 ** .pp
@@ -1881,6 +1906,22 @@
 ** more responsive. But not all servers correctly handle pipelined commands,
 ** so if you have problems you might want to try setting this variable to 0.
 ** .pp
+** If $$imap_pipeline_max is set, this is only the starting depth.
+** .pp
+** \fBNote:\fP Changes to this variable have no effect on open connections.
+*/
+
+{ "imap_pipeline_max", DT_NUMBER, 0 },
+/*
+** .pp
+** If this is greater than $$imap_pipeline_depth, NeoMutt will adjust the
+** depth of the IMAP pipeline while it's running, up to this limit.
+** .pp
+** The depth grows while the server answers commands as quickly as the
+** network allows.  It shrinks if the commands start waiting at the server,
+** or if the server says that it's throttling the connection.  This keeps
+** high-latency links busy without overloading servers that limit clients.
+** .pp
 ** \fBNote:\fP Changes to this variable have no effect on open connections.
 */
 
@@ -2181,6 +2222,20 @@
 ** how often (in seconds) NeoMutt will update message counts.
 */
 
+{ "mail_check_threads", DT_NUMBER, 0 },
+/*
+** .pp
+** If this variable is greater than one, that many threads are used to check
+** local Maildir and MH mailboxes for new mail at the same time.  A value of
+** 0 or 1 checks them one after another.
+** .pp
+** IMAP mailboxes are always checked in parallel: the STATUS commands are
+** sent to every server before waiting for the replies.
+** .pp
+** \fBNote:\fP This variable has no effect if NeoMutt was built without
+** thread support.
+*/
+
 { "mailcap_path", DT_SLIST, "~/.mailcap:" PKGDATADIR "/mailcap:" SYSCONFDIR "/mailcap:/etc/mailcap:/usr/etc/mailcap:/usr/local/etc/mailcap" },
 /*
 ** .pp
@@ -2227,6 +2282,22 @@
 */
 #endif
 
+{ "maildir_read_threads", DT_NUMBER, 0 },
+/*
+** .pp
+** When opening a Maildir mailbox, NeoMutt has to read the headers of every
+** message that isn't in the header cache.  If this variable is greater than
+** one, that many threads are used to fetch the message files from disk in
+** parallel.  This can make opening large mailboxes much faster, especially
+** when the mailbox is on a network filesystem or hasn't been read recently.
+** .pp
+** The headers are still parsed, and the header cache still updated, by the
+** main thread.  A value of 0 or 1 reads the messages one at a time.
+** .pp
+** \fBNote:\fP This variable has no effect if NeoMutt was built without
+** thread support.
+*/
+
 { "maildir_trash", DT_BOOL, false },
 /*
 ** .pp
@@ -2323,6 +2394,17 @@
 ** (especially for large folders).
 */
 
+{ "message_cache_size", DT_LONG, 0 },
+/*
+** .pp
+** This is the maximum size, in bytes, of the $$message_cachedir.  When the
+** cache grows larger than this, the least recently read messages are
+** deleted.  A value of 0 means there's no limit.
+** .pp
+** The sizes are recorded in an index file, \fC.bcache-index\fP, in the
+** $$message_cachedir.
+*/
+
 { "message_cachedir", DT_PATH, 0 },
 /*
 ** .pp
@@ -2346,6 +2428,29 @@
 ** \fCprintf(3)\fP-like sequences see the section on $$index_format.
 */
 
+{ "message_prefetch", DT_NUMBER, 0 },
+/*
+** .pp
+** When this variable is greater than 0, NeoMutt downloads emails from IMAP and
+** POP servers while you aren't typing, so that they open without a wait.  It
+** fetches the rest of the current thread, then this many of the emails that
+** follow the cursor in the index.
+** .pp
+** Emails are downloaded one at a time into the $$message_cachedir, which must
+** be set.  When you press a key, NeoMutt finishes the current email, then
+** stops.  IMAP emails aren't marked as read.
+** .pp
+** Also see the $$message_prefetch_budget variable.
+*/
+
+{ "message_prefetch_budget", DT_LONG, 4194304 },
+/*
+** .pp
+** This is the maximum number of bytes that $$message_prefetch will download
+** each time the cursor moves.  Emails that would exceed it are skipped.  A
+** value of 0 means no limit.
+*/
+
 { "meta_key", DT_BOOL, false },
 /*
 ** .pp
@@ -2689,6 +2794,18 @@
 ** articles headers will be saved in cache when you quit newsgroup.
 */
 
+#ifdef USE_ZLIB
+{ "nntp_deflate", DT_BOOL, true },
+/*
+** .pp
+** When \fIset\fP, NeoMutt will use the COMPRESS DEFLATE extension (RFC8054)
+** if advertised by the server.
+** .pp
+** Overview data compresses well, so this speeds up entering large
+** newsgroups.
+*/
+#endif
+
 { "nntp_listgroup", DT_BOOL, true },
 /*
 ** .pp
@@ -2810,6 +2927,22 @@
 ** .pp
 */
 
+{ "pattern_threads", DT_NUMBER, 0 },
+/*
+** .pp
+** When limiting, tagging or searching a large mailbox, NeoMutt can match a
+** pattern against many messages at once.  If this variable is greater than
+** one, that many threads are used.  A value of 0 or 1 matches the messages
+** on the main thread.
+** .pp
+** Only patterns that can be answered from the headers are split between
+** threads; patterns that need the body, e.g. \fC~b\fP or \fC~B\fP, are
+** always matched one message at a time.
+** .pp
+** \fBNote:\fP This variable has no effect if NeoMutt was built without
+** thread support.
+*/
+
 { "pgp_auto_decode", DT_BOOL, false },
 /*
 ** .pp
@@ -4729,6 +4862,18 @@
 ** The "unread" value is a synonym for "new".
 */
 
+{ "sort_parallel", DT_NUMBER, 0 },
+/*
+** .pp
+** When sorting the index by anything other than threads, NeoMutt extracts
+** a sort key from each message and sorts the keys.  If this variable is
+** greater than one, that many threads are used to sort large mailboxes.
+** A value of 0 or 1 sorts on the main thread.
+** .pp
+** \fBNote:\fP This variable has no effect if NeoMutt was built without
+** thread support.
+*/
+
 { "sort_re", DT_BOOL, true },
 /*
 ** .pp
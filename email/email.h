@@ -68,6 +68,7 @@ struct Email
   bool matched  : 1;           ///< Search matches this Email
 
   bool attach_valid : 1;       ///< true when the attachment count is valid
+  bool pair_valid   : 1;       ///< true when the index colours are valid
 
   // the following are used to support collapsing threads
   bool collapsed : 1;          ///< Is this message part of a collapsed thread?
@@ -77,7 +78,10 @@ struct Email
 
   short recipient;             ///< User_is_recipient()'s return value, cached
 
-  int pair;                    ///< Color-pair to use when displaying in the index
+  int pair;                    ///< Color-pair to use when displaying in the index, 0 if none
+  int pair_author;             ///< Color-pair for the author in the index, 0 if none
+  int pair_flags;              ///< Color-pair for the flags in the index, 0 if none
+  int pair_subject;            ///< Color-pair for the subject in the index, 0 if none
 
   time_t date_sent;            ///< Time when the message was sent (UTC)
   time_t received;             ///< Time when the message was placed in the mailbox
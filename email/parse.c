@@ -166,8 +166,9 @@ static void parse_parameters(struct ParameterList *pl, const char *s, bool allow
           s++;
           for (; *s; s++)
           {
+            static struct ConfigHandle h_assumed_charset = { "assumed_charset" };
             const char *const c_assumed_charset =
-                cs_subset_string(NeoMutt->sub, "assumed_charset");
+                cs_handle_string(NeoMutt->sub, &h_assumed_charset);
             if (c_assumed_charset)
             {
               // As iso-2022-* has a character of '"' with non-ascii state, ignore it
@@ -516,8 +517,9 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
     }
     else
     {
+      static struct ConfigHandle h_assumed_charset = { "assumed_charset" };
       const char *const c_assumed_charset =
-          cs_subset_string(NeoMutt->sub, "assumed_charset");
+          cs_handle_string(NeoMutt->sub, &h_assumed_charset);
       mutt_param_set(&ct->parameter, "charset",
                      (c_assumed_charset) ? (const char *) mutt_ch_get_default_charset() :
                                            "us-ascii");
@@ -784,8 +786,9 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e, char *line,
             {
               FREE(&env->list_post);
               env->list_post = mlist;
+              static struct ConfigHandle h_auto_subscribe = { "auto_subscribe" };
               const bool c_auto_subscribe =
-                  cs_subset_bool(NeoMutt->sub, "auto_subscribe");
+                  cs_handle_bool(NeoMutt->sub, &h_auto_subscribe);
               if (c_auto_subscribe)
                 mutt_auto_subscribe(env->list_post);
 
@@ -907,8 +910,9 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e, char *line,
             {
               case 'O':
               {
+                static struct ConfigHandle h_mark_old = { "mark_old" };
                 const bool c_mark_old =
-                    cs_subset_bool(NeoMutt->sub, "mark_old");
+                    cs_handle_bool(NeoMutt->sub, &h_mark_old);
                 e->old = c_mark_old;
                 break;
               }
@@ -1023,7 +1027,8 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e, char *line,
     /* restore the original line */
     line[strlen(line)] = ':';
 
-    const bool c_weed = cs_subset_bool(NeoMutt->sub, "weed");
+    static struct ConfigHandle h_weed = { "weed" };
+    const bool c_weed = cs_handle_bool(NeoMutt->sub, &h_weed);
     if (!(weed && c_weed && mutt_matches_ignore(line)))
     {
       struct ListNode *np = mutt_list_insert_tail(&env->userhdrs, mutt_str_dup(line));
@@ -1186,8 +1191,9 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
         if ((!mutt_buffer_is_empty(&env->spam)) && (*buf != '\0'))
         {
           /* If `$spam_separator` defined, append with separator */
+          static struct ConfigHandle h_spam_separator = { "spam_separator" };
           const char *const c_spam_separator =
-              cs_subset_string(NeoMutt->sub, "spam_separator");
+              cs_handle_string(NeoMutt->sub, &h_spam_separator);
           if (c_spam_separator)
           {
             mutt_buffer_addstr(&env->spam, c_spam_separator);
@@ -1238,8 +1244,9 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
     {
       regmatch_t pmatch[1];
 
+      static struct ConfigHandle h_reply_regex = { "reply_regex" };
       const struct Regex *c_reply_regex =
-          cs_subset_regex(NeoMutt->sub, "reply_regex");
+          cs_handle_regex(NeoMutt->sub, &h_reply_regex);
       if (mutt_regex_capture(c_reply_regex, env->subject, 1, pmatch))
       {
         env->real_subj = env->subject + pmatch[0].rm_eo;
@@ -1263,7 +1270,8 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
     }
 
 #ifdef USE_AUTOCRYPT
-    const bool c_autocrypt = cs_subset_bool(NeoMutt->sub, "autocrypt");
+    static struct ConfigHandle h_autocrypt = { "autocrypt" };
+    const bool c_autocrypt = cs_handle_bool(NeoMutt->sub, &h_autocrypt);
     if (c_autocrypt)
     {
       struct Mailbox *m = ctx_mailbox(Context);
@@ -41,6 +41,7 @@ struct MuttThread
   bool deep                    : 1; ///< Is the Thread deeply nested?
   unsigned int subtree_visible : 2; ///< Is this Thread subtree visible?
   bool next_subtree_visible    : 1; ///< Is the next Thread subtree visible?
+  bool touched                 : 1; ///< Has the Thread changed since it was last sorted?
 
   struct MuttThread *parent;        ///< Parent of this Thread
   struct MuttThread *child;         ///< Child of this Thread
@@ -35,7 +35,6 @@
 #include "core/lib.h"
 #include "gui/lib.h"
 #include "mutt.h"
-#include "index/lib.h"
 #include "keymap.h"
 #include "protos.h"
 
@@ -326,9 +325,10 @@ void mutt_set_flag_update(struct Mailbox *m, struct Email *e,
       break;
   }
 
+  /* the colour will be chosen again when the Email is next displayed */
   if (update)
   {
-    mutt_set_header_color(m, e);
+    e->pair_valid = false;
   }
 
   /* if the message status has changed, we need to invalidate the cached
@@ -1084,7 +1084,7 @@ static enum CommandResult add_pattern(struct ColorLineList *top, const char *s,
       struct Email *e = m->emails[i];
       if (!e)
         break;
-      e->pair = 0;
+      e->pair_valid = false;
     }
   }
 
@@ -1909,5 +1909,5 @@ void mutt_decode_attachment(struct Body *b, struct State *s)
   }
 
   if (cd != (iconv_t) (-1))
-    iconv_close(cd);
+    mutt_ch_iconv_close(cd);
 }
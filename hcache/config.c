@@ -125,6 +125,9 @@ static struct ConfigDef HcacheVars[] = {
   { "header_cache_compress_level", DT_NUMBER|DT_NOT_NEGATIVE, 1, 0, compress_level_validator,
     "(hcache) Level of compression for method"
   },
+  { "header_cache_compress_dictionary", DT_BOOL, true, 0, NULL,
+    "(hcache) Train a compression dictionary for each folder"
+  },
 #endif
 #if defined(HAVE_QDBM) || defined(HAVE_TC) || defined(HAVE_KC)
   { "header_cache_compress", DT_DEPRECATED|DT_BOOL, false, 0, NULL, NULL },
@@ -33,7 +33,6 @@
  */
 
 #include "config.h"
-#include <assert.h>
 #include <errno.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -62,6 +61,28 @@
 
 static unsigned int hcachever = 0x0;
 
+#ifdef USE_HCACHE_COMPRESSION
+/// Key of the compression dictionary, followed by the name of the compression method
+#define HCACHE_DICT_KEY "/@DICT"
+/// Number of records used to train a compression dictionary
+#define HCACHE_DICT_SAMPLES 1000
+/// Maximum size of a compression dictionary
+#define HCACHE_DICT_SIZE (16 * 1024)
+/// Larger records aren't typical, so aren't used for training
+#define HCACHE_DICT_MAX_SAMPLE (16 * 1024)
+
+ARRAY_HEAD(SampleSizeArray, size_t);
+
+/**
+ * struct HcacheDictSamples - Records collected to train a compression dictionary
+ */
+struct HcacheDictSamples
+{
+  struct Buffer data;           ///< Uncompressed records, one after another
+  struct SampleSizeArray sizes; ///< Size of each record
+};
+#endif
+
 /**
  * header_size - Compute the size of the header with uuid validity
  * and crc.
@@ -84,96 +105,166 @@ static size_t header_size(void)
  */
 static void *dump(struct HeaderCache *hc, const struct Email *e, int *off, uint32_t uidvalidity)
 {
-  struct Email e_dump;
-  bool convert = !CharsetIsUtf8;
-
-  *off = 0;
-  unsigned char *d = mutt_mem_malloc(4096);
-
-  d = serial_dump_uint32_t((uidvalidity != 0) ? uidvalidity : mutt_date_epoch(), d, off);
-  d = serial_dump_int(hc->crc, d, off);
-
-  assert((size_t) *off == header_size());
-
-  lazy_realloc(&d, *off + sizeof(struct Email));
-  memcpy(&e_dump, e, sizeof(struct Email));
-
-  /* some fields are not safe to cache */
-  e_dump.tagged = false;
-  e_dump.changed = false;
-  e_dump.threaded = false;
-  e_dump.recip_valid = false;
-  e_dump.searched = false;
-  e_dump.matched = false;
-  e_dump.collapsed = false;
-  e_dump.visible = true;
-  e_dump.num_hidden = 0;
-  e_dump.recipient = 0;
-  e_dump.pair = 0;
-  e_dump.attach_valid = false;
-  e_dump.path = NULL;
-  e_dump.tree = NULL;
-  e_dump.thread = NULL;
-  e_dump.sequence = 0;
-  e_dump.notify = NULL;
-  STAILQ_INIT(&e_dump.tags);
-#ifdef MIXMASTER
-  STAILQ_INIT(&e_dump.chain);
-#endif
-  e_dump.edata = NULL;
-
-  memcpy(d + *off, &e_dump, sizeof(struct Email));
-  *off += sizeof(struct Email);
+  size_t dlen = 0;
+  unsigned char *d = serial_dump_email(e, header_size(), !CharsetIsUtf8, &dlen);
 
-  d = serial_dump_envelope(e_dump.env, d, off, convert);
-  d = serial_dump_body(e_dump.body, d, off, convert);
-  d = serial_dump_tags(&e->tags, d, off);
+  if (uidvalidity == 0)
+    uidvalidity = mutt_date_epoch();
+  memcpy(d, &uidvalidity, sizeof(uint32_t));
+  memcpy(d + sizeof(uint32_t), &hc->crc, sizeof(int));
 
+  *off = dlen;
   return d;
 }
 
 /**
  * restore - Restore an Email from data retrieved from the cache
- * @param d Data retrieved using mutt_hcache_dump
- * @retval ptr Success, the restored header (can't be NULL)
+ * @param d       Data retrieved using mutt_hcache_dump
+ * @param dlen    Length of the data
+ * @param shallow If true, don't restore the Envelope or Body
+ * @retval ptr  Success, the restored header
+ * @retval NULL The data is damaged
  *
  * @note The returned Email must be free'd by caller code with
  *       email_free()
  */
-static struct Email *restore(const unsigned char *d)
+static struct Email *restore(const unsigned char *d, size_t dlen, bool shallow)
 {
-  int off = 0;
-  struct Email *e = email_new();
-  bool convert = !CharsetIsUtf8;
+  /* skip validate and crc */
+  const size_t hlen = header_size();
+  if (dlen < hlen)
+    return NULL;
 
-  /* skip validate */
-  off += sizeof(uint32_t);
+  return serial_restore_email(d + hlen, dlen - hlen, !CharsetIsUtf8, shallow);
+}
 
-  /* skip crc */
-  off += sizeof(unsigned int);
+#ifdef USE_HCACHE_COMPRESSION
+/**
+ * dict_key - Get the key of the compression dictionary
+ * @param cops Compression method
+ * @param buf  Buffer for the result
+ * @param buflen Length of the buffer
+ * @retval num Length of the key
+ */
+static size_t dict_key(const struct ComprOps *cops, char *buf, size_t buflen)
+{
+  return snprintf(buf, buflen, "%s-%s", HCACHE_DICT_KEY, cops->name);
+}
 
-  size_t sequence = e->sequence;
-  struct Notify *notify = e->notify;
-  memcpy(e, d + off, sizeof(struct Email));
-  off += sizeof(struct Email);
-  e->sequence = sequence;
-  e->notify = notify;
+/**
+ * dict_samples_free - Free the dictionary training samples
+ * @param ptr Samples to free
+ */
+static void dict_samples_free(struct HcacheDictSamples **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
 
-  STAILQ_INIT(&e->tags);
-#ifdef MIXMASTER
-  STAILQ_INIT(&e->chain);
-#endif
+  struct HcacheDictSamples *ds = *ptr;
+  mutt_buffer_dealloc(&ds->data);
+  ARRAY_FREE(&ds->sizes);
+  FREE(ptr);
+}
 
-  e->env = mutt_env_new();
-  serial_restore_envelope(e->env, d, &off, convert);
+/**
+ * dict_load - Load the compression dictionary for a folder
+ * @param hc   Header cache handle
+ * @param cops Compression method
+ *
+ * If the folder doesn't have a dictionary yet, start collecting records to
+ * train one.
+ */
+static void dict_load(struct HeaderCache *hc, const struct ComprOps *cops)
+{
+  const bool c_header_cache_compress_dictionary =
+      cs_subset_bool(NeoMutt->sub, "header_cache_compress_dictionary");
+  if (!c_header_cache_compress_dictionary || !cops->set_dict || !cops->train)
+    return;
+
+  char key[64];
+  size_t keylen = dict_key(cops, key, sizeof(key));
 
-  e->body = mutt_body_new();
-  serial_restore_body(e->body, d, &off, convert);
-  serial_restore_tags(&e->tags, d, &off);
+  /* The dictionary is stored after the crc, so a stale one is ignored */
+  bool loaded = false;
+  size_t dlen = 0;
+  void *data = mutt_hcache_fetch_raw(hc, key, keylen, &dlen);
+  if (data && (dlen > sizeof(int)))
+  {
+    unsigned int crc = 0;
+    memcpy(&crc, data, sizeof(int));
+    if (crc == hc->crc)
+      loaded = cops->set_dict(hc->cctx, (char *) data + sizeof(int), dlen - sizeof(int));
+  }
+  mutt_hcache_free_raw(hc, &data);
+
+  if (loaded)
+  {
+    mutt_debug(LL_DEBUG3, "Header cache will use a %s dictionary\n", cops->name);
+    return;
+  }
 
-  return e;
+  hc->samples = mutt_mem_calloc(1, sizeof(struct HcacheDictSamples));
 }
 
+/**
+ * dict_train - Train and save a compression dictionary
+ * @param hc   Header cache handle
+ * @param cops Compression method
+ */
+static void dict_train(struct HeaderCache *hc, const struct ComprOps *cops)
+{
+  struct HcacheDictSamples *ds = hc->samples;
+
+  size_t dlen = 0;
+  void *dict = cops->train(ds->data.data, ARRAY_GET(&ds->sizes, 0),
+                           ARRAY_SIZE(&ds->sizes), HCACHE_DICT_SIZE, &dlen);
+
+  /* Whatever happens, don't try again until the folder is reopened */
+  dict_samples_free(&hc->samples);
+
+  if (!dict)
+    return;
+
+  if (cops->set_dict(hc->cctx, dict, dlen))
+  {
+    char key[64];
+    size_t keylen = dict_key(cops, key, sizeof(key));
+
+    char *record = mutt_mem_malloc(sizeof(int) + dlen);
+    memcpy(record, &hc->crc, sizeof(int));
+    memcpy(record + sizeof(int), dict, dlen);
+    mutt_hcache_store_raw(hc, key, keylen, record, sizeof(int) + dlen);
+    FREE(&record);
+
+    mutt_debug(LL_DEBUG3, "Trained a %zu byte %s dictionary\n", dlen, cops->name);
+  }
+
+  FREE(&dict);
+}
+
+/**
+ * dict_add_sample - Add a record to the dictionary training samples
+ * @param hc   Header cache handle
+ * @param cops Compression method
+ * @param data Uncompressed record
+ * @param dlen Length of the record
+ *
+ * Once enough samples have been collected, the dictionary is trained.
+ */
+static void dict_add_sample(struct HeaderCache *hc, const struct ComprOps *cops,
+                            const char *data, size_t dlen)
+{
+  if (!hc->samples || (dlen == 0) || (dlen > HCACHE_DICT_MAX_SAMPLE))
+    return;
+
+  mutt_buffer_addstr_n(&hc->samples->data, data, dlen);
+  ARRAY_ADD(&hc->samples->sizes, dlen);
+
+  if (ARRAY_SIZE(&hc->samples->sizes) >= HCACHE_DICT_SAMPLES)
+    dict_train(hc, cops);
+}
+#endif
+
 struct RealKey
 {
   char key[1024];
@@ -426,6 +517,12 @@ struct HeaderCache *mutt_hcache_open(const char *path, const char *folder, hcach
   }
 
   mutt_buffer_pool_release(&hcpath);
+
+#ifdef USE_HCACHE_COMPRESSION
+  if (hc && c_header_cache_compress_method)
+    dict_load(hc, compress_get_ops(c_header_cache_compress_method));
+#endif
+
   return hc;
 }
 
@@ -448,39 +545,40 @@ void mutt_hcache_close(struct HeaderCache *hc)
     const struct ComprOps *cops = compress_get_ops(c_header_cache_compress_method);
     cops->close(&hc->cctx);
   }
+  dict_samples_free(&hc->samples);
 #endif
 
+  if ((hc->batch > 0) && ops->commit)
+    ops->commit(hc->ctx);
+
   ops->close(&hc->ctx);
   FREE(&hc->folder);
   FREE(&hc);
 }
 
 /**
- * mutt_hcache_fetch - Multiplexor for StoreOps::fetch
+ * hcache_decode - Validate and restore an Email from a cache record
+ * @param hc          Pointer to the struct HeaderCache structure got by mutt_hcache_open()
+ * @param data        Record retrieved from the backend
+ * @param dlen        Length of the record
+ * @param uidvalidity Only restore if it matches the stored uidvalidity
+ * @param shallow     If true, don't restore the Envelope or Body
+ * @retval obj HCacheEntry containing an Email, empty on failure
  */
-struct HCacheEntry mutt_hcache_fetch(struct HeaderCache *hc, const char *key,
-                                     size_t keylen, uint32_t uidvalidity)
+static struct HCacheEntry hcache_decode(struct HeaderCache *hc, const void *data,
+                                        size_t dlen, uint32_t uidvalidity, bool shallow)
 {
-  struct RealKey *rk = realkey(key, keylen);
   struct HCacheEntry entry = { 0 };
 
-  size_t dlen;
-  void *data = mutt_hcache_fetch_raw(hc, rk->key, rk->len, &dlen);
-  void *to_free = data;
-  if (!data)
-  {
-    goto end;
-  }
-
   /* restore uidvalidity and crc */
   size_t hlen = header_size();
-  int off = 0;
-  serial_restore_uint32_t(&entry.uidvalidity, data, &off);
-  serial_restore_int(&entry.crc, data, &off);
-  assert((size_t) off == hlen);
+  if (dlen < hlen)
+    return entry;
+  memcpy(&entry.uidvalidity, data, sizeof(uint32_t));
+  memcpy(&entry.crc, (const char *) data + sizeof(uint32_t), sizeof(int));
   if (entry.crc != hc->crc || ((uidvalidity != 0) && uidvalidity != entry.uidvalidity))
   {
-    goto end;
+    return entry;
   }
 
 #ifdef USE_HCACHE_COMPRESSION
@@ -490,22 +588,193 @@ struct HCacheEntry mutt_hcache_fetch(struct HeaderCache *hc, const char *key,
   {
     const struct ComprOps *cops = compress_get_ops(c_header_cache_compress_method);
 
-    void *dblob = cops->decompress(hc->cctx, (char *) data + hlen, dlen - hlen);
+    size_t ulen = 0;
+    void *dblob = cops->decompress(hc->cctx, (const char *) data + hlen, dlen - hlen, &ulen);
     if (!dblob)
     {
-      goto end;
+      return entry;
     }
     data = (char *) dblob - hlen; /* restore skips uidvalidity and crc */
+    dlen = hlen + ulen;
   }
 #endif
 
-  entry.email = restore(data);
+  entry.email = restore(data, dlen, shallow);
+  return entry;
+}
+
+/**
+ * hcache_fetch - Fetch and restore an Email from the cache
+ * @param hc          Pointer to the struct HeaderCache structure got by mutt_hcache_open()
+ * @param key         Message identification string
+ * @param keylen      Length of the string pointed to by key
+ * @param uidvalidity Only restore if it matches the stored uidvalidity
+ * @param shallow     If true, don't restore the Envelope or Body
+ * @retval obj HCacheEntry containing an Email, empty on failure
+ */
+static struct HCacheEntry hcache_fetch(struct HeaderCache *hc, const char *key,
+                                       size_t keylen, uint32_t uidvalidity, bool shallow)
+{
+  struct RealKey *rk = realkey(key, keylen);
+  struct HCacheEntry entry = { 0 };
 
-end:
-  mutt_hcache_free_raw(hc, &to_free);
+  size_t dlen;
+  void *data = mutt_hcache_fetch_raw(hc, rk->key, rk->len, &dlen);
+  if (!data)
+    return entry;
+
+  entry = hcache_decode(hc, data, dlen, uidvalidity, shallow);
+
+  mutt_hcache_free_raw(hc, &data);
   return entry;
 }
 
+/**
+ * mutt_hcache_fetch - Multiplexor for StoreOps::fetch
+ */
+struct HCacheEntry mutt_hcache_fetch(struct HeaderCache *hc, const char *key,
+                                     size_t keylen, uint32_t uidvalidity)
+{
+  return hcache_fetch(hc, key, keylen, uidvalidity, false);
+}
+
+/**
+ * mutt_hcache_fetch_flags - Fetch the flags of a message from the cache
+ * @param hc          Pointer to the struct HeaderCache structure got by mutt_hcache_open()
+ * @param key         Message identification string
+ * @param keylen      Length of the string pointed to by key
+ * @param uidvalidity Only restore if it matches the stored uidvalidity
+ * @retval obj HCacheEntry containing an Email, empty on failure
+ *
+ * This is much cheaper than mutt_hcache_fetch().  Only the flags, dates and
+ * tags of the Email are restored.  Email.env and Email.body will be NULL.
+ */
+struct HCacheEntry mutt_hcache_fetch_flags(struct HeaderCache *hc, const char *key,
+                                           size_t keylen, uint32_t uidvalidity)
+{
+  return hcache_fetch(hc, key, keylen, uidvalidity, true);
+}
+
+/**
+ * struct HCacheFetchKey - A key for mutt_hcache_fetch_many()
+ */
+struct HCacheFetchKey
+{
+  char *key;  ///< Full key, as used by the backend
+  size_t len; ///< Length of the key
+  size_t idx; ///< Index of the key in the caller's list
+};
+
+/**
+ * struct HCacheFetchMany - Private data for mutt_hcache_fetch_many()
+ */
+struct HCacheFetchMany
+{
+  struct HeaderCache *hc;          ///< Header cache
+  struct HCacheFetchKey *fkeys;    ///< Keys, in the order passed to the backend
+  uint32_t uidvalidity;            ///< Only restore if it matches the stored uidvalidity
+  hcache_fetch_t cb;               ///< Caller's callback
+  void *cb_data;                   ///< Caller's private data
+  int found;                       ///< Number of Emails restored
+};
+
+/**
+ * fetch_key_cmp - Compare two keys - Implements ::sort_t
+ */
+static int fetch_key_cmp(const void *a, const void *b)
+{
+  const struct HCacheFetchKey *ka = a;
+  const struct HCacheFetchKey *kb = b;
+
+  int rc = memcmp(ka->key, kb->key, MIN(ka->len, kb->len));
+  if (rc != 0)
+    return rc;
+
+  return (ka->len > kb->len) - (ka->len < kb->len);
+}
+
+/**
+ * fetch_many_cb - Restore an Email found by the backend - Implements ::store_fetch_t
+ */
+static void fetch_many_cb(void *data, size_t idx, const void *value, size_t vlen)
+{
+  struct HCacheFetchMany *fm = data;
+
+  struct HCacheEntry hce = hcache_decode(fm->hc, value, vlen, fm->uidvalidity, false);
+  if (!hce.email)
+    return;
+
+  fm->found++;
+  fm->cb(fm->cb_data, fm->fkeys[idx].idx, hce);
+}
+
+/**
+ * mutt_hcache_fetch_many - Multiplexor for StoreOps::fetch_many
+ */
+int mutt_hcache_fetch_many(struct HeaderCache *hc, const char **keys,
+                           const size_t *keylens, size_t num,
+                           uint32_t uidvalidity, hcache_fetch_t cb, void *data)
+{
+  const char *const c_header_cache_backend =
+      cs_subset_string(NeoMutt->sub, "header_cache_backend");
+  const struct StoreOps *ops = store_get_backend_ops(c_header_cache_backend);
+
+  if (!hc || !ops || !keys || !keylens || !cb)
+    return -1;
+  if (num == 0)
+    return 0;
+
+  struct HCacheFetchMany fm = { hc, NULL, uidvalidity, cb, data, 0 };
+  fm.fkeys = mutt_mem_calloc(num, sizeof(struct HCacheFetchKey));
+  const char **bkeys = mutt_mem_calloc(num, sizeof(char *));
+  size_t *blens = mutt_mem_calloc(num, sizeof(size_t));
+
+  struct Buffer path = mutt_buffer_make(1024);
+  for (size_t i = 0; i < num; i++)
+  {
+    struct RealKey *rk = realkey(keys[i], keylens[i]);
+    fm.fkeys[i].len = mutt_buffer_printf(&path, "%s%.*s", hc->folder, (int) rk->len, rk->key);
+    fm.fkeys[i].key = mutt_buffer_strdup(&path);
+    fm.fkeys[i].idx = i;
+  }
+  mutt_buffer_dealloc(&path);
+
+  /* Backends can scan sorted keys in one pass */
+  qsort(fm.fkeys, num, sizeof(struct HCacheFetchKey), fetch_key_cmp);
+  for (size_t i = 0; i < num; i++)
+  {
+    bkeys[i] = fm.fkeys[i].key;
+    blens[i] = fm.fkeys[i].len;
+  }
+
+  int rc = 0;
+  if (ops->fetch_many)
+  {
+    rc = ops->fetch_many(hc->ctx, bkeys, blens, num, fetch_many_cb, &fm);
+  }
+  else
+  {
+    for (size_t i = 0; i < num; i++)
+    {
+      size_t vlen = 0;
+      void *value = ops->fetch(hc->ctx, bkeys[i], blens[i], &vlen);
+      if (!value)
+        continue;
+
+      fetch_many_cb(&fm, i, value, vlen);
+      ops->free(hc->ctx, &value);
+    }
+  }
+
+  for (size_t i = 0; i < num; i++)
+    FREE(&fm.fkeys[i].key);
+  FREE(&fm.fkeys);
+  FREE(&bkeys);
+  FREE(&blens);
+
+  return (rc < 0) ? rc : fm.found;
+}
+
 /**
  * mutt_hcache_fetch_raw - Fetch a message's header from the cache
  * @param[in]  hc     Pointer to the struct HeaderCache structure got by mutt_hcache_open()
@@ -573,6 +842,8 @@ int mutt_hcache_store(struct HeaderCache *hc, const char *key, size_t keylen,
 
     const struct ComprOps *cops = compress_get_ops(c_header_cache_compress_method);
 
+    dict_add_sample(hc, cops, data + hlen, dlen - hlen);
+
     /* data / dlen gets ptr to compressed data here */
     size_t clen = dlen;
     void *cdata = cops->compress(hc->cctx, data + hlen, dlen - hlen, &clen);
@@ -651,3 +922,49 @@ int mutt_hcache_delete_record(struct HeaderCache *hc, const char *key, size_t ke
   mutt_buffer_dealloc(&path);
   return rc;
 }
+
+/**
+ * mutt_hcache_begin - Multiplexor for StoreOps::begin
+ */
+int mutt_hcache_begin(struct HeaderCache *hc)
+{
+  if (!hc)
+    return -1;
+
+  const char *const c_header_cache_backend =
+      cs_subset_string(NeoMutt->sub, "header_cache_backend");
+  const struct StoreOps *ops = store_get_backend_ops(c_header_cache_backend);
+
+  if (hc->batch++ > 0)
+    return 0;
+
+  if (!ops || !ops->begin)
+    return 0;
+
+  int rc = ops->begin(hc->ctx);
+  if (rc != 0)
+    hc->batch = 0;
+
+  return rc;
+}
+
+/**
+ * mutt_hcache_commit - Multiplexor for StoreOps::commit
+ */
+int mutt_hcache_commit(struct HeaderCache *hc)
+{
+  if (!hc || (hc->batch == 0))
+    return -1;
+
+  const char *const c_header_cache_backend =
+      cs_subset_string(NeoMutt->sub, "header_cache_backend");
+  const struct StoreOps *ops = store_get_backend_ops(c_header_cache_backend);
+
+  if (--hc->batch > 0)
+    return 0;
+
+  if (!ops || !ops->commit)
+    return 0;
+
+  return ops->commit(hc->ctx);
+}
@@ -1,7 +1,8 @@
 #!/bin/sh
 
 BASEVERSION=7
-STRUCTURES="Address Body Buffer Email Envelope ListNode Parameter"
+RECORDVERSION=2
+STRUCTURES="Address Body Buffer Email Envelope ListNode Parameter SerialEmail SerialListRef"
 
 cleanstruct () {
   echo "$1" | sed -e 's/.* //'
@@ -84,9 +85,10 @@ md5prog () {
 DEST="$1"
 TMPD="$DEST.tmp"
 
-TEXT="$BASEVERSION"
+TEXT="$BASEVERSION $RECORDVERSION"
 
 echo "/* base version: $BASEVERSION" > "$TMPD"
+echo " * record version: $RECORDVERSION" >> "$TMPD"
 while read -r line; do
   case "$line" in
     'struct'*)
@@ -105,6 +107,7 @@ echo " */" >> "$TMPD"
 MD5PROG=$(md5prog)
 MD5TEXT=$(echo "$TEXT" | $MD5PROG | cut -c-8)
 echo "#define HCACHEVER 0x$MD5TEXT" >> "$TMPD"
+echo "#define HCACHE_RECORD_VERSION $RECORDVERSION" >> "$TMPD"
 
 # TODO: validate we have all structs
 
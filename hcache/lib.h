@@ -41,19 +41,20 @@
  *
  * @sa Address Body Buffer Email Envelope ListNode Parameter
  *
- * To save the data, the Header Cache uses a set of 'dump' functions
- * (\ref hc_serial) to 'serialise' the structures.  The cache also stores a CRC
- * checksum of the C structs that were used.  When retrieving the data, the
- * Header Cache uses a set of 'restore' functions to turn the data back into
+ * To save the data, the Header Cache 'serialises' each Email into a flat,
+ * versioned record (\ref hc_serial).  The record has a fixed layout followed
+ * by a table of strings, so it doesn't depend on the in-memory layout of the
+ * structs.  The cache also stores a CRC checksum of the C structs that were
+ * used.  When retrieving the data, the Header Cache turns the record back into
  * structs.
  *
  * The CRC checksum is created by `hcache/hcachever.sh` during the build
- * process.  Whenever the definition of any of the structs changes, the CRC will
- * change, invalidating any existing cached data.
+ * process.  Whenever the definition of any of the structs, or the record,
+ * changes, the CRC will change, invalidating any existing cached data.
  *
  * @note Adding or removing a field from the set of serialised fields will
  * **not** affect the CRC.  In this case, it is vital that you bump the
- * **`BASEVERSION`** variable in `hcache/hcachever.sh`
+ * **`RECORDVERSION`** variable in `hcache/hcachever.sh`
  *
  * ## Source
  *
@@ -72,6 +73,7 @@
 
 struct Buffer;
 struct Email;
+struct HcacheDictSamples;
 
 /**
  * struct HeaderCache - header cache structure
@@ -87,6 +89,8 @@ struct HeaderCache
   unsigned int crc;
   void *ctx;
   void *cctx;
+  int batch;                         ///< Depth of nested mutt_hcache_begin() calls
+  struct HcacheDictSamples *samples; ///< Records collected to train a compression dictionary
 };
 
 /**
@@ -106,6 +110,16 @@ struct HCacheEntry
  */
 typedef void (*hcache_namer_t)(const char *path, struct Buffer *dest);
 
+/**
+ * typedef hcache_fetch_t - Prototype for a callback from mutt_hcache_fetch_many()
+ * @param data Private data passed to mutt_hcache_fetch_many()
+ * @param idx  Index of the key in the list
+ * @param hce  Entry retrieved from the cache
+ *
+ * The callback takes ownership of the Email in the HCacheEntry.
+ */
+typedef void (*hcache_fetch_t)(void *data, size_t idx, struct HCacheEntry hce);
+
 /**
  * mutt_hcache_open - open the connection to the header cache
  * @param path   Location of the header cache (often as specified by the user)
@@ -148,6 +162,27 @@ int mutt_hcache_store(struct HeaderCache *hc, const char *key, size_t keylen,
  *       comparing it with the crc value of the struct HeaderCache structure.
  */
 struct HCacheEntry mutt_hcache_fetch(struct HeaderCache *hc, const char *key, size_t keylen, uint32_t uidvalidity);
+struct HCacheEntry mutt_hcache_fetch_flags(struct HeaderCache *hc, const char *key, size_t keylen, uint32_t uidvalidity);
+
+/**
+ * mutt_hcache_fetch_many - fetch and validate many messages' headers from the cache
+ * @param hc          Pointer to the struct HeaderCache structure got by mutt_hcache_open()
+ * @param keys        Message identification strings
+ * @param keylens     Lengths of the strings pointed to by keys
+ * @param num         Number of keys
+ * @param uidvalidity Only restore if it matches the stored uidvalidity
+ * @param cb          Function to call for each valid entry
+ * @param data        Private data passed to the callback
+ * @retval num Number of entries found
+ * @retval -1  Error
+ *
+ * This is equivalent to calling mutt_hcache_fetch() for each key, but lets
+ * the backend look up all the keys in one pass.  Keys that aren't found, or
+ * whose entries aren't valid, are skipped.  The callback isn't called in the
+ * order of the keys.
+ */
+int mutt_hcache_fetch_many(struct HeaderCache *hc, const char **keys, const size_t *keylens,
+                           size_t num, uint32_t uidvalidity, hcache_fetch_t cb, void *data);
 
 int mutt_hcache_store_raw(struct HeaderCache *hc, const char *key, size_t keylen,
                           void *data, size_t dlen);
@@ -161,6 +196,25 @@ void *mutt_hcache_fetch_raw(struct HeaderCache *hc, const char *key, size_t keyl
  */
 void mutt_hcache_free_raw(struct HeaderCache *hc, void **data);
 
+/**
+ * mutt_hcache_begin - start a batch of changes
+ * @param hc Pointer to the struct HeaderCache structure got by mutt_hcache_open()
+ * @retval 0   Success
+ * @retval num Generic or backend-specific error code otherwise
+ *
+ * Until the matching mutt_hcache_commit(), the backend may defer writing the
+ * changes.  Batches may be nested; only the outermost commit writes.
+ */
+int mutt_hcache_begin(struct HeaderCache *hc);
+
+/**
+ * mutt_hcache_commit - write a batch of changes
+ * @param hc Pointer to the struct HeaderCache structure got by mutt_hcache_open()
+ * @retval 0   Success
+ * @retval num Generic or backend-specific error code otherwise
+ */
+int mutt_hcache_commit(struct HeaderCache *hc);
+
 /**
  * mutt_hcache_delete_record - delete a key / data pair
  * @param hc     Pointer to the struct HeaderCache structure got by mutt_hcache_open()
@@ -26,605 +26,659 @@
 /**
  * @page hc_serial Email-object serialiser
  *
- * Email-object serialiser
+ * Turn an Email into a flat, versioned record for the header cache, and back.
+ *
+ * The record has a fixed-size part (struct SerialEmail), a table of items and
+ * a table of NUL-terminated strings.  Dumping sizes the record up front, so it
+ * is built in a single allocation.  Restoring copies each string once, straight
+ * out of the string table, and checks every reference against the size of the
+ * record, so a damaged record is treated as a cache miss.
+ *
+ * If the strings of an Email are all plain ASCII, the record says so and no
+ * character set conversion is attempted on restore.
  */
 
 #include "config.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
-#include <sys/types.h>
 #include "mutt/lib.h"
 #include "address/lib.h"
 #include "config/lib.h"
 #include "email/lib.h"
 #include "core/lib.h"
 #include "serialize.h"
+#include "hcache/hcversion.h"
+
+// Layout of SerialEmail.email_bits
+#define SEB_MIME            (1 << 0)  ///< Email.mime
+#define SEB_FLAGGED         (1 << 1)  ///< Email.flagged
+#define SEB_DELETED         (1 << 2)  ///< Email.deleted
+#define SEB_PURGE           (1 << 3)  ///< Email.purge
+#define SEB_QUASI_DELETED   (1 << 4)  ///< Email.quasi_deleted
+#define SEB_ATTACH_DEL      (1 << 5)  ///< Email.attach_del
+#define SEB_OLD             (1 << 6)  ///< Email.old
+#define SEB_READ            (1 << 7)  ///< Email.read
+#define SEB_EXPIRED         (1 << 8)  ///< Email.expired
+#define SEB_SUPERSEDED      (1 << 9)  ///< Email.superseded
+#define SEB_REPLIED         (1 << 10) ///< Email.replied
+#define SEB_SUBJECT_CHANGED (1 << 11) ///< Email.subject_changed
+#define SEB_DISPLAY_SUBJECT (1 << 12) ///< Email.display_subject
+#define SEB_ACTIVE          (1 << 13) ///< Email.active
+#define SEB_TRASH           (1 << 14) ///< Email.trash
+#define SEB_ZOCCIDENT       (1 << 15) ///< Email.zoccident
+#define SEB_ZHOURS_SHIFT    16        ///< Email.zhours, 5 bits
+#define SEB_ZMINUTES_SHIFT  21        ///< Email.zminutes, 6 bits
+
+// Layout of SerialEmail.body_bits
+#define SBB_USE_DISP        (1 << 0)  ///< Body.use_disp
+#define SBB_UNLINK          (1 << 1)  ///< Body.unlink
+#define SBB_NOCONV          (1 << 2)  ///< Body.noconv
+#define SBB_FORCE_CHARSET   (1 << 3)  ///< Body.force_charset
+#define SBB_GOODSIG         (1 << 4)  ///< Body.goodsig
+#define SBB_WARNSIG         (1 << 5)  ///< Body.warnsig
+#define SBB_BADSIG          (1 << 6)  ///< Body.badsig
+#define SBB_TYPE_SHIFT      8         ///< Body.type, 4 bits
+#define SBB_ENCODING_SHIFT  12        ///< Body.encoding, 3 bits
+#define SBB_DISP_SHIFT      16        ///< Body.disposition, 2 bits
+
+ARRAY_HEAD(SerialItemArray, uint32_t);
 
 /**
- * lazy_realloc - Reallocate some memory
- * @param ptr Pointer to resize
- * @param size Minimum size
- *
- * The minimum size is 4KiB to avoid repeated resizing.
+ * struct SerialWriter - Work space for dumping an Email
  */
-void lazy_realloc(void *ptr, size_t size)
+struct SerialWriter
 {
-  void **p = (void **) ptr;
-
-  if (p && (size < 4096))
-    return;
-
-  mutt_mem_realloc(ptr, size);
-}
+  struct SerialItemArray items; ///< Item table
+  struct Buffer strings;        ///< String table
+  const char *charset;          ///< Convert strings from this charset to utf-8, or NULL
+  bool non_ascii;               ///< A string isn't plain ASCII
+};
 
 /**
- * serial_dump_int - Pack an integer into a binary blob
- * @param i   Integer to save
- * @param d   Binary blob to add to
- * @param off Offset into the blob
- * @retval ptr End of the newly packed binary
+ * struct SerialReader - Work space for restoring an Email
  */
-unsigned char *serial_dump_int(unsigned int i, unsigned char *d, int *off)
+struct SerialReader
 {
-  lazy_realloc(&d, *off + sizeof(int));
-  memcpy(d + *off, &i, sizeof(int));
-  (*off) += sizeof(int);
-
-  return d;
-}
+  const struct SerialEmail *se; ///< Fixed part of the record
+  const unsigned char *items;   ///< Item table (may be unaligned)
+  const char *strings;          ///< String table
+  const char *charset;          ///< Convert strings from utf-8 to this charset, or NULL
+};
 
 /**
- * serial_dump_uint32_t - Pack a uint32_t into a binary blob
- * @param s   uint32_t to save
- * @param d   Binary blob to add to
- * @param off Offset into the blob
- * @retval ptr End of the newly packed binary
+ * list_width - Get the number of items used by each entry of a list
+ * @param list List, e.g. #SL_FROM
+ * @retval num Items per entry
  */
-unsigned char *serial_dump_uint32_t(uint32_t s, unsigned char *d, int *off)
+static uint32_t list_width(enum SerialList list)
 {
-  lazy_realloc(&d, *off + sizeof(uint32_t));
-  memcpy(d + *off, &s, sizeof(uint32_t));
-  (*off) += sizeof(uint32_t);
-
-  return d;
+  if (list <= SL_MAIL_FOLLOWUP_TO)
+    return 3;
+  if (list == SL_PARAMETER)
+    return 2;
+  return 1;
 }
 
 /**
- * serial_restore_int - Unpack an integer from a binary blob
- * @param i   Integer to write to
- * @param d   Binary blob to read from
- * @param off Offset into the blob
+ * serial_email_bits - Pack the flags of an Email
+ * @param e Email
+ * @retval num Packed flags, see SerialEmail.email_bits
+ *
+ * Flags that only make sense for the current session aren't saved.
  */
-void serial_restore_int(unsigned int *i, const unsigned char *d, int *off)
+static uint32_t serial_email_bits(const struct Email *e)
 {
-  memcpy(i, d + *off, sizeof(int));
-  (*off) += sizeof(int);
+  uint32_t bits = 0;
+
+  if (e->mime)            bits |= SEB_MIME;
+  if (e->flagged)         bits |= SEB_FLAGGED;
+  if (e->deleted)         bits |= SEB_DELETED;
+  if (e->purge)           bits |= SEB_PURGE;
+  if (e->quasi_deleted)   bits |= SEB_QUASI_DELETED;
+  if (e->attach_del)      bits |= SEB_ATTACH_DEL;
+  if (e->old)             bits |= SEB_OLD;
+  if (e->read)            bits |= SEB_READ;
+  if (e->expired)         bits |= SEB_EXPIRED;
+  if (e->superseded)      bits |= SEB_SUPERSEDED;
+  if (e->replied)         bits |= SEB_REPLIED;
+  if (e->subject_changed) bits |= SEB_SUBJECT_CHANGED;
+  if (e->display_subject) bits |= SEB_DISPLAY_SUBJECT;
+  if (e->active)          bits |= SEB_ACTIVE;
+  if (e->trash)           bits |= SEB_TRASH;
+  if (e->zoccident)       bits |= SEB_ZOCCIDENT;
+
+  bits |= (e->zhours & 0x1f) << SEB_ZHOURS_SHIFT;
+  bits |= (e->zminutes & 0x3f) << SEB_ZMINUTES_SHIFT;
+
+  return bits;
 }
 
 /**
- * serial_restore_uint32_t - Unpack an uint32_t from a binary blob
- * @param s   uint32_t to write to
- * @param d   Binary blob to read from
- * @param off Offset into the blob
+ * serial_body_bits - Pack the flags and types of a Body
+ * @param b Body
+ * @retval num Packed flags, see SerialEmail.body_bits
  */
-void serial_restore_uint32_t(uint32_t *s, const unsigned char *d, int *off)
+static uint32_t serial_body_bits(const struct Body *b)
 {
-  memcpy(s, d + *off, sizeof(uint32_t));
-  (*off) += sizeof(uint32_t);
+  uint32_t bits = 0;
+
+  if (b->use_disp)      bits |= SBB_USE_DISP;
+  if (b->unlink)        bits |= SBB_UNLINK;
+  if (b->noconv)        bits |= SBB_NOCONV;
+  if (b->force_charset) bits |= SBB_FORCE_CHARSET;
+  if (b->goodsig)       bits |= SBB_GOODSIG;
+  if (b->warnsig)       bits |= SBB_WARNSIG;
+  if (b->badsig)        bits |= SBB_BADSIG;
+
+  bits |= (b->type & 0xf) << SBB_TYPE_SHIFT;
+  bits |= (b->encoding & 0x7) << SBB_ENCODING_SHIFT;
+  bits |= (b->disposition & 0x3) << SBB_DISP_SHIFT;
+
+  return bits;
 }
 
 /**
- * serial_dump_char_size - Pack a fixed-length string into a binary blob
- * @param c       String to pack
- * @param d       Binary blob to add to
- * @param size    Size of the string
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * writer_add_str - Add a string to the string table
+ * @param sw      Writer
+ * @param str     String to add (may be NULL)
+ * @param convert If true, the string will be converted to utf-8
+ * @retval num Reference to the string, 0 for NULL
  */
-unsigned char *serial_dump_char_size(char *c, ssize_t size, unsigned char *d,
-                                     int *off, bool convert)
+static uint32_t writer_add_str(struct SerialWriter *sw, const char *str, bool convert)
 {
-  char *p = c;
+  if (!str)
+    return 0;
 
-  if (!c)
-  {
-    size = 0;
-    d = serial_dump_int(size, d, off);
-    return d;
-  }
+  char *conv = NULL;
+  size_t len = mutt_str_len(str);
 
-  if (convert && !mutt_str_is_ascii(c, size))
+  if (!mutt_str_is_ascii(str, len))
   {
-    p = mutt_strn_dup(c, size);
-    const char *const c_charset = cs_subset_string(NeoMutt->sub, "charset");
-    if (mutt_ch_convert_string(&p, c_charset, "utf-8", MUTT_ICONV_NO_FLAGS) == 0)
+    // Flag the record whatever the current $charset is, so that a reader
+    // using a different $charset knows to convert it
+    sw->non_ascii = true;
+    if (convert && sw->charset)
     {
-      size = mutt_str_len(p) + 1;
+      conv = mutt_str_dup(str);
+      if (mutt_ch_convert_string(&conv, sw->charset, "utf-8", MUTT_ICONV_NO_FLAGS) == 0)
+      {
+        str = conv;
+        len = mutt_str_len(str);
+      }
     }
   }
 
-  d = serial_dump_int(size, d, off);
-  lazy_realloc(&d, *off + size);
-  memcpy(d + *off, p, size);
-  *off += size;
+  uint32_t ref = mutt_buffer_len(&sw->strings) + 1;
+  mutt_buffer_addstr_n(&sw->strings, str, len + 1); // Including NUL byte
 
-  if (p != c)
-    FREE(&p);
-
-  return d;
+  FREE(&conv);
+  return ref;
 }
 
 /**
- * serial_dump_char - Pack a variable-length string into a binary blob
- * @param c       String to pack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
+ * writer_add_list - Add a list of strings to the item table
+ * @param sw      Writer
+ * @param se      Record to fill in
+ * @param list    List, e.g. #SL_REFERENCES
+ * @param lh      List of strings
  * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
- */
-unsigned char *serial_dump_char(char *c, unsigned char *d, int *off, bool convert)
-{
-  return serial_dump_char_size(c, mutt_str_len(c) + 1, d, off, convert);
-}
-
-/**
- * serial_restore_char - Unpack a variable-length string from a binary blob
- * @param[out] c       Store the unpacked string here
- * @param[in]  d       Binary blob to read from
- * @param[out] off     Offset into the blob
- * @param[in]  convert If true, the strings will be converted to utf-8
  */
-void serial_restore_char(char **c, const unsigned char *d, int *off, bool convert)
+static void writer_add_list(struct SerialWriter *sw, struct SerialEmail *se,
+                            enum SerialList list, const struct ListHead *lh, bool convert)
 {
-  unsigned int size;
-  serial_restore_int(&size, d, off);
+  se->lists[list].start = ARRAY_SIZE(&sw->items);
 
-  if (size == 0)
-  {
-    *c = NULL;
-    return;
-  }
-
-  *c = mutt_mem_malloc(size);
-  memcpy(*c, d + *off, size);
-  if (convert && !mutt_str_is_ascii(*c, size))
+  struct ListNode *np = NULL;
+  STAILQ_FOREACH(np, lh, entries)
   {
-    char *tmp = mutt_str_dup(*c);
-    const char *const c_charset = cs_subset_string(NeoMutt->sub, "charset");
-    if (mutt_ch_convert_string(&tmp, "utf-8", c_charset, MUTT_ICONV_NO_FLAGS) == 0)
-    {
-      FREE(c);
-      *c = tmp;
-    }
-    else
-    {
-      FREE(&tmp);
-    }
+    ARRAY_ADD(&sw->items, writer_add_str(sw, np->data, convert));
+    se->lists[list].count++;
   }
-  *off += size;
 }
 
 /**
- * serial_dump_address - Pack an Address into a binary blob
- * @param al      AddressList to pack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * writer_add_addrlist - Add an AddressList to the item table
+ * @param sw   Writer
+ * @param se   Record to fill in
+ * @param list List, e.g. #SL_FROM
+ * @param al   AddressList
  */
-unsigned char *serial_dump_address(struct AddressList *al, unsigned char *d,
-                                   int *off, bool convert)
+static void writer_add_addrlist(struct SerialWriter *sw, struct SerialEmail *se,
+                                enum SerialList list, const struct AddressList *al)
 {
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
-
-  d = serial_dump_int(0xdeadbeef, d, off);
+  se->lists[list].start = ARRAY_SIZE(&sw->items);
 
   struct Address *a = NULL;
   TAILQ_FOREACH(a, al, entries)
   {
-    d = serial_dump_char(a->personal, d, off, convert);
-    d = serial_dump_char(a->mailbox, d, off, false);
-    d = serial_dump_int(a->group, d, off);
-    counter++;
+    ARRAY_ADD(&sw->items, writer_add_str(sw, a->personal, true));
+    ARRAY_ADD(&sw->items, writer_add_str(sw, a->mailbox, false));
+    ARRAY_ADD(&sw->items, a->group ? 1 : 0);
+    se->lists[list].count++;
   }
-
-  memcpy(d + start_off, &counter, sizeof(int));
-
-  return d;
 }
 
 /**
- * serial_restore_address - Unpack an Address from a binary blob
- * @param[out] al      Store the unpacked AddressList here
- * @param[in]  d       Binary blob to read from
- * @param[out] off     Offset into the blob
- * @param[in]  convert If true, the strings will be converted from utf-8
+ * serial_dump_email - Pack an Email into a flat record
+ * @param[in]  e       Email to pack
+ * @param[in]  hlen    Number of bytes to reserve at the start, for the caller
+ * @param[in]  convert If true, the strings will be converted to utf-8
+ * @param[out] dlen    Length of the record, including the reserved bytes
+ * @retval ptr Binary blob representing the Email
+ *
+ * @note The caller must free the returned data
  */
-void serial_restore_address(struct AddressList *al, const unsigned char *d,
-                            int *off, bool convert)
+void *serial_dump_email(const struct Email *e, size_t hlen, bool convert, size_t *dlen)
 {
-  unsigned int counter = 0;
-  unsigned int g = 0;
+  const struct Envelope *env = e->env;
+  const struct Body *b = e->body;
+
+  struct SerialWriter sw = { 0 };
+  ARRAY_INIT(&sw.items);
+  sw.strings = mutt_buffer_make(1024);
+  if (convert)
+    sw.charset = cs_subset_string(NeoMutt->sub, "charset");
+
+  struct SerialEmail se = { 0 };
+  se.version = HCACHE_RECORD_VERSION;
+  se.date_sent = e->date_sent;
+  se.received = e->received;
+  se.offset = e->offset;
+  se.lines = e->lines;
+  se.index = e->index;
+  se.msgno = e->msgno;
+  se.vnum = e->vnum;
+  se.score = e->score;
+  se.attach_total = e->attach_total;
+  se.security = e->security;
+  se.email_bits = serial_email_bits(e);
+  se.real_subj = -1;
+
+  if (env)
+  {
+    writer_add_addrlist(&sw, &se, SL_RETURN_PATH, &env->return_path);
+    writer_add_addrlist(&sw, &se, SL_FROM, &env->from);
+    writer_add_addrlist(&sw, &se, SL_TO, &env->to);
+    writer_add_addrlist(&sw, &se, SL_CC, &env->cc);
+    writer_add_addrlist(&sw, &se, SL_BCC, &env->bcc);
+    writer_add_addrlist(&sw, &se, SL_SENDER, &env->sender);
+    writer_add_addrlist(&sw, &se, SL_REPLY_TO, &env->reply_to);
+    writer_add_addrlist(&sw, &se, SL_MAIL_FOLLOWUP_TO, &env->mail_followup_to);
+
+    se.strings[SS_LIST_POST] = writer_add_str(&sw, env->list_post, true);
+    se.strings[SS_SUBJECT] = writer_add_str(&sw, env->subject, true);
+    if (env->subject && env->real_subj)
+      se.real_subj = env->real_subj - env->subject;
+    se.strings[SS_MESSAGE_ID] = writer_add_str(&sw, env->message_id, false);
+    se.strings[SS_SUPERSEDES] = writer_add_str(&sw, env->supersedes, false);
+    se.strings[SS_DATE] = writer_add_str(&sw, env->date, false);
+    se.strings[SS_X_LABEL] = writer_add_str(&sw, env->x_label, true);
+    se.strings[SS_ORGANIZATION] = writer_add_str(&sw, env->organization, true);
+    if (!mutt_buffer_is_empty(&env->spam))
+      se.strings[SS_SPAM] = writer_add_str(&sw, mutt_buffer_string(&env->spam), true);
+#ifdef USE_NNTP
+    se.strings[SS_XREF] = writer_add_str(&sw, env->xref, false);
+    se.strings[SS_FOLLOWUP_TO] = writer_add_str(&sw, env->followup_to, false);
+    se.strings[SS_X_COMMENT_TO] = writer_add_str(&sw, env->x_comment_to, true);
+#endif
 
-  serial_restore_int(&counter, d, off);
+    writer_add_list(&sw, &se, SL_REFERENCES, &env->references, false);
+    writer_add_list(&sw, &se, SL_IN_REPLY_TO, &env->in_reply_to, false);
+    writer_add_list(&sw, &se, SL_USERHDRS, &env->userhdrs, true);
+  }
 
-  while (counter)
+  if (b)
   {
-    struct Address *a = mutt_addr_new();
-    serial_restore_char(&a->personal, d, off, convert);
-    serial_restore_char(&a->mailbox, d, off, false);
-    serial_restore_int(&g, d, off);
-    a->group = !!g;
-    mutt_addrlist_append(al, a);
-    counter--;
+    se.body_hdr_offset = b->hdr_offset;
+    se.body_offset = b->offset;
+    se.body_length = b->length;
+    se.body_stamp = b->stamp;
+    se.body_attach_count = b->attach_count;
+    se.body_bits = serial_body_bits(b);
+
+    se.strings[SS_XTYPE] = writer_add_str(&sw, b->xtype, false);
+    se.strings[SS_SUBTYPE] = writer_add_str(&sw, b->subtype, false);
+    se.strings[SS_DESCRIPTION] = writer_add_str(&sw, b->description, true);
+    se.strings[SS_FORM_NAME] = writer_add_str(&sw, b->form_name, true);
+    se.strings[SS_FILENAME] = writer_add_str(&sw, b->filename, true);
+    se.strings[SS_D_FILENAME] = writer_add_str(&sw, b->d_filename, true);
+
+    se.lists[SL_PARAMETER].start = ARRAY_SIZE(&sw.items);
+    struct Parameter *np = NULL;
+    TAILQ_FOREACH(np, &b->parameter, entries)
+    {
+      ARRAY_ADD(&sw.items, writer_add_str(&sw, np->attribute, false));
+      ARRAY_ADD(&sw.items, writer_add_str(&sw, np->value, true));
+      se.lists[SL_PARAMETER].count++;
+    }
   }
-}
-
-/**
- * serial_dump_stailq - Pack a STAILQ into a binary blob
- * @param l       List to read from
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
- */
-unsigned char *serial_dump_stailq(struct ListHead *l, unsigned char *d, int *off, bool convert)
-{
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
 
-  d = serial_dump_int(0xdeadbeef, d, off);
-
-  struct ListNode *np = NULL;
-  STAILQ_FOREACH(np, l, entries)
+  se.lists[SL_TAGS].start = ARRAY_SIZE(&sw.items);
+  struct Tag *t = NULL;
+  STAILQ_FOREACH(t, &e->tags, entries)
   {
-    d = serial_dump_char(np->data, d, off, convert);
-    counter++;
+    ARRAY_ADD(&sw.items, writer_add_str(&sw, t->name, false));
+    se.lists[SL_TAGS].count++;
   }
 
-  memcpy(d + start_off, &counter, sizeof(int));
-
+  if (sw.non_ascii)
+    se.flags |= SERIAL_NON_ASCII;
+  se.num_items = ARRAY_SIZE(&sw.items);
+  se.strings_len = mutt_buffer_len(&sw.strings);
+
+  const size_t items_len = se.num_items * sizeof(uint32_t);
+  *dlen = hlen + sizeof(se) + items_len + se.strings_len;
+
+  unsigned char *d = mutt_mem_malloc(*dlen);
+  unsigned char *p = d + hlen;
+  memcpy(p, &se, sizeof(se));
+  p += sizeof(se);
+  if (items_len != 0)
+    memcpy(p, sw.items.entries, items_len);
+  p += items_len;
+  if (se.strings_len != 0)
+    memcpy(p, sw.strings.data, se.strings_len);
+
+  ARRAY_FREE(&sw.items);
+  mutt_buffer_dealloc(&sw.strings);
   return d;
 }
 
 /**
- * serial_restore_stailq - Unpack a STAILQ from a binary blob
- * @param l       List to add to
- * @param d       Binary blob to read from
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted from utf-8
+ * reader_item - Get an entry from the item table
+ * @param sr  Reader
+ * @param idx Index of the item
+ * @retval num Value of the item
  */
-void serial_restore_stailq(struct ListHead *l, const unsigned char *d, int *off, bool convert)
+static uint32_t reader_item(const struct SerialReader *sr, uint32_t idx)
 {
-  unsigned int counter;
-
-  serial_restore_int(&counter, d, off);
-
-  struct ListNode *np = NULL;
-  while (counter)
-  {
-    np = mutt_list_insert_tail(l, NULL);
-    serial_restore_char(&np->data, d, off, convert);
-    counter--;
-  }
+  uint32_t item;
+  memcpy(&item, sr->items + (idx * sizeof(uint32_t)), sizeof(item));
+  return item;
 }
 
 /**
- * serial_dump_buffer - Pack a Buffer into a binary blob
- * @param buf     Buffer to pack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * reader_get_str - Copy a string out of the string table
+ * @param sr      Reader
+ * @param ref     Reference to the string, 0 for NULL
+ * @param convert If true, the string will be converted from utf-8
+ * @retval ptr New string
  */
-unsigned char *serial_dump_buffer(struct Buffer *buf, unsigned char *d, int *off, bool convert)
+static char *reader_get_str(const struct SerialReader *sr, uint32_t ref, bool convert)
 {
-  if (!buf)
-  {
-    d = serial_dump_int(0, d, off);
-    return d;
-  }
-
-  d = serial_dump_int(1, d, off);
-
-  d = serial_dump_char_size(buf->data, buf->dsize + 1, d, off, convert);
-  d = serial_dump_int(buf->dptr - buf->data, d, off);
-  d = serial_dump_int(buf->dsize, d, off);
-
-  return d;
-}
+  if (ref == 0)
+    return NULL;
 
-/**
- * serial_restore_buffer - Unpack a Buffer from a binary blob
- * @param[out] buf     Store the unpacked Buffer here
- * @param[in]  d       Binary blob to read from
- * @param[out] off     Offset into the blob
- * @param[in]  convert If true, the strings will be converted from utf-8
- */
-void serial_restore_buffer(struct Buffer *buf, const unsigned char *d, int *off, bool convert)
-{
-  unsigned int used;
-  unsigned int offset;
-  serial_restore_int(&used, d, off);
-  if (!used)
+  const char *str = sr->strings + ref - 1;
+  if (convert && sr->charset)
   {
-    return;
+    size_t len = mutt_str_len(str);
+    if (!mutt_str_is_ascii(str, len))
+    {
+      char *tmp = mutt_strn_dup(str, len);
+      if (mutt_ch_convert_string(&tmp, "utf-8", sr->charset, MUTT_ICONV_NO_FLAGS) == 0)
+        return tmp;
+      FREE(&tmp);
+    }
   }
 
-  serial_restore_char(&buf->data, d, off, convert);
-  serial_restore_int(&offset, d, off);
-  mutt_buffer_seek(buf, offset);
-  serial_restore_int(&used, d, off);
-  buf->dsize = used;
+  return mutt_str_dup(str);
 }
 
 /**
- * serial_dump_parameter - Pack a Parameter into a binary blob
- * @param pl      Parameter to pack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * reader_get_list - Unpack a list of strings
+ * @param sr      Reader
+ * @param list    List, e.g. #SL_REFERENCES
+ * @param lh      List to add to
+ * @param convert If true, the strings will be converted from utf-8
  */
-unsigned char *serial_dump_parameter(struct ParameterList *pl, unsigned char *d,
-                                     int *off, bool convert)
+static void reader_get_list(const struct SerialReader *sr, enum SerialList list,
+                            struct ListHead *lh, bool convert)
 {
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
-
-  d = serial_dump_int(0xdeadbeef, d, off);
-
-  struct Parameter *np = NULL;
-  TAILQ_FOREACH(np, pl, entries)
+  const struct SerialListRef *lr = &sr->se->lists[list];
+  for (uint32_t i = 0; i < lr->count; i++)
   {
-    d = serial_dump_char(np->attribute, d, off, false);
-    d = serial_dump_char(np->value, d, off, convert);
-    counter++;
+    char *str = reader_get_str(sr, reader_item(sr, lr->start + i), convert);
+    mutt_list_insert_tail(lh, str);
   }
-
-  memcpy(d + start_off, &counter, sizeof(int));
-
-  return d;
 }
 
 /**
- * serial_restore_parameter - Unpack a Parameter from a binary blob
- * @param pl      Store the unpacked Parameter here
- * @param d       Binary blob to read from
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted from utf-8
+ * reader_get_addrlist - Unpack an AddressList
+ * @param sr   Reader
+ * @param list List, e.g. #SL_FROM
+ * @param al   AddressList to add to
  */
-void serial_restore_parameter(struct ParameterList *pl, const unsigned char *d,
-                              int *off, bool convert)
+static void reader_get_addrlist(const struct SerialReader *sr,
+                                enum SerialList list, struct AddressList *al)
 {
-  unsigned int counter;
-
-  serial_restore_int(&counter, d, off);
-
-  struct Parameter *np = NULL;
-  while (counter)
+  const struct SerialListRef *lr = &sr->se->lists[list];
+  for (uint32_t i = 0; i < lr->count; i++)
   {
-    np = mutt_param_new();
-    serial_restore_char(&np->attribute, d, off, false);
-    serial_restore_char(&np->value, d, off, convert);
-    TAILQ_INSERT_TAIL(pl, np, entries);
-    counter--;
+    const uint32_t idx = lr->start + (i * 3);
+    struct Address *a = mutt_addr_new();
+    a->personal = reader_get_str(sr, reader_item(sr, idx), true);
+    a->mailbox = reader_get_str(sr, reader_item(sr, idx + 1), false);
+    a->group = (reader_item(sr, idx + 2) != 0);
+    mutt_addrlist_append(al, a);
   }
 }
 
 /**
- * serial_dump_body - Pack an Body into a binary blob
- * @param c       Body to pack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * reader_check - Check that a record is intact
+ * @param se   Fixed part of the record
+ * @param d    Start of the item table
+ * @param dlen Length of the tables
+ * @retval true The record can be restored safely
  */
-unsigned char *serial_dump_body(struct Body *c, unsigned char *d, int *off, bool convert)
+static bool reader_check(const struct SerialEmail *se, const unsigned char *d, size_t dlen)
 {
-  struct Body nb;
+  if (se->version != HCACHE_RECORD_VERSION)
+    return false;
 
-  memcpy(&nb, c, sizeof(struct Body));
+  const uint64_t items_len = (uint64_t) se->num_items * sizeof(uint32_t);
+  if ((items_len + se->strings_len) != dlen)
+    return false;
 
-  /* some fields are not safe to cache */
-  nb.content = NULL;
-  nb.charset = NULL;
-  nb.next = NULL;
-  nb.parts = NULL;
-  nb.email = NULL;
-  nb.aptr = NULL;
-  nb.mime_headers = NULL;
-  nb.language = NULL;
+  const char *strings = (const char *) d + items_len;
+  if ((se->strings_len != 0) && (strings[se->strings_len - 1] != '\0'))
+    return false;
 
-  lazy_realloc(&d, *off + sizeof(struct Body));
-  memcpy(d + *off, &nb, sizeof(struct Body));
-  *off += sizeof(struct Body);
+  for (size_t i = 0; i < SS_MAX; i++)
+    if (se->strings[i] > se->strings_len)
+      return false;
 
-  d = serial_dump_char(nb.xtype, d, off, false);
-  d = serial_dump_char(nb.subtype, d, off, false);
-
-  d = serial_dump_parameter(&nb.parameter, d, off, convert);
-
-  d = serial_dump_char(nb.description, d, off, convert);
-  d = serial_dump_char(nb.form_name, d, off, convert);
-  d = serial_dump_char(nb.filename, d, off, convert);
-  d = serial_dump_char(nb.d_filename, d, off, convert);
-
-  return d;
-}
-
-/**
- * serial_restore_body - Unpack a Body from a binary blob
- * @param c       Store the unpacked Body here
- * @param d       Binary blob to read from
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted from utf-8
- */
-void serial_restore_body(struct Body *c, const unsigned char *d, int *off, bool convert)
-{
-  memcpy(c, d + *off, sizeof(struct Body));
-  *off += sizeof(struct Body);
-  c->language = NULL;
-
-  serial_restore_char(&c->xtype, d, off, false);
-  serial_restore_char(&c->subtype, d, off, false);
-
-  TAILQ_INIT(&c->parameter);
-  serial_restore_parameter(&c->parameter, d, off, convert);
+  for (size_t i = 0; i < SL_MAX; i++)
+  {
+    const uint64_t end = se->lists[i].start +
+                         ((uint64_t) se->lists[i].count * list_width(i));
+    if (end > se->num_items)
+      return false;
 
-  serial_restore_char(&c->description, d, off, convert);
-  serial_restore_char(&c->form_name, d, off, convert);
-  serial_restore_char(&c->filename, d, off, convert);
-  serial_restore_char(&c->d_filename, d, off, convert);
-}
+    if (i <= SL_MAIL_FOLLOWUP_TO)
+      continue;
 
-/**
- * serial_dump_envelope - Pack an Envelope into a binary blob
- * @param env     Envelope to pack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- * @param convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
- */
-unsigned char *serial_dump_envelope(struct Envelope *env, unsigned char *d,
-                                    int *off, bool convert)
-{
-  d = serial_dump_address(&env->return_path, d, off, convert);
-  d = serial_dump_address(&env->from, d, off, convert);
-  d = serial_dump_address(&env->to, d, off, convert);
-  d = serial_dump_address(&env->cc, d, off, convert);
-  d = serial_dump_address(&env->bcc, d, off, convert);
-  d = serial_dump_address(&env->sender, d, off, convert);
-  d = serial_dump_address(&env->reply_to, d, off, convert);
-  d = serial_dump_address(&env->mail_followup_to, d, off, convert);
-
-  d = serial_dump_char(env->list_post, d, off, convert);
-  d = serial_dump_char(env->subject, d, off, convert);
-
-  if (env->real_subj)
-    d = serial_dump_int(env->real_subj - env->subject, d, off);
-  else
-    d = serial_dump_int(-1, d, off);
-
-  d = serial_dump_char(env->message_id, d, off, false);
-  d = serial_dump_char(env->supersedes, d, off, false);
-  d = serial_dump_char(env->date, d, off, false);
-  d = serial_dump_char(env->x_label, d, off, convert);
-  d = serial_dump_char(env->organization, d, off, convert);
-
-  d = serial_dump_buffer(&env->spam, d, off, convert);
-
-  d = serial_dump_stailq(&env->references, d, off, false);
-  d = serial_dump_stailq(&env->in_reply_to, d, off, false);
-  d = serial_dump_stailq(&env->userhdrs, d, off, convert);
+    /* Every item of the other lists is a string reference */
+    for (uint64_t j = se->lists[i].start; j < end; j++)
+    {
+      uint32_t item;
+      memcpy(&item, d + (j * sizeof(uint32_t)), sizeof(item));
+      if (item > se->strings_len)
+        return false;
+    }
+  }
 
-#ifdef USE_NNTP
-  d = serial_dump_char(env->xref, d, off, false);
-  d = serial_dump_char(env->followup_to, d, off, false);
-  d = serial_dump_char(env->x_comment_to, d, off, convert);
-#endif
+  /* The address lists interleave string references and group flags */
+  for (size_t i = 0; i <= SL_MAIL_FOLLOWUP_TO; i++)
+  {
+    for (uint32_t j = 0; j < se->lists[i].count; j++)
+    {
+      const uint64_t idx = se->lists[i].start + ((uint64_t) j * 3);
+      uint32_t personal, mailbox;
+      memcpy(&personal, d + (idx * sizeof(uint32_t)), sizeof(personal));
+      memcpy(&mailbox, d + ((idx + 1) * sizeof(uint32_t)), sizeof(mailbox));
+      if ((personal > se->strings_len) || (mailbox > se->strings_len))
+        return false;
+    }
+  }
 
-  return d;
+  return true;
 }
 
 /**
- * serial_restore_envelope - Unpack an Envelope from a binary blob
- * @param env     Store the unpacked Envelope here
- * @param d       Binary blob to read from
- * @param off     Offset into the blob
+ * serial_restore_email - Unpack an Email from a flat record
+ * @param d       Record, as created by serial_dump_email(), minus the reserved bytes
+ * @param dlen    Length of the record
  * @param convert If true, the strings will be converted from utf-8
+ * @param shallow If true, only restore the flags and dates, not the Envelope or Body
+ * @retval ptr  Restored Email
+ * @retval NULL The record is damaged or has the wrong version
+ *
+ * A shallow restore is much cheaper.  It leaves Email.env and Email.body NULL.
+ *
+ * @note The returned Email must be free'd by caller code with email_free()
  */
-void serial_restore_envelope(struct Envelope *env, const unsigned char *d, int *off, bool convert)
+struct Email *serial_restore_email(const unsigned char *d, size_t dlen, bool convert, bool shallow)
 {
-  int real_subj_off;
-
-  serial_restore_address(&env->return_path, d, off, convert);
-  serial_restore_address(&env->from, d, off, convert);
-  serial_restore_address(&env->to, d, off, convert);
-  serial_restore_address(&env->cc, d, off, convert);
-  serial_restore_address(&env->bcc, d, off, convert);
-  serial_restore_address(&env->sender, d, off, convert);
-  serial_restore_address(&env->reply_to, d, off, convert);
-  serial_restore_address(&env->mail_followup_to, d, off, convert);
-
-  serial_restore_char(&env->list_post, d, off, convert);
-
+  struct SerialEmail se;
+  if (!d || (dlen < sizeof(se)))
+    return NULL;
+
+  memcpy(&se, d, sizeof(se));
+  d += sizeof(se);
+  dlen -= sizeof(se);
+
+  if (!reader_check(&se, d, dlen))
+    return NULL;
+
+  struct SerialReader sr = { 0 };
+  sr.se = &se;
+  sr.items = d;
+  sr.strings = (const char *) d + (se.num_items * sizeof(uint32_t));
+  if (convert && (se.flags & SERIAL_NON_ASCII))
+    sr.charset = cs_subset_string(NeoMutt->sub, "charset");
+
+  struct Email *e = email_new();
+  e->date_sent = se.date_sent;
+  e->received = se.received;
+  e->offset = se.offset;
+  e->lines = se.lines;
+  e->index = se.index;
+  e->msgno = se.msgno;
+  e->vnum = se.vnum;
+  e->score = se.score;
+  e->attach_total = se.attach_total;
+  e->security = se.security;
+
+  const uint32_t eb = se.email_bits;
+  e->mime = (eb & SEB_MIME);
+  e->flagged = (eb & SEB_FLAGGED);
+  e->deleted = (eb & SEB_DELETED);
+  e->purge = (eb & SEB_PURGE);
+  e->quasi_deleted = (eb & SEB_QUASI_DELETED);
+  e->attach_del = (eb & SEB_ATTACH_DEL);
+  e->old = (eb & SEB_OLD);
+  e->read = (eb & SEB_READ);
+  e->expired = (eb & SEB_EXPIRED);
+  e->superseded = (eb & SEB_SUPERSEDED);
+  e->replied = (eb & SEB_REPLIED);
+  e->subject_changed = (eb & SEB_SUBJECT_CHANGED);
+  e->display_subject = (eb & SEB_DISPLAY_SUBJECT);
+  e->active = (eb & SEB_ACTIVE);
+  e->trash = (eb & SEB_TRASH);
+  e->zoccident = (eb & SEB_ZOCCIDENT);
+  e->zhours = (eb >> SEB_ZHOURS_SHIFT) & 0x1f;
+  e->zminutes = (eb >> SEB_ZMINUTES_SHIFT) & 0x3f;
+
+  struct SerialListRef *lr = &se.lists[SL_TAGS];
+  for (uint32_t i = 0; i < lr->count; i++)
+    driver_tags_add(&e->tags, reader_get_str(&sr, reader_item(&sr, lr->start + i), false));
+
+  if (shallow)
+    return e;
+
+  struct Envelope *env = mutt_env_new();
+  e->env = env;
+
+  reader_get_addrlist(&sr, SL_RETURN_PATH, &env->return_path);
+  reader_get_addrlist(&sr, SL_FROM, &env->from);
+  reader_get_addrlist(&sr, SL_TO, &env->to);
+  reader_get_addrlist(&sr, SL_CC, &env->cc);
+  reader_get_addrlist(&sr, SL_BCC, &env->bcc);
+  reader_get_addrlist(&sr, SL_SENDER, &env->sender);
+  reader_get_addrlist(&sr, SL_REPLY_TO, &env->reply_to);
+  reader_get_addrlist(&sr, SL_MAIL_FOLLOWUP_TO, &env->mail_followup_to);
+
+  env->list_post = reader_get_str(&sr, se.strings[SS_LIST_POST], true);
   const bool c_auto_subscribe = cs_subset_bool(NeoMutt->sub, "auto_subscribe");
   if (c_auto_subscribe)
     mutt_auto_subscribe(env->list_post);
 
-  serial_restore_char(&env->subject, d, off, convert);
-  serial_restore_int((unsigned int *) (&real_subj_off), d, off);
+  env->subject = reader_get_str(&sr, se.strings[SS_SUBJECT], true);
+  if (env->subject && (se.real_subj >= 0) && ((size_t) se.real_subj <= mutt_str_len(env->subject)))
+    env->real_subj = env->subject + se.real_subj;
 
-  if (real_subj_off >= 0)
-    env->real_subj = env->subject + real_subj_off;
-  else
-    env->real_subj = NULL;
+  env->message_id = reader_get_str(&sr, se.strings[SS_MESSAGE_ID], false);
+  env->supersedes = reader_get_str(&sr, se.strings[SS_SUPERSEDES], false);
+  env->date = reader_get_str(&sr, se.strings[SS_DATE], false);
+  env->x_label = reader_get_str(&sr, se.strings[SS_X_LABEL], true);
+  env->organization = reader_get_str(&sr, se.strings[SS_ORGANIZATION], true);
 
-  serial_restore_char(&env->message_id, d, off, false);
-  serial_restore_char(&env->supersedes, d, off, false);
-  serial_restore_char(&env->date, d, off, false);
-  serial_restore_char(&env->x_label, d, off, convert);
-  serial_restore_char(&env->organization, d, off, convert);
-
-  serial_restore_buffer(&env->spam, d, off, convert);
-
-  serial_restore_stailq(&env->references, d, off, false);
-  serial_restore_stailq(&env->in_reply_to, d, off, false);
-  serial_restore_stailq(&env->userhdrs, d, off, convert);
+  char *spam = reader_get_str(&sr, se.strings[SS_SPAM], true);
+  if (spam)
+  {
+    mutt_buffer_strcpy(&env->spam, spam);
+    FREE(&spam);
+  }
 
 #ifdef USE_NNTP
-  serial_restore_char(&env->xref, d, off, false);
-  serial_restore_char(&env->followup_to, d, off, false);
-  serial_restore_char(&env->x_comment_to, d, off, convert);
+  env->xref = reader_get_str(&sr, se.strings[SS_XREF], false);
+  env->followup_to = reader_get_str(&sr, se.strings[SS_FOLLOWUP_TO], false);
+  env->x_comment_to = reader_get_str(&sr, se.strings[SS_X_COMMENT_TO], true);
 #endif
-}
-
-/**
- * serial_dump_tags - Pack a TagList into a binary blob
- * @param tags    TagList to pack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- * @retval ptr End of the newly packed binary
- */
-unsigned char *serial_dump_tags(const struct TagList *tags, unsigned char *d, int *off)
-{
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
 
-  d = serial_dump_int(0xdeadbeef, d, off);
-
-  struct Tag *t = NULL;
-  STAILQ_FOREACH(t, tags, entries)
+  reader_get_list(&sr, SL_REFERENCES, &env->references, false);
+  reader_get_list(&sr, SL_IN_REPLY_TO, &env->in_reply_to, false);
+  reader_get_list(&sr, SL_USERHDRS, &env->userhdrs, true);
+
+  struct Body *b = mutt_body_new();
+  e->body = b;
+
+  b->hdr_offset = se.body_hdr_offset;
+  b->offset = se.body_offset;
+  b->length = se.body_length;
+  b->stamp = se.body_stamp;
+  b->attach_count = se.body_attach_count;
+
+  const uint32_t bb = se.body_bits;
+  b->use_disp = (bb & SBB_USE_DISP);
+  b->unlink = (bb & SBB_UNLINK);
+  b->noconv = (bb & SBB_NOCONV);
+  b->force_charset = (bb & SBB_FORCE_CHARSET);
+  b->goodsig = (bb & SBB_GOODSIG);
+  b->warnsig = (bb & SBB_WARNSIG);
+  b->badsig = (bb & SBB_BADSIG);
+  b->type = (bb >> SBB_TYPE_SHIFT) & 0xf;
+  b->encoding = (bb >> SBB_ENCODING_SHIFT) & 0x7;
+  b->disposition = (bb >> SBB_DISP_SHIFT) & 0x3;
+
+  b->xtype = reader_get_str(&sr, se.strings[SS_XTYPE], false);
+  b->subtype = reader_get_str(&sr, se.strings[SS_SUBTYPE], false);
+  b->description = reader_get_str(&sr, se.strings[SS_DESCRIPTION], true);
+  b->form_name = reader_get_str(&sr, se.strings[SS_FORM_NAME], true);
+  b->filename = reader_get_str(&sr, se.strings[SS_FILENAME], true);
+  b->d_filename = reader_get_str(&sr, se.strings[SS_D_FILENAME], true);
+
+  lr = &se.lists[SL_PARAMETER];
+  for (uint32_t i = 0; i < lr->count; i++)
   {
-    d = serial_dump_char(t->name, d, off, false);
-    counter++;
+    const uint32_t idx = lr->start + (i * 2);
+    struct Parameter *np = mutt_param_new();
+    np->attribute = reader_get_str(&sr, reader_item(&sr, idx), false);
+    np->value = reader_get_str(&sr, reader_item(&sr, idx + 1), true);
+    TAILQ_INSERT_TAIL(&b->parameter, np, entries);
   }
 
-  memcpy(d + start_off, &counter, sizeof(int));
-
-  return d;
-}
-
-/**
- * serial_restore_tags - Unpack a TagList into a binary blob
- * @param tags    TagList to unpack
- * @param d       Binary blob to add to
- * @param off     Offset into the blob
- */
-void serial_restore_tags(struct TagList *tags, const unsigned char *d, int *off)
-{
-  unsigned int counter = 0;
-
-  serial_restore_int(&counter, d, off);
-
-  while (counter)
-  {
-    char *name = NULL;
-    serial_restore_char(&name, d, off, false);
-    driver_tags_add(tags, name);
-    counter--;
-  }
+  return e;
 }
@@ -29,39 +29,112 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <sys/types.h>
 
-struct AddressList;
-struct Body;
-struct Buffer;
-struct Envelope;
-struct ListHead;
-struct ParameterList;
-struct TagList;
+struct Email;
 
-unsigned char *serial_dump_address  (struct AddressList *al,     unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_body     (struct Body *c,             unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_tags     (const struct TagList *tags, unsigned char *d, int *off);
-unsigned char *serial_dump_buffer   (struct Buffer *buf,         unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_char     (char *c,                    unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_char_size(char *c, ssize_t size,      unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_envelope (struct Envelope *e,         unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_int      (unsigned int i,             unsigned char *d, int *off);
-unsigned char *serial_dump_uint32_t (uint32_t s,                 unsigned char *d, int *off);
-unsigned char *serial_dump_parameter(struct ParameterList *pl,   unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_stailq   (struct ListHead *l,         unsigned char *d, int *off, bool convert);
+/**
+ * enum SerialString - Strings stored at a fixed position in an Email record
+ */
+enum SerialString
+{
+  SS_LIST_POST,    ///< Envelope.list_post
+  SS_SUBJECT,      ///< Envelope.subject
+  SS_MESSAGE_ID,   ///< Envelope.message_id
+  SS_SUPERSEDES,   ///< Envelope.supersedes
+  SS_DATE,         ///< Envelope.date
+  SS_X_LABEL,      ///< Envelope.x_label
+  SS_ORGANIZATION, ///< Envelope.organization
+  SS_SPAM,         ///< Envelope.spam
+  SS_XREF,         ///< Envelope.xref
+  SS_FOLLOWUP_TO,  ///< Envelope.followup_to
+  SS_X_COMMENT_TO, ///< Envelope.x_comment_to
+  SS_XTYPE,        ///< Body.xtype
+  SS_SUBTYPE,      ///< Body.subtype
+  SS_DESCRIPTION,  ///< Body.description
+  SS_FORM_NAME,    ///< Body.form_name
+  SS_FILENAME,     ///< Body.filename
+  SS_D_FILENAME,   ///< Body.d_filename
+  SS_MAX,
+};
+
+/**
+ * enum SerialList - Lists stored in the item table of an Email record
+ */
+enum SerialList
+{
+  SL_RETURN_PATH,      ///< Envelope.return_path, 3 items per Address
+  SL_FROM,             ///< Envelope.from, 3 items per Address
+  SL_TO,               ///< Envelope.to, 3 items per Address
+  SL_CC,               ///< Envelope.cc, 3 items per Address
+  SL_BCC,              ///< Envelope.bcc, 3 items per Address
+  SL_SENDER,           ///< Envelope.sender, 3 items per Address
+  SL_REPLY_TO,         ///< Envelope.reply_to, 3 items per Address
+  SL_MAIL_FOLLOWUP_TO, ///< Envelope.mail_followup_to, 3 items per Address
+  SL_REFERENCES,       ///< Envelope.references, 1 item per ListNode
+  SL_IN_REPLY_TO,      ///< Envelope.in_reply_to, 1 item per ListNode
+  SL_USERHDRS,         ///< Envelope.userhdrs, 1 item per ListNode
+  SL_PARAMETER,        ///< Body.parameter, 2 items per Parameter
+  SL_TAGS,             ///< Email.tags, 1 item per Tag
+  SL_MAX,
+};
+
+/**
+ * struct SerialListRef - Location of a list in the item table
+ */
+struct SerialListRef
+{
+  uint32_t start; ///< Index of the first item
+  uint32_t count; ///< Number of list entries
+};
+
+/**
+ * struct SerialEmail - Fixed part of an Email record in the header cache
+ *
+ * A record is laid out as:
+ * - struct SerialEmail
+ * - uint32_t items[num_items]
+ * - char strings[strings_len]
+ *
+ * Strings are referenced by their offset in the string table plus one, so
+ * that zero can mean NULL.  Every string is NUL-terminated.  An item is either
+ * a string reference or, for an Address, its group flag.
+ *
+ * All the fields have a fixed size and offset, so the record doesn't depend on
+ * the in-memory layout of struct Email and any field can be read without
+ * parsing the rest of the record.
+ */
+struct SerialEmail
+{
+  uint32_t version;                  ///< Record version, #HCACHE_RECORD_VERSION
+  uint32_t flags;                    ///< Record flags, e.g. #SERIAL_NON_ASCII
+  uint32_t num_items;                ///< Number of entries in the item table
+  uint32_t strings_len;              ///< Size of the string table in bytes
+  int64_t date_sent;                 ///< Email.date_sent
+  int64_t received;                  ///< Email.received
+  int64_t offset;                    ///< Email.offset
+  int64_t body_hdr_offset;           ///< Body.hdr_offset
+  int64_t body_offset;               ///< Body.offset
+  int64_t body_length;               ///< Body.length
+  int64_t body_stamp;                ///< Body.stamp
+  int32_t lines;                     ///< Email.lines
+  int32_t index;                     ///< Email.index
+  int32_t msgno;                     ///< Email.msgno
+  int32_t vnum;                      ///< Email.vnum
+  int32_t score;                     ///< Email.score
+  int32_t attach_total;              ///< Email.attach_total
+  int32_t body_attach_count;         ///< Body.attach_count
+  int32_t real_subj;                 ///< Offset of Envelope.real_subj in the subject, or -1
+  uint32_t email_bits;               ///< Email flags and timezone, see serial_email_bits()
+  uint32_t body_bits;                ///< Body flags and types, see serial_body_bits()
+  uint32_t security;                 ///< Email.security
+  uint32_t strings[SS_MAX];          ///< Fixed strings, see #SerialString
+  struct SerialListRef lists[SL_MAX]; ///< Lists, see #SerialList
+};
 
-void serial_restore_address  (struct AddressList *al,   const unsigned char *d, int *off, bool convert);
-void serial_restore_body     (struct Body *c,           const unsigned char *d, int *off, bool convert);
-void serial_restore_tags     (struct TagList *tags,     const unsigned char *d, int *off);
-void serial_restore_buffer   (struct Buffer *buf,       const unsigned char *d, int *off, bool convert);
-void serial_restore_char     (char **c,                 const unsigned char *d, int *off, bool convert);
-void serial_restore_envelope (struct Envelope *e,       const unsigned char *d, int *off, bool convert);
-void serial_restore_int      (unsigned int *i,          const unsigned char *d, int *off);
-void serial_restore_uint32_t (uint32_t *s,              const unsigned char *d, int *off);
-void serial_restore_parameter(struct ParameterList *pl, const unsigned char *d, int *off, bool convert);
-void serial_restore_stailq   (struct ListHead *l,       const unsigned char *d, int *off, bool convert);
+#define SERIAL_NO_FLAGS  0         ///< No flags are set
+#define SERIAL_NON_ASCII (1 << 0)  ///< Some of the strings aren't plain ASCII
 
-void lazy_realloc(void *ptr, size_t size);
+void *        serial_dump_email   (const struct Email *e, size_t hlen, bool convert, size_t *dlen);
+struct Email *serial_restore_email(const unsigned char *d, size_t dlen, bool convert, bool shallow);
 
 #endif /* MUTT_HCACHE_SERIALIZE_H */
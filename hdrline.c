@@ -191,8 +191,9 @@ static const char *make_from_prefix(enum FieldType disp)
     [DISP_FROM] = "",  [DISP_PLAIN] = "",
   };
 
+  static struct ConfigHandle h_from_chars = { "from_chars" };
   const struct MbTable *c_from_chars =
-      cs_subset_mbtable(NeoMutt->sub, "from_chars");
+      cs_handle_mbtable(NeoMutt->sub, &h_from_chars);
 
   if (!c_from_chars || !c_from_chars->chars || (c_from_chars->len == 0))
     return long_prefixes[disp];
@@ -446,7 +447,8 @@ static const char *index_format_str(char *buf, size_t buflen, size_t col, int co
   char fmt[128], tmp[1024];
   char *p = NULL, *tags = NULL;
   bool optional = (flags & MUTT_FORMAT_OPTIONAL);
-  const short c_sort = cs_subset_sort(NeoMutt->sub, "sort");
+  static struct ConfigHandle h_sort = { "sort" };
+  const short c_sort = cs_handle_sort(NeoMutt->sub, &h_sort);
   int threads = ((c_sort & SORT_MASK) == SORT_THREADS);
   int is_index = (flags & MUTT_FORMAT_INDEX);
   size_t colorlen;
@@ -463,14 +465,18 @@ static const char *index_format_str(char *buf, size_t buflen, size_t col, int co
   const struct Address *to = TAILQ_FIRST(&e->env->to);
   const struct Address *cc = TAILQ_FIRST(&e->env->cc);
 
+  static struct ConfigHandle h_crypt_chars = { "crypt_chars" };
   const struct MbTable *c_crypt_chars =
-      cs_subset_mbtable(NeoMutt->sub, "crypt_chars");
+      cs_handle_mbtable(NeoMutt->sub, &h_crypt_chars);
+  static struct ConfigHandle h_flag_chars = { "flag_chars" };
   const struct MbTable *c_flag_chars =
-      cs_subset_mbtable(NeoMutt->sub, "flag_chars");
+      cs_handle_mbtable(NeoMutt->sub, &h_flag_chars);
+  static struct ConfigHandle h_to_chars = { "to_chars" };
   const struct MbTable *c_to_chars =
-      cs_subset_mbtable(NeoMutt->sub, "to_chars");
+      cs_handle_mbtable(NeoMutt->sub, &h_to_chars);
+  static struct ConfigHandle h_date_format = { "date_format" };
   const char *const c_date_format =
-      cs_subset_string(NeoMutt->sub, "date_format");
+      cs_handle_string(NeoMutt->sub, &h_date_format);
 
   buf[0] = '\0';
   switch (op)
@@ -991,8 +997,9 @@ static const char *index_format_str(char *buf, size_t buflen, size_t col, int co
       if (!optional)
       {
         make_from_addr(e->env, tmp, sizeof(tmp), true);
+        static struct ConfigHandle h_save_address = { "save_address" };
         const bool c_save_address =
-            cs_subset_bool(NeoMutt->sub, "save_address");
+            cs_handle_bool(NeoMutt->sub, &h_save_address);
         if (!c_save_address && (p = strpbrk(tmp, "%@")))
           *p = '\0';
         mutt_format_s(buf, buflen, prec, tmp);
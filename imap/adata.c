@@ -53,6 +53,7 @@ void imap_adata_free(void **ptr)
   {
     if (adata->conn->close)
       adata->conn->close(adata->conn);
+    FREE(&adata->conn->inbuf);
     FREE(&adata->conn);
   }
 
@@ -73,6 +74,7 @@ struct ImapAccountData *imap_adata_new(struct Account *a)
   adata->seqid = new_seqid;
   const short c_imap_pipeline_depth =
       cs_subset_number(NeoMutt->sub, "imap_pipeline_depth");
+  imap_pipeline_reset(adata);
   adata->cmdslots = c_imap_pipeline_depth + 2;
   adata->cmds = mutt_mem_calloc(adata->cmdslots, sizeof(*adata->cmds));
 
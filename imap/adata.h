@@ -72,6 +72,13 @@ struct ImapAccountData
   int lastcmd;
   struct Buffer cmdbuf;
 
+  /* adaptive pipeline, see cmd_adapt_depth() */
+  int pipeline_depth; ///< Number of commands that may be queued up
+  int pipeline_max;   ///< Maximum pipeline depth, 0 if it's fixed
+  uint64_t rtt_min;   ///< Fastest command round trip, in microseconds
+  uint64_t rtt_avg;   ///< Smoothed command round trip, in microseconds
+  uint64_t throttled; ///< When the server last throttled us, in microseconds
+
   char delim;
   struct Mailbox *mailbox;      ///< Current selected mailbox
   struct Mailbox *prev_mailbox; ///< Previously selected mailbox
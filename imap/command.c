@@ -81,9 +81,20 @@ static const char *const Capabilities[] = {
   "LIST-EXTENDED",
   "COMPRESS=DEFLATE",
   "X-GM-EXT-1",
+  "ESEARCH",
   NULL,
 };
 
+/**
+ * cmd_queue_count - How many IMAP commands are waiting for a response?
+ * @param adata Imap Account data
+ * @retval num Number of commands, sent or unsent
+ */
+static int cmd_queue_count(struct ImapAccountData *adata)
+{
+  return (adata->nextcmd - adata->lastcmd + adata->cmdslots) % adata->cmdslots;
+}
+
 /**
  * cmd_queue_full - Is the IMAP command queue full?
  * @param adata Imap Account data
@@ -91,10 +102,51 @@ static const char *const Capabilities[] = {
  */
 static bool cmd_queue_full(struct ImapAccountData *adata)
 {
-  if (((adata->nextcmd + 1) % adata->cmdslots) == adata->lastcmd)
-    return true;
+  return cmd_queue_count(adata) > adata->pipeline_depth;
+}
+
+/**
+ * cmd_queue_grow - Make room in the command queue for a deeper pipeline
+ * @param adata Imap Account data
+ *
+ * The commands are copied, in order, to the start of the new queue.
+ */
+static void cmd_queue_grow(struct ImapAccountData *adata)
+{
+  const int count = cmd_queue_count(adata);
+  const int slots = MAX(adata->cmdslots * 2, adata->pipeline_depth + 2);
+
+  struct ImapCommand *cmds = mutt_mem_calloc(slots, sizeof(*cmds));
+  for (int i = 0; i < count; i++)
+    cmds[i] = adata->cmds[(adata->lastcmd + i) % adata->cmdslots];
+
+  FREE(&adata->cmds);
+  adata->cmds = cmds;
+  adata->cmdslots = slots;
+  adata->lastcmd = 0;
+  adata->nextcmd = count;
+  mutt_debug(LL_DEBUG3, "IMAP command queue has %d slots\n", slots);
+}
+
+/**
+ * cmd_adapt_depth - Adjust the pipeline depth after a command completes
+ * @param adata Imap Account data
+ * @param cmd   Command that has just completed
+ * @param count Number of commands that were waiting, including this one
+ *
+ * See imap_pipeline_adapt()
+ */
+static void cmd_adapt_depth(struct ImapAccountData *adata, struct ImapCommand *cmd, int count)
+{
+  if ((adata->pipeline_max == 0) || (cmd->sent == 0))
+    return;
 
-  return false;
+  const char *trailer = imap_cmd_trailer(adata);
+  const bool throttled = (cmd->state != IMAP_RES_OK) &&
+                         (mutt_istr_startswith(trailer, "[THROTTLED]") ||
+                          mutt_istr_startswith(trailer, "[LIMIT]"));
+
+  imap_pipeline_adapt(adata, cmd->sent, mutt_date_epoch_us(), count, throttled);
 }
 
 /**
@@ -113,6 +165,10 @@ static struct ImapCommand *cmd_new(struct ImapAccountData *adata)
     return NULL;
   }
 
+  /* the pipeline may have grown beyond the queue */
+  if (cmd_queue_count(adata) >= (adata->cmdslots - 1))
+    cmd_queue_grow(adata);
+
   cmd = adata->cmds + adata->nextcmd;
   adata->nextcmd = (adata->nextcmd + 1) % adata->cmdslots;
 
@@ -121,10 +177,16 @@ static struct ImapCommand *cmd_new(struct ImapAccountData *adata)
     adata->seqno = 0;
 
   cmd->state = IMAP_RES_NEW;
+  cmd->sent = 0;
 
   return cmd;
 }
 
+// fwd decl, mutually recursive: cmd_queue, cmd_start, cmd_wait
+static void cmd_handle_fatal(struct ImapAccountData *adata);
+static int cmd_start(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags flags);
+static int cmd_wait(struct ImapAccountData *adata, ImapCmdFlags flags, bool room);
+
 /**
  * cmd_queue - Add a IMAP command to the queue
  * @param adata Imap Account data
@@ -133,15 +195,26 @@ static struct ImapCommand *cmd_new(struct ImapAccountData *adata)
  * @retval  0 Success
  * @retval <0 Failure, e.g. #IMAP_RES_BAD
  *
- * If the queue is full, attempts to drain it.
+ * If the queue is full, the queued commands are sent and we wait for the
+ * first one to complete.  This way, a long run of commands streams through
+ * the pipeline, rather than stalling each time it fills.
  */
 static int cmd_queue(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags flags)
 {
   if (cmd_queue_full(adata))
   {
-    mutt_debug(LL_DEBUG3, "Draining IMAP command pipeline\n");
+    mutt_debug(LL_DEBUG3, "Waiting for the IMAP command pipeline\n");
 
-    const int rc = imap_exec(adata, NULL, flags & IMAP_CMD_POLL);
+    int rc;
+    if (!mutt_buffer_is_empty(&adata->cmdbuf) && (cmd_start(adata, NULL, flags & IMAP_CMD_POLL) < 0))
+    {
+      cmd_handle_fatal(adata);
+      rc = IMAP_EXEC_FATAL;
+    }
+    else
+    {
+      rc = cmd_wait(adata, flags & IMAP_CMD_POLL, true);
+    }
 
     if (rc == IMAP_EXEC_ERROR)
       return IMAP_RES_BAD;
@@ -220,6 +293,17 @@ static int cmd_start(struct ImapAccountData *adata, const char *cmdstr, ImapCmdF
                           (flags & IMAP_CMD_PASS) ? IMAP_LOG_PASS : IMAP_LOG_CMD);
   mutt_buffer_reset(&adata->cmdbuf);
 
+  /* note when the commands were sent, to measure the server's response time */
+  if (adata->pipeline_max > 0)
+  {
+    const uint64_t now = mutt_date_epoch_us();
+    for (int c = adata->lastcmd; c != adata->nextcmd; c = (c + 1) % adata->cmdslots)
+    {
+      if (adata->cmds[c].sent == 0)
+        adata->cmds[c].sent = now;
+    }
+  }
+
   /* unidle when command queue is flushed */
   if (adata->state == IMAP_IDLE)
     adata->state = IMAP_SELECTED;
@@ -426,6 +510,8 @@ static void cmd_parse_fetch(struct ImapAccountData *adata, char *s)
   }
 
   mutt_debug(LL_DEBUG2, "Message UID %u updated\n", imap_edata_get(e)->uid);
+  /* the flags may have changed, so the old search results can't be trusted */
+  mdata->search_gen++;
   /* skip FETCH */
   s = imap_next_word(s);
   s = imap_next_word(s);
@@ -973,6 +1059,7 @@ static void cmd_parse_exists(struct ImapAccountData *adata, const char *pn)
   else
   {
     mutt_debug(LL_DEBUG2, "New mail in %s - %d messages total\n", mdata->name, count);
+    mdata->search_gen++;
     mdata->reopen |= IMAP_NEWMAIL_PENDING;
     mdata->new_mail_count = count;
   }
@@ -1020,6 +1107,8 @@ static int cmd_handle_untagged(struct ImapAccountData *adata)
     cmd_parse_lsub(adata, s);
   else if (mutt_istr_startswith(s, "MYRIGHTS"))
     cmd_parse_myrights(adata, s);
+  else if (mutt_istr_startswith(s, "ESEARCH"))
+    cmd_parse_esearch(adata, s);
   else if (mutt_istr_startswith(s, "SEARCH"))
     cmd_parse_search(adata, s);
   else if (mutt_istr_startswith(s, "STATUS"))
@@ -1067,6 +1156,16 @@ int imap_cmd_start(struct ImapAccountData *adata, const char *cmdstr)
   return cmd_start(adata, cmdstr, IMAP_CMD_NO_FLAGS);
 }
 
+/**
+ * imap_cmd_queue_full - Is the IMAP command queue full?
+ * @param adata Imap Account data
+ * @retval true Queuing another command will wait for the server
+ */
+bool imap_cmd_queue_full(struct ImapAccountData *adata)
+{
+  return cmd_queue_full(adata);
+}
+
 /**
  * imap_cmd_step - Reads server responses from an IMAP command
  * @param adata Imap Account data
@@ -1081,7 +1180,6 @@ int imap_cmd_step(struct ImapAccountData *adata)
   if (!adata)
     return -1;
 
-  size_t len = 0;
   int c;
   int rc;
   int stillrunning = 0;
@@ -1093,42 +1191,24 @@ int imap_cmd_step(struct ImapAccountData *adata)
     return IMAP_RES_BAD;
   }
 
-  /* read into buffer, expanding buffer as necessary until we have a full
-   * line */
-  do
+  char *line = NULL;
+  const int len = mutt_socket_readln_span(adata->conn, &line, MUTT_SOCK_LOG_FULL);
+  if (len < 0)
   {
-    if (len == adata->blen)
-    {
-      mutt_mem_realloc(&adata->buf, adata->blen + IMAP_CMD_BUFSIZE);
-      adata->blen = adata->blen + IMAP_CMD_BUFSIZE;
-      mutt_debug(LL_DEBUG3, "grew buffer to %lu bytes\n", adata->blen);
-    }
-
-    /* back up over '\0' */
-    if (len)
-      len--;
-    c = mutt_socket_readln_d(adata->buf + len, adata->blen - len, adata->conn, MUTT_SOCK_LOG_FULL);
-    if (c <= 0)
-    {
-      mutt_debug(LL_DEBUG1, "Error reading server response\n");
-      cmd_handle_fatal(adata);
-      return IMAP_RES_BAD;
-    }
-
-    len += c;
+    mutt_debug(LL_DEBUG1, "Error reading server response\n");
+    cmd_handle_fatal(adata);
+    return IMAP_RES_BAD;
   }
-  /* if we've read all the way to the end of the buffer, we haven't read a
-   * full line (mutt_socket_readln strips the \r, so we always have at least
-   * one character free when we've read a full line) */
-  while (len == adata->blen);
 
-  /* don't let one large string make cmd->buf hog memory forever */
-  if ((adata->blen > IMAP_CMD_BUFSIZE) && (len <= IMAP_CMD_BUFSIZE))
+  /* make room for the line, but don't let one large string make cmd->buf hog
+   * memory forever */
+  if (((size_t) len >= adata->blen) || ((adata->blen > IMAP_CMD_BUFSIZE) && (len < IMAP_CMD_BUFSIZE)))
   {
-    mutt_mem_realloc(&adata->buf, IMAP_CMD_BUFSIZE);
-    adata->blen = IMAP_CMD_BUFSIZE;
-    mutt_debug(LL_DEBUG3, "shrank buffer to %lu bytes\n", adata->blen);
+    adata->blen = ((len / IMAP_CMD_BUFSIZE) + 1) * IMAP_CMD_BUFSIZE;
+    mutt_mem_realloc(&adata->buf, adata->blen);
+    mutt_debug(LL_DEBUG3, "resized buffer to %lu bytes\n", adata->blen);
   }
+  memcpy(adata->buf, line, len + 1);
 
   adata->lastread = mutt_date_epoch();
 
@@ -1155,6 +1235,7 @@ int imap_cmd_step(struct ImapAccountData *adata)
    *
    * For both these cases, we default to returning OK */
   rc = IMAP_RES_OK;
+  const int count = cmd_queue_count(adata);
   c = adata->lastcmd;
   do
   {
@@ -1170,6 +1251,7 @@ int imap_cmd_step(struct ImapAccountData *adata)
         }
         cmd->state = cmd_status(adata->buf);
         rc = cmd->state;
+        cmd_adapt_depth(adata, cmd, count);
         if (cmd->state == IMAP_RES_NO || cmd->state == IMAP_RES_BAD)
         {
           mutt_message(_("IMAP command failed: %s"), adata->buf);
@@ -1268,6 +1350,22 @@ int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags fl
   if (flags & IMAP_CMD_QUEUE)
     return IMAP_EXEC_SUCCESS;
 
+  return imap_exec_wait(adata, flags);
+}
+
+/**
+ * cmd_wait - Wait for the responses to the commands that have been sent
+ * @param adata Imap Account data
+ * @param flags Flags, see #ImapCmdFlags
+ * @param room  Stop waiting once there's room in the command queue
+ * @retval #IMAP_EXEC_SUCCESS Commands successful
+ * @retval #IMAP_EXEC_ERROR   A command returned an error
+ * @retval #IMAP_EXEC_FATAL   Imap connection failure
+ */
+static int cmd_wait(struct ImapAccountData *adata, ImapCmdFlags flags, bool room)
+{
+  int rc;
+
   const short c_imap_poll_timeout =
       cs_subset_number(NeoMutt->sub, "imap_poll_timeout");
   if ((flags & IMAP_CMD_POLL) && (c_imap_poll_timeout > 0) &&
@@ -1286,6 +1384,12 @@ int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags fl
     // The queue is empty, so the single command has been processed
     if ((flags & IMAP_CMD_SINGLE) && (adata->nextcmd == adata->lastcmd))
       break;
+    // A command has completed, so another one can be queued
+    if (room && (rc == IMAP_RES_CONTINUE) && !cmd_queue_full(adata))
+    {
+      rc = IMAP_RES_OK;
+      break;
+    }
   } while (rc == IMAP_RES_CONTINUE);
   mutt_sig_allow_interrupt(false);
 
@@ -1303,6 +1407,22 @@ int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags fl
   return IMAP_EXEC_SUCCESS;
 }
 
+/**
+ * imap_exec_wait - Wait for the responses to the commands that have been sent
+ * @param adata Imap Account data
+ * @param flags Flags, see #ImapCmdFlags
+ * @retval #IMAP_EXEC_SUCCESS Commands successful
+ * @retval #IMAP_EXEC_ERROR   A command returned an error
+ * @retval #IMAP_EXEC_FATAL   Imap connection failure
+ *
+ * This lets the caller send commands to several servers, using
+ * imap_cmd_start(), before waiting for any of them.
+ */
+int imap_exec_wait(struct ImapAccountData *adata, ImapCmdFlags flags)
+{
+  return cmd_wait(adata, flags, false);
+}
+
 /**
  * imap_cmd_finish - Attempt to perform cleanup
  * @param adata Imap Account data
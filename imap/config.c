@@ -84,6 +84,9 @@ static struct ConfigDef ImapVars[] = {
   { "imap_fetch_chunk_size", DT_LONG|DT_NOT_NEGATIVE, 0, 0, NULL,
     "(imap) Download headers in blocks of this size"
   },
+  { "imap_fetch_connections", DT_NUMBER|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "(imap) Number of extra connections used to download new headers"
+  },
   { "imap_headers", DT_STRING|R_INDEX, 0, 0, NULL,
     "(imap) Additional email headers to download when getting index"
   },
@@ -102,6 +105,9 @@ static struct ConfigDef ImapVars[] = {
   { "imap_pipeline_depth", DT_NUMBER|DT_NOT_NEGATIVE, 15, 0, NULL,
     "(imap) Number of IMAP commands that may be queued up"
   },
+  { "imap_pipeline_max", DT_NUMBER|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "(imap) Maximum depth of an adaptive IMAP pipeline"
+  },
   { "imap_rfc5161", DT_BOOL, true, 0, NULL,
     "(imap) Use the IMAP ENABLE extension to select capabilities"
   },
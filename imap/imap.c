@@ -65,6 +65,9 @@
 #ifdef ENABLE_NLS
 #include <libintl.h>
 #endif
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#endif
 
 struct Progress;
 struct stat;
@@ -532,7 +535,7 @@ int imap_delete_mailbox(struct Mailbox *m, char *path)
  * imap_logout - Gracefully log out of server
  * @param adata Imap Account data
  */
-static void imap_logout(struct ImapAccountData *adata)
+void imap_logout(struct ImapAccountData *adata)
 {
   /* we set status here to let imap_handle_untagged know we _expect_ to
    * receive a bye response (so it doesn't freak out and close the conn) */
@@ -591,7 +594,7 @@ void imap_logout_all(void)
  * @retval  0 Success
  * @retval -1 Failure
  *
- * Not explicitly buffered, relies on FILE buffering.
+ * The data is taken straight from the Connection's buffer.
  *
  * @note Strips `\r` from `\r\n`.
  *       Apparently even literals use `\r\n`-terminated strings ?!
@@ -599,7 +602,6 @@ void imap_logout_all(void)
 int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
                       unsigned long bytes, struct Progress *pbar)
 {
-  char c;
   bool r = false;
   struct Buffer buf = { 0 }; // Do not allocate, maybe it won't be used
 
@@ -609,9 +611,11 @@ int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
 
   mutt_debug(LL_DEBUG2, "reading %ld bytes\n", bytes);
 
-  for (unsigned long pos = 0; pos < bytes; pos++)
+  for (unsigned long pos = 0; pos < bytes;)
   {
-    if (mutt_socket_readchar(adata->conn, &c) != 1)
+    char *span = NULL;
+    const int len = mutt_socket_read_span(adata->conn, &span, bytes - pos);
+    if (len < 0)
     {
       mutt_debug(LL_DEBUG1, "error during read, %ld bytes read\n", pos);
       adata->status = IMAP_FATAL;
@@ -620,23 +624,32 @@ int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
       return -1;
     }
 
-    if (r && (c != '\n'))
-      fputc('\r', fp);
+    if (c_debug_level >= IMAP_LOG_LTRL)
+      mutt_buffer_addstr_n(&buf, span, len);
 
-    if (c == '\r')
+    /* copy runs of data between the \r's */
+    const char *end = span + len;
+    for (const char *p = span; p < end;)
     {
-      r = true;
-      continue;
-    }
-    else
+      if (r && (*p != '\n'))
+        fputc('\r', fp);
       r = false;
 
-    fputc(c, fp);
+      const char *cr = memchr(p, '\r', end - p);
+      if (!cr)
+      {
+        fwrite(p, 1, end - p, fp);
+        break;
+      }
+
+      fwrite(p, 1, cr - p, fp);
+      r = true;
+      p = cr + 1;
+    }
 
-    if (pbar && !(pos % 1024))
+    pos += len;
+    if (pbar)
       progress_update(pbar, pos, -1);
-    if (c_debug_level >= IMAP_LOG_LTRL)
-      mutt_buffer_addch(&buf, c);
   }
 
   if (c_debug_level >= IMAP_LOG_LTRL)
@@ -683,6 +696,7 @@ void imap_expunge_mailbox(struct Mailbox *m)
 
 #ifdef USE_HCACHE
   imap_hcache_open(adata, mdata);
+  mutt_hcache_begin(mdata->hcache);
 #endif
 
   for (int i = 0; i < m->msg_count; i++)
@@ -728,6 +742,7 @@ void imap_expunge_mailbox(struct Mailbox *m)
   }
 
 #ifdef USE_HCACHE
+  mutt_hcache_commit(mdata->hcache);
   imap_hcache_close(mdata);
 #endif
 
@@ -861,6 +876,7 @@ void imap_close_connection(struct ImapAccountData *adata)
   adata->lastcmd = 0;
   adata->status = 0;
   memset(adata->cmds, 0, sizeof(struct ImapCommand) * adata->cmdslots);
+  imap_pipeline_reset(adata);
 }
 
 /**
@@ -1018,6 +1034,7 @@ int imap_sync_message_for_copy(struct Mailbox *m, struct Email *e,
     return 0;
   }
 
+  imap_mdata_get(m)->search_gen++;
   snprintf(uid, sizeof(uid), "%u", imap_edata_get(e)->uid);
   mutt_buffer_reset(cmd);
   mutt_buffer_addstr(cmd, "UID STORE ");
@@ -1275,6 +1292,81 @@ int imap_mailbox_status(struct Mailbox *m, bool queue)
   return imap_status(adata, mdata, queue);
 }
 
+/**
+ * imap_mailbox_status_many - Refresh the statistics of many Mailboxes at once
+ * @param[in]  mailboxes Mailboxes to check
+ * @param[in]  num       Number of Mailboxes
+ * @param[out] status    Result for each Mailbox, e.g. #MX_STATUS_NEW_MAIL
+ *
+ * The STATUS commands are sent to every Account before waiting for any of the
+ * replies, so a check takes as long as the slowest server, not the sum of
+ * them all.  If an Account has more Mailboxes than its command queue can hold,
+ * this is repeated until they have all been checked.
+ */
+void imap_mailbox_status_many(struct Mailbox **mailboxes, size_t num, enum MxStatus *status)
+{
+  if (!mailboxes || !status || (num == 0))
+    return;
+
+  bool *queued = mutt_mem_calloc(num, sizeof(bool));
+  struct ImapAccountData **busy = mutt_mem_calloc(num, sizeof(struct ImapAccountData *));
+  size_t remaining = num;
+
+  while (remaining > 0)
+  {
+    size_t num_busy = 0;
+    for (size_t i = 0; i < num; i++)
+    {
+      if (queued[i])
+        continue;
+
+      struct ImapAccountData *adata = imap_adata_get(mailboxes[i]);
+      size_t j = 0;
+      while ((j < num_busy) && (busy[j] != adata))
+        j++;
+
+      /* Leave it for the next round, rather than waiting for this server now */
+      if (adata && (j < num_busy) && imap_cmd_queue_full(adata))
+        continue;
+
+      queued[i] = true;
+      remaining--;
+
+      const int nextcmd = adata ? adata->nextcmd : 0;
+      if (imap_mailbox_status(mailboxes[i], true) < 0)
+      {
+        status[i] = MX_STATUS_ERROR;
+        continue;
+      }
+      status[i] = MX_STATUS_OK;
+
+      if (adata && (j == num_busy) && (adata->nextcmd != nextcmd))
+        busy[num_busy++] = adata;
+    }
+
+    for (size_t j = 0; j < num_busy; j++)
+    {
+      if (imap_cmd_start(busy[j], NULL) < 0)
+        busy[j] = NULL;
+    }
+
+    for (size_t j = 0; j < num_busy; j++)
+    {
+      if (busy[j] && (busy[j]->nextcmd != busy[j]->lastcmd))
+        imap_exec_wait(busy[j], IMAP_CMD_POLL);
+    }
+  }
+
+  for (size_t i = 0; i < num; i++)
+  {
+    if (status[i] != MX_STATUS_ERROR)
+      status[i] = mailboxes[i]->has_new ? MX_STATUS_NEW_MAIL : MX_STATUS_OK;
+  }
+
+  FREE(&busy);
+  FREE(&queued);
+}
+
 /**
  * imap_subscribe - Subscribe to a mailbox
  * @param path      Mailbox path
@@ -1555,6 +1647,9 @@ enum MxStatus imap_sync_mailbox(struct Mailbox *m, bool expunge, bool close)
   if (check == MX_STATUS_ERROR)
     return check;
 
+  /* the flags on the server are about to change */
+  mdata->search_gen++;
+
   /* if we are expunging anyway, we can do deleted messages very quickly... */
   if (expunge && (m->rights & MUTT_ACL_DELETE))
   {
@@ -1589,6 +1684,7 @@ enum MxStatus imap_sync_mailbox(struct Mailbox *m, bool expunge, bool close)
 
 #ifdef USE_HCACHE
   imap_hcache_open(adata, mdata);
+  mutt_hcache_begin(mdata->hcache);
 #endif
 
   /* save messages with real (non-flag) changes */
@@ -1636,6 +1732,7 @@ enum MxStatus imap_sync_mailbox(struct Mailbox *m, bool expunge, bool close)
   }
 
 #ifdef USE_HCACHE
+  mutt_hcache_commit(mdata->hcache);
   imap_hcache_close(mdata);
 #endif
 
@@ -2346,6 +2443,7 @@ static int imap_tags_commit(struct Mailbox *m, struct Email *e, char *buf)
   if (!(adata->mailbox->rights & MUTT_ACL_WRITE))
     return 0;
 
+  imap_mdata_get(m)->search_gen++;
   snprintf(uid, sizeof(uid), "%u", imap_edata_get(e)->uid);
 
   /* Remove old custom flags */
@@ -2503,6 +2601,7 @@ struct MxOps MxImapOps = {
   .msg_commit       = imap_msg_commit,
   .msg_close        = imap_msg_close,
   .msg_padding_size = NULL,
+  .msg_prefetch     = imap_msg_prefetch,
   .msg_save_hcache  = imap_msg_save_hcache,
   .tags_edit        = imap_tags_edit,
   .tags_commit      = imap_tags_commit,
@@ -46,6 +46,7 @@
  * | imap/mdata.c      | @subpage imap_mdata      |
  * | imap/message.c    | @subpage imap_message    |
  * | imap/msn.c        | @subpage imap_msn        |
+ * | imap/pipeline.c   | @subpage imap_pipeline   |
  * | imap/search.c     | @subpage imap_search     |
  * | imap/utf7.c       | @subpage imap_utf7       |
  * | imap/util.c       | @subpage imap_util       |
@@ -77,6 +78,7 @@ int imap_delete_mailbox(struct Mailbox *m, char *path);
 int imap_sync_mailbox(struct Mailbox *m, bool expunge, bool close);
 int imap_path_status(const char *path, bool queue);
 int imap_mailbox_status(struct Mailbox *m, bool queue);
+void imap_mailbox_status_many(struct Mailbox **mailboxes, size_t num, enum MxStatus *status);
 int imap_subscribe(char *path, bool subscribe);
 int imap_complete(char *buf, size_t buflen, const char *path);
 int imap_fast_trash(struct Mailbox *m, const char *dest);
@@ -110,6 +112,6 @@ void imap_get_parent_path(const char *path, char *buf, size_t buflen);
 void imap_clean_path(char *path, size_t plen);
 
 /* search.c */
-bool imap_search(struct Mailbox *m, const struct PatternList *pat);
+bool imap_search(struct Mailbox *m, struct PatternList *pat);
 
 #endif /* MUTT_IMAP_LIB_H */
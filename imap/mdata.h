@@ -30,6 +30,19 @@
 struct Mailbox;
 struct ImapAccountData;
 
+ARRAY_HEAD(ImapUidArray, unsigned int);
+
+/**
+ * struct ImapSearchCache - A server-side search and its results
+ */
+struct ImapSearchCache
+{
+  char *query;                ///< IMAP SEARCH criteria
+  unsigned int gen;           ///< ImapMboxData::search_gen when the search was run
+  struct ImapUidArray uids;   ///< UIDs of the matching Emails
+};
+ARRAY_HEAD(ImapSearchCacheArray, struct ImapSearchCache);
+
 /**
  * struct ImapMboxData - IMAP-specific Mailbox data - @extends Mailbox
  *
@@ -58,6 +71,9 @@ struct ImapMboxData
   struct HashTable *uid_hash;
   ARRAY_HEAD(MSN, struct Email *) msn; ///< look up headers by (MSN-1)
   struct BodyCache *bcache;
+  struct ImapSearchCacheArray search_cache; ///< Recent searches, most recent last
+  struct ImapUidArray *search_uids;         ///< Results of the running search
+  unsigned int search_gen;                  ///< Changes whenever cached searches become stale
 
   struct HeaderCache *hcache;
 };
@@ -70,6 +70,14 @@
 
 struct BodyCache;
 
+#ifdef USE_HCACHE
+/// Number of messages to look up in the header cache at once
+#define IMAP_HCACHE_BATCH 256
+#endif
+
+/// Fewest headers that each connection must fetch, before extra ones are opened
+#define IMAP_FETCH_CONN_MIN 200
+
 /**
  * msg_cache_open - Open a message cache
  * @param m     Selected Imap Mailbox
@@ -392,22 +400,21 @@ static int msg_parse_fetch(struct ImapHeader *h, char *s)
 
 /**
  * msg_fetch_header - import IMAP FETCH response into an ImapHeader
- * @param m   Mailbox
- * @param ih  ImapHeader
- * @param buf Server string containing FETCH response
- * @param fp  Connection to server
+ * @param adata Imap Account data
+ * @param ih    ImapHeader
+ * @param buf   Server string containing FETCH response
+ * @param fp    Connection to server
  * @retval  0 Success
  * @retval -1 String is not a fetch response
  * @retval -2 String is a corrupt fetch response
  *
  * Expects string beginning with * n FETCH.
  */
-static int msg_fetch_header(struct Mailbox *m, struct ImapHeader *ih, char *buf, FILE *fp)
+static int msg_fetch_header(struct ImapAccountData *adata, struct ImapHeader *ih,
+                            char *buf, FILE *fp)
 {
   int rc = -1; /* default now is that string isn't FETCH response */
 
-  struct ImapAccountData *adata = imap_adata_get(m);
-
   if (buf[0] != '*')
     return rc;
 
@@ -510,7 +517,7 @@ static void imap_alloc_uid_hash(struct ImapAccountData *adata, unsigned int msn_
 {
   struct ImapMboxData *mdata = adata->mailbox->mdata;
   if (!mdata->uid_hash)
-    mdata->uid_hash = mutt_hash_int_new(MAX(6 * msn_count / 5, 30), MUTT_HASH_NO_FLAGS);
+    mdata->uid_hash = mutt_hash_int_new(MAX(6 * msn_count / 5, 30), MUTT_HASH_OPEN_ADDR);
 }
 
 /**
@@ -640,6 +647,93 @@ static void set_changed_flag(struct Mailbox *m, struct Email *e, int local_chang
 }
 
 #ifdef USE_HCACHE
+/**
+ * read_headers_normal_eval_batch - Match a batch of messages with the header cache
+ * @param m                  Imap Selected Mailbox
+ * @param pending            Email data from the server
+ * @param num                Number of Email data
+ * @param store_flag_updates if true, save flags to the header cache
+ * @param eval_condstore     if true, use CONDSTORE to fetch flags
+ *
+ * The Email data is consumed: it's either attached to a cached Email, or freed.
+ */
+static void read_headers_normal_eval_batch(struct Mailbox *m, struct ImapEmailData **pending,
+                                           size_t num, bool store_flag_updates,
+                                           bool eval_condstore)
+{
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  unsigned int uids[IMAP_HCACHE_BATCH];
+  struct Email *emails[IMAP_HCACHE_BATCH];
+
+  for (size_t i = 0; i < num; i++)
+    uids[i] = pending[i]->uid;
+
+  imap_hcache_get_many(mdata, uids, num, emails);
+
+  for (size_t i = 0; i < num; i++)
+  {
+    struct ImapEmailData *edata = pending[i];
+    struct Email *e = emails[i];
+    if (!e)
+    {
+      imap_edata_free((void **) &edata);
+      continue;
+    }
+
+    if (imap_msn_get(&mdata->msn, edata->msn - 1))
+    {
+      mutt_debug(LL_DEBUG2, "skipping hcache FETCH for duplicate message %d\n", edata->msn);
+      email_free(&e);
+      imap_edata_free((void **) &edata);
+      continue;
+    }
+
+    m->emails[m->msg_count] = e;
+    imap_msn_set(&mdata->msn, edata->msn - 1, e);
+    mutt_hash_int_insert(mdata->uid_hash, edata->uid, e);
+
+    e->index = edata->uid;
+    /* messages which have not been expunged are ACTIVE (borrowed from mh
+     * folders) */
+    e->active = true;
+    e->changed = false;
+    if (eval_condstore)
+    {
+      edata->read = e->read;
+      edata->old = e->old;
+      edata->deleted = e->deleted;
+      edata->flagged = e->flagged;
+      edata->replied = e->replied;
+    }
+    else
+    {
+      e->read = edata->read;
+      e->old = edata->old;
+      e->deleted = edata->deleted;
+      e->flagged = edata->flagged;
+      e->replied = edata->replied;
+    }
+
+    /*  mailbox->emails[msgno]->received is restored from mutt_hcache_restore */
+    e->edata = edata;
+    e->edata_free = imap_edata_free;
+    STAILQ_INIT(&e->tags);
+
+    /* We take a copy of the tags so we can split the string */
+    char *tags_copy = mutt_str_dup(edata->flags_remote);
+    driver_tags_replace(&e->tags, tags_copy);
+    FREE(&tags_copy);
+
+    m->msg_count++;
+    mailbox_size_add(m, e);
+
+    /* If this is the first time we are fetching, we need to
+     * store the current state of flags back into the header cache */
+    if (!eval_condstore && store_flag_updates)
+      imap_hcache_put(mdata, e);
+  }
+}
+
 /**
  * read_headers_normal_eval_cache - Retrieve data from the header cache
  * @param adata              Imap Account data
@@ -667,7 +761,8 @@ static int read_headers_normal_eval_cache(struct ImapAccountData *adata,
 
   struct Mailbox *m = adata->mailbox;
   struct ImapMboxData *mdata = imap_mdata_get(m);
-  int idx = m->msg_count;
+  struct ImapEmailData *pending[IMAP_HCACHE_BATCH];
+  size_t num_pending = 0;
 
   if (m->verbose)
   {
@@ -702,7 +797,7 @@ static int read_headers_normal_eval_cache(struct ImapAccountData *adata,
       if (rc != IMAP_RES_CONTINUE)
         break;
 
-      mfhrc = msg_fetch_header(m, &h, adata->buf, NULL);
+      mfhrc = msg_fetch_header(adata, &h, adata->buf, NULL);
       if (mfhrc < 0)
         continue;
 
@@ -727,66 +822,27 @@ static int read_headers_normal_eval_cache(struct ImapAccountData *adata,
         continue;
       }
 
-      struct Email *e = imap_hcache_get(mdata, h.edata->uid);
-      m->emails[idx] = e;
-      if (e)
-      {
-        imap_msn_set(&mdata->msn, h.edata->msn - 1, e);
-        mutt_hash_int_insert(mdata->uid_hash, h.edata->uid, e);
-
-        e->index = h.edata->uid;
-        /* messages which have not been expunged are ACTIVE (borrowed from mh
-         * folders) */
-        e->active = true;
-        e->changed = false;
-        if (eval_condstore)
-        {
-          h.edata->read = e->read;
-          h.edata->old = e->old;
-          h.edata->deleted = e->deleted;
-          h.edata->flagged = e->flagged;
-          h.edata->replied = e->replied;
-        }
-        else
-        {
-          e->read = h.edata->read;
-          e->old = h.edata->old;
-          e->deleted = h.edata->deleted;
-          e->flagged = h.edata->flagged;
-          e->replied = h.edata->replied;
-        }
-
-        /*  mailbox->emails[msgno]->received is restored from mutt_hcache_restore */
-        e->edata = h.edata;
-        e->edata_free = imap_edata_free;
-        STAILQ_INIT(&e->tags);
-
-        /* We take a copy of the tags so we can split the string */
-        char *tags_copy = mutt_str_dup(h.edata->flags_remote);
-        driver_tags_replace(&e->tags, tags_copy);
-        FREE(&tags_copy);
-
-        m->msg_count++;
-        mailbox_size_add(m, e);
-
-        /* If this is the first time we are fetching, we need to
-         * store the current state of flags back into the header cache */
-        if (!eval_condstore && store_flag_updates)
-          imap_hcache_put(mdata, e);
-
-        h.edata = NULL;
-        idx++;
-      }
+      /* The cache is searched in batches, see read_headers_normal_eval_batch() */
+      pending[num_pending++] = h.edata;
+      h.edata = NULL;
     } while (mfhrc == -1);
 
     imap_edata_free((void **) &h.edata);
 
     if ((mfhrc < -1) || ((rc != IMAP_RES_CONTINUE) && (rc != IMAP_RES_OK)))
       goto fail;
+
+    if ((num_pending == IMAP_HCACHE_BATCH) || ((rc != IMAP_RES_CONTINUE) && (num_pending > 0)))
+    {
+      read_headers_normal_eval_batch(m, pending, num_pending, store_flag_updates, eval_condstore);
+      num_pending = 0;
+    }
   }
 
   rc = 0;
 fail:
+  for (size_t i = 0; i < num_pending; i++)
+    imap_edata_free((void **) &pending[i]);
   progress_free(&progress);
   return rc;
 }
@@ -947,6 +1003,7 @@ static int read_headers_condstore_qresync_updates(struct ImapAccountData *adata,
     imap_expunge_mailbox(m);
 
     imap_hcache_open(adata, mdata);
+    mutt_hcache_begin(mdata->hcache);
     mdata->reopen &= ~IMAP_EXPUNGE_PENDING;
   }
 
@@ -1035,6 +1092,419 @@ fail:
 
 #endif /* USE_HCACHE */
 
+/**
+ * msg_new_email - Create an Email from a FETCH response
+ * @param h  Parsed FETCH response
+ * @param fp File containing the email's headers
+ * @retval ptr New Email
+ *
+ * The Email takes ownership of the ImapEmailData in the ImapHeader.
+ */
+static struct Email *msg_new_email(struct ImapHeader *h, FILE *fp)
+{
+  struct Email *e = email_new();
+
+  e->index = h->edata->uid;
+  /* messages which have not been expunged are ACTIVE (borrowed from mh
+   * folders) */
+  e->active = true;
+  e->changed = false;
+  e->read = h->edata->read;
+  e->old = h->edata->old;
+  e->deleted = h->edata->deleted;
+  e->flagged = h->edata->flagged;
+  e->replied = h->edata->replied;
+  e->received = h->received;
+  e->edata = (void *) (h->edata);
+  e->edata_free = imap_edata_free;
+  STAILQ_INIT(&e->tags);
+
+  /* We take a copy of the tags so we can split the string */
+  char *tags_copy = mutt_str_dup(h->edata->flags_remote);
+  driver_tags_replace(&e->tags, tags_copy);
+  FREE(&tags_copy);
+
+  rewind(fp);
+  /* NOTE: if Date: header is missing, mutt_rfc822_read_header depends
+   *   on h->received being set */
+  e->env = mutt_rfc822_read_header(fp, e, false, false);
+  /* body built as a side-effect of mutt_rfc822_read_header */
+  e->body->length = h->content_length;
+
+  h->edata = NULL;
+  return e;
+}
+
+/**
+ * msg_add_email - Add a new Email to the Mailbox
+ * @param[in]  m      Imap Selected Mailbox
+ * @param[in]  e      Email, created by msg_new_email()
+ * @param[out] maxuid Highest UID seen
+ */
+static void msg_add_email(struct Mailbox *m, struct Email *e, unsigned int *maxuid)
+{
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  struct ImapEmailData *edata = imap_edata_get(e);
+
+  m->emails[m->msg_count] = e;
+
+  imap_msn_set(&mdata->msn, edata->msn - 1, e);
+  mutt_hash_int_insert(mdata->uid_hash, edata->uid, e);
+
+  if (*maxuid < edata->uid)
+    *maxuid = edata->uid;
+
+  mailbox_size_add(m, e);
+
+#ifdef USE_HCACHE
+  imap_hcache_put(mdata, e);
+#endif /* USE_HCACHE */
+
+  m->msg_count++;
+}
+
+/**
+ * read_headers_new_mail - Make room for mail that arrived during a download
+ * @param[in]     m       Imap Selected Mailbox
+ * @param[in,out] msn_end Last Message Sequence Number to fetch
+ */
+static void read_headers_new_mail(struct Mailbox *m, unsigned int *msn_end)
+{
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+
+  if (!(mdata->reopen & IMAP_NEWMAIL_PENDING))
+    return;
+
+  *msn_end = mdata->new_mail_count;
+  while (*msn_end > m->email_max)
+    mx_alloc_memory(m);
+  imap_msn_reserve(&mdata->msn, *msn_end);
+  mdata->reopen &= ~IMAP_NEWMAIL_PENDING;
+  mdata->new_mail_count = 0;
+}
+
+/**
+ * struct ImapFetchConn - A connection downloading a share of the new headers
+ */
+struct ImapFetchConn
+{
+  struct ImapAccountData *adata; ///< Connection to the server
+  unsigned int next;             ///< Next MSN to request
+  unsigned int end;              ///< Last MSN of this connection's share
+  bool busy;                     ///< A FETCH is in progress
+  bool failed;                   ///< The connection has broken
+};
+
+/**
+ * fetch_conn_open - Open an extra connection for downloading headers
+ * @param m       Imap Selected Mailbox
+ * @param msn_end Last Message Sequence Number that will be fetched
+ * @retval ptr  Connection examining the Mailbox
+ * @retval NULL Failure
+ *
+ * The Mailbox is opened read-only, so the connection can't change any flags.
+ * The connection is only used if it sees the same messages as the owning one.
+ * It stays in the authenticated state, so that the untagged responses it
+ * receives aren't applied to the Mailbox.
+ */
+static struct ImapAccountData *fetch_conn_open(struct Mailbox *m, unsigned int msn_end)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  unsigned int count = 0;
+  unsigned int uidvalidity = 0;
+  char buf[PATH_MAX];
+  int rc;
+
+  struct ImapAccountData *fadata = imap_adata_new(m->account);
+  fadata->conn = mutt_conn_new(&adata->conn->account);
+  if (!fadata->conn || (imap_login(fadata) < 0))
+    goto fail;
+
+  snprintf(buf, sizeof(buf), "EXAMINE %s", mdata->munge_name);
+  if (imap_cmd_start(fadata, buf) < 0)
+    goto fail;
+
+  while ((rc = imap_cmd_step(fadata)) == IMAP_RES_CONTINUE)
+  {
+    char *pc = imap_next_word(fadata->buf);
+    if (mutt_istr_startswith(pc, "OK [UIDVALIDITY"))
+    {
+      pc = imap_next_word(pc + 3);
+      if (mutt_str_atoui(pc, &uidvalidity) < 0)
+        uidvalidity = 0;
+    }
+    else if (mutt_str_atoui(pc, &count) > 0)
+    {
+      if (!mutt_istr_startswith(imap_next_word(pc), "EXISTS"))
+        count = 0;
+    }
+  }
+
+  if ((rc != IMAP_RES_OK) || (uidvalidity != mdata->uidvalidity) || (count < msn_end))
+  {
+    mutt_debug(LL_DEBUG1, "Extra connection sees a different mailbox: %u messages, UIDVALIDITY %u\n",
+               count, uidvalidity);
+    imap_logout(fadata);
+    goto fail;
+  }
+
+  return fadata;
+
+fail:
+  imap_adata_free((void **) &fadata);
+  return NULL;
+}
+
+/**
+ * fetch_conn_start - Request the next block of headers on a connection
+ * @param fc     Connection
+ * @param hdrreq Header fields to request
+ * @retval  0 Success
+ * @retval <0 Failure
+ */
+static int fetch_conn_start(struct ImapFetchConn *fc, const char *hdrreq)
+{
+  unsigned int fetch_end = fc->end;
+  const long c_imap_fetch_chunk_size =
+      cs_subset_long(NeoMutt->sub, "imap_fetch_chunk_size");
+  if ((c_imap_fetch_chunk_size > 0) && ((fc->end - fc->next) >= c_imap_fetch_chunk_size))
+    fetch_end = fc->next + c_imap_fetch_chunk_size - 1;
+
+  char *cmd = NULL;
+  mutt_str_asprintf(&cmd, "FETCH %u:%u (UID FLAGS INTERNALDATE RFC822.SIZE %s)",
+                    fc->next, fetch_end, hdrreq);
+  int rc = imap_cmd_start(fc->adata, cmd);
+  FREE(&cmd);
+
+  fc->next = fetch_end + 1;
+  fc->busy = (rc == 0);
+  return rc;
+}
+
+/**
+ * fetch_conn_response - Handle a response to a FETCH on an extra connection
+ * @param adata     Imap Account data
+ * @param fp        Temporary file for the headers
+ * @param emails    New Emails, indexed by MSN
+ * @param msn_begin First Message Sequence Number being fetched
+ * @param msn_end   Last Message Sequence Number being fetched
+ * @retval  1 A new Email was created
+ * @retval  0 The response was ignored
+ * @retval -1 The FETCH response was corrupt
+ */
+static int fetch_conn_response(struct ImapAccountData *adata, FILE *fp,
+                               struct Email **emails, unsigned int msn_begin,
+                               unsigned int msn_end)
+{
+  struct ImapHeader h = { 0 };
+  int rc = 0;
+
+  rewind(fp);
+  h.edata = imap_edata_new();
+
+  int mfhrc = msg_fetch_header(adata, &h, adata->buf, fp);
+  if (mfhrc < -1)
+  {
+    rc = -1;
+  }
+  else if ((mfhrc == 0) && ftello(fp))
+  {
+    if ((h.edata->msn < msn_begin) || (h.edata->msn > msn_end))
+    {
+      mutt_debug(LL_DEBUG1, "skipping FETCH response for unknown message number %d\n",
+                 h.edata->msn);
+    }
+    else if (emails[h.edata->msn - msn_begin])
+    {
+      mutt_debug(LL_DEBUG2, "skipping FETCH response for duplicate message %d\n",
+                 h.edata->msn);
+    }
+    else
+    {
+      /* make sure we don't get remnants from older larger message headers */
+      fputs("\n\n", fp);
+      emails[h.edata->msn - msn_begin] = msg_new_email(&h, fp);
+      rc = 1;
+    }
+  }
+
+  imap_edata_free((void **) &h.edata);
+  return rc;
+}
+
+/**
+ * read_headers_fetch_parallel - Download new headers over several connections
+ * @param[in]  m         Imap Selected Mailbox
+ * @param[in]  msn_begin First Message Sequence Number
+ * @param[in]  msn_end   Last Message Sequence Number
+ * @param[in]  hdrreq    Header fields to request
+ * @param[in]  fp        Temporary file for the headers
+ * @param[out] maxuid    Highest UID seen
+ * @param[in]  progress  Progress bar, may be NULL
+ * @retval  1 No extra connections were used, nothing was fetched
+ * @retval  0 Success, though some headers may be missing
+ * @retval -1 Error
+ *
+ * If `$imap_fetch_connections` is set, extra connections are opened and the
+ * messages are shared out between them.  The owning connection takes the first
+ * share.  Every FETCH is sent before any responses are read.  Then responses
+ * are read from whichever connection has data waiting.
+ *
+ * The new Emails are held back until every connection has finished.  Then
+ * they're added to the Mailbox, the MSN table and the header cache, in MSN
+ * order, as if they had been fetched over one connection.
+ *
+ * If an extra connection fails, the caller must fetch the missing headers.
+ */
+static int read_headers_fetch_parallel(struct Mailbox *m, unsigned int msn_begin,
+                                       unsigned int msn_end, const char *hdrreq,
+                                       FILE *fp, unsigned int *maxuid,
+                                       struct Progress *progress)
+{
+  const short c_imap_fetch_connections =
+      cs_subset_number(NeoMutt->sub, "imap_fetch_connections");
+  if ((c_imap_fetch_connections < 1) || (msn_end < msn_begin))
+    return 1;
+
+  const unsigned int count = msn_end - msn_begin + 1;
+  const int num = MIN(c_imap_fetch_connections, (int) (count / IMAP_FETCH_CONN_MIN) - 1);
+  if (num < 1)
+    return 1;
+
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapFetchConn *fcs = mutt_mem_calloc(num + 1, sizeof(struct ImapFetchConn));
+  int num_fcs = 0;
+
+  fcs[num_fcs++].adata = adata;
+  for (int i = 0; i < num; i++)
+  {
+    struct ImapAccountData *fadata = fetch_conn_open(m, msn_end);
+    if (fadata)
+      fcs[num_fcs++].adata = fadata;
+  }
+
+  if (num_fcs == 1)
+  {
+    FREE(&fcs);
+    return 1;
+  }
+
+  mutt_debug(LL_DEBUG2, "Fetching %u headers over %d connections\n", count, num_fcs);
+
+  struct Email **emails = mutt_mem_calloc(count, sizeof(struct Email *));
+  unsigned int received = 0;
+  int num_busy = 0;
+  int rc = -1;
+
+  unsigned int msn = msn_begin;
+  for (int i = 0; i < num_fcs; i++)
+  {
+    fcs[i].next = msn;
+    fcs[i].end = msn + (count / num_fcs) - 1;
+    if (i < (int) (count % num_fcs))
+      fcs[i].end++;
+    msn = fcs[i].end + 1;
+
+    if (fetch_conn_start(&fcs[i], hdrreq) < 0)
+    {
+      if (i == 0)
+        goto done;
+      fcs[i].failed = true;
+    }
+    else
+    {
+      num_busy++;
+    }
+  }
+
+  while (num_busy > 0)
+  {
+    if (SigInt && query_abort_header_download(adata))
+      goto done;
+
+    bool ready = false;
+    for (int i = 0; i < num_fcs; i++)
+      if (fcs[i].busy && (mutt_socket_poll(fcs[i].adata->conn, 0) > 0))
+        ready = true;
+
+    for (int i = 0; i < num_fcs; i++)
+    {
+      struct ImapFetchConn *fc = &fcs[i];
+      if (!fc->busy)
+        continue;
+      /* If no connection has data waiting, wait for the first busy one */
+      if (ready && (mutt_socket_poll(fc->adata->conn, 0) <= 0))
+        continue;
+
+      int step_rc = imap_cmd_step(fc->adata);
+      if (step_rc == IMAP_RES_CONTINUE)
+      {
+        int frc = fetch_conn_response(fc->adata, fp, emails, msn_begin, msn_end);
+        if (frc < 0)
+        {
+          step_rc = IMAP_RES_BAD;
+        }
+        else if (frc > 0)
+        {
+          received++;
+          if (m->verbose)
+            progress_update(progress, msn_begin + received - 1, -1);
+        }
+      }
+      else if (step_rc == IMAP_RES_OK)
+      {
+        fc->busy = false;
+        if ((fc->next <= fc->end) && (fetch_conn_start(fc, hdrreq) < 0))
+          step_rc = IMAP_RES_BAD;
+        else if (!fc->busy)
+          num_busy--;
+      }
+
+      if ((step_rc != IMAP_RES_CONTINUE) && (step_rc != IMAP_RES_OK))
+      {
+        if (i == 0)
+          goto done;
+
+        mutt_debug(LL_DEBUG1, "Extra connection failed, its headers will be fetched later\n");
+        imap_close_connection(fc->adata);
+        fc->failed = true;
+        fc->busy = false;
+        num_busy--;
+      }
+
+      if (!ready)
+        break;
+    }
+  }
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (!emails[i])
+      continue;
+    msg_add_email(m, emails[i], maxuid);
+    emails[i] = NULL;
+  }
+
+  rc = 0;
+
+done:
+  for (int i = 1; i < num_fcs; i++)
+  {
+    if (fcs[i].busy || fcs[i].failed)
+      imap_close_connection(fcs[i].adata);
+    else
+      imap_logout(fcs[i].adata);
+    imap_adata_free((void **) &fcs[i].adata);
+  }
+  for (unsigned int i = 0; i < count; i++)
+    email_free(&emails[i]);
+  FREE(&emails);
+  FREE(&fcs);
+
+  return rc;
+}
+
 /**
  * read_headers_fetch_new - Retrieve new messages from the server
  * @param[in]  m                Imap Selected Mailbox
@@ -1065,7 +1535,6 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
 
   struct ImapAccountData *adata = imap_adata_get(m);
   struct ImapMboxData *mdata = imap_mdata_get(m);
-  int idx = m->msg_count;
 
   if (!adata || (adata->mailbox != m))
     return -1;
@@ -1124,6 +1593,19 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
 
   buf = mutt_buffer_pool_get();
 
+  if (initial_download && !evalhc)
+  {
+    rc = read_headers_fetch_parallel(m, msn_begin, msn_end, hdrreq, fp, maxuid, progress);
+    if (rc < 0)
+      goto bail;
+    if (rc == 0)
+    {
+      /* Fetch any headers that an extra connection failed to deliver */
+      evalhc = true;
+      read_headers_new_mail(m, &msn_end);
+    }
+  }
+
   /* NOTE:
    *   The (fetch_msn_end < msn_end) used to be important to prevent
    *   an infinite loop, in the event the server did not return all
@@ -1165,7 +1647,7 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
         if (rc != IMAP_RES_CONTINUE)
           break;
 
-        mfhrc = msg_fetch_header(m, &h, adata->buf, fp);
+        mfhrc = msg_fetch_header(adata, &h, adata->buf, fp);
         if (mfhrc < 0)
           continue;
 
@@ -1193,51 +1675,7 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
           continue;
         }
 
-        struct Email *e = email_new();
-        m->emails[idx] = e;
-
-        imap_msn_set(&mdata->msn, h.edata->msn - 1, e);
-        mutt_hash_int_insert(mdata->uid_hash, h.edata->uid, e);
-
-        e->index = h.edata->uid;
-        /* messages which have not been expunged are ACTIVE (borrowed from mh
-         * folders) */
-        e->active = true;
-        e->changed = false;
-        e->read = h.edata->read;
-        e->old = h.edata->old;
-        e->deleted = h.edata->deleted;
-        e->flagged = h.edata->flagged;
-        e->replied = h.edata->replied;
-        e->received = h.received;
-        e->edata = (void *) (h.edata);
-        e->edata_free = imap_edata_free;
-        STAILQ_INIT(&e->tags);
-
-        /* We take a copy of the tags so we can split the string */
-        char *tags_copy = mutt_str_dup(h.edata->flags_remote);
-        driver_tags_replace(&e->tags, tags_copy);
-        FREE(&tags_copy);
-
-        if (*maxuid < h.edata->uid)
-          *maxuid = h.edata->uid;
-
-        rewind(fp);
-        /* NOTE: if Date: header is missing, mutt_rfc822_read_header depends
-         *   on h.received being set */
-        e->env = mutt_rfc822_read_header(fp, e, false, false);
-        /* body built as a side-effect of mutt_rfc822_read_header */
-        e->body->length = h.content_length;
-        mailbox_size_add(m, e);
-
-#ifdef USE_HCACHE
-        imap_hcache_put(mdata, e);
-#endif /* USE_HCACHE */
-
-        m->msg_count++;
-
-        h.edata = NULL;
-        idx++;
+        msg_add_email(m, msg_new_email(&h, fp), maxuid);
       } while (mfhrc == -1);
 
       imap_edata_free((void **) &h.edata);
@@ -1247,15 +1685,7 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
     }
 
     /* In case we get new mail while fetching the headers. */
-    if (mdata->reopen & IMAP_NEWMAIL_PENDING)
-    {
-      msn_end = mdata->new_mail_count;
-      while (msn_end > m->email_max)
-        mx_alloc_memory(m);
-      imap_msn_reserve(&mdata->msn, msn_end);
-      mdata->reopen &= ~IMAP_NEWMAIL_PENDING;
-      mdata->new_mail_count = 0;
-    }
+    read_headers_new_mail(m, &msn_end);
 
     /* Note: RFC3501 section 7.4.1 and RFC7162 section 3.2.10.2 say we
      * must not get any EXPUNGE/VANISHED responses in the middle of a
@@ -1337,6 +1767,7 @@ retry:
 
 #ifdef USE_HCACHE
   imap_hcache_open(adata, mdata);
+  mutt_hcache_begin(mdata->hcache);
 
   if (mdata->hcache && initial_download)
   {
@@ -1493,6 +1924,7 @@ retry:
 
 bail:
 #ifdef USE_HCACHE
+  mutt_hcache_commit(mdata->hcache);
   imap_hcache_close(mdata);
   FREE(&uid_seqset);
 #endif /* USE_HCACHE */
@@ -1921,18 +2353,23 @@ char *imap_set_flags(struct Mailbox *m, struct Email *e, char *s, bool *server_c
 }
 
 /**
- * imap_msg_open - Open an email message in a Mailbox - Implements MxOps::msg_open()
+ * msg_fetch_body - Download a whole email from the server
+ * @param m             Imap Selected Mailbox
+ * @param e             Email
+ * @param fp            File to save the email to
+ * @param peek          If true, don't mark the email read on the server
+ * @param show_progress If true, show a progress bar
+ * @retval true Success
  */
-bool imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
+static bool msg_fetch_body(struct Mailbox *m, struct Email *e, FILE *fp,
+                           bool peek, bool show_progress)
 {
-  struct Envelope *newenv = NULL;
   char buf[1024];
   char *pc = NULL;
   unsigned int bytes;
   struct Progress *progress = NULL;
   unsigned int uid;
-  bool retried = false;
-  bool read;
+  bool rc_ok = false;
   int rc;
 
   /* Sam's weird courier server returns an OK response even when FETCH
@@ -1941,49 +2378,14 @@ bool imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
 
   struct ImapAccountData *adata = imap_adata_get(m);
 
-  if (!adata || (adata->mailbox != m))
-    return false;
-
-  struct Email *e = m->emails[msgno];
-  if (!e)
-    return false;
-
-  msg->fp = msg_cache_get(m, e);
-  if (msg->fp)
-  {
-    if (imap_edata_get(e)->parsed)
-      return true;
-    goto parsemsg;
-  }
-
-  /* This function is called in a few places after endwin()
-   * e.g. mutt_pipe_message(). */
-  bool output_progress = !isendwin() && m->verbose;
-  if (output_progress)
-    mutt_message(_("Fetching message..."));
-
-  msg->fp = msg_cache_put(m, e);
-  if (!msg->fp)
-  {
-    struct Buffer *path = mutt_buffer_pool_get();
-    mutt_buffer_mktemp(path);
-    msg->fp = mutt_file_fopen(mutt_buffer_string(path), "w+");
-    unlink(mutt_buffer_string(path));
-    mutt_buffer_pool_release(&path);
-
-    if (!msg->fp)
-      return false;
-  }
-
   /* mark this header as currently inactive so the command handler won't
    * also try to update it. HACK until all this code can be moved into the
    * command handler */
   e->active = false;
 
-  const bool c_imap_peek = cs_subset_bool(NeoMutt->sub, "imap_peek");
   snprintf(buf, sizeof(buf), "UID FETCH %u %s", imap_edata_get(e)->uid,
            ((adata->capabilities & IMAP_CAP_IMAP4REV1) ?
-                (c_imap_peek ? "BODY.PEEK[]" : "BODY[]") :
+                (peek ? "BODY.PEEK[]" : "BODY[]") :
                 "RFC822"));
 
   imap_cmd_start(adata, buf);
@@ -2023,11 +2425,11 @@ bool imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
             imap_error("imap_msg_open()", buf);
             goto bail;
           }
-          if (output_progress)
+          if (show_progress)
           {
             progress = progress_new(_("Fetching message..."), MUTT_PROGRESS_NET, bytes);
           }
-          if (imap_read_literal(msg->fp, adata, bytes, output_progress ? progress : NULL) < 0)
+          if (imap_read_literal(fp, adata, bytes, progress) < 0)
           {
             goto bail;
           }
@@ -2053,11 +2455,8 @@ bool imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
     }
   } while (rc == IMAP_RES_CONTINUE);
 
-  /* see comment before command start. */
-  e->active = true;
-
-  fflush(msg->fp);
-  if (ferror(msg->fp))
+  fflush(fp);
+  if (ferror(fp))
     goto bail;
 
   if (rc != IMAP_RES_OK)
@@ -2066,6 +2465,65 @@ bool imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
   if (!fetched || !imap_code(adata->buf))
     goto bail;
 
+  rc_ok = true;
+
+bail:
+  /* see comment before command start. */
+  e->active = true;
+  progress_free(&progress);
+  return rc_ok;
+}
+
+/**
+ * imap_msg_open - Open an email message in a Mailbox - Implements MxOps::msg_open()
+ */
+bool imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno)
+{
+  struct Envelope *newenv = NULL;
+  char buf[1024];
+  bool retried = false;
+  bool read;
+
+  struct ImapAccountData *adata = imap_adata_get(m);
+
+  if (!adata || (adata->mailbox != m))
+    return false;
+
+  struct Email *e = m->emails[msgno];
+  if (!e)
+    return false;
+
+  msg->fp = msg_cache_get(m, e);
+  if (msg->fp)
+  {
+    if (imap_edata_get(e)->parsed)
+      return true;
+    goto parsemsg;
+  }
+
+  /* This function is called in a few places after endwin()
+   * e.g. mutt_pipe_message(). */
+  bool output_progress = !isendwin() && m->verbose;
+  if (output_progress)
+    mutt_message(_("Fetching message..."));
+
+  msg->fp = msg_cache_put(m, e);
+  if (!msg->fp)
+  {
+    struct Buffer *path = mutt_buffer_pool_get();
+    mutt_buffer_mktemp(path);
+    msg->fp = mutt_file_fopen(mutt_buffer_string(path), "w+");
+    unlink(mutt_buffer_string(path));
+    mutt_buffer_pool_release(&path);
+
+    if (!msg->fp)
+      return false;
+  }
+
+  const bool c_imap_peek = cs_subset_bool(NeoMutt->sub, "imap_peek");
+  if (!msg_fetch_body(m, e, msg->fp, c_imap_peek, output_progress))
+    goto bail;
+
   msg_cache_commit(m, e);
 
 parsemsg:
@@ -2111,17 +2569,53 @@ parsemsg:
     goto parsemsg;
   }
 
-  progress_free(&progress);
   return true;
 
 bail:
-  e->active = true;
   mutt_file_fclose(&msg->fp);
   imap_cache_del(m, e);
-  progress_free(&progress);
   return false;
 }
 
+/**
+ * imap_msg_prefetch - Download an email into the cache - Implements MxOps::msg_prefetch()
+ */
+long imap_msg_prefetch(struct Mailbox *m, struct Email *e)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+
+  if (!adata || (adata->mailbox != m) || !e)
+    return -1;
+
+  FILE *fp = msg_cache_get(m, e);
+  if (fp)
+  {
+    mutt_file_fclose(&fp);
+    return 0;
+  }
+
+  /* Only IMAP4rev1 can fetch an email without marking it read */
+  if (!(adata->capabilities & IMAP_CAP_IMAP4REV1))
+    return -1;
+
+  fp = msg_cache_put(m, e);
+  if (!fp)
+    return -1;
+
+  long bytes = -1;
+  if (msg_fetch_body(m, e, fp, true, false))
+    bytes = ftell(fp);
+  if (mutt_file_fclose(&fp) != 0)
+    bytes = -1;
+
+  if (bytes < 0)
+    imap_cache_del(m, e);
+  else
+    msg_cache_commit(m, e);
+
+  return bytes;
+}
+
 /**
  * imap_msg_commit - Save changes to an email - Implements MxOps::msg_commit()
  *
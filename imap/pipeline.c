@@ -0,0 +1,120 @@
+/**
+ * @file
+ * Adapt the depth of the IMAP pipeline
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page imap_pipeline Adapt the depth of the IMAP pipeline
+ *
+ * Adapt the depth of the IMAP pipeline
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "private.h"
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "adata.h"
+
+/**
+ * imap_pipeline_reset - Start adapting the pipeline afresh
+ * @param adata Imap Account data
+ *
+ * The depth goes back to $imap_pipeline_depth and everything learnt about
+ * the server is forgotten, e.g. after reconnecting.
+ */
+void imap_pipeline_reset(struct ImapAccountData *adata)
+{
+  const short c_imap_pipeline_depth =
+      cs_subset_number(NeoMutt->sub, "imap_pipeline_depth");
+  const short c_imap_pipeline_max = cs_subset_number(NeoMutt->sub, "imap_pipeline_max");
+
+  adata->pipeline_depth = c_imap_pipeline_depth;
+  adata->pipeline_max = 0;
+  if ((c_imap_pipeline_depth > 0) && (c_imap_pipeline_max > c_imap_pipeline_depth))
+    adata->pipeline_max = c_imap_pipeline_max;
+
+  adata->rtt_min = 0;
+  adata->rtt_avg = 0;
+  adata->throttled = 0;
+}
+
+/**
+ * imap_pipeline_adapt - Adjust the pipeline depth to the server's response time
+ * @param adata     Imap Account data
+ * @param sent      When the command was sent, in microseconds
+ * @param now       When its response arrived, in microseconds
+ * @param count     Number of commands that were waiting, including this one
+ * @param throttled true if the server failed the command, saying it's throttling us
+ *
+ * Commands that are sent back-to-back should each take about one network
+ * round trip.  The fastest round trip seen is used as a baseline.  If the
+ * average is much slower, the extra time is spent waiting at the server, so
+ * the commands in it are a backlog.
+ *
+ * Like TCP Vegas, the depth grows while the full pipeline has no backlog and
+ * shrinks when the backlog gets large.  Growing by one for each response
+ * doubles the depth every round trip.  If the server says that it's
+ * throttling us, the depth is halved, once per round trip.
+ */
+void imap_pipeline_adapt(struct ImapAccountData *adata, uint64_t sent,
+                         uint64_t now, int count, bool throttled)
+{
+  /* a lone command's time is its own, e.g. a large FETCH */
+  if ((adata->pipeline_max == 0) || (sent == 0) || (count < 2))
+    return;
+
+  if (throttled)
+  {
+    /* commands sent before we last backed off don't count */
+    if (sent > adata->throttled)
+    {
+      adata->pipeline_depth = MAX(adata->pipeline_depth / 2, 1);
+      adata->throttled = now;
+      mutt_debug(LL_DEBUG2, "server is throttling, pipeline depth %d\n", adata->pipeline_depth);
+    }
+    return;
+  }
+
+  const uint64_t rtt = (now > sent) ? (now - sent) : 1;
+  if ((adata->rtt_min == 0) || (rtt < adata->rtt_min))
+    adata->rtt_min = rtt;
+  if (adata->rtt_avg == 0)
+    adata->rtt_avg = rtt;
+  else
+    adata->rtt_avg = ((7 * adata->rtt_avg) + rtt) / 8;
+
+  const uint64_t backlog = adata->pipeline_depth * (adata->rtt_avg - adata->rtt_min) /
+                           adata->rtt_avg;
+
+  if ((backlog < 1) && (count > adata->pipeline_depth) &&
+      (adata->pipeline_depth < adata->pipeline_max))
+  {
+    adata->pipeline_depth++;
+    mutt_debug(LL_DEBUG3, "pipeline depth %d\n", adata->pipeline_depth);
+  }
+  else if ((backlog > 3) && (adata->pipeline_depth > 1))
+  {
+    adata->pipeline_depth--;
+    mutt_debug(LL_DEBUG3, "pipeline depth %d\n", adata->pipeline_depth);
+  }
+}
@@ -40,6 +40,8 @@ struct ImapMboxData;
 struct ListHead;
 struct Mailbox;
 struct Message;
+struct Pattern;
+struct PatternList;
 struct Progress;
 
 #define IMAP_PORT     143  ///< Default port for IMAP
@@ -139,8 +141,9 @@ typedef uint32_t ImapCapFlags;              ///< Flags, e.g. #IMAP_CAP_IMAP4
 #define IMAP_CAP_LIST_EXTENDED    (1 << 16) ///< RFC5258: IMAP4 LIST Command Extensions
 #define IMAP_CAP_COMPRESS         (1 << 17) ///< RFC4978: COMPRESS=DEFLATE
 #define IMAP_CAP_X_GM_EXT_1       (1 << 18) ///< https://developers.google.com/gmail/imap/imap-extensions
+#define IMAP_CAP_ESEARCH          (1 << 19) ///< RFC4731: IMAP4 Extension to SEARCH Command
 
-#define IMAP_CAP_ALL             ((1 << 19) - 1)
+#define IMAP_CAP_ALL             ((1 << 20) - 1)
 
 /**
  * struct ImapList - Items in an IMAP browser
@@ -160,6 +163,7 @@ struct ImapCommand
 {
   char seq[SEQ_LEN + 1]; ///< Command tag, e.g. 'a0001'
   int state;            ///< Command state, e.g. #IMAP_RES_NEW
+  uint64_t sent;        ///< When the command was sent, in microseconds
 };
 
 /**
@@ -188,6 +192,7 @@ void imap_close_connection(struct ImapAccountData *adata);
 int imap_read_literal(FILE *fp, struct ImapAccountData *adata, unsigned long bytes, struct Progress *pbar);
 void imap_expunge_mailbox(struct Mailbox *m);
 int imap_login(struct ImapAccountData *adata);
+void imap_logout(struct ImapAccountData *adata);
 int imap_sync_message_for_copy(struct Mailbox *m, struct Email *e, struct Buffer *cmd, enum QuadOption *err_continue);
 bool imap_has_flag(struct ListHead *flag_list, const char *flag);
 int imap_adata_find(const char *path, struct ImapAccountData **adata, struct ImapMboxData **mdata);
@@ -197,11 +202,13 @@ int imap_authenticate(struct ImapAccountData *adata);
 
 /* command.c */
 int imap_cmd_start(struct ImapAccountData *adata, const char *cmdstr);
+bool imap_cmd_queue_full(struct ImapAccountData *adata);
 int imap_cmd_step(struct ImapAccountData *adata);
 void imap_cmd_finish(struct ImapAccountData *adata);
 bool imap_code(const char *s);
 const char *imap_cmd_trailer(struct ImapAccountData *adata);
 int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags flags);
+int imap_exec_wait(struct ImapAccountData *adata, ImapCmdFlags flags);
 int imap_cmd_idle(struct ImapAccountData *adata);
 
 /* message.c */
@@ -212,6 +219,7 @@ int imap_cache_clean(struct Mailbox *m);
 int imap_append_message(struct Mailbox *m, struct Message *msg);
 
 bool imap_msg_open(struct Mailbox *m, struct Message *msg, int msgno);
+long imap_msg_prefetch(struct Mailbox *m, struct Email *e);
 int imap_msg_close(struct Mailbox *m, struct Message *msg);
 int imap_msg_commit(struct Mailbox *m, struct Message *msg);
 int imap_msg_save_hcache(struct Mailbox *m, struct Email *e);
@@ -221,6 +229,7 @@ int imap_msg_save_hcache(struct Mailbox *m, struct Email *e);
 void imap_hcache_open(struct ImapAccountData *adata, struct ImapMboxData *mdata);
 void imap_hcache_close(struct ImapMboxData *mdata);
 struct Email *imap_hcache_get(struct ImapMboxData *mdata, unsigned int uid);
+void imap_hcache_get_many(struct ImapMboxData *mdata, const unsigned int *uids, size_t num, struct Email **emails);
 int imap_hcache_put(struct ImapMboxData *mdata, struct Email *e);
 int imap_hcache_del(struct ImapMboxData *mdata, unsigned int uid);
 int imap_hcache_store_uid_seqset(struct ImapMboxData *mdata);
@@ -254,7 +263,14 @@ void imap_utf_decode(bool unicode, char **s);
 void imap_allow_reopen(struct Mailbox *m);
 void imap_disallow_reopen(struct Mailbox *m);
 
+/* pipeline.c */
+void imap_pipeline_adapt(struct ImapAccountData *adata, uint64_t sent, uint64_t now, int count, bool throttled);
+void imap_pipeline_reset(struct ImapAccountData *adata);
+
 /* search.c */
+void cmd_parse_esearch(struct ImapAccountData *adata, const char *s);
 void cmd_parse_search(struct ImapAccountData *adata, const char *s);
+void imap_search_cache_clear(struct ImapMboxData *mdata);
+bool imap_search_compile(struct Mailbox *m, struct PatternList *pat, struct Buffer *buf, struct Pattern **root);
 
 #endif /* MUTT_IMAP_PRIVATE_H */
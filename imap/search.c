@@ -30,7 +30,9 @@
  */
 
 #include "config.h"
+#include <ctype.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include "private.h"
 #include "mutt/lib.h"
@@ -41,12 +43,15 @@
 #include "adata.h"
 #include "mdata.h"
 
+/// Maximum number of searches to remember for each Mailbox
+#define IMAP_SEARCH_CACHE_MAX 8
+
 // fwd decl, mutually recursive: check_pattern_list, check_pattern
 static int check_pattern_list(const struct PatternList *patterns);
 
 // fwd-decl, mutually recursive: compile_search, compile_search_children
 static bool compile_search(const struct ImapAccountData *adata,
-                           const struct Pattern *pat, struct Buffer *buf);
+                           const struct Pattern *pat, bool all, struct Buffer *buf);
 
 /**
  * check_pattern - Check whether a pattern can be searched server-side
@@ -93,33 +98,144 @@ static int check_pattern_list(const struct PatternList *patterns)
   return positives;
 }
 
+/**
+ * check_translatable - Can the server evaluate a whole pattern?
+ * @param m   Mailbox
+ * @param pat Pattern to check
+ * @retval true  The pattern, and all its children, can be converted to IMAP SEARCH keys
+ * @retval false Some of the pattern must be matched locally
+ */
+static bool check_translatable(const struct Mailbox *m, const struct Pattern *pat)
+{
+  switch (pat->op)
+  {
+    case MUTT_PAT_AND:
+    case MUTT_PAT_OR:
+    {
+      const struct Pattern *c = NULL;
+      SLIST_FOREACH(c, pat->child, entries)
+      {
+        if (!check_translatable(m, c))
+          return false;
+      }
+      return true;
+    }
+    case MUTT_PAT_BODY:
+    case MUTT_PAT_HEADER:
+    case MUTT_PAT_WHOLE_MSG:
+      return pat->string_match;
+    case MUTT_PAT_SERVERSEARCH:
+    case MUTT_ALL:
+      return true;
+    case MUTT_PAT_SUBJECT:
+    case MUTT_PAT_FROM:
+    case MUTT_PAT_TO:
+    case MUTT_PAT_CC:
+      /* IMAP string searches always ignore case */
+      return pat->string_match && pat->ign_case;
+    case MUTT_FLAG:
+    case MUTT_REPLIED:
+    case MUTT_READ:
+    case MUTT_UNREAD:
+    case MUTT_DELETED:
+      /* The server doesn't know about flags that haven't been synced yet */
+      return !m->changed;
+    default:
+      return false;
+  }
+}
+
+/**
+ * search_root - Find the part of a pattern that the server can match by itself
+ * @param m   Mailbox
+ * @param pat Pattern
+ * @retval ptr  Smallest pattern that contains all the server-side searches
+ * @retval NULL The server-side searches must be matched separately
+ *
+ * The server's result for the returned pattern is exact, so it doesn't need
+ * to be matched locally.
+ */
+static struct Pattern *search_root(const struct Mailbox *m, struct Pattern *pat)
+{
+  while (!check_translatable(m, pat))
+  {
+    if ((pat->op != MUTT_PAT_AND) && (pat->op != MUTT_PAT_OR))
+      return NULL;
+
+    struct Pattern *next = NULL;
+    struct Pattern *c = NULL;
+    SLIST_FOREACH(c, pat->child, entries)
+    {
+      if (!check_pattern(c))
+        continue;
+      if (next)
+        return NULL;
+      next = c;
+    }
+
+    if (!next)
+      return NULL;
+    pat = next;
+  }
+
+  return pat;
+}
+
+/**
+ * clear_server_match - Forget the results of the previous server-side search
+ * @param pat Pattern
+ */
+static void clear_server_match(struct PatternList *pat)
+{
+  struct Pattern *p = NULL;
+  SLIST_FOREACH(p, pat, entries)
+  {
+    p->server_match = false;
+    if (p->child)
+      clear_server_match(p->child);
+  }
+}
+
 /**
  * compile_search_children - Compile a search command for a pattern's children
  * @param adata Imap Account data
  * @param pat Parent pattern
+ * @param all Compile all the children, not just the server-side searches
  * @param buf Buffer for the resulting command
  * @retval true  Success
  * @retval false Failure
  */
 static bool compile_search_children(const struct ImapAccountData *adata,
-                                    const struct Pattern *pat, struct Buffer *buf)
+                                    const struct Pattern *pat, bool all,
+                                    struct Buffer *buf)
 {
-  int clauses = check_pattern_list(pat->child);
+  int clauses = 0;
+  struct Pattern *c;
+  if (all)
+  {
+    SLIST_FOREACH(c, pat->child, entries)
+    {
+      clauses++;
+    }
+  }
+  else
+  {
+    clauses = check_pattern_list(pat->child);
+  }
   if (clauses == 0)
     return true;
 
   mutt_buffer_addch(buf, '(');
 
-  struct Pattern *c;
   SLIST_FOREACH(c, pat->child, entries)
   {
-    if (!check_pattern(c))
+    if (!all && !check_pattern(c))
       continue;
 
     if ((pat->op == MUTT_PAT_OR) && (clauses > 1))
       mutt_buffer_addstr(buf, "OR ");
 
-    if (!compile_search(adata, c, buf))
+    if (!compile_search(adata, c, all, buf))
       return false;
 
     if (clauses > 1)
@@ -190,6 +306,39 @@ static bool compile_search_self(const struct ImapAccountData *adata,
       imap_quote_string(term, sizeof(term), pat->p.str, false);
       mutt_buffer_addstr(buf, term);
       break;
+    case MUTT_PAT_SUBJECT:
+    case MUTT_PAT_FROM:
+    case MUTT_PAT_TO:
+    case MUTT_PAT_CC:
+      if (pat->op == MUTT_PAT_SUBJECT)
+        mutt_buffer_addstr(buf, "SUBJECT ");
+      else if (pat->op == MUTT_PAT_FROM)
+        mutt_buffer_addstr(buf, "FROM ");
+      else if (pat->op == MUTT_PAT_TO)
+        mutt_buffer_addstr(buf, "TO ");
+      else
+        mutt_buffer_addstr(buf, "CC ");
+      imap_quote_string(term, sizeof(term), pat->p.str, false);
+      mutt_buffer_addstr(buf, term);
+      break;
+    case MUTT_ALL:
+      mutt_buffer_addstr(buf, "ALL");
+      break;
+    case MUTT_FLAG:
+      mutt_buffer_addstr(buf, "FLAGGED");
+      break;
+    case MUTT_REPLIED:
+      mutt_buffer_addstr(buf, "ANSWERED");
+      break;
+    case MUTT_READ:
+      mutt_buffer_addstr(buf, "SEEN");
+      break;
+    case MUTT_UNREAD:
+      mutt_buffer_addstr(buf, "UNSEEN");
+      break;
+    case MUTT_DELETED:
+      mutt_buffer_addstr(buf, "DELETED");
+      break;
   }
   return true;
 }
@@ -198,6 +347,7 @@ static bool compile_search_self(const struct ImapAccountData *adata,
  * compile_search - Convert NeoMutt pattern to IMAP search
  * @param adata Imap Account data
  * @param pat Pattern to convert
+ * @param all Convert the whole pattern, not just the server-side searches
  * @param buf Buffer for result
  * @retval true  Success
  * @retval false Failure
@@ -205,28 +355,195 @@ static bool compile_search_self(const struct ImapAccountData *adata,
  * Convert neomutt Pattern to IMAP SEARCH command containing only elements
  * that require full-text search (neomutt already has what it needs for most
  * match types, and does a better job (eg server doesn't support regexes).
+ *
+ * If the pattern has been checked by check_translatable(), all of it can be
+ * converted and the server's result will be exact.
  */
 static bool compile_search(const struct ImapAccountData *adata,
-                           const struct Pattern *pat, struct Buffer *buf)
+                           const struct Pattern *pat, bool all, struct Buffer *buf)
 {
-  if (!check_pattern(pat))
+  if (!all && !check_pattern(pat))
     return true;
 
   if (pat->pat_not)
     mutt_buffer_addstr(buf, "NOT ");
 
-  return pat->child ? compile_search_children(adata, pat, buf) :
+  return pat->child ? compile_search_children(adata, pat, all, buf) :
                       compile_search_self(adata, pat, buf);
 }
 
+/**
+ * imap_search_cache_clear - Forget the results of previous searches
+ * @param mdata Imap Mailbox data
+ */
+void imap_search_cache_clear(struct ImapMboxData *mdata)
+{
+  if (!mdata)
+    return;
+
+  struct ImapSearchCache *sc = NULL;
+  ARRAY_FOREACH(sc, &mdata->search_cache)
+  {
+    FREE(&sc->query);
+    ARRAY_FREE(&sc->uids);
+  }
+  ARRAY_FREE(&mdata->search_cache);
+}
+
+/**
+ * search_cache_find - Find the results of a previous search
+ * @param mdata Imap Mailbox data
+ * @param query IMAP SEARCH criteria
+ * @retval ptr  Results of the search
+ * @retval NULL The search hasn't been run, or the Mailbox has changed since
+ *
+ * Anything that could change the results, e.g. new mail or a flag update,
+ * bumps ImapMboxData::search_gen, which makes the old results stale.
+ *
+ * The results are moved to the end of the cache, so they'll be forgotten last.
+ */
+static struct ImapSearchCache *search_cache_find(struct ImapMboxData *mdata,
+                                                 const char *query)
+{
+  struct ImapSearchCache *sc = NULL;
+  ARRAY_FOREACH(sc, &mdata->search_cache)
+  {
+    if ((sc->gen != mdata->search_gen) || !mutt_str_equal(sc->query, query))
+      continue;
+
+    struct ImapSearchCache found = *sc;
+    ARRAY_REMOVE(&mdata->search_cache, sc);
+    ARRAY_ADD(&mdata->search_cache, found);
+    return ARRAY_LAST(&mdata->search_cache);
+  }
+  return NULL;
+}
+
+/**
+ * search_cache_add - Remember the results of a search
+ * @param mdata Imap Mailbox data
+ * @param query IMAP SEARCH criteria
+ * @param uids  UIDs of the matching Emails, will be taken over
+ */
+static void search_cache_add(struct ImapMboxData *mdata, const char *query,
+                             struct ImapUidArray *uids)
+{
+  /* drop any results that are out of date */
+  for (size_t i = ARRAY_SIZE(&mdata->search_cache); i > 0; i--)
+  {
+    struct ImapSearchCache *sc = ARRAY_GET(&mdata->search_cache, i - 1);
+    if (sc->gen == mdata->search_gen)
+      continue;
+    FREE(&sc->query);
+    ARRAY_FREE(&sc->uids);
+    ARRAY_REMOVE(&mdata->search_cache, sc);
+  }
+
+  if (ARRAY_SIZE(&mdata->search_cache) >= IMAP_SEARCH_CACHE_MAX)
+  {
+    struct ImapSearchCache *oldest = ARRAY_GET(&mdata->search_cache, 0);
+    FREE(&oldest->query);
+    ARRAY_FREE(&oldest->uids);
+    ARRAY_REMOVE(&mdata->search_cache, oldest);
+  }
+
+  struct ImapSearchCache sc = { 0 };
+  sc.query = mutt_str_dup(query);
+  sc.gen = mdata->search_gen;
+  sc.uids = *uids;
+  ARRAY_INIT(uids);
+  ARRAY_ADD(&mdata->search_cache, sc);
+}
+
+/**
+ * search_run - Run a search on the server, or use a previous result
+ * @param m     Mailbox
+ * @param query IMAP SEARCH criteria
+ * @retval true  Success, Email::matched has been set
+ * @retval false Failure
+ */
+static bool search_run(struct Mailbox *m, const char *query)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  struct ImapUidArray uids = ARRAY_HEAD_INITIALIZER;
+  bool ok = true;
+
+  struct ImapSearchCache *sc = search_cache_find(mdata, query);
+  if (sc)
+  {
+    mutt_debug(LL_DEBUG2, "Using cached search: %s\n", query);
+  }
+  else
+  {
+    struct Buffer *cmd = mutt_buffer_pool_get();
+    if (adata->capabilities & IMAP_CAP_ESEARCH)
+      mutt_buffer_printf(cmd, "UID SEARCH RETURN (ALL) %s", query);
+    else
+      mutt_buffer_printf(cmd, "UID SEARCH %s", query);
+
+    mdata->search_uids = &uids;
+    ok = (imap_exec(adata, mutt_buffer_string(cmd), IMAP_CMD_NO_FLAGS) == IMAP_EXEC_SUCCESS);
+    mdata->search_uids = NULL;
+    mutt_buffer_pool_release(&cmd);
+
+    if (ok)
+    {
+      search_cache_add(mdata, query, &uids);
+      sc = ARRAY_LAST(&mdata->search_cache);
+    }
+    ARRAY_FREE(&uids);
+  }
+
+  if (!sc)
+    return false;
+
+  unsigned int *uid = NULL;
+  ARRAY_FOREACH(uid, &sc->uids)
+  {
+    struct Email *e = mutt_hash_int_find(mdata->uid_hash, *uid);
+    if (e)
+      e->matched = true;
+  }
+
+  return true;
+}
+
+/**
+ * imap_search_compile - Convert a pattern to IMAP SEARCH criteria
+ * @param[in]  m    Mailbox
+ * @param[in]  pat  Pattern to convert
+ * @param[out] buf  Buffer for the criteria
+ * @param[out] root Part of the pattern the server can match by itself, may be NULL
+ * @retval true  Success
+ * @retval false Failure
+ *
+ * If all the server-side searches are in a part of the pattern that the
+ * server can match by itself, that whole part is converted and returned in
+ * root.  Otherwise, only the server-side searches are converted.
+ */
+bool imap_search_compile(struct Mailbox *m, struct PatternList *pat,
+                         struct Buffer *buf, struct Pattern **root)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  *root = search_root(m, SLIST_FIRST(pat));
+  if (*root)
+    return compile_search(adata, *root, true, buf);
+
+  return compile_search(adata, SLIST_FIRST(pat), false, buf);
+}
+
 /**
  * imap_search - Find messages in mailbox matching a pattern
  * @param m   Mailbox
  * @param pat Pattern to match
  * @retval true  Success
  * @retval false Failure
+ *
+ * If the server can match part of the pattern by itself, that part is marked
+ * with Pattern::server_match, see imap_search_compile().
  */
-bool imap_search(struct Mailbox *m, const struct PatternList *pat)
+bool imap_search(struct Mailbox *m, struct PatternList *pat)
 {
   for (int i = 0; i < m->msg_count; i++)
   {
@@ -236,16 +553,18 @@ bool imap_search(struct Mailbox *m, const struct PatternList *pat)
     e->matched = false;
   }
 
+  clear_server_match(pat);
   if (check_pattern_list(pat) == 0)
     return true;
 
   struct Buffer buf;
   mutt_buffer_init(&buf);
-  mutt_buffer_addstr(&buf, "UID SEARCH ");
 
-  struct ImapAccountData *adata = imap_adata_get(m);
-  const bool ok = compile_search(adata, SLIST_FIRST(pat), &buf) &&
-                  (imap_exec(adata, buf.data, IMAP_CMD_NO_FLAGS) == IMAP_EXEC_SUCCESS);
+  struct Pattern *root = NULL;
+  bool ok = imap_search_compile(m, pat, &buf, &root);
+  ok = ok && search_run(m, buf.data);
+  if (ok && root)
+    root->server_match = true;
 
   FREE(&buf.data);
   return ok;
@@ -259,17 +578,76 @@ bool imap_search(struct Mailbox *m, const struct PatternList *pat)
 void cmd_parse_search(struct ImapAccountData *adata, const char *s)
 {
   unsigned int uid;
-  struct Email *e = NULL;
   struct ImapMboxData *mdata = adata->mailbox->mdata;
 
   mutt_debug(LL_DEBUG2, "Handling SEARCH\n");
 
+  if (!mdata->search_uids)
+    return;
+
   while ((s = imap_next_word((char *) s)) && (*s != '\0'))
   {
     if (mutt_str_atoui(s, &uid) < 0)
       continue;
-    e = mutt_hash_int_find(mdata->uid_hash, uid);
-    if (e)
-      e->matched = true;
+    ARRAY_ADD(mdata->search_uids, uid);
+  }
+}
+
+/**
+ * cmd_parse_esearch - store ESEARCH response for later use
+ * @param adata Imap Account data
+ * @param s     Command string with search results
+ *
+ * The results are a compact set of UIDs, e.g.
+ * `* ESEARCH (TAG "a1") UID ALL 2,10:15,21`
+ */
+void cmd_parse_esearch(struct ImapAccountData *adata, const char *s)
+{
+  struct ImapMboxData *mdata = adata->mailbox->mdata;
+
+  mutt_debug(LL_DEBUG2, "Handling ESEARCH\n");
+
+  if (!mdata->search_uids)
+    return;
+
+  s = imap_next_word((char *) s);
+  if (*s == '(')
+  {
+    s = strchr(s, ')');
+    if (!s)
+      return;
+    s = imap_next_word((char *) s);
+  }
+
+  while (*s != '\0')
+  {
+    if (!mutt_istr_startswith(s, "ALL "))
+    {
+      s = imap_next_word((char *) s);
+      continue;
+    }
+
+    s = imap_next_word((char *) s);
+    while (isdigit((unsigned char) *s))
+    {
+      char *end = NULL;
+      unsigned long first = strtoul(s, &end, 10);
+      unsigned long last = first;
+      if (*end == ':')
+        last = strtoul(end + 1, &end, 10);
+      if (last < first)
+      {
+        unsigned long tmp = first;
+        first = last;
+        last = tmp;
+      }
+
+      for (unsigned long uid = first; uid <= last; uid++)
+        ARRAY_ADD(mdata->search_uids, uid);
+
+      s = end;
+      if (*s == ',')
+        s++;
+    }
   }
 }
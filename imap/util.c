@@ -108,6 +108,7 @@ void imap_mdata_cache_reset(struct ImapMboxData *mdata)
   mutt_hash_free(&mdata->uid_hash);
   imap_msn_free(&mdata->msn);
   mutt_bcache_close(&mdata->bcache);
+  imap_search_cache_clear(mdata);
 }
 
 /**
@@ -371,6 +372,50 @@ struct Email *imap_hcache_get(struct ImapMboxData *mdata, unsigned int uid)
   return hce.email;
 }
 
+/**
+ * imap_hcache_fetch_cb - Save an Email found in the header cache - Implements ::hcache_fetch_t
+ */
+static void imap_hcache_fetch_cb(void *data, size_t idx, struct HCacheEntry hce)
+{
+  struct Email **emails = data;
+  emails[idx] = hce.email;
+}
+
+/**
+ * imap_hcache_get_many - Get many header cache entries by their UIDs
+ * @param[in]  mdata  Imap Mailbox data
+ * @param[in]  uids   UIDs of the Emails
+ * @param[in]  num    Number of UIDs
+ * @param[out] emails Array of num Emails, set to NULL for a miss
+ */
+void imap_hcache_get_many(struct ImapMboxData *mdata, const unsigned int *uids,
+                          size_t num, struct Email **emails)
+{
+  for (size_t i = 0; i < num; i++)
+    emails[i] = NULL;
+
+  if (!mdata->hcache || (num == 0))
+    return;
+
+  const size_t keysize = 16;
+  char *keybuf = mutt_mem_calloc(num, keysize);
+  const char **keys = mutt_mem_calloc(num, sizeof(char *));
+  size_t *keylens = mutt_mem_calloc(num, sizeof(size_t));
+
+  for (size_t i = 0; i < num; i++)
+  {
+    keys[i] = keybuf + (i * keysize);
+    keylens[i] = snprintf(keybuf + (i * keysize), keysize, "/%u", uids[i]);
+  }
+
+  mutt_hcache_fetch_many(mdata->hcache, keys, keylens, num, mdata->uidvalidity,
+                         imap_hcache_fetch_cb, emails);
+
+  FREE(&keybuf);
+  FREE(&keys);
+  FREE(&keylens);
+}
+
 /**
  * imap_hcache_put - Add an entry to the header cache
  * @param mdata Imap Mailbox data
@@ -42,6 +42,12 @@ static struct ConfigDef IndexVars[] = {
   { "mark_macro_prefix", DT_STRING, IP "'", 0, NULL,
     "Prefix for macros using '<mark-message>'"
   },
+  { "message_prefetch", DT_NUMBER|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "Number of following emails to download while idle"
+  },
+  { "message_prefetch_budget", DT_LONG|DT_NOT_NEGATIVE, 4194304, 0, NULL,
+    "Maximum bytes to download ahead of time, each time the cursor moves"
+  },
   { "uncollapse_jump", DT_BOOL, false, 0, NULL,
     "When opening a thread, jump to the next unread message"
   },
@@ -947,11 +947,9 @@ int index_color(struct Menu *menu, int line)
   if (!e)
     return 0;
 
-  if (e->pair)
-    return e->pair;
-
-  mutt_set_header_color(m, e);
-  return e->pair;
+  if (!e->pair_valid)
+    mutt_set_header_color(m, e);
+  return e->pair ? e->pair : mutt_color(MT_COLOR_NORMAL);
 }
 
 /**
@@ -1370,6 +1368,7 @@ struct Mailbox *mutt_index_menu(struct MuttWindow *dlg, struct Mailbox *m_init)
       }
 
       window_redraw(NULL);
+      index_prefetch(shared);
       op = km_dokey(MENU_MAIN);
 
       /* either user abort or timeout */
@@ -4216,29 +4215,58 @@ struct Mailbox *mutt_index_menu(struct MuttWindow *dlg, struct Mailbox *m_init)
   return m;
 }
 
+/**
+ * color_match - Find the first colour whose pattern matches an Email
+ * @param list  List of colours, e.g. mutt_color_index()
+ * @param m     Mailbox
+ * @param e     Email
+ * @param cache Cache for common Patterns
+ * @retval ptr  Matching colour
+ * @retval NULL No match
+ */
+static struct ColorLine *color_match(struct ColorLineList *list, struct Mailbox *m,
+                                     struct Email *e, struct PatternCache *cache)
+{
+  struct ColorLine *color = NULL;
+  STAILQ_FOREACH(color, list, entries)
+  {
+    if (mutt_pattern_exec(SLIST_FIRST(color->color_pattern),
+                          MUTT_MATCH_FULL_ADDRESS, m, e, cache))
+    {
+      return color;
+    }
+  }
+  return NULL;
+}
+
 /**
  * mutt_set_header_color - Select a colour for a message
  * @param m Mailbox
  * @param e Current Email
+ *
+ * The colours of the line, and of the author, flags and subject, are cached
+ * in the Email until something clears Email::pair_valid.
  */
 void mutt_set_header_color(struct Mailbox *m, struct Email *e)
 {
   if (!e)
     return;
 
-  struct ColorLine *color = NULL;
   struct PatternCache cache = { 0 };
 
-  STAILQ_FOREACH(color, mutt_color_index(), entries)
-  {
-    if (mutt_pattern_exec(SLIST_FIRST(color->color_pattern),
-                          MUTT_MATCH_FULL_ADDRESS, m, e, &cache))
-    {
-      e->pair = color->pair;
-      return;
-    }
-  }
-  e->pair = mutt_color(MT_COLOR_NORMAL);
+  struct ColorLine *color = color_match(mutt_color_index(), m, e, &cache);
+  e->pair = color ? color->pair : 0;
+
+  color = color_match(mutt_color_index_author(), m, e, &cache);
+  e->pair_author = color ? color->pair : 0;
+
+  color = color_match(mutt_color_index_flags(), m, e, &cache);
+  e->pair_flags = color ? color->pair : 0;
+
+  color = color_match(mutt_color_index_subject(), m, e, &cache);
+  e->pair_subject = color ? color->pair : 0;
+
+  e->pair_valid = true;
 }
 
 /**
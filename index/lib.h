@@ -30,6 +30,7 @@
  * | index/config.c       | @subpage index_config       |
  * | index/index.c        | @subpage index_index        |
  * | index/observer.c     | @subpage index_observer     |
+ * | index/prefetch.c     | @subpage index_prefetch     |
  * | index/private_data.c | @subpage index_private_data |
  * | index/shared_data.c  | @subpage index_shared_data  |
  */
@@ -66,5 +67,6 @@ void mutt_set_header_color(struct Mailbox *m, struct Email *e);
 void mutt_update_index(struct Menu *menu, struct Context *ctx, enum MxStatus check, int oldcount, struct IndexSharedData *shared);
 struct MuttWindow *index_pager_init(void);
 void index_pager_shutdown(struct MuttWindow *dlg);
+void index_prefetch(struct IndexSharedData *shared);
 
 #endif /* MUTT_INDEX_LIB_H */
@@ -183,7 +183,7 @@ static int index_color_observer(struct NotifyCallback *nc)
       struct Email *e = m->emails[i];
       if (!e)
         break;
-      e->pair = 0;
+      e->pair_valid = false;
     }
   }
 
@@ -299,7 +299,7 @@ static int index_score_observer(struct NotifyCallback *nc)
       break;
 
     mutt_score_message(m, e, true);
-    e->pair = 0; // Force recalc of colour
+    e->pair_valid = false; // Force recalc of colour
   }
 
   mutt_debug(LL_DEBUG5, "score done\n");
@@ -0,0 +1,244 @@
+/**
+ * @file
+ * Download emails ahead of time
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page index_prefetch Download emails ahead of time
+ *
+ * While the user is reading, the emails they're likely to read next are
+ * downloaded into the body cache, so that opening them doesn't have to wait
+ * for the server.
+ *
+ * The candidates are the rest of the current thread, then the next
+ * `$message_prefetch` emails in the Index.  They're downloaded one at a time,
+ * only while no keys are waiting.  As soon as the user presses a key, control
+ * returns to the Index, or Pager, after the current email has finished.
+ *
+ * Each time the cursor moves, up to `$message_prefetch_budget` bytes will be
+ * downloaded.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "gui/lib.h"
+#include "lib.h"
+#include "context.h"
+#include "mutt_globals.h"
+#include "mx.h"
+#include "shared_data.h"
+#ifdef USE_INOTIFY
+#include "monitor.h"
+#endif
+
+/// How long the user must be idle, in milliseconds, before downloading starts
+#define PREFETCH_IDLE_MS 500
+
+ARRAY_HEAD(PrefetchEmailArray, struct Email *);
+
+/**
+ * struct PrefetchState - State of the downloads for the current cursor position
+ *
+ * The Emails in `tried` are only compared, never dereferenced, so it doesn't
+ * matter if they have been freed since.
+ */
+struct PrefetchState
+{
+  struct Mailbox *mailbox;         ///< Mailbox being prefetched
+  size_t email_seq;                ///< Sequence number of the current Email
+  long used;                       ///< Bytes downloaded since the cursor moved
+  bool finished;                   ///< There's nothing left to download
+  struct PrefetchEmailArray tried; ///< Emails already considered
+};
+
+static struct PrefetchState Prefetch = { 0 };
+
+/**
+ * prefetch_wanted - Should this Email be downloaded?
+ * @param e Email
+ * @retval true It hasn't been considered yet
+ */
+static bool prefetch_wanted(struct Email *e)
+{
+  if (!e || !e->visible)
+    return false;
+
+  struct Email **ep = NULL;
+  ARRAY_FOREACH(ep, &Prefetch.tried)
+  {
+    if (*ep == e)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * prefetch_next - Find the next Email to download
+ * @param shared Shared Index data
+ * @param count  Number of following Emails in the Index to consider
+ * @retval ptr  Email to download
+ * @retval NULL Nothing left to do
+ */
+static struct Email *prefetch_next(struct IndexSharedData *shared, int count)
+{
+  struct Mailbox *m = shared->mailbox;
+  struct Email *e_cur = shared->email;
+
+  /* The rest of the current thread, even if it's collapsed */
+  const short c_sort = cs_subset_sort(shared->sub, "sort");
+  if (((c_sort & SORT_MASK) == SORT_THREADS) && e_cur->thread)
+  {
+    struct MuttThread *top = e_cur->thread;
+    while (top->parent)
+      top = top->parent;
+
+    bool after = false;
+    struct MuttThread *t = top;
+    while (t)
+    {
+      if (t->message == e_cur)
+        after = true;
+      else if (after && prefetch_wanted(t->message))
+        return t->message;
+
+      if (t->child)
+      {
+        t = t->child;
+        continue;
+      }
+
+      while ((t != top) && !t->next)
+        t = t->parent;
+      t = (t == top) ? NULL : t->next;
+    }
+  }
+
+  /* The following Emails in the Index */
+  for (int i = 1; (i <= count) && (e_cur->vnum >= 0); i++)
+  {
+    struct Email *e = mutt_get_virt_email(m, e_cur->vnum + i);
+    if (!e)
+      break;
+    if (prefetch_wanted(e))
+      return e;
+  }
+
+  return NULL;
+}
+
+/**
+ * prefetch_step - Download one Email
+ * @param shared Shared Index data
+ *
+ * Emails that are already in the cache are skipped, without using any of the
+ * budget.  Emails that won't fit in the remaining budget aren't downloaded.
+ */
+static void prefetch_step(struct IndexSharedData *shared)
+{
+  const short c_message_prefetch = cs_subset_number(shared->sub, "message_prefetch");
+  const long c_message_prefetch_budget =
+      cs_subset_long(shared->sub, "message_prefetch_budget");
+
+  struct Email *e = NULL;
+  while ((e = prefetch_next(shared, c_message_prefetch)))
+  {
+    ARRAY_ADD(&Prefetch.tried, e);
+
+    if ((c_message_prefetch_budget > 0) && e->body &&
+        ((Prefetch.used + e->body->length) > c_message_prefetch_budget))
+    {
+      continue;
+    }
+
+    long bytes = mx_msg_prefetch(shared->mailbox, e);
+    if (bytes < 0)
+    {
+      mutt_debug(LL_DEBUG1, "Prefetch failed, stopping\n");
+      break;
+    }
+
+    if (bytes > 0)
+    {
+      mutt_debug(LL_DEBUG2, "Prefetched %ld bytes\n", bytes);
+      Prefetch.used += bytes;
+      return;
+    }
+  }
+
+  Prefetch.finished = true;
+  ARRAY_FREE(&Prefetch.tried);
+}
+
+/**
+ * index_prefetch - Download Emails ahead of time, while the user is idle
+ * @param shared Shared Index data
+ *
+ * This returns as soon as a key is pressed, or there's nothing left to do.
+ * The key is left for km_dokey().
+ */
+void index_prefetch(struct IndexSharedData *shared)
+{
+  if (!shared || !shared->mailbox || !shared->email)
+    return;
+
+  const short c_message_prefetch = cs_subset_number(shared->sub, "message_prefetch");
+  struct Mailbox *m = shared->mailbox;
+  if ((c_message_prefetch < 1) || !m->mx_ops || !m->mx_ops->msg_prefetch)
+    return;
+
+  if ((Prefetch.mailbox != m) || (Prefetch.email_seq != shared->email_seq))
+  {
+    ARRAY_FREE(&Prefetch.tried);
+    Prefetch.mailbox = m;
+    Prefetch.email_seq = shared->email_seq;
+    Prefetch.used = 0;
+    Prefetch.finished = false;
+  }
+
+  int delay = PREFETCH_IDLE_MS;
+  while (!Prefetch.finished)
+  {
+    mutt_getch_timeout(delay);
+    struct KeyEvent ch = mutt_getch();
+    mutt_getch_timeout(-1);
+
+    if (ch.ch != -2)
+    {
+      mutt_unget_event(ch.ch, ch.op);
+      return;
+    }
+
+    if (SigWinch)
+      return;
+#ifdef USE_INOTIFY
+    if (MonitorFilesChanged)
+      return;
+#endif
+
+    prefetch_step(shared);
+    delay = 0;
+  }
+}
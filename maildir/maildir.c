@@ -71,6 +71,8 @@ struct Progress;
 #define MMC_NEW_DIR (1 << 0) ///< 'new' directory changed
 #define MMC_CUR_DIR (1 << 1) ///< 'cur' directory changed
 
+ARRAY_HEAD(EmailArray, struct Email *);
+
 /**
  * maildir_check_dir - Check for new mail / mail counts
  * @param m           Mailbox to check
@@ -88,9 +90,10 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
   char *p = NULL;
   struct stat sb;
 
-  struct Buffer *path = mutt_buffer_pool_get();
-  struct Buffer *msgpath = mutt_buffer_pool_get();
-  mutt_buffer_printf(path, "%s/%s", mailbox_path(m), dir_name);
+  /* This may be run in a worker thread, so it can't use the buffer pool */
+  struct Buffer path = mutt_buffer_make(0);
+  struct Buffer msgpath = mutt_buffer_make(0);
+  mutt_buffer_printf(&path, "%s/%s", mailbox_path(m), dir_name);
 
   /* when $mail_check_recent is set, if the new/ directory hasn't been modified since
    * the user last exited the m, then we know there is no recent mail.  */
@@ -98,7 +101,7 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
       cs_subset_bool(NeoMutt->sub, "mail_check_recent");
   if (check_new && c_mail_check_recent)
   {
-    if ((stat(mutt_buffer_string(path), &sb) == 0) &&
+    if ((stat(mutt_buffer_string(&path), &sb) == 0) &&
         (mutt_file_stat_timespec_compare(&sb, MUTT_STAT_MTIME, &m->last_visited) < 0))
     {
       check_new = false;
@@ -108,7 +111,7 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
   if (!(check_new || check_stats))
     goto cleanup;
 
-  dirp = opendir(mutt_buffer_string(path));
+  dirp = opendir(mutt_buffer_string(&path));
   if (!dirp)
   {
     m->type = MUTT_UNKNOWN;
@@ -138,9 +141,9 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
       {
         if (c_mail_check_recent)
         {
-          mutt_buffer_printf(msgpath, "%s/%s", mutt_buffer_string(path), de->d_name);
+          mutt_buffer_printf(&msgpath, "%s/%s", mutt_buffer_string(&path), de->d_name);
           /* ensure this message was received since leaving this m */
-          if ((stat(mutt_buffer_string(msgpath), &sb) == 0) &&
+          if ((stat(mutt_buffer_string(&msgpath), &sb) == 0) &&
               (mutt_file_stat_timespec_compare(&sb, MUTT_STAT_CTIME, &m->last_visited) <= 0))
           {
             continue;
@@ -158,8 +161,8 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
   closedir(dirp);
 
 cleanup:
-  mutt_buffer_pool_release(&path);
-  mutt_buffer_pool_release(&msgpath);
+  mutt_buffer_dealloc(&path);
+  mutt_buffer_dealloc(&msgpath);
 }
 
 /**
@@ -498,6 +501,32 @@ static int maildir_cmp_inode(const void *a, const void *b)
   return ma->inode - mb->inode;
 }
 
+/**
+ * maildir_email_new - Create an Email for a file in a Maildir
+ * @param subdir Subdirectory, e.g. 'new'
+ * @param name   Filename
+ * @param is_old Mark the Email as old
+ * @retval ptr New Email
+ *
+ * Only the flags in the filename are parsed.
+ */
+static struct Email *maildir_email_new(const char *subdir, const char *name, bool is_old)
+{
+  struct Email *e = email_new();
+  e->edata = maildir_edata_new();
+  e->edata_free = maildir_edata_free;
+
+  e->old = is_old;
+  maildir_parse_flags(e, name);
+
+  struct Buffer *buf = mutt_buffer_pool_get();
+  mutt_buffer_printf(buf, "%s/%s", subdir, name);
+  e->path = mutt_buffer_strdup(buf);
+  mutt_buffer_pool_release(&buf);
+
+  return e;
+}
+
 /**
  * maildir_parse_dir - Read a Maildir mailbox
  * @param[in]  m        Mailbox
@@ -538,19 +567,11 @@ int maildir_parse_dir(struct Mailbox *m, struct MdEmailArray *mda,
     /* FOO - really ignore the return value? */
     mutt_debug(LL_DEBUG2, "queueing %s\n", de->d_name);
 
-    e = email_new();
-    e->edata = maildir_edata_new();
-    e->edata_free = maildir_edata_free;
-
-    e->old = is_old;
-    maildir_parse_flags(e, de->d_name);
+    e = maildir_email_new(subdir, de->d_name, is_old);
 
     if (m->verbose && progress)
       progress_update(progress, ARRAY_SIZE(mda) + 1, -1);
 
-    mutt_buffer_printf(buf, "%s/%s", subdir, de->d_name);
-    e->path = mutt_buffer_strdup(buf);
-
     entry = maildir_entry_new();
     entry->email = e;
     entry->inode = de->d_ino;
@@ -586,6 +607,246 @@ size_t maildir_hcache_keylen(const char *fn)
   return p ? (size_t) (p - fn) : mutt_str_len(fn);
 }
 
+#ifdef USE_HCACHE
+/**
+ * maildir_hcache_restore - Replace a Maildir Email with one from the header cache
+ * @param md    Maildir Email
+ * @param e     Email from the header cache
+ * @param fname Full path of the message file
+ */
+static void maildir_hcache_restore(struct MdEmail *md, struct Email *e, const char *fname)
+{
+  e->edata = maildir_edata_new();
+  e->edata_free = maildir_edata_free;
+  e->old = md->email->old;
+  e->path = mutt_str_dup(md->email->path);
+  email_free(&md->email);
+  md->email = e;
+  maildir_parse_flags(md->email, fname);
+}
+
+/**
+ * maildir_hcache_fetch_cb - Save an Email found in the header cache - Implements ::hcache_fetch_t
+ */
+static void maildir_hcache_fetch_cb(void *data, size_t idx, struct HCacheEntry hce)
+{
+  struct HCacheEntry *hits = data;
+  hits[idx] = hce;
+}
+
+/**
+ * maildir_hcache_fetch_all - Look up many Maildir Emails in the header cache
+ * @param hc  Header cache
+ * @param mds Maildir Emails
+ * @param num Number of Maildir Emails
+ * @retval ptr Array of num cache entries; the Email is NULL for a miss
+ *
+ * @note The caller must free the array and any Emails in it
+ */
+static struct HCacheEntry *maildir_hcache_fetch_all(struct HeaderCache *hc,
+                                                    struct MdEmail **mds, size_t num)
+{
+  struct HCacheEntry *hits = mutt_mem_calloc(num, sizeof(struct HCacheEntry));
+  if (!hc || (num == 0))
+    return hits;
+
+  const char **keys = mutt_mem_calloc(num, sizeof(char *));
+  size_t *keylens = mutt_mem_calloc(num, sizeof(size_t));
+  for (size_t i = 0; i < num; i++)
+  {
+    keys[i] = mds[i]->email->path + 3;
+    keylens[i] = maildir_hcache_keylen(keys[i]);
+  }
+
+  mutt_hcache_fetch_many(hc, keys, keylens, num, 0, maildir_hcache_fetch_cb, hits);
+
+  FREE(&keys);
+  FREE(&keylens);
+  return hits;
+}
+#endif
+
+/**
+ * struct MdPrefetch - A Maildir message being read by a worker thread
+ */
+struct MdPrefetch
+{
+  struct MdEmail *md; ///< Maildir Email
+  char *fname;        ///< Full path of the message file
+  FILE *fp;           ///< Open message, with the first block already read
+  int stat_rc;        ///< Result of stat() on the message file
+  time_t mtime;       ///< Modification time of the message file
+};
+
+/// Number of message files that are open at the same time
+#define MAILDIR_PREFETCH_BATCH 256
+
+#ifdef USE_HCACHE
+/**
+ * maildir_prefetch_stat - Get the modification times of message files - Implements ::worker_t
+ */
+static void maildir_prefetch_stat(void *data, size_t start, size_t end)
+{
+  struct MdPrefetch *mp = data;
+  struct stat st = { 0 };
+
+  for (size_t i = start; i < end; i++)
+  {
+    mp[i].stat_rc = stat(mp[i].fname, &st);
+    mp[i].mtime = st.st_mtime;
+  }
+}
+#endif
+
+/**
+ * maildir_prefetch_open - Open message files and read their first block - Implements ::worker_t
+ *
+ * The data is left in the stdio buffer of the file handle, so the main thread
+ * can parse the headers without waiting for the disk.
+ */
+static void maildir_prefetch_open(void *data, size_t start, size_t end)
+{
+  struct MdPrefetch *mp = data;
+
+  for (size_t i = start; i < end; i++)
+  {
+    FILE *fp = fopen(mp[i].fname, "r");
+    if (!fp)
+      continue;
+
+    int ch = fgetc(fp);
+    if (ch != EOF)
+      ungetc(ch, fp);
+    mp[i].fp = fp;
+  }
+}
+
+/**
+ * maildir_delayed_parsing_prefetch - Do the second parsing pass, reading the files on worker threads
+ * @param[in]  m           Mailbox
+ * @param[out] mda         Maildir array to parse
+ * @param[in]  progress    Progress bar
+ * @param[in]  num_threads Number of threads to use
+ *
+ * The worker threads only do the file I/O: stat() and the first read of each
+ * message.  The headers are parsed, in order, on this thread.  The parser
+ * isn't thread-safe: it uses the global Buffer pool, the logger, the iconv
+ * descriptor cache, and $auto_subscribe adds to the global list of
+ * subscribed addresses.  The header cache backends aren't thread-safe either.
+ */
+static void maildir_delayed_parsing_prefetch(struct Mailbox *m, struct MdEmailArray *mda,
+                                             struct Progress *progress, int num_threads)
+{
+  struct MdPrefetch *mp = mutt_mem_calloc(ARRAY_SIZE(mda), sizeof(struct MdPrefetch));
+  struct Buffer *fn = mutt_buffer_pool_get();
+  size_t num = 0;
+  size_t done = 0;
+
+  struct MdEmail **mdp = NULL;
+  ARRAY_FOREACH(mdp, mda)
+  {
+    struct MdEmail *md = *mdp;
+    if (!md || !md->email || md->header_parsed)
+      continue;
+
+    mutt_buffer_printf(fn, "%s/%s", mailbox_path(m), md->email->path);
+    mp[num].md = md;
+    mp[num].fname = mutt_buffer_strdup(fn);
+    num++;
+  }
+  mutt_buffer_pool_release(&fn);
+
+#ifdef USE_HCACHE
+  const char *const c_header_cache =
+      cs_subset_path(NeoMutt->sub, "header_cache");
+  struct HeaderCache *hc = mutt_hcache_open(c_header_cache, mailbox_path(m), NULL);
+  mutt_hcache_begin(hc);
+
+  const bool c_maildir_header_cache_verify =
+      cs_subset_bool(NeoMutt->sub, "maildir_header_cache_verify");
+  if (c_maildir_header_cache_verify)
+    mutt_worker_run(num, 64, num_threads, maildir_prefetch_stat, mp);
+
+  struct MdEmail **mds = mutt_mem_calloc(num, sizeof(struct MdEmail *));
+  for (size_t i = 0; i < num; i++)
+    mds[i] = mp[i].md;
+  struct HCacheEntry *hits = maildir_hcache_fetch_all(hc, mds, num);
+  FREE(&mds);
+
+  /* Satisfy what we can from the cache, keeping only the misses */
+  size_t num_miss = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    struct MdEmail *md = mp[i].md;
+    struct HCacheEntry *hce = &hits[i];
+
+    if (hce->email && (mp[i].stat_rc == 0) && (mp[i].mtime <= hce->uidvalidity))
+    {
+      if (m->verbose && progress)
+        progress_update(progress, done, -1);
+      done++;
+      maildir_hcache_restore(md, hce->email, mp[i].fname);
+      FREE(&mp[i].fname);
+      continue;
+    }
+
+    email_free(&hce->email);
+    mp[num_miss++] = mp[i];
+  }
+  num = num_miss;
+  FREE(&hits);
+#endif
+
+  for (size_t batch = 0; batch < num; batch += MAILDIR_PREFETCH_BATCH)
+  {
+    struct MdPrefetch *mpb = mp + batch;
+    const size_t count = MIN(num - batch, MAILDIR_PREFETCH_BATCH);
+
+    mutt_worker_run(count, 8, num_threads, maildir_prefetch_open, mpb);
+
+    for (size_t i = 0; i < count; i++)
+    {
+      struct MdEmail *md = mpb[i].md;
+      if (m->verbose && progress)
+        progress_update(progress, done, -1);
+      done++;
+
+      if (mpb[i].fp && maildir_parse_stream(m->type, mpb[i].fp, mpb[i].fname,
+                                            md->email->old, md->email))
+      {
+        md->header_parsed = true;
+      }
+      else
+      {
+        email_free(&md->email);
+      }
+      mutt_file_fclose(&mpb[i].fp);
+    }
+
+#ifdef USE_HCACHE
+    /* Store the batch in one go */
+    for (size_t i = 0; i < count; i++)
+    {
+      struct MdEmail *md = mpb[i].md;
+      if (!md->email)
+        continue;
+      const char *key = md->email->path + 3;
+      size_t keylen = maildir_hcache_keylen(key);
+      mutt_hcache_store(hc, key, keylen, md->email, 0);
+    }
+#endif
+  }
+
+  for (size_t i = 0; i < num; i++)
+    FREE(&mp[i].fname);
+  FREE(&mp);
+
+#ifdef USE_HCACHE
+  mutt_hcache_commit(hc);
+  mutt_hcache_close(hc);
+#endif
+}
+
 /**
  * maildir_delayed_parsing - This function does the second parsing pass
  * @param[in]  m   Mailbox
@@ -595,70 +856,88 @@ size_t maildir_hcache_keylen(const char *fn)
 void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
                              struct Progress *progress)
 {
+  const short c_maildir_read_threads =
+      cs_subset_number(NeoMutt->sub, "maildir_read_threads");
+  if ((c_maildir_read_threads > 1) && mutt_worker_available())
+  {
+    maildir_delayed_parsing_prefetch(m, mda, progress, c_maildir_read_threads);
+    return;
+  }
+
   char fn[PATH_MAX];
 
+  struct MdEmail **mds = mutt_mem_calloc(ARRAY_SIZE(mda), sizeof(struct MdEmail *));
+  size_t num = 0;
+
+  struct MdEmail **mdp = NULL;
+  ARRAY_FOREACH(mdp, mda)
+  {
+    struct MdEmail *md = *mdp;
+    if (!md || !md->email || md->header_parsed)
+      continue;
+
+    mds[num++] = md;
+  }
+
 #ifdef USE_HCACHE
   const char *const c_header_cache =
       cs_subset_path(NeoMutt->sub, "header_cache");
   struct HeaderCache *hc = mutt_hcache_open(c_header_cache, mailbox_path(m), NULL);
+  mutt_hcache_begin(hc);
+
+  struct HCacheEntry *hits = maildir_hcache_fetch_all(hc, mds, num);
+  const bool c_maildir_header_cache_verify =
+      cs_subset_bool(NeoMutt->sub, "maildir_header_cache_verify");
 #endif
 
-  struct MdEmail *md = NULL;
-  struct MdEmail **mdp = NULL;
-  ARRAY_FOREACH(mdp, mda)
+  for (size_t i = 0; i < num; i++)
   {
-    md = *mdp;
-    if (!md || !md->email || md->header_parsed)
-      continue;
+    struct MdEmail *md = mds[i];
 
     if (m->verbose && progress)
-      progress_update(progress, ARRAY_FOREACH_IDX, -1);
+      progress_update(progress, i, -1);
 
     snprintf(fn, sizeof(fn), "%s/%s", mailbox_path(m), md->email->path);
 
 #ifdef USE_HCACHE
-    struct stat lastchanged = { 0 };
-    int rc = 0;
-    const bool c_maildir_header_cache_verify =
-        cs_subset_bool(NeoMutt->sub, "maildir_header_cache_verify");
-    if (c_maildir_header_cache_verify)
+    if (hits[i].email)
     {
-      rc = stat(fn, &lastchanged);
-    }
+      struct stat lastchanged = { 0 };
+      int rc = 0;
+      if (c_maildir_header_cache_verify)
+      {
+        rc = stat(fn, &lastchanged);
+      }
 
-    const char *key = md->email->path + 3;
-    size_t keylen = maildir_hcache_keylen(key);
-    struct HCacheEntry hce = mutt_hcache_fetch(hc, key, keylen, 0);
+      if ((rc == 0) && (lastchanged.st_mtime <= hits[i].uidvalidity))
+      {
+        maildir_hcache_restore(md, hits[i].email, fn);
+        continue;
+      }
 
-    if (hce.email && (rc == 0) && (lastchanged.st_mtime <= hce.uidvalidity))
-    {
-      hce.email->edata = maildir_edata_new();
-      hce.email->edata_free = maildir_edata_free;
-      hce.email->old = md->email->old;
-      hce.email->path = mutt_str_dup(md->email->path);
-      email_free(&md->email);
-      md->email = hce.email;
-      maildir_parse_flags(md->email, fn);
+      email_free(&hits[i].email);
     }
-    else
 #endif
+
+    if (maildir_parse_message(m->type, fn, md->email->old, md->email))
     {
-      if (maildir_parse_message(m->type, fn, md->email->old, md->email))
-      {
-        md->header_parsed = true;
+      md->header_parsed = true;
 #ifdef USE_HCACHE
-        key = md->email->path + 3;
-        keylen = maildir_hcache_keylen(key);
-        mutt_hcache_store(hc, key, keylen, md->email, 0);
+      const char *key = md->email->path + 3;
+      size_t keylen = maildir_hcache_keylen(key);
+      mutt_hcache_store(hc, key, keylen, md->email, 0);
 #endif
-      }
-      else
-        email_free(&md->email);
     }
+    else
+      email_free(&md->email);
   }
+
 #ifdef USE_HCACHE
+  FREE(&hits);
+  mutt_hcache_commit(hc);
   mutt_hcache_close(hc);
 #endif
+  FREE(&mds);
 }
 
 /**
@@ -842,7 +1121,8 @@ void maildir_parse_flags(struct Email *e, const char *path)
 
         case 'T': /* trashed */
         {
-          const bool c_flag_safe = cs_subset_bool(NeoMutt->sub, "flag_safe");
+          static struct ConfigHandle h_flag_safe = { "flag_safe" };
+          const bool c_flag_safe = cs_handle_bool(NeoMutt->sub, &h_flag_safe);
           if (!e->flagged || !c_flag_safe)
           {
             e->trash = true;
@@ -1151,6 +1431,218 @@ static bool maildir_mbox_open_append(struct Mailbox *m, OpenMailboxFlags flags)
   return true;
 }
 
+/**
+ * maildir_merge_email - Update an Email from a freshly scanned copy
+ * @param m     Mailbox
+ * @param e     Email in the Mailbox
+ * @param e_new Email created from the file's current name
+ * @retval true The flags changed
+ */
+static bool maildir_merge_email(struct Mailbox *m, struct Email *e, struct Email *e_new)
+{
+  bool flags_changed = false;
+
+  /* check to see if the message has moved to a different
+   * subdirectory.  If so, update the associated filename.  */
+  if (!mutt_str_equal(e->path, e_new->path))
+    mutt_str_replace(&e->path, e_new->path);
+
+  /* if the user hasn't modified the flags on this message, update
+   * the flags we just detected.  */
+  if (!e->changed)
+    if (maildir_update_flags(m, e, e_new))
+      flags_changed = true;
+
+  if (e->deleted == e->trash)
+  {
+    if (e->deleted != e_new->deleted)
+    {
+      e->deleted = e_new->deleted;
+      flags_changed = true;
+    }
+  }
+  e->trash = e_new->trash;
+
+  return flags_changed;
+}
+
+#ifdef USE_INOTIFY
+/**
+ * maildir_canon_find - Find an Email by its canonical filename
+ * @param m     Mailbox
+ * @param canon Canonical filename, see maildir_canon_filename()
+ * @retval ptr  Email
+ * @retval NULL Not found
+ *
+ * The lookup table is rebuilt whenever it's found to be out of date, e.g.
+ * after the Mailbox has been rescanned or expunged.
+ */
+static struct Email *maildir_canon_find(struct Mailbox *m, const char *canon)
+{
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  struct Buffer *buf = mutt_buffer_pool_get();
+  struct Email *e_found = NULL;
+
+  for (int pass = 0; pass < 2; pass++)
+  {
+    if (!mdata->canon_hash || (mdata->canon_count != m->msg_count) || (pass > 0))
+    {
+      mutt_hash_free(&mdata->canon_hash);
+      mdata->canon_hash = mutt_hash_new(MAX(m->msg_count, 128),
+                                        MUTT_HASH_STRDUP_KEYS | MUTT_HASH_OPEN_ADDR);
+      for (int i = 0; i < m->msg_count; i++)
+      {
+        struct Email *e = m->emails[i];
+        if (!e)
+          break;
+        maildir_canon_filename(buf, e->path);
+        mutt_hash_insert(mdata->canon_hash, mutt_buffer_string(buf), (void *) (intptr_t) (i + 1));
+      }
+      mdata->canon_count = m->msg_count;
+    }
+
+    const intptr_t index = (intptr_t) mutt_hash_find(mdata->canon_hash, canon) - 1;
+    if (index < 0)
+      break;
+
+    /* The Emails may have moved since the table was built */
+    struct Email *e = (index < m->msg_count) ? m->emails[index] : NULL;
+    if (e)
+    {
+      maildir_canon_filename(buf, e->path);
+      if (mutt_str_equal(mutt_buffer_string(buf), canon))
+      {
+        e_found = e;
+        break;
+      }
+    }
+  }
+
+  mutt_buffer_pool_release(&buf);
+  return e_found;
+}
+
+/**
+ * maildir_check_events - Apply the changes reported by the monitor
+ * @param m      Mailbox
+ * @param events Files added to, or removed from, the Maildir
+ * @retval enum #MxStatus
+ *
+ * This is the incremental version of maildir_mbox_check().  Only the files
+ * that were added or removed are looked at.
+ */
+static enum MxStatus maildir_check_events(struct Mailbox *m, struct MonitorEventArray *events)
+{
+  bool occult = false;
+  bool flags_changed = false;
+  const bool c_mark_old = cs_subset_bool(NeoMutt->sub, "mark_old");
+
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  struct MdEmailArray mda = ARRAY_HEAD_INITIALIZER;
+  struct EmailArray removed = ARRAY_HEAD_INITIALIZER;
+  struct HashTable *arrivals = mutt_hash_new(MAX(ARRAY_SIZE(events), 16), MUTT_HASH_STRDUP_KEYS);
+  struct Buffer *canon = mutt_buffer_pool_get();
+
+  struct MonitorEvent *ev = NULL;
+  ARRAY_FOREACH(ev, events)
+  {
+    const char *subdir = ev->cur ? "cur" : "new";
+    mutt_debug(LL_DEBUG2, "%s %s/%s\n", ev->added ? "added" : "removed", subdir, ev->name);
+
+    maildir_canon_filename(canon, ev->name);
+    struct Email *e = maildir_canon_find(m, mutt_buffer_string(canon));
+    struct MdEmail *md = mutt_hash_find(arrivals, mutt_buffer_string(canon));
+    struct Email *e_new = maildir_email_new(subdir, ev->name, c_mark_old && ev->cur);
+
+    if (ev->added)
+    {
+      if (e)
+      {
+        /* A known email has been renamed */
+        e->active = true;
+        if (maildir_merge_email(m, e, e_new))
+          flags_changed = true;
+        email_free(&e_new);
+      }
+      else if (md)
+      {
+        /* A new email has been renamed before we've read it */
+        email_free(&md->email);
+        md->email = e_new;
+      }
+      else
+      {
+        md = maildir_entry_new();
+        md->email = e_new;
+        md->canon_fname = mutt_buffer_strdup(canon);
+        ARRAY_ADD(&mda, md);
+        mutt_hash_insert(arrivals, md->canon_fname, md);
+      }
+    }
+    else
+    {
+      if (e && mutt_str_equal(e->path, e_new->path))
+        ARRAY_ADD(&removed, e);
+      else if (md && md->email && mutt_str_equal(md->email->path, e_new->path))
+        email_free(&md->email);
+      email_free(&e_new);
+    }
+  }
+
+  /* The file may have been renamed again, or the event may be stale */
+  struct Email **ep = NULL;
+  ARRAY_FOREACH(ep, &removed)
+  {
+    struct Email *e = *ep;
+    mutt_buffer_printf(canon, "%s/%s", mailbox_path(m), e->path);
+    if (access(mutt_buffer_string(canon), F_OK) == 0)
+      continue;
+
+    occult = true;
+    e->deleted = true;
+    e->purge = true;
+  }
+
+  ARRAY_FREE(&removed);
+  mutt_hash_free(&arrivals);
+  mutt_buffer_pool_release(&canon);
+
+  if (occult)
+    mailbox_changed(m, NT_MAILBOX_RESORT);
+
+  maildir_delayed_parsing(m, &mda, NULL);
+
+  const int old_count = m->msg_count;
+  const int num_new = maildir_move_to_mailbox(m, &mda);
+  if (num_new > 0)
+  {
+    /* Keep the lookup table in step with the new Emails */
+    if (mdata->canon_hash && (mdata->canon_count == old_count))
+    {
+      struct Buffer *buf = mutt_buffer_pool_get();
+      for (int i = old_count; i < m->msg_count; i++)
+      {
+        maildir_canon_filename(buf, m->emails[i]->path);
+        mutt_hash_insert(mdata->canon_hash, mutt_buffer_string(buf), (void *) (intptr_t) (i + 1));
+      }
+      mutt_buffer_pool_release(&buf);
+      mdata->canon_count = m->msg_count;
+    }
+    mailbox_changed(m, NT_MAILBOX_INVALID);
+    m->changed = true;
+  }
+
+  ARRAY_FREE(&mda);
+  if (occult)
+    return MX_STATUS_REOPENED;
+  if (num_new > 0)
+    return MX_STATUS_NEW_MAIL;
+  if (flags_changed)
+    return MX_STATUS_FLAGS;
+  return MX_STATUS_OK;
+}
+#endif
+
 /**
  * maildir_mbox_check - Check for new mail - Implements MxOps::mbox_check()
  *
@@ -1178,6 +1670,24 @@ enum MxStatus maildir_mbox_check(struct Mailbox *m)
   if (!c_check_new)
     return MX_STATUS_OK;
 
+#ifdef USE_INOTIFY
+  /* If the monitor has seen every change, just apply them */
+  struct MonitorEventArray events = ARRAY_HEAD_INITIALIZER;
+  const int rc_events = mutt_monitor_events(m, &events);
+  if (rc_events == 0)
+  {
+    MonitorContextChanged = false;
+    enum MxStatus rc = maildir_check_events(m, &events);
+    struct MonitorEvent *ev = NULL;
+    ARRAY_FOREACH(ev, &events)
+    {
+      FREE(&ev->name);
+    }
+    ARRAY_FREE(&events);
+    return rc;
+  }
+#endif
+
   struct Buffer *buf = mutt_buffer_pool_get();
   mutt_buffer_printf(buf, "%s/new", mailbox_path(m));
   if (stat(mutt_buffer_string(buf), &st_new) == -1)
@@ -1198,6 +1708,11 @@ enum MxStatus maildir_mbox_check(struct Mailbox *m)
     changed = MMC_NEW_DIR;
   if (mutt_file_stat_timespec_compare(&st_cur, MUTT_STAT_MTIME, &mdata->mtime_cur) > 0)
     changed |= MMC_CUR_DIR;
+#ifdef USE_INOTIFY
+  /* Events were lost, so the mtimes can't be trusted */
+  if (rc_events == -2)
+    changed = MMC_NEW_DIR | MMC_CUR_DIR;
+#endif
 
   if (changed == MMC_NO_DIRS)
   {
@@ -1232,7 +1747,7 @@ enum MxStatus maildir_mbox_check(struct Mailbox *m)
   /* we create a hash table keyed off the canonical (sans flags) filename
    * of each message we scanned.  This is used in the loop over the
    * existing messages below to do some correlation.  */
-  fnames = mutt_hash_new(ARRAY_SIZE(&mda), MUTT_HASH_NO_FLAGS);
+  fnames = mutt_hash_new(ARRAY_SIZE(&mda), MUTT_HASH_OPEN_ADDR);
 
   struct MdEmail *md = NULL;
   struct MdEmail **mdp = NULL;
@@ -1258,27 +1773,8 @@ enum MxStatus maildir_mbox_check(struct Mailbox *m)
     {
       /* message already exists, merge flags */
       e->active = true;
-
-      /* check to see if the message has moved to a different
-       * subdirectory.  If so, update the associated filename.  */
-      if (!mutt_str_equal(e->path, md->email->path))
-        mutt_str_replace(&e->path, md->email->path);
-
-      /* if the user hasn't modified the flags on this message, update
-       * the flags we just detected.  */
-      if (!e->changed)
-        if (maildir_update_flags(m, e, md->email))
-          flags_changed = true;
-
-      if (e->deleted == e->trash)
-      {
-        if (e->deleted != md->email->deleted)
-        {
-          e->deleted = md->email->deleted;
-          flags_changed = true;
-        }
-      }
-      e->trash = md->email->trash;
+      if (maildir_merge_email(m, e, md->email))
+        flags_changed = true;
 
       /* this is a duplicate of an existing email, so remove it */
       email_free(&md->email);
@@ -1307,6 +1803,7 @@ enum MxStatus maildir_mbox_check(struct Mailbox *m)
 
   /* destroy the file name hash */
   mutt_hash_free(&fnames);
+  mutt_hash_free(&mdata->canon_hash);
 
   /* If we didn't just get new mail, update the tables. */
   if (occult)
@@ -1379,7 +1876,10 @@ enum MxStatus maildir_mbox_sync(struct Mailbox *m)
   const char *const c_header_cache =
       cs_subset_path(NeoMutt->sub, "header_cache");
   if (m->type == MUTT_MAILDIR)
+  {
     hc = mutt_hcache_open(c_header_cache, mailbox_path(m), NULL);
+    mutt_hcache_begin(hc);
+  }
 #endif
 
   struct Progress *progress = NULL;
@@ -1405,7 +1905,10 @@ enum MxStatus maildir_mbox_sync(struct Mailbox *m)
 
 #ifdef USE_HCACHE
   if (m->type == MUTT_MAILDIR)
+  {
+    mutt_hcache_commit(hc);
     mutt_hcache_close(hc);
+  }
 #endif
 
   /* XXX race condition? */
@@ -1434,7 +1937,10 @@ enum MxStatus maildir_mbox_sync(struct Mailbox *m)
 err:
 #ifdef USE_HCACHE
   if (m->type == MUTT_MAILDIR)
+  {
+    mutt_hcache_commit(hc);
     mutt_hcache_close(hc);
+  }
 #endif
   return MX_STATUS_ERROR;
 }
@@ -1653,6 +2159,7 @@ struct MxOps MxMaildirOps = {
   .mbox_open_append = maildir_mbox_open_append,
   .mbox_check       = maildir_mbox_check,
   .mbox_check_stats = maildir_mbox_check_stats,
+  .stats_threadsafe = true,
   .mbox_sync        = maildir_mbox_sync,
   .mbox_close       = maildir_mbox_close,
   .msg_open         = maildir_msg_open,
@@ -1660,6 +2167,7 @@ struct MxOps MxMaildirOps = {
   .msg_commit       = maildir_msg_commit,
   .msg_close        = maildir_msg_close,
   .msg_padding_size = NULL,
+  .msg_prefetch     = NULL,
   .msg_save_hcache  = maildir_msg_save_hcache,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
@@ -36,7 +36,11 @@
  */
 void maildir_mdata_free(void **ptr)
 {
-  // struct MaildirMboxData *mdata = *ptr;
+  if (!ptr || !*ptr)
+    return;
+
+  struct MaildirMboxData *mdata = *ptr;
+  mutt_hash_free(&mdata->canon_hash);
   FREE(ptr);
 }
 
@@ -26,6 +26,7 @@
 #include <sys/types.h>
 #include <time.h>
 
+struct HashTable;
 struct Mailbox;
 
 /**
@@ -35,6 +36,8 @@ struct MaildirMboxData
 {
   struct timespec mtime_cur;
   mode_t mh_umask;
+  struct HashTable *canon_hash; ///< Canonical filename -> index of Email + 1
+  int canon_count;              ///< Number of Emails when canon_hash was updated
 };
 
 void                    maildir_mdata_free(void **ptr);
@@ -610,6 +610,7 @@ void mh_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda, struct Prog
   const char *const c_header_cache =
       cs_subset_path(NeoMutt->sub, "header_cache");
   struct HeaderCache *hc = mutt_hcache_open(c_header_cache, mailbox_path(m), NULL);
+  mutt_hcache_begin(hc);
 #endif
 
   struct MdEmail *md = NULL;
@@ -665,6 +666,7 @@ void mh_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda, struct Prog
     }
   }
 #ifdef USE_HCACHE
+  mutt_hcache_commit(hc);
   mutt_hcache_close(hc);
 #endif
 
@@ -954,7 +956,7 @@ enum MxStatus mh_mbox_check(struct Mailbox *m)
   mh_seq_free(&mhs);
 
   /* check for modifications and adjust flags */
-  fnames = mutt_hash_new(ARRAY_SIZE(&mda), MUTT_HASH_NO_FLAGS);
+  fnames = mutt_hash_new(ARRAY_SIZE(&mda), MUTT_HASH_OPEN_ADDR);
 
   struct MdEmail *md = NULL;
   struct MdEmail **mdp = NULL;
@@ -1035,7 +1037,10 @@ enum MxStatus mh_mbox_sync(struct Mailbox *m)
   const char *const c_header_cache =
       cs_subset_path(NeoMutt->sub, "header_cache");
   if (m->type == MUTT_MH)
+  {
     hc = mutt_hcache_open(c_header_cache, mailbox_path(m), NULL);
+    mutt_hcache_begin(hc);
+  }
 #endif
 
   struct Progress *progress = NULL;
@@ -1061,7 +1066,10 @@ enum MxStatus mh_mbox_sync(struct Mailbox *m)
 
 #ifdef USE_HCACHE
   if (m->type == MUTT_MH)
+  {
+    mutt_hcache_commit(hc);
     mutt_hcache_close(hc);
+  }
 #endif
 
   mh_seq_update(m);
@@ -1090,7 +1098,10 @@ enum MxStatus mh_mbox_sync(struct Mailbox *m)
 err:
 #ifdef USE_HCACHE
   if (m->type == MUTT_MH)
+  {
+    mutt_hcache_commit(hc);
     mutt_hcache_close(hc);
+  }
 #endif
   return MX_STATUS_ERROR;
 }
@@ -1253,6 +1264,7 @@ struct MxOps MxMhOps = {
   .mbox_open_append = mh_mbox_open_append,
   .mbox_check       = mh_mbox_check,
   .mbox_check_stats = mh_mbox_check_stats,
+  .stats_threadsafe = true,
   .mbox_sync        = mh_mbox_sync,
   .mbox_close       = mh_mbox_close,
   .msg_open         = mh_msg_open,
@@ -1260,6 +1272,7 @@ struct MxOps MxMhOps = {
   .msg_commit       = mh_msg_commit,
   .msg_close        = mh_msg_close,
   .msg_padding_size = NULL,
+  .msg_prefetch     = NULL,
   .msg_save_hcache  = mh_msg_save_hcache,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
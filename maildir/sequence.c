@@ -393,9 +393,10 @@ int mh_seq_read(struct MhSequences *mhs, const char *path)
   if (!fp)
     return 0; /* yes, ask callers to silently ignore the error */
 
+  char *save = NULL;
   while ((buf = mutt_file_read_line(buf, &sz, fp, NULL, MUTT_RL_NO_FLAGS)))
   {
-    char *t = strtok(buf, " \t:");
+    char *t = strtok_r(buf, " \t:", &save);
     if (!t)
       continue;
 
@@ -414,7 +415,7 @@ int mh_seq_read(struct MhSequences *mhs, const char *path)
     else /* unknown sequence */
       continue;
 
-    while ((t = strtok(NULL, " \t:")))
+    while ((t = strtok_r(NULL, " \t:", &save)))
     {
       if (mh_seq_read_token(t, &first, &last) < 0)
       {
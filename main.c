@@ -1304,6 +1304,7 @@ main_exit:
   mutt_keys_free();
   myvarlist_free(&MyVars);
   mutt_prex_free();
+  mutt_ch_cache_cleanup();
   neomutt_free(&NeoMutt);
   cs_free(&cs);
   log_queue_flush(log_disp_terminal);
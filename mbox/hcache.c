@@ -0,0 +1,141 @@
+/**
+ * @file
+ * Describe an mbox folder for the header cache
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mbox_hcache Describe an mbox folder for the header cache
+ *
+ * Describe an mbox folder for the header cache
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "private.h"
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "lib.h"
+
+/**
+ * mbox_hcache_tail - Checksum the end of a folder
+ * @param[in]  fp   Folder
+ * @param[in]  size Size of the folder to consider
+ * @param[out] md5  Buffer for the checksum, 16 bytes
+ * @retval true Success
+ */
+static bool mbox_hcache_tail(FILE *fp, LOFF_T size, unsigned char *md5)
+{
+  char buf[MBOX_HCACHE_TAIL];
+  LOFF_T start = (size > MBOX_HCACHE_TAIL) ? (size - MBOX_HCACHE_TAIL) : 0;
+  size_t len = size - start;
+
+  if (pread(fileno(fp), buf, len, start) != (ssize_t) len)
+    return false;
+
+  mutt_md5_bytes(buf, len, md5);
+  return true;
+}
+
+/**
+ * mbox_hcache_describe - Describe a folder, ready to save in the header cache
+ * @param[out] idx  Index to fill in, Index.count is left alone
+ * @param[in]  fp   Folder
+ * @param[in]  type Mailbox type, e.g. #MUTT_MBOX
+ * @retval true Success
+ */
+bool mbox_hcache_describe(struct MboxIndex *idx, FILE *fp, enum MailboxType type)
+{
+  if (!idx || !fp)
+    return false;
+
+  struct stat sb;
+  if (fstat(fileno(fp), &sb) != 0)
+    return false;
+
+  if (!mbox_hcache_tail(fp, sb.st_size, idx->tail))
+    return false;
+
+  struct timespec ts = { 0 };
+  idx->type = type;
+  idx->version = MBOX_HCACHE_VERSION;
+  idx->size = sb.st_size;
+  mutt_file_get_stat_timespec(&ts, &sb, MUTT_STAT_MTIME);
+  idx->mtime_sec = ts.tv_sec;
+  idx->mtime_nsec = ts.tv_nsec;
+  mutt_file_get_stat_timespec(&ts, &sb, MUTT_STAT_CTIME);
+  idx->ctime_sec = ts.tv_sec;
+  idx->ctime_nsec = ts.tv_nsec;
+  idx->inode = sb.st_ino;
+  return true;
+}
+
+/**
+ * mbox_hcache_compare - Has a folder changed since its index was saved?
+ * @param idx  Index from the header cache
+ * @param fp   Folder
+ * @param type Mailbox type, e.g. #MUTT_MBOX
+ * @retval enum #MboxHcacheState, e.g. #MBOX_HCACHE_UNCHANGED
+ *
+ * A folder is unchanged if its size, times, inode and tail all match.
+ *
+ * Like mbox_mbox_check(), for an append we expect to see a message separator
+ * at exactly what used to be the end of the folder.  As a further check, the
+ * data before it must be unchanged.
+ */
+enum MboxHcacheState mbox_hcache_compare(const struct MboxIndex *idx, FILE *fp,
+                                         enum MailboxType type)
+{
+  if (!idx || !fp || (idx->type != type) || (idx->version != MBOX_HCACHE_VERSION))
+    return MBOX_HCACHE_CHANGED;
+
+  struct MboxIndex cur = { 0 };
+  if (!mbox_hcache_describe(&cur, fp, type))
+    return MBOX_HCACHE_CHANGED;
+
+  if ((cur.size == idx->size) && (cur.mtime_sec == idx->mtime_sec) &&
+      (cur.mtime_nsec == idx->mtime_nsec) && (cur.ctime_sec == idx->ctime_sec) &&
+      (cur.ctime_nsec == idx->ctime_nsec) && (cur.inode == idx->inode) &&
+      (memcmp(cur.tail, idx->tail, sizeof(cur.tail)) == 0))
+  {
+    return MBOX_HCACHE_UNCHANGED;
+  }
+
+  if ((idx->size <= 0) || (idx->size >= cur.size))
+    return MBOX_HCACHE_CHANGED;
+
+  char buf[sizeof(MMDF_SEP)] = { 0 };
+  if (pread(fileno(fp), buf, sizeof(buf) - 1, idx->size) != (ssize_t) (sizeof(buf) - 1))
+    return MBOX_HCACHE_CHANGED;
+  if (((type == MUTT_MBOX) && !mutt_str_startswith(buf, "From ")) ||
+      ((type == MUTT_MMDF) && !mutt_str_equal(buf, MMDF_SEP)))
+  {
+    return MBOX_HCACHE_CHANGED;
+  }
+
+  unsigned char tail[16];
+  if (!mbox_hcache_tail(fp, idx->size, tail) || (memcmp(tail, idx->tail, sizeof(tail)) != 0))
+    return MBOX_HCACHE_CHANGED;
+
+  return MBOX_HCACHE_APPENDED;
+}
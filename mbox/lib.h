@@ -29,6 +29,7 @@
  * | File          | Description          |
  * | :------------ | :------------------- |
  * | mbox/config.c | @subpage mbox_config |
+ * | mbox/hcache.c | @subpage mbox_hcache |
  * | mbox/mbox.c   | @subpage mbox_mbox   |
  */
 
@@ -42,6 +42,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <utime.h>
+#include "private.h"
 #include "mutt/lib.h"
 #include "address/lib.h"
 #include "config/lib.h"
@@ -56,6 +57,9 @@
 #include "muttlib.h"
 #include "mx.h"
 #include "protos.h"
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#endif
 
 /**
  * struct MUpdate - Store of new offsets, used by mutt_sync_mailbox()
@@ -171,6 +175,257 @@ static void mbox_unlock_mailbox(struct Mailbox *m)
   }
 }
 
+#ifdef USE_HCACHE
+#define MBOX_HCACHE_INDEX "/@MBOX" ///< Header cache key of the folder's index
+
+/**
+ * mbox_hcache_key - Generate the header cache key for a message
+ * @param offset Offset of the message in the folder
+ * @param buf    Buffer for the result
+ * @param buflen Length of the buffer
+ * @retval num Length of the key
+ */
+static size_t mbox_hcache_key(int64_t offset, char *buf, size_t buflen)
+{
+  return snprintf(buf, buflen, "/%" PRId64, offset);
+}
+
+/**
+ * mbox_hcache_index - Read a folder's index from the header cache
+ * @param[in]  hc      Header cache
+ * @param[out] idx     Index
+ * @param[out] offsets Offsets of the messages, must be freed by the caller
+ * @retval true The index was found
+ */
+static bool mbox_hcache_index(struct HeaderCache *hc, struct MboxIndex *idx, int64_t **offsets)
+{
+  size_t dlen = 0;
+  void *data = mutt_hcache_fetch_raw(hc, MBOX_HCACHE_INDEX,
+                                     mutt_str_len(MBOX_HCACHE_INDEX), &dlen);
+  if (!data)
+    return false;
+
+  bool rc = false;
+  if (dlen >= sizeof(*idx))
+  {
+    memcpy(idx, data, sizeof(*idx));
+    const size_t olen = dlen - sizeof(*idx);
+    if ((idx->version == MBOX_HCACHE_VERSION) && (idx->count >= 0) &&
+        ((olen % sizeof(int64_t)) == 0) && ((olen / sizeof(int64_t)) == (uint64_t) idx->count))
+    {
+      *offsets = mutt_mem_malloc(MAX(olen, 1));
+      memcpy(*offsets, (char *) data + sizeof(*idx), olen);
+      rc = true;
+    }
+  }
+
+  mutt_hcache_free_raw(hc, &data);
+  return rc;
+}
+
+/**
+ * mbox_hcache_forget - Delete a folder's index from the header cache
+ * @param hc      Header cache
+ * @param offsets Offsets of the messages in the index
+ * @param num     Number of offsets
+ */
+static void mbox_hcache_forget(struct HeaderCache *hc, const int64_t *offsets, size_t num)
+{
+  char key[32];
+
+  mutt_hcache_begin(hc);
+  for (size_t i = 0; i < num; i++)
+  {
+    size_t keylen = mbox_hcache_key(offsets[i], key, sizeof(key));
+    mutt_hcache_delete_record(hc, key, keylen);
+  }
+  mutt_hcache_delete_record(hc, MBOX_HCACHE_INDEX, mutt_str_len(MBOX_HCACHE_INDEX));
+  mutt_hcache_commit(hc);
+}
+
+/**
+ * mbox_hcache_fetch_cb - Save an Email found in the header cache - Implements ::hcache_fetch_t
+ */
+static void mbox_hcache_fetch_cb(void *data, size_t idx, struct HCacheEntry hce)
+{
+  struct Email **emails = data;
+  emails[idx] = hce.email;
+}
+
+/**
+ * mbox_hcache_restore - Read a folder's messages from the header cache
+ * @param m  Mailbox
+ * @param hc Header cache
+ * @retval num Offset of the first message that wasn't restored
+ *
+ * If the folder hasn't changed since its index was saved, all of its messages
+ * are restored.  If messages have been appended, the old ones are restored and
+ * the caller only needs to parse the rest.  Otherwise, the stale index is
+ * deleted and nothing is restored.
+ *
+ * On return, the folder's file is positioned at the returned offset.
+ */
+static LOFF_T mbox_hcache_restore(struct Mailbox *m, struct HeaderCache *hc)
+{
+  struct MboxAccountData *adata = mbox_adata_get(m);
+  if (!hc || !adata || (m->msg_count != 0))
+    return 0;
+
+  struct MboxIndex idx = { 0 };
+  int64_t *offsets = NULL;
+  if (!mbox_hcache_index(hc, &idx, &offsets))
+    return 0;
+
+  LOFF_T pos = 0;
+  const size_t num = idx.count;
+
+  if ((num > 0) && (mbox_hcache_compare(&idx, adata->fp, m->type) != MBOX_HCACHE_CHANGED))
+  {
+    const char **keys = mutt_mem_calloc(num, sizeof(char *));
+    size_t *keylens = mutt_mem_calloc(num, sizeof(size_t));
+    struct Email **emails = mutt_mem_calloc(num, sizeof(struct Email *));
+    char *keybuf = mutt_mem_malloc(num * 32);
+
+    for (size_t i = 0; i < num; i++)
+    {
+      keys[i] = keybuf + (i * 32);
+      keylens[i] = mbox_hcache_key(offsets[i], keybuf + (i * 32), 32);
+    }
+
+    if (mutt_hcache_fetch_many(hc, keys, keylens, num, 0, mbox_hcache_fetch_cb, emails) == num)
+    {
+      for (size_t i = 0; i < num; i++)
+      {
+        if (m->msg_count == m->email_max)
+          mx_alloc_memory(m);
+        emails[i]->index = m->msg_count;
+        m->emails[m->msg_count++] = emails[i];
+      }
+      pos = idx.size;
+    }
+    else
+    {
+      for (size_t i = 0; i < num; i++)
+        email_free(&emails[i]);
+    }
+
+    FREE(&keys);
+    FREE(&keylens);
+    FREE(&emails);
+    FREE(&keybuf);
+  }
+
+  if (pos == 0)
+    mbox_hcache_forget(hc, offsets, num);
+
+  FREE(&offsets);
+
+  if (fseeko(adata->fp, pos, SEEK_SET) != 0)
+    mutt_debug(LL_DEBUG1, "fseek() failed\n");
+
+  mutt_debug(LL_DEBUG2, "restored %d messages from the header cache\n", m->msg_count);
+  return pos;
+}
+
+/**
+ * mbox_offset_cmp - Compare two message offsets - Implements ::sort_t
+ */
+static int mbox_offset_cmp(const void *a, const void *b)
+{
+  const int64_t oa = *(const int64_t *) a;
+  const int64_t ob = *(const int64_t *) b;
+  return (oa > ob) - (oa < ob);
+}
+
+/**
+ * mbox_hcache_save - Save a folder's messages to the header cache
+ * @param m     Mailbox
+ * @param hc    Header cache
+ * @param first Index of the first Email that needs saving
+ * @param purge Deleted Emails have been removed from the folder
+ *
+ * The Emails before @a first must be unchanged since they were last saved.
+ * Messages that are no longer in the folder are deleted from the cache.
+ */
+static void mbox_hcache_save(struct Mailbox *m, struct HeaderCache *hc, int first, bool purge)
+{
+  struct MboxAccountData *adata = mbox_adata_get(m);
+  if (!hc || !adata)
+    return;
+
+  struct MboxIndex idx = { 0 };
+  int64_t *old_offsets = NULL;
+  size_t old_num = 0;
+  if (mbox_hcache_index(hc, &idx, &old_offsets))
+    old_num = idx.count;
+
+  memset(&idx, 0, sizeof(idx));
+  if (!mbox_hcache_describe(&idx, adata->fp, m->type) || (idx.size != m->size))
+  {
+    /* We can't describe the folder, so don't leave a stale index behind */
+    mbox_hcache_forget(hc, old_offsets, old_num);
+    FREE(&old_offsets);
+    return;
+  }
+
+  int64_t *offsets = mutt_mem_calloc(MAX(m->msg_count, 1), sizeof(int64_t));
+  char key[32];
+
+  mutt_hcache_begin(hc);
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (purge && e->deleted)
+      continue;
+
+    offsets[idx.count++] = e->offset;
+    if (i >= first)
+    {
+      size_t keylen = mbox_hcache_key(e->offset, key, sizeof(key));
+      mutt_hcache_store(hc, key, keylen, e, 0);
+    }
+  }
+
+  /* The Emails may have been sorted */
+  qsort(offsets, idx.count, sizeof(int64_t), mbox_offset_cmp);
+
+  /* Delete the messages that have moved, or gone */
+  for (size_t i = 0, j = 0; i < old_num; i++)
+  {
+    while ((j < (size_t) idx.count) && (offsets[j] < old_offsets[i]))
+      j++;
+    if ((j < (size_t) idx.count) && (offsets[j] == old_offsets[i]))
+      continue;
+
+    size_t keylen = mbox_hcache_key(old_offsets[i], key, sizeof(key));
+    mutt_hcache_delete_record(hc, key, keylen);
+  }
+
+  const size_t dlen = sizeof(idx) + (idx.count * sizeof(int64_t));
+  char *data = mutt_mem_malloc(dlen);
+  memcpy(data, &idx, sizeof(idx));
+  memcpy(data + sizeof(idx), offsets, idx.count * sizeof(int64_t));
+  mutt_hcache_store_raw(hc, MBOX_HCACHE_INDEX, mutt_str_len(MBOX_HCACHE_INDEX), data, dlen);
+  mutt_hcache_commit(hc);
+
+  FREE(&data);
+  FREE(&offsets);
+  FREE(&old_offsets);
+}
+
+/**
+ * mbox_hcache_open - Open the header cache for a folder
+ * @param m Mailbox
+ * @retval ptr  Header cache
+ * @retval NULL Header caching is disabled
+ */
+static struct HeaderCache *mbox_hcache_open(struct Mailbox *m)
+{
+  const char *const c_header_cache = cs_subset_path(NeoMutt->sub, "header_cache");
+  return mutt_hcache_open(c_header_cache, mailbox_path(m), NULL);
+}
+#endif
+
 /**
  * mmdf_parse_mailbox - Read a mailbox in MMDF format
  * @param m Mailbox
@@ -195,6 +450,9 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
   struct stat sb;
   struct Progress *progress = NULL;
   enum MxOpenReturns rc = MX_OPEN_ERROR;
+#ifdef USE_HCACHE
+  struct HeaderCache *hc = NULL;
+#endif
 
   if (stat(mailbox_path(m), &sb) == -1)
   {
@@ -214,6 +472,13 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
     progress = progress_new(msg, MUTT_PROGRESS_READ, 0);
   }
 
+#ifdef USE_HCACHE
+  hc = mbox_hcache_open(m);
+  if (ftello(adata->fp) == 0)
+    mbox_hcache_restore(m, hc);
+  const int first = m->msg_count;
+#endif
+
   while (true)
   {
     if (!fgets(buf, sizeof(buf) - 1, adata->fp))
@@ -326,8 +591,15 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
     goto fail;
   }
 
+#ifdef USE_HCACHE
+  mbox_hcache_save(m, hc, first, false);
+#endif
+
   rc = MX_OPEN_OK;
 fail:
+#ifdef USE_HCACHE
+  mutt_hcache_close(hc);
+#endif
   progress_free(&progress);
   return rc;
 }
@@ -353,13 +625,11 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
     return MX_OPEN_ERROR;
 
   struct stat sb;
-  char buf[8192], return_path[256];
-  struct Email *e_cur = NULL;
-  time_t t;
-  int count = 0, lines = 0;
-  LOFF_T loc;
   struct Progress *progress = NULL;
   enum MxOpenReturns rc = MX_OPEN_ERROR;
+#ifdef USE_HCACHE
+  struct HeaderCache *hc = NULL;
+#endif
 
   /* Save information about the folder at the time we opened it. */
   if (stat(mailbox_path(m), &sb) == -1)
@@ -382,140 +652,15 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
     progress = progress_new(msg, MUTT_PROGRESS_READ, 0);
   }
 
-  loc = ftello(adata->fp);
-  while ((fgets(buf, sizeof(buf), adata->fp)) && !SigInt)
-  {
-    if (is_from(buf, return_path, sizeof(return_path), &t))
-    {
-      /* Save the Content-Length of the previous message */
-      if (count > 0)
-      {
-        struct Email *e = m->emails[m->msg_count - 1];
-        if (e->body->length < 0)
-        {
-          e->body->length = loc - e->body->offset - 1;
-          if (e->body->length < 0)
-            e->body->length = 0;
-        }
-        if (!e->lines)
-          e->lines = lines ? lines - 1 : 0;
-      }
-
-      count++;
-
-      if (m->verbose)
-      {
-        progress_update(progress, count, (int) (ftello(adata->fp) / (m->size / 100 + 1)));
-      }
-
-      if (m->msg_count == m->email_max)
-        mx_alloc_memory(m);
-
-      m->emails[m->msg_count] = email_new();
-      e_cur = m->emails[m->msg_count];
-      e_cur->received = t - mutt_date_local_tz(t);
-      e_cur->offset = loc;
-      e_cur->index = m->msg_count;
-
-      e_cur->env = mutt_rfc822_read_header(adata->fp, e_cur, false, false);
-
-      /* if we know how long this message is, either just skip over the body,
-       * or if we don't know how many lines there are, count them now (this will
-       * save time by not having to search for the next message marker).  */
-      if (e_cur->body->length > 0)
-      {
-        LOFF_T tmploc;
-
-        loc = ftello(adata->fp);
-
-        /* The test below avoids a potential integer overflow if the
-         * content-length is huge (thus necessarily invalid).  */
-        tmploc = (e_cur->body->length < m->size) ? (loc + e_cur->body->length + 1) : -1;
-
-        if ((tmploc > 0) && (tmploc < m->size))
-        {
-          /* check to see if the content-length looks valid.  we expect to
-           * to see a valid message separator at this point in the stream */
-          if ((fseeko(adata->fp, tmploc, SEEK_SET) != 0) ||
-              !fgets(buf, sizeof(buf), adata->fp) || !mutt_str_startswith(buf, "From "))
-          {
-            mutt_debug(LL_DEBUG1, "bad content-length in message %d (cl=" OFF_T_FMT ")\n",
-                       e_cur->index, e_cur->body->length);
-            mutt_debug(LL_DEBUG1, "    LINE: %s", buf);
-            /* nope, return the previous position */
-            if ((loc < 0) || (fseeko(adata->fp, loc, SEEK_SET) != 0))
-            {
-              mutt_debug(LL_DEBUG1, "#1 fseek() failed\n");
-            }
-            e_cur->body->length = -1;
-          }
-        }
-        else if (tmploc != m->size)
-        {
-          /* content-length would put us past the end of the file, so it
-           * must be wrong */
-          e_cur->body->length = -1;
-        }
-
-        if (e_cur->body->length != -1)
-        {
-          /* good content-length.  check to see if we know how many lines
-           * are in this message.  */
-          if (e_cur->lines == 0)
-          {
-            int cl = e_cur->body->length;
-
-            /* count the number of lines in this message */
-            if ((loc < 0) || (fseeko(adata->fp, loc, SEEK_SET) != 0))
-              mutt_debug(LL_DEBUG1, "#2 fseek() failed\n");
-            while (cl-- > 0)
-            {
-              if (fgetc(adata->fp) == '\n')
-                e_cur->lines++;
-            }
-          }
-
-          /* return to the offset of the next message separator */
-          if (fseeko(adata->fp, tmploc, SEEK_SET) != 0)
-            mutt_debug(LL_DEBUG1, "#3 fseek() failed\n");
-        }
-      }
-
-      m->msg_count++;
-
-      if (TAILQ_EMPTY(&e_cur->env->return_path) && return_path[0])
-      {
-        mutt_addrlist_parse(&e_cur->env->return_path, return_path);
-      }
-
-      if (TAILQ_EMPTY(&e_cur->env->from))
-        mutt_addrlist_copy(&e_cur->env->from, &e_cur->env->return_path, false);
-
-      lines = 0;
-    }
-    else
-      lines++;
-
-    loc = ftello(adata->fp);
-  }
-
-  /* Only set the content-length of the previous message if we have read more
-   * than one message during _this_ invocation.  If this routine is called
-   * when new mail is received, we need to make sure not to clobber what
-   * previously was the last message since the headers may be sorted.  */
-  if (count > 0)
-  {
-    struct Email *e = m->emails[m->msg_count - 1];
-    if (e->body->length < 0)
-    {
-      e->body->length = ftello(adata->fp) - e->body->offset - 1;
-      if (e->body->length < 0)
-        e->body->length = 0;
-    }
+#ifdef USE_HCACHE
+  hc = mbox_hcache_open(m);
+  if (ftello(adata->fp) == 0)
+    mbox_hcache_restore(m, hc);
+  const int first = m->msg_count;
+#endif
 
-    if (!e->lines)
-      e->lines = lines ? lines - 1 : 0;
-  }
+  if (!mbox_parse_mmap(m, adata, progress))
+    mbox_parse_stream(m, adata, progress);
 
   if (SigInt)
   {
@@ -524,8 +669,15 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
     goto fail; /* action aborted */
   }
 
+#ifdef USE_HCACHE
+  mbox_hcache_save(m, hc, first, false);
+#endif
+
   rc = MX_OPEN_OK;
 fail:
+#ifdef USE_HCACHE
+  mutt_hcache_close(hc);
+#endif
   progress_free(&progress);
   return rc;
 }
@@ -1450,6 +1602,14 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
   }
   FREE(&new_offset);
   FREE(&old_offset);
+
+#ifdef USE_HCACHE
+  /* The rewritten messages now match their Emails */
+  struct HeaderCache *hc = mbox_hcache_open(m);
+  mbox_hcache_save(m, hc, first, true);
+  mutt_hcache_close(hc);
+#endif
+
   unlink(mutt_buffer_string(tempfile)); /* remove partial copy of the mailbox */
   mutt_buffer_pool_release(&tempfile);
   mutt_sig_unblock();
@@ -1842,6 +2002,7 @@ struct MxOps MxMboxOps = {
   .msg_commit       = mbox_msg_commit,
   .msg_close        = mbox_msg_close,
   .msg_padding_size = mbox_msg_padding_size,
+  .msg_prefetch     = NULL,
   .msg_save_hcache  = NULL,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
@@ -1872,6 +2033,7 @@ struct MxOps MxMmdfOps = {
   .msg_commit       = mmdf_msg_commit,
   .msg_close        = mbox_msg_close,
   .msg_padding_size = mmdf_msg_padding_size,
+  .msg_prefetch     = NULL,
   .msg_save_hcache  = NULL,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
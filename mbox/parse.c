@@ -0,0 +1,424 @@
+/**
+ * @file
+ * Find the messages in an mbox folder
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mbox_parse Find the messages in an mbox folder
+ *
+ * Find the messages in an mbox folder, either by reading it line by line, or
+ * by searching a memory map of it.  Both ways give the same result.
+ */
+
+#include "config.h"
+#include <errno.h>
+#include <inttypes.h> // IWYU pragma: keep
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "private.h"
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "lib.h"
+#include "progress/lib.h"
+#include "mutt_globals.h"
+#include "mx.h"
+
+/**
+ * mbox_parse_stream - Read a mailbox, line by line
+ * @param m        Mailbox
+ * @param adata    Mbox Account data
+ * @param progress Progress bar, may be NULL
+ *
+ * Parse the mailbox from the current position of the file to the end.
+ * This works on any file, but is slower than mbox_parse_mmap().
+ */
+void mbox_parse_stream(struct Mailbox *m, struct MboxAccountData *adata, struct Progress *progress)
+{
+  char buf[8192], return_path[256];
+  struct Email *e_cur = NULL;
+  time_t t;
+  int count = 0, lines = 0;
+  LOFF_T loc;
+
+  loc = ftello(adata->fp);
+  while ((fgets(buf, sizeof(buf), adata->fp)) && !SigInt)
+  {
+    if (is_from(buf, return_path, sizeof(return_path), &t))
+    {
+      /* Save the Content-Length of the previous message */
+      if (count > 0)
+      {
+        struct Email *e = m->emails[m->msg_count - 1];
+        if (e->body->length < 0)
+        {
+          e->body->length = loc - e->body->offset - 1;
+          if (e->body->length < 0)
+            e->body->length = 0;
+        }
+        if (!e->lines)
+          e->lines = lines ? lines - 1 : 0;
+      }
+
+      count++;
+
+      if (m->verbose)
+      {
+        progress_update(progress, count, (int) (ftello(adata->fp) / (m->size / 100 + 1)));
+      }
+
+      if (m->msg_count == m->email_max)
+        mx_alloc_memory(m);
+
+      m->emails[m->msg_count] = email_new();
+      e_cur = m->emails[m->msg_count];
+      e_cur->received = t - mutt_date_local_tz(t);
+      e_cur->offset = loc;
+      e_cur->index = m->msg_count;
+
+      e_cur->env = mutt_rfc822_read_header(adata->fp, e_cur, false, false);
+
+      /* if we know how long this message is, either just skip over the body,
+       * or if we don't know how many lines there are, count them now (this will
+       * save time by not having to search for the next message marker).  */
+      if (e_cur->body->length > 0)
+      {
+        LOFF_T tmploc;
+
+        loc = ftello(adata->fp);
+
+        /* The test below avoids a potential integer overflow if the
+         * content-length is huge (thus necessarily invalid).  */
+        tmploc = (e_cur->body->length < m->size) ? (loc + e_cur->body->length + 1) : -1;
+
+        if ((tmploc > 0) && (tmploc < m->size))
+        {
+          /* check to see if the content-length looks valid.  we expect to
+           * to see a valid message separator at this point in the stream */
+          if ((fseeko(adata->fp, tmploc, SEEK_SET) != 0) ||
+              !fgets(buf, sizeof(buf), adata->fp) || !mutt_str_startswith(buf, "From "))
+          {
+            mutt_debug(LL_DEBUG1, "bad content-length in message %d (cl=" OFF_T_FMT ")\n",
+                       e_cur->index, e_cur->body->length);
+            mutt_debug(LL_DEBUG1, "    LINE: %s", buf);
+            /* nope, return the previous position */
+            if ((loc < 0) || (fseeko(adata->fp, loc, SEEK_SET) != 0))
+            {
+              mutt_debug(LL_DEBUG1, "#1 fseek() failed\n");
+            }
+            e_cur->body->length = -1;
+          }
+        }
+        else if (tmploc != m->size)
+        {
+          /* content-length would put us past the end of the file, so it
+           * must be wrong */
+          e_cur->body->length = -1;
+        }
+
+        if (e_cur->body->length != -1)
+        {
+          /* good content-length.  check to see if we know how many lines
+           * are in this message.  */
+          if (e_cur->lines == 0)
+          {
+            int cl = e_cur->body->length;
+
+            /* count the number of lines in this message */
+            if ((loc < 0) || (fseeko(adata->fp, loc, SEEK_SET) != 0))
+              mutt_debug(LL_DEBUG1, "#2 fseek() failed\n");
+            while (cl-- > 0)
+            {
+              if (fgetc(adata->fp) == '\n')
+                e_cur->lines++;
+            }
+          }
+
+          /* return to the offset of the next message separator */
+          if (fseeko(adata->fp, tmploc, SEEK_SET) != 0)
+            mutt_debug(LL_DEBUG1, "#3 fseek() failed\n");
+        }
+      }
+
+      m->msg_count++;
+
+      if (TAILQ_EMPTY(&e_cur->env->return_path) && return_path[0])
+      {
+        mutt_addrlist_parse(&e_cur->env->return_path, return_path);
+      }
+
+      if (TAILQ_EMPTY(&e_cur->env->from))
+        mutt_addrlist_copy(&e_cur->env->from, &e_cur->env->return_path, false);
+
+      lines = 0;
+    }
+    else
+      lines++;
+
+    loc = ftello(adata->fp);
+  }
+
+  /* Only set the content-length of the previous message if we have read more
+   * than one message during _this_ invocation.  If this routine is called
+   * when new mail is received, we need to make sure not to clobber what
+   * previously was the last message since the headers may be sorted.  */
+  if (count > 0)
+  {
+    struct Email *e = m->emails[m->msg_count - 1];
+    if (e->body->length < 0)
+    {
+      e->body->length = ftello(adata->fp) - e->body->offset - 1;
+      if (e->body->length < 0)
+        e->body->length = 0;
+    }
+
+    if (!e->lines)
+      e->lines = lines ? lines - 1 : 0;
+  }
+}
+
+/**
+ * mbox_find_from - Find the next line beginning "From "
+ * @param map  Mapped mailbox
+ * @param pos  Offset of the start of a line
+ * @param size Size of the mailbox
+ * @retval num Offset of the next "From " line, or size if there isn't one
+ */
+static size_t mbox_find_from(const char *map, size_t pos, size_t size)
+{
+  if ((size - pos) < 5)
+    return size;
+  if (memcmp(map + pos, "From ", 5) == 0)
+    return pos;
+
+  const char *from = memmem(map + pos, size - pos, "\nFrom ", 6);
+  return from ? (from - map + 1) : size;
+}
+
+/**
+ * mbox_count_newlines - Count the newlines in part of a mapped mailbox
+ * @param map   Mapped mailbox
+ * @param start Offset of the start of the region
+ * @param end   Offset of the end of the region
+ * @retval num Number of newlines
+ */
+static int mbox_count_newlines(const char *map, size_t start, size_t end)
+{
+  int lines = 0;
+  const char *p = map + start;
+  const char *e = map + end;
+
+  while ((p < e) && (p = memchr(p, '\n', e - p)))
+  {
+    lines++;
+    p++;
+  }
+
+  return lines;
+}
+
+/**
+ * mbox_parse_mmap - Read a mailbox, using a memory map
+ * @param m        Mailbox
+ * @param adata    Mbox Account data
+ * @param progress Progress bar, may be NULL
+ * @retval true  Success
+ * @retval false The mailbox couldn't be mapped, nothing was read
+ *
+ * Parse the mailbox from the current position of the file to the end.
+ * Rather than reading every line of every message, search the mapped file
+ * for message separators and only parse the headers.  If the file can't be
+ * mapped, the caller should fall back to mbox_parse_stream().
+ */
+bool mbox_parse_mmap(struct Mailbox *m, struct MboxAccountData *adata, struct Progress *progress)
+{
+  struct stat sb;
+  LOFF_T start = ftello(adata->fp);
+  if ((start < 0) || (fstat(fileno(adata->fp), &sb) != 0) ||
+      (sb.st_size != m->size) || (start >= sb.st_size) ||
+      ((uintmax_t) sb.st_size > SIZE_MAX))
+  {
+    return false;
+  }
+
+  const size_t size = sb.st_size;
+  char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(adata->fp), 0);
+  if (map == MAP_FAILED)
+  {
+    mutt_debug(LL_DEBUG1, "mmap() failed: %s\n", strerror(errno));
+    return false;
+  }
+  posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+
+  /* Read the headers straight from the map, if we can */
+  FILE *fp = NULL;
+#ifdef USE_FMEMOPEN
+  fp = fmemopen(map, size, "r");
+#endif
+  if (!fp)
+    fp = adata->fp;
+
+  char buf[8192], return_path[256];
+  struct Email *e_cur = NULL;
+  time_t t;
+  int count = 0;
+  size_t lines_from = start; // Lines after this belong to the current email
+  size_t pos = mbox_find_from(map, start, size);
+
+  while ((pos < size) && !SigInt)
+  {
+    const char *eol = memchr(map + pos, '\n', size - pos);
+    const size_t len = eol ? (eol - (map + pos) + 1) : (size - pos);
+    const size_t blen = MIN(len, sizeof(buf) - 1);
+    memcpy(buf, map + pos, blen);
+    buf[blen] = '\0';
+
+    if (!is_from(buf, return_path, sizeof(return_path), &t))
+    {
+      pos = mbox_find_from(map, pos + len, size);
+      continue;
+    }
+
+    /* Save the Content-Length of the previous message */
+    if (e_cur)
+    {
+      if (e_cur->body->length < 0)
+      {
+        e_cur->body->length = pos - e_cur->body->offset - 1;
+        if (e_cur->body->length < 0)
+          e_cur->body->length = 0;
+      }
+      if (!e_cur->lines)
+      {
+        int lines = mbox_count_newlines(map, lines_from, pos);
+        e_cur->lines = lines ? lines - 1 : 0;
+      }
+    }
+
+    count++;
+
+    if (m->verbose)
+    {
+      progress_update(progress, count, (int) (pos / (m->size / 100 + 1)));
+    }
+
+    if (m->msg_count == m->email_max)
+      mx_alloc_memory(m);
+
+    m->emails[m->msg_count] = email_new();
+    e_cur = m->emails[m->msg_count];
+    e_cur->received = t - mutt_date_local_tz(t);
+    e_cur->offset = pos;
+    e_cur->index = m->msg_count;
+
+    if (fseeko(fp, pos + len, SEEK_SET) != 0)
+      mutt_debug(LL_DEBUG1, "#1 fseek() failed\n");
+    e_cur->env = mutt_rfc822_read_header(fp, e_cur, false, false);
+
+    LOFF_T loc = ftello(fp);
+    size_t next = (loc < 0) ? size : loc;
+
+    /* if we know how long this message is, we can check for a message
+     * separator at the end, rather than searching for it */
+    if (e_cur->body->length > 0)
+    {
+      /* The test below avoids a potential integer overflow if the
+       * content-length is huge (thus necessarily invalid).  */
+      LOFF_T tmploc = (e_cur->body->length < m->size) ? (loc + e_cur->body->length + 1) : -1;
+
+      if ((tmploc > 0) && (tmploc < m->size))
+      {
+        if (((size - tmploc) < 5) || (memcmp(map + tmploc, "From ", 5) != 0))
+        {
+          mutt_debug(LL_DEBUG1, "bad content-length in message %d (cl=" OFF_T_FMT ")\n",
+                     e_cur->index, e_cur->body->length);
+          e_cur->body->length = -1;
+        }
+      }
+      else if (tmploc != m->size)
+      {
+        /* content-length would put us past the end of the file, so it
+         * must be wrong */
+        e_cur->body->length = -1;
+      }
+
+      if (e_cur->body->length != -1)
+      {
+        /* good content-length.  check to see if we know how many lines
+         * are in this message.  */
+        if (e_cur->lines == 0)
+        {
+          e_cur->lines = mbox_count_newlines(map, loc, tmploc - 1);
+        }
+        next = tmploc;
+      }
+    }
+
+    lines_from = next;
+    m->msg_count++;
+
+    if (TAILQ_EMPTY(&e_cur->env->return_path) && return_path[0])
+    {
+      mutt_addrlist_parse(&e_cur->env->return_path, return_path);
+    }
+
+    if (TAILQ_EMPTY(&e_cur->env->from))
+      mutt_addrlist_copy(&e_cur->env->from, &e_cur->env->return_path, false);
+
+    pos = mbox_find_from(map, next, size);
+  }
+
+  /* Only set the content-length of the previous message if we have read more
+   * than one message during _this_ invocation.  See mbox_parse_stream() */
+  if (e_cur)
+  {
+    if (e_cur->body->length < 0)
+    {
+      e_cur->body->length = pos - e_cur->body->offset - 1;
+      if (e_cur->body->length < 0)
+        e_cur->body->length = 0;
+    }
+
+    if (!e_cur->lines)
+    {
+      /* An unterminated last line still counts */
+      int lines = mbox_count_newlines(map, lines_from, pos);
+      if ((pos > lines_from) && (map[pos - 1] != '\n'))
+        lines++;
+      e_cur->lines = lines ? lines - 1 : 0;
+    }
+  }
+
+  if (fp != adata->fp)
+    mutt_file_fclose(&fp);
+  munmap(map, size);
+
+  /* Leave the file where mbox_parse_stream() would */
+  if (fseeko(adata->fp, pos, SEEK_SET) != 0)
+    mutt_debug(LL_DEBUG1, "#2 fseek() failed\n");
+
+  return true;
+}
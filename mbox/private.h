@@ -0,0 +1,77 @@
+/**
+ * @file
+ * Mbox private types
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MBOX_PRIVATE_H
+#define MUTT_MBOX_PRIVATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "core/lib.h"
+
+struct MboxAccountData;
+struct Progress;
+
+#define MBOX_HCACHE_VERSION 1 ///< Layout of struct MboxIndex
+#define MBOX_HCACHE_TAIL 1024 ///< Number of bytes at the end of the folder to checksum
+
+/**
+ * struct MboxIndex - Summary of an mbox/MMDF folder, saved in the header cache
+ *
+ * In the header cache, the index is followed by the offsets of all the
+ * messages, in file order.  Each message is stored under its offset.
+ *
+ * The mtime alone can't be trusted: after rewriting a folder, mutt and
+ * NeoMutt put the old mtime back with utime(), which only keeps seconds.
+ * utime() can't reset the ctime, though.
+ */
+struct MboxIndex
+{
+  int32_t type;           ///< Mailbox type, e.g. #MUTT_MBOX
+  int32_t version;        ///< Layout of the index, #MBOX_HCACHE_VERSION
+  int64_t size;           ///< Size of the folder
+  int64_t mtime_sec;      ///< Modification time of the folder
+  int64_t mtime_nsec;     ///< Modification time of the folder (nanoseconds)
+  int64_t ctime_sec;      ///< Status change time of the folder
+  int64_t ctime_nsec;     ///< Status change time of the folder (nanoseconds)
+  int64_t inode;          ///< Inode of the folder
+  int64_t count;          ///< Number of messages
+  unsigned char tail[16]; ///< MD5 checksum of the end of the folder
+};
+
+/**
+ * enum MboxHcacheState - How a folder has changed since its index was saved
+ */
+enum MboxHcacheState
+{
+  MBOX_HCACHE_CHANGED,   ///< The folder has been rewritten, the index is stale
+  MBOX_HCACHE_UNCHANGED, ///< The folder is unchanged
+  MBOX_HCACHE_APPENDED,  ///< Messages have only been appended to the folder
+};
+
+enum MboxHcacheState mbox_hcache_compare (const struct MboxIndex *idx, FILE *fp, enum MailboxType type);
+bool                 mbox_hcache_describe(struct MboxIndex *idx, FILE *fp, enum MailboxType type);
+
+bool mbox_parse_mmap  (struct Mailbox *m, struct MboxAccountData *adata, struct Progress *progress);
+void mbox_parse_stream(struct Mailbox *m, struct MboxAccountData *adata, struct Progress *progress);
+
+#endif /* MUTT_MBOX_PRIVATE_H */
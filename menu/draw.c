@@ -64,12 +64,18 @@ static int get_color(int index, unsigned char *s)
   switch (type)
   {
     case MT_COLOR_INDEX_AUTHOR:
+      if (e && e->pair_valid)
+        return e->pair_author;
       color = mutt_color_index_author();
       break;
     case MT_COLOR_INDEX_FLAGS:
+      if (e && e->pair_valid)
+        return e->pair_flags;
       color = mutt_color_index_flags();
       break;
     case MT_COLOR_INDEX_SUBJECT:
+      if (e && e->pair_valid)
+        return e->pair_subject;
       color = mutt_color_index_subject();
       break;
     case MT_COLOR_INDEX_TAG:
@@ -117,7 +123,8 @@ static void print_enriched_string(struct MuttWindow *win, int index, int attr,
   size_t n = mutt_str_len((char *) s);
   mbstate_t mbstate;
 
-  const bool c_ascii_chars = cs_subset_bool(sub, "ascii_chars");
+  static struct ConfigHandle h_ascii_chars = { "ascii_chars" };
+  const bool c_ascii_chars = cs_handle_bool(sub, &h_ascii_chars);
   memset(&mbstate, 0, sizeof(mbstate));
   while (*s)
   {
@@ -318,9 +325,11 @@ void menu_make_entry(struct Menu *menu, char *buf, size_t buflen, int i)
 static void menu_pad_string(struct Menu *menu, char *buf, size_t buflen)
 {
   char *scratch = mutt_str_dup(buf);
-  const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
+  static struct ConfigHandle h_arrow_cursor = { "arrow_cursor" };
+  const bool c_arrow_cursor = cs_handle_bool(menu->sub, &h_arrow_cursor);
+  static struct ConfigHandle h_arrow_string = { "arrow_string" };
   const char *const c_arrow_string =
-      cs_subset_string(menu->sub, "arrow_string");
+      cs_handle_string(menu->sub, &h_arrow_string);
   int shift = c_arrow_cursor ? mutt_strwidth(c_arrow_string) + 1 : 0;
   int cols = menu->win_index->state.cols - shift;
 
@@ -387,9 +396,11 @@ void menu_redraw_index(struct Menu *menu)
       mutt_window_move(menu->win_index, 0, i - menu->top);
       do_color = true;
 
-      const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
+      static struct ConfigHandle h_arrow_cursor = { "arrow_cursor" };
+      const bool c_arrow_cursor = cs_handle_bool(menu->sub, &h_arrow_cursor);
+      static struct ConfigHandle h_arrow_string = { "arrow_string" };
       const char *const c_arrow_string =
-          cs_subset_string(menu->sub, "arrow_string");
+          cs_handle_string(menu->sub, &h_arrow_string);
       if (i == menu->current)
       {
         mutt_curses_set_color(MT_COLOR_INDICATOR);
@@ -446,9 +457,11 @@ void menu_redraw_motion(struct Menu *menu)
   mutt_window_move(menu->win_index, 0, menu->oldcurrent - menu->top);
   mutt_curses_set_attr(old_color);
 
-  const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
+  static struct ConfigHandle h_arrow_cursor = { "arrow_cursor" };
+  const bool c_arrow_cursor = cs_handle_bool(menu->sub, &h_arrow_cursor);
+  static struct ConfigHandle h_arrow_string = { "arrow_string" };
   const char *const c_arrow_string =
-      cs_subset_string(menu->sub, "arrow_string");
+      cs_handle_string(menu->sub, &h_arrow_string);
   if (c_arrow_cursor)
   {
     /* clear the arrow */
@@ -504,9 +517,11 @@ void menu_redraw_current(struct Menu *menu)
   menu_pad_string(menu, buf, sizeof(buf));
 
   mutt_curses_set_color(MT_COLOR_INDICATOR);
-  const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
+  static struct ConfigHandle h_arrow_cursor = { "arrow_cursor" };
+  const bool c_arrow_cursor = cs_handle_bool(menu->sub, &h_arrow_cursor);
+  static struct ConfigHandle h_arrow_string = { "arrow_string" };
   const char *const c_arrow_string =
-      cs_subset_string(menu->sub, "arrow_string");
+      cs_handle_string(menu->sub, &h_arrow_string);
   if (c_arrow_cursor)
   {
     mutt_window_addstr(menu->win_index, c_arrow_string);
@@ -51,6 +51,17 @@
 bool MonitorFilesChanged = false;
 bool MonitorContextChanged = false;
 
+/**
+ * enum MonitorEventsState - State of the event stream for the current Maildir
+ */
+enum MonitorEventsState
+{
+  MON_EVENTS_OFF,   ///< The current mailbox isn't watched
+  MON_EVENTS_START, ///< Watching has just started, events may have been missed
+  MON_EVENTS_LIVE,  ///< Every event has been recorded
+  MON_EVENTS_LOST,  ///< Events have been lost, the mailbox must be rescanned
+};
+
 static int INotifyFd = -1;
 static struct Monitor *Monitor = NULL;
 static size_t PollFdsCount = 0;
@@ -58,10 +69,24 @@ static size_t PollFdsLen = 0;
 static struct pollfd *PollFds = NULL;
 
 static int MonitorContextDescriptor = -1;
+static int MonitorContextCurDescriptor = -1;
+
+static bool MonitorFilesPending = false; ///< Events were read outside of mutt_monitor_poll()
+static enum MonitorEventsState MonitorEventsState = MON_EVENTS_OFF;
+static struct MonitorEventArray MonitorEvents = ARRAY_HEAD_INITIALIZER;
 
-#define INOTIFY_MASK_DIR (IN_MOVED_TO | IN_ATTRIB | IN_CLOSE_WRITE | IN_ISDIR)
+#define INOTIFY_MASK_DIR                                                       \
+  (IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ATTRIB | IN_CLOSE_WRITE | IN_ISDIR)
 #define INOTIFY_MASK_FILE IN_CLOSE_WRITE
 
+/// Events that add a file to a Maildir directory
+#define INOTIFY_MASK_ADDED (IN_MOVED_TO | IN_CLOSE_WRITE)
+/// Events that remove a file from a Maildir directory
+#define INOTIFY_MASK_REMOVED (IN_MOVED_FROM | IN_DELETE)
+
+/// Maximum number of queued events, before a rescan is cheaper
+#define MONITOR_EVENTS_MAX 10000
+
 #define EVENT_BUFLEN MAX(4096, sizeof(struct inotify_event) + NAME_MAX + 1)
 
 /**
@@ -87,6 +112,7 @@ struct Monitor
   ino_t st_ino;
   enum MailboxType type;
   int desc;
+  int desc_cur; ///< Watch descriptor of a Maildir's 'cur' directory
 };
 
 /**
@@ -103,6 +129,52 @@ struct MonitorInfo
   struct Buffer path_buf; ///< access via path only (maybe not initialized)
 };
 
+/**
+ * monitor_events_reset - Discard the queued events for the current mailbox
+ * @param state New state of the event stream
+ */
+static void monitor_events_reset(enum MonitorEventsState state)
+{
+  struct MonitorEvent *ev = NULL;
+  ARRAY_FOREACH(ev, &MonitorEvents)
+  {
+    FREE(&ev->name);
+  }
+  ARRAY_FREE(&MonitorEvents);
+  MonitorEventsState = state;
+}
+
+/**
+ * monitor_event_record - Queue an event for the current mailbox
+ * @param event inotify event
+ * @param cur   true if the event is for the 'cur' directory
+ */
+static void monitor_event_record(const struct inotify_event *event, bool cur)
+{
+  if (MonitorEventsState != MON_EVENTS_LIVE)
+    return;
+
+  if ((event->len == 0) || (event->mask & IN_ISDIR) ||
+      !(event->mask & (INOTIFY_MASK_ADDED | INOTIFY_MASK_REMOVED)))
+  {
+    return;
+  }
+
+  if (ARRAY_SIZE(&MonitorEvents) >= MONITOR_EVENTS_MAX)
+  {
+    mutt_debug(LL_DEBUG2, "too many events, rescan needed\n");
+    monitor_events_reset(MON_EVENTS_LOST);
+    return;
+  }
+
+  struct MonitorEvent ev = {
+    .name = mutt_str_dup(event->name),
+    .cur = cur,
+    .added = (event->mask & INOTIFY_MASK_ADDED),
+  };
+  ARRAY_ADD(&MonitorEvents, ev);
+}
+
 /**
  * mutt_poll_fd_add - Add a file to the watch list
  * @param fd     File to watch
@@ -211,6 +283,7 @@ static struct Monitor *monitor_new(struct MonitorInfo *info, int descriptor)
   monitor->st_dev = info->st_dev;
   monitor->st_ino = info->st_ino;
   monitor->desc = descriptor;
+  monitor->desc_cur = -1;
   monitor->next = Monitor;
   if (info->type == MUTT_MH)
     monitor->mh_backup_path = mutt_str_dup(info->path);
@@ -258,6 +331,8 @@ static void monitor_delete(struct Monitor *monitor)
     ptr = &(*ptr)->next;
   }
 
+  if (monitor->desc_cur != -1)
+    inotify_rm_watch(INotifyFd, monitor->desc_cur);
   FREE(&monitor->mh_backup_path);
   monitor = monitor->next;
   FREE(ptr);
@@ -276,9 +351,21 @@ static int monitor_handle_ignore(int desc)
   struct Monitor *iter = Monitor;
   struct stat sb;
 
-  while (iter && (iter->desc != desc))
+  while (iter && (iter->desc != desc) && (iter->desc_cur != desc))
     iter = iter->next;
 
+  if (iter && (iter->desc_cur == desc))
+  {
+    mutt_debug(LL_DEBUG3, "cleanup watch (implicitly removed) - descriptor=%d\n", desc);
+    iter->desc_cur = -1;
+    if (MonitorContextCurDescriptor == desc)
+    {
+      MonitorContextCurDescriptor = -1;
+      monitor_events_reset(MON_EVENTS_OFF);
+    }
+    return -1;
+  }
+
   if (iter)
   {
     if ((iter->type == MUTT_MH) && (stat(iter->mh_backup_path, &sb) == 0))
@@ -304,7 +391,11 @@ static int monitor_handle_ignore(int desc)
     }
 
     if (MonitorContextDescriptor == desc)
+    {
       MonitorContextDescriptor = new_desc;
+      if (new_desc == -1)
+        monitor_events_reset(MON_EVENTS_OFF);
+    }
 
     if (new_desc == -1)
     {
@@ -382,6 +473,60 @@ static enum ResolveResult monitor_resolve(struct MonitorInfo *info, struct Mailb
   return iter ? RESOLVE_RES_OK_EXISTING : RESOLVE_RES_OK_NOTEXISTING;
 }
 
+/**
+ * monitor_read_events - Read and handle all the pending inotify events
+ * @retval true At least one event was read
+ *
+ * The inotify descriptor is non-blocking, so this never waits.
+ */
+static bool monitor_read_events(void)
+{
+  char buf[EVENT_BUFLEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+  bool found = false;
+
+  /* Handling an event may close the descriptor */
+  while (INotifyFd != -1)
+  {
+    int len = read(INotifyFd, buf, sizeof(buf));
+    if (len <= 0)
+    {
+      if ((len == -1) && (errno != EAGAIN))
+      {
+        mutt_debug(LL_DEBUG2, "read inotify events failed, errno=%d %s\n",
+                   errno, strerror(errno));
+      }
+      break;
+    }
+
+    found = true;
+    const char *ptr = buf;
+    while (ptr < (buf + len))
+    {
+      const struct inotify_event *event = (const struct inotify_event *) ptr;
+      mutt_debug(LL_DEBUG3, "+ detail: descriptor=%d mask=0x%x\n", event->wd, event->mask);
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        if (MonitorEventsState == MON_EVENTS_LIVE)
+          monitor_events_reset(MON_EVENTS_LOST);
+        MonitorContextChanged = true;
+      }
+      else if (event->mask & IN_IGNORED)
+      {
+        monitor_handle_ignore(event->wd);
+      }
+      else if ((event->wd == MonitorContextDescriptor) ||
+               (event->wd == MonitorContextCurDescriptor))
+      {
+        MonitorContextChanged = true;
+        monitor_event_record(event, (event->wd == MonitorContextCurDescriptor));
+      }
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+
+  return found;
+}
+
 /**
  * mutt_monitor_poll - Check for filesystem changes
  * @retval -3 unknown/unexpected events: poll timeout / fds not handled by us
@@ -399,13 +544,14 @@ static enum ResolveResult monitor_resolve(struct MonitorInfo *info, struct Mailb
 int mutt_monitor_poll(void)
 {
   int rc = 0;
-  char buf[EVENT_BUFLEN] __attribute__((aligned(__alignof__(struct inotify_event))));
 
-  MonitorFilesChanged = false;
+  /* mutt_monitor_events() may have read some events for us */
+  MonitorFilesChanged = MonitorFilesPending;
+  MonitorFilesPending = false;
 
   if (INotifyFd != -1)
   {
-    int fds = poll(PollFds, PollFdsLen, MuttGetchTimeout);
+    int fds = poll(PollFds, PollFdsLen, MonitorFilesChanged ? 0 : MuttGetchTimeout);
 
     if (fds == -1)
     {
@@ -431,34 +577,7 @@ int mutt_monitor_poll(void)
           {
             MonitorFilesChanged = true;
             mutt_debug(LL_DEBUG3, "file change(s) detected\n");
-            char *ptr = buf;
-            const struct inotify_event *event = NULL;
-
-            while (true)
-            {
-              int len = read(INotifyFd, buf, sizeof(buf));
-              if (len == -1)
-              {
-                if (errno != EAGAIN)
-                {
-                  mutt_debug(LL_DEBUG2, "read inotify events failed, errno=%d %s\n",
-                             errno, strerror(errno));
-                }
-                break;
-              }
-
-              while (ptr < (buf + len))
-              {
-                event = (const struct inotify_event *) ptr;
-                mutt_debug(LL_DEBUG3, "+ detail: descriptor=%d mask=0x%x\n",
-                           event->wd, event->mask);
-                if (event->mask & IN_IGNORED)
-                  monitor_handle_ignore(event->wd);
-                else if (event->wd == MonitorContextDescriptor)
-                  MonitorContextChanged = true;
-                ptr += sizeof(struct inotify_event) + event->len;
-              }
-            }
+            monitor_read_events();
           }
         }
       }
@@ -484,11 +603,15 @@ int mutt_monitor_add(struct Mailbox *m)
   monitor_info_init(&info);
 
   int rc = 0;
+  struct Monitor *monitor = NULL;
   enum ResolveResult desc = monitor_resolve(&info, m);
   if (desc != RESOLVE_RES_OK_NOTEXISTING)
   {
     if (!m && (desc == RESOLVE_RES_OK_EXISTING))
-      MonitorContextDescriptor = info.monitor->desc;
+    {
+      monitor = info.monitor;
+      goto context;
+    }
     rc = (desc == RESOLVE_RES_OK_EXISTING) ? 0 : -1;
     goto cleanup;
   }
@@ -504,10 +627,27 @@ int mutt_monitor_add(struct Mailbox *m)
   }
 
   mutt_debug(LL_DEBUG3, "inotify_add_watch descriptor=%d for '%s'\n", desc, info.path);
-  if (!m)
-    MonitorContextDescriptor = desc;
 
-  monitor_new(&info, desc);
+  monitor = monitor_new(&info, desc);
+
+  /* Watch a Maildir's 'cur' too, so that changes can be applied incrementally */
+  if (info.type == MUTT_MAILDIR)
+  {
+    struct Buffer *cur = mutt_buffer_pool_get();
+    mutt_buffer_printf(cur, "%.*s/cur", (int) mutt_str_len(info.path) - 4, info.path);
+    monitor->desc_cur = inotify_add_watch(INotifyFd, mutt_buffer_string(cur), INOTIFY_MASK_DIR);
+    mutt_debug(LL_DEBUG3, "inotify_add_watch descriptor=%d for '%s'\n",
+               monitor->desc_cur, mutt_buffer_string(cur));
+    mutt_buffer_pool_release(&cur);
+  }
+
+  if (m)
+    goto cleanup;
+
+context:
+  MonitorContextDescriptor = monitor->desc;
+  MonitorContextCurDescriptor = monitor->desc_cur;
+  monitor_events_reset((monitor->desc_cur == -1) ? MON_EVENTS_OFF : MON_EVENTS_START);
 
 cleanup:
   monitor_info_free(&info);
@@ -534,7 +674,9 @@ int mutt_monitor_remove(struct Mailbox *m)
   if (!m)
   {
     MonitorContextDescriptor = -1;
+    MonitorContextCurDescriptor = -1;
     MonitorContextChanged = false;
+    monitor_events_reset(MON_EVENTS_OFF);
   }
 
   if (monitor_resolve(&info, m) != RESOLVE_RES_OK_EXISTING)
@@ -565,7 +707,7 @@ int mutt_monitor_remove(struct Mailbox *m)
     }
   }
 
-  inotify_rm_watch(info.monitor->desc, INotifyFd);
+  inotify_rm_watch(INotifyFd, info.monitor->desc);
   mutt_debug(LL_DEBUG3, "inotify_rm_watch for '%s' descriptor=%d\n", info.path,
              info.monitor->desc);
 
@@ -577,3 +719,38 @@ cleanup:
   monitor_info_free(&info2);
   return rc;
 }
+
+/**
+ * mutt_monitor_events - Get the changes to the current Maildir
+ * @param[in]  m      Mailbox
+ * @param[out] events Array for the events, which the caller must free
+ * @retval  0 Success, every change since the last call is in events
+ * @retval -1 The mailbox isn't being watched
+ * @retval -2 Events have been lost, the mailbox must be rescanned
+ *
+ * The events are the files added to, or removed from, the 'new' and 'cur'
+ * directories.  After a non-zero return, the events will be recorded from now
+ * on.
+ *
+ * We may not have been waiting for a key, e.g. during a sync, so any events
+ * that are waiting are read first.
+ */
+int mutt_monitor_events(struct Mailbox *m, struct MonitorEventArray *events)
+{
+  if (!m || (m != ctx_mailbox(Context)) || (MonitorEventsState == MON_EVENTS_OFF))
+    return -1;
+
+  if (monitor_read_events())
+    MonitorFilesPending = true;
+
+  if (MonitorEventsState != MON_EVENTS_LIVE)
+  {
+    const int rc = (MonitorEventsState == MON_EVENTS_LOST) ? -2 : -1;
+    monitor_events_reset(MON_EVENTS_LIVE);
+    return rc;
+  }
+
+  *events = MonitorEvents;
+  ARRAY_INIT(&MonitorEvents);
+  return 0;
+}
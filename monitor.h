@@ -24,13 +24,26 @@
 #define MUTT_MONITOR_H
 
 #include <stdbool.h>
+#include "mutt/lib.h"
 
 struct Mailbox;
 
+/**
+ * struct MonitorEvent - A file added to, or removed from, a Maildir
+ */
+struct MonitorEvent
+{
+  char *name; ///< Filename
+  bool cur;   ///< true if the file is in 'cur', false for 'new'
+  bool added; ///< true if the file was added, false if it was removed
+};
+ARRAY_HEAD(MonitorEventArray, struct MonitorEvent);
+
 extern bool MonitorFilesChanged;   ///< true after a monitored file has changed
 extern bool MonitorContextChanged; ///< true after the current mailbox has changed
 
 int mutt_monitor_add(struct Mailbox *m);
+int mutt_monitor_events(struct Mailbox *m, struct MonitorEventArray *events);
 int mutt_monitor_remove(struct Mailbox *m);
 int mutt_monitor_poll(void);
 
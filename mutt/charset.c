@@ -24,6 +24,15 @@
  * @page mutt_charset Conversion between different character encodings
  *
  * Conversion between different character encodings
+ *
+ * Opening an iconv descriptor is expensive, so a small pool of them is kept
+ * open, keyed by the final pair of charset names.  mutt_ch_iconv_open() takes
+ * an idle descriptor from the pool, if it can, and mutt_ch_iconv_close()
+ * returns it.
+ *
+ * mutt_ch_convert_string() doesn't use iconv at all if the conversion
+ * wouldn't change the string, i.e. pure ASCII between ASCII-compatible
+ * charsets, or valid UTF-8 to UTF-8.
  */
 
 #include "config.h"
@@ -33,6 +42,7 @@
 #include <langinfo.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include "config/lib.h"
@@ -46,6 +56,9 @@
 #ifdef ENABLE_NLS
 #include <libintl.h>
 #endif
+#ifdef USE_PTHREAD
+#include <pthread.h>
+#endif
 
 #ifndef EILSEQ
 #define EILSEQ EINVAL
@@ -77,6 +90,30 @@ TAILQ_HEAD(LookupList, Lookup);
 
 static struct LookupList Lookups = TAILQ_HEAD_INITIALIZER(Lookups);
 
+/// Number of iconv descriptors to keep open
+#define ICONV_CACHE_SIZE 8
+
+/**
+ * struct IconvCacheEntry - An open iconv descriptor
+ */
+struct IconvCacheEntry
+{
+  char *tocode;           ///< Target character set, after the hooks
+  char *fromcode;         ///< Source character set, after the hooks
+  iconv_t cd;             ///< iconv descriptor
+  bool in_use;            ///< Descriptor has been given to a caller
+  unsigned long last_use; ///< When the descriptor was last given out
+};
+
+/// Pool of open iconv descriptors
+static struct IconvCacheEntry IconvCache[ICONV_CACHE_SIZE] = { 0 };
+/// Clock for finding the least-recently used descriptor
+static unsigned long IconvCacheClock = 0;
+#ifdef USE_PTHREAD
+/// Protects the IconvCache, it may be used by worker threads
+static pthread_mutex_t IconvCacheLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 /**
  * struct MimeNames - MIME name lookup entry
  */
@@ -544,6 +581,260 @@ const char *mutt_ch_charset_lookup(const char *chs)
   return lookup_charset(MUTT_LOOKUP_CHARSET, chs);
 }
 
+/**
+ * iconv_cache_lock - Lock the IconvCache
+ */
+static void iconv_cache_lock(void)
+{
+#ifdef USE_PTHREAD
+  pthread_mutex_lock(&IconvCacheLock);
+#endif
+}
+
+/**
+ * iconv_cache_unlock - Unlock the IconvCache
+ */
+static void iconv_cache_unlock(void)
+{
+#ifdef USE_PTHREAD
+  pthread_mutex_unlock(&IconvCacheLock);
+#endif
+}
+
+/**
+ * iconv_cache_entry_clear - Close and forget a cached descriptor
+ * @param ice Cache entry
+ *
+ * If the descriptor is still in use, it's left open.
+ * The caller will close it when mutt_ch_iconv_close() doesn't find it.
+ */
+static void iconv_cache_entry_clear(struct IconvCacheEntry *ice)
+{
+  if (!ice->in_use && (ice->cd != (iconv_t) -1) && ice->tocode)
+    iconv_close(ice->cd);
+  FREE(&ice->tocode);
+  FREE(&ice->fromcode);
+  ice->cd = (iconv_t) -1;
+  ice->in_use = false;
+  ice->last_use = 0;
+}
+
+/**
+ * iconv_cache_open - Get an iconv descriptor, from the cache if possible
+ * @param tocode   Target character set, after the hooks
+ * @param fromcode Source character set, after the hooks
+ * @retval ptr iconv descriptor, or (iconv_t) -1 on error
+ *
+ * An idle cached descriptor is reset to its initial state.  If there isn't
+ * one, a new descriptor is opened and put in the cache, replacing the
+ * least-recently used idle descriptor.  If every descriptor is in use, the new
+ * one isn't cached.
+ */
+static iconv_t iconv_cache_open(const char *tocode, const char *fromcode)
+{
+  iconv_cache_lock();
+  for (size_t i = 0; i < ICONV_CACHE_SIZE; i++)
+  {
+    struct IconvCacheEntry *ice = &IconvCache[i];
+    if (!ice->tocode || ice->in_use || !mutt_str_equal(ice->tocode, tocode) ||
+        !mutt_str_equal(ice->fromcode, fromcode))
+    {
+      continue;
+    }
+
+    ice->in_use = true;
+    ice->last_use = ++IconvCacheClock;
+    iconv_cache_unlock();
+    iconv(ice->cd, NULL, NULL, NULL, NULL);
+    return ice->cd;
+  }
+  iconv_cache_unlock();
+
+  iconv_t cd = iconv_open(tocode, fromcode);
+  if (cd == (iconv_t) -1)
+    return cd;
+
+  iconv_cache_lock();
+  struct IconvCacheEntry *victim = NULL;
+  for (size_t i = 0; i < ICONV_CACHE_SIZE; i++)
+  {
+    struct IconvCacheEntry *ice = &IconvCache[i];
+    if (ice->in_use)
+      continue;
+    if (!victim || (ice->last_use < victim->last_use))
+      victim = ice;
+  }
+
+  if (victim)
+  {
+    iconv_cache_entry_clear(victim);
+    victim->tocode = mutt_str_dup(tocode);
+    victim->fromcode = mutt_str_dup(fromcode);
+    victim->cd = cd;
+    victim->in_use = true;
+    victim->last_use = ++IconvCacheClock;
+  }
+  iconv_cache_unlock();
+
+  return cd;
+}
+
+/**
+ * iconv_names - Work out the charset names to give to iconv
+ * @param[in]  tocode   Target character set
+ * @param[in]  fromcode Source character set
+ * @param[in]  flags    Flags, e.g. #MUTT_ICONV_HOOK_FROM
+ * @param[out] tobuf    Buffer for the target name
+ * @param[out] frombuf  Buffer for the source name
+ * @param[in]  buflen   Length of the buffers
+ *
+ * See mutt_ch_iconv_open() for how the hooks are applied.
+ */
+static void iconv_names(const char *tocode, const char *fromcode, uint8_t flags,
+                        char *tobuf, char *frombuf, size_t buflen)
+{
+  char tocode1[128] = { 0 };
+  char fromcode1[128] = { 0 };
+  const char *tmp = NULL;
+
+  /* transform to MIME preferred charset names */
+  mutt_ch_canonical_charset(tocode1, sizeof(tocode1), tocode);
+  mutt_ch_canonical_charset(fromcode1, sizeof(fromcode1), fromcode);
+
+  /* maybe apply charset-hooks and recanonicalise fromcode,
+   * but only when caller asked us to sanitize a potentially wrong
+   * charset name incoming from the wild exterior. */
+  if (flags & MUTT_ICONV_HOOK_FROM)
+  {
+    tmp = mutt_ch_charset_lookup(fromcode1);
+    if (tmp)
+      mutt_ch_canonical_charset(fromcode1, sizeof(fromcode1), tmp);
+  }
+
+  /* always apply iconv-hooks to suit system's iconv tastes */
+  tmp = mutt_ch_iconv_lookup(tocode1);
+  mutt_str_copy(tobuf, tmp ? tmp : tocode1, buflen);
+  tmp = mutt_ch_iconv_lookup(fromcode1);
+  mutt_str_copy(frombuf, tmp ? tmp : fromcode1, buflen);
+}
+
+/**
+ * charset_is - Does a charset name match, ignoring any extension?
+ * @param cs   Character set, e.g. "utf-8//TRANSLIT"
+ * @param name Name to match, e.g. "utf-8"
+ * @retval true The names match
+ */
+static bool charset_is(const char *cs, const char *name)
+{
+  const size_t len = mutt_istr_startswith(cs, name);
+  return (len != 0) && ((cs[len] == '\0') || (cs[len] == '/'));
+}
+
+/**
+ * charset_is_ascii_compatible - Is ASCII a subset of this charset?
+ * @param cs Character set, after the hooks
+ * @retval true Every ASCII string has the same bytes in this charset
+ *
+ * Only a few common charsets are recognised.  Anything else is assumed to be
+ * incompatible.
+ */
+static bool charset_is_ascii_compatible(const char *cs)
+{
+  return charset_is(cs, "us-ascii") || charset_is(cs, "utf-8") ||
+         mutt_istr_startswith(cs, "iso-8859-") ||
+         mutt_istr_startswith(cs, "windows-125") || mutt_istr_startswith(cs, "koi8-");
+}
+
+/**
+ * str_ascii_len - Measure the leading ASCII part of a string
+ * @param s   String
+ * @param len Length of the string
+ * @retval num Number of leading ASCII bytes
+ *
+ * The string is tested a word at a time.
+ */
+static size_t str_ascii_len(const char *s, size_t len)
+{
+  const uint64_t high_bits = 0x8080808080808080ULL;
+  size_t i = 0;
+
+  for (; (i + sizeof(uint64_t)) <= len; i += sizeof(uint64_t))
+  {
+    uint64_t word;
+    memcpy(&word, s + i, sizeof(word));
+    if (word & high_bits)
+      break;
+  }
+
+  for (; (i < len) && !(s[i] & 0x80); i++)
+    ; // do nothing
+
+  return i;
+}
+
+/**
+ * str_is_valid_utf8 - Is a string valid UTF-8?
+ * @param s   String
+ * @param len Length of the string
+ * @retval true The string is valid UTF-8
+ *
+ * Overlong encodings, surrogates and code points above U+10FFFF are invalid,
+ * as they are to iconv.
+ */
+static bool str_is_valid_utf8(const char *s, size_t len)
+{
+  const unsigned char *u = (const unsigned char *) s;
+  size_t i = 0;
+
+  while (true)
+  {
+    i += str_ascii_len(s + i, len - i);
+    if (i == len)
+      return true;
+
+    const unsigned char c = u[i];
+    size_t n;
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xBF;
+
+    if ((c >= 0xC2) && (c <= 0xDF))
+    {
+      n = 1;
+    }
+    else if ((c >= 0xE0) && (c <= 0xEF))
+    {
+      n = 2;
+      if (c == 0xE0)
+        lo = 0xA0; // overlong
+      else if (c == 0xED)
+        hi = 0x9F; // surrogates
+    }
+    else if ((c >= 0xF0) && (c <= 0xF4))
+    {
+      n = 3;
+      if (c == 0xF0)
+        lo = 0x90; // overlong
+      else if (c == 0xF4)
+        hi = 0x8F; // > U+10FFFF
+    }
+    else
+    {
+      return false;
+    }
+
+    if ((len - i) <= n)
+      return false;
+    if ((u[i + 1] < lo) || (u[i + 1] > hi))
+      return false;
+    for (size_t j = 2; j <= n; j++)
+    {
+      if ((u[i + j] & 0xC0) != 0x80)
+        return false;
+    }
+    i += n + 1;
+  }
+}
+
 /**
  * mutt_ch_iconv_open - Set up iconv for conversions
  * @param tocode   Current character set
@@ -565,42 +856,58 @@ const char *mutt_ch_charset_lookup(const char *chs)
  *
  * @note The top-well-named MUTT_ICONV_HOOK_FROM acts on charset-hooks,
  * not at all on iconv-hooks.
+ *
+ * @note The descriptor must be released with mutt_ch_iconv_close()
  */
 iconv_t mutt_ch_iconv_open(const char *tocode, const char *fromcode, uint8_t flags)
 {
-  char tocode1[128];
-  char fromcode1[128];
-  const char *tocode2 = NULL, *fromcode2 = NULL;
-  const char *tmp = NULL;
+  char tocode2[128];
+  char fromcode2[128];
 
-  iconv_t cd;
+  iconv_names(tocode, fromcode, flags, tocode2, fromcode2, sizeof(tocode2));
 
-  /* transform to MIME preferred charset names */
-  mutt_ch_canonical_charset(tocode1, sizeof(tocode1), tocode);
-  mutt_ch_canonical_charset(fromcode1, sizeof(fromcode1), fromcode);
+  /* call system iconv with names it appreciates */
+  return iconv_cache_open(tocode2, fromcode2);
+}
 
-  /* maybe apply charset-hooks and recanonicalise fromcode,
-   * but only when caller asked us to sanitize a potentially wrong
-   * charset name incoming from the wild exterior. */
-  if (flags & MUTT_ICONV_HOOK_FROM)
+/**
+ * mutt_ch_iconv_close - Finish with an iconv descriptor
+ * @param cd iconv descriptor from mutt_ch_iconv_open()
+ *
+ * If the descriptor is cached, it's kept open for the next caller.
+ */
+void mutt_ch_iconv_close(iconv_t cd)
+{
+  if (cd == (iconv_t) -1)
+    return;
+
+  iconv_cache_lock();
+  for (size_t i = 0; i < ICONV_CACHE_SIZE; i++)
   {
-    tmp = mutt_ch_charset_lookup(fromcode1);
-    if (tmp)
-      mutt_ch_canonical_charset(fromcode1, sizeof(fromcode1), tmp);
+    struct IconvCacheEntry *ice = &IconvCache[i];
+    if (ice->in_use && (ice->cd == cd))
+    {
+      ice->in_use = false;
+      iconv_cache_unlock();
+      return;
+    }
   }
+  iconv_cache_unlock();
 
-  /* always apply iconv-hooks to suit system's iconv tastes */
-  tocode2 = mutt_ch_iconv_lookup(tocode1);
-  tocode2 = tocode2 ? tocode2 : tocode1;
-  fromcode2 = mutt_ch_iconv_lookup(fromcode1);
-  fromcode2 = fromcode2 ? fromcode2 : fromcode1;
-
-  /* call system iconv with names it appreciates */
-  cd = iconv_open(tocode2, fromcode2);
-  if (cd != (iconv_t) -1)
-    return cd;
+  iconv_close(cd);
+}
 
-  return (iconv_t) -1;
+/**
+ * mutt_ch_cache_cleanup - Close all the cached iconv descriptors
+ *
+ * Descriptors that are still in use are closed by mutt_ch_iconv_close().
+ */
+void mutt_ch_cache_cleanup(void)
+{
+  iconv_cache_lock();
+  for (size_t i = 0; i < ICONV_CACHE_SIZE; i++)
+    iconv_cache_entry_clear(&IconvCache[i]);
+  iconv_cache_unlock();
 }
 
 /**
@@ -738,7 +1045,7 @@ int mutt_ch_check(const char *s, size_t slen, const char *from, const char *to)
     rc = errno;
 
   FREE(&saved_out);
-  iconv_close(cd);
+  mutt_ch_iconv_close(cd);
   return rc;
 }
 
@@ -771,11 +1078,28 @@ int mutt_ch_convert_string(char **ps, const char *from, const char *to, uint8_t
   const char *repls[] = { "\357\277\275", "?", 0 };
   int rc = 0;
 
-  iconv_t cd = mutt_ch_iconv_open(to, from, flags);
+  char tocode[128];
+  char fromcode[128];
+  iconv_names(to, from, flags, tocode, fromcode, sizeof(tocode));
+
+  /* Skip iconv if the conversion wouldn't change anything */
+  size_t len = strlen(s);
+  if (charset_is_ascii_compatible(fromcode) && charset_is_ascii_compatible(tocode))
+  {
+    const size_t ascii = str_ascii_len(s, len);
+    if (ascii == len)
+      return 0;
+    if (charset_is(fromcode, "utf-8") && charset_is(tocode, "utf-8") &&
+        str_is_valid_utf8(s + ascii, len - ascii))
+    {
+      return 0;
+    }
+  }
+
+  iconv_t cd = iconv_cache_open(tocode, fromcode);
   if (cd == (iconv_t) -1)
     return -1;
 
-  size_t len;
   const char *ib = NULL;
   char *buf = NULL, *ob = NULL;
   size_t ibl, obl;
@@ -789,7 +1113,6 @@ int mutt_ch_convert_string(char **ps, const char *from, const char *to, uint8_t
   else
     outrepl = "?";
 
-  len = strlen(s);
   ib = s;
   ibl = len + 1;
   obl = MB_LEN_MAX * ibl;
@@ -797,7 +1120,7 @@ int mutt_ch_convert_string(char **ps, const char *from, const char *to, uint8_t
   ob = buf;
 
   mutt_ch_iconv(cd, &ib, &ibl, &ob, &obl, inrepls, outrepl, &rc);
-  iconv_close(cd);
+  mutt_ch_iconv_close(cd);
 
   *ob = '\0';
 
@@ -842,7 +1165,7 @@ bool mutt_ch_check_charset(const char *cs, bool strict)
   iconv_t cd = mutt_ch_iconv_open(cs, cs, MUTT_ICONV_NO_FLAGS);
   if (cd != (iconv_t) (-1))
   {
-    iconv_close(cd);
+    mutt_ch_iconv_close(cd);
     return true;
   }
 
@@ -894,8 +1217,7 @@ void mutt_ch_fgetconv_close(struct FgetConv **fc)
   if (!fc || !*fc)
     return;
 
-  if ((*fc)->cd != (iconv_t) -1)
-    iconv_close((*fc)->cd);
+  mutt_ch_iconv_close((*fc)->cd);
   FREE(fc);
 }
 
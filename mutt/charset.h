@@ -71,6 +71,7 @@ enum LookupType
 #define MUTT_ICONV_NO_FLAGS  0 ///< No flags are set
 #define MUTT_ICONV_HOOK_FROM 1 ///< apply charset-hooks to fromcode
 
+void             mutt_ch_cache_cleanup(void);
 void             mutt_ch_canonical_charset(char *buf, size_t buflen, const char *name);
 const char *     mutt_ch_charset_lookup(const char *chs);
 int              mutt_ch_check(const char *s, size_t slen, const char *from, const char *to);
@@ -86,6 +87,7 @@ char *           mutt_ch_fgetconvs(char *buf, size_t buflen, struct FgetConv *fc
 char *           mutt_ch_get_default_charset(void);
 char *           mutt_ch_get_langinfo_charset(void);
 size_t           mutt_ch_iconv(iconv_t cd, const char **inbuf, size_t *inbytesleft, char **outbuf, size_t *outbytesleft, const char **inrepls, const char *outrepl, int *iconverrno);
+void             mutt_ch_iconv_close(iconv_t cd);
 const char *     mutt_ch_iconv_lookup(const char *chs);
 iconv_t          mutt_ch_iconv_open(const char *tocode, const char *fromcode, uint8_t flags);
 bool             mutt_ch_lookup_add(enum LookupType type, const char *pat, const char *replace, struct Buffer *err);
@@ -442,6 +442,17 @@ uint64_t mutt_date_epoch_ms(void)
   return (uint64_t) tv.tv_sec * 1000 + tv.tv_usec / 1000;
 }
 
+/**
+ * mutt_date_epoch_us - Return the number of microseconds since the Unix epoch
+ * @retval us The number of us since the Unix epoch, or 0 on failure
+ */
+uint64_t mutt_date_epoch_us(void)
+{
+  struct timeval tv = { 0, 0 };
+  gettimeofday(&tv, NULL);
+  return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
 /**
  * mutt_date_parse_date - Parse a date string in RFC822 format
  * @param[in]  s      String to parse
@@ -25,17 +25,64 @@
  * @page mutt_hash Hash Table data structure
  *
  * Hash Table data structure.
+ *
+ * ## Chained Hash Tables
+ *
+ * By default, a Hash Table is a fixed-size array of buckets.  Each bucket is a
+ * linked list of HashElems.  The size is chosen by the caller.  If it's too
+ * small, the lists grow long and lookups slow down.
+ *
+ * ## Open addressing
+ *
+ * A Hash Table created with #MUTT_HASH_OPEN_ADDR stores its keys in an array
+ * of slots, using linear probing.  Each slot also holds the key's 64-bit hash,
+ * so most mismatches are rejected without comparing the keys.
+ *
+ * When the table is 3/4 full, a new array, twice the size, is allocated.  The
+ * old slots are moved across a few at a time, each time the table is changed,
+ * so no single insert has to pay for the whole resize.  Until then, lookups
+ * check both arrays.
+ *
+ * Deleting a key shifts the following slots back, so no tombstones are needed.
+ *
+ * Elements with duplicate keys share a slot, chained using HashElem.next, so
+ * mutt_hash_find_bucket() only returns elements with a matching key.
  */
 
 #include "config.h"
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include "hash.h"
 #include "memory.h"
 #include "string2.h"
 
 #define SOME_PRIME 149711
 
+/// Maximum number of keys in an open-addressing Hash Table, in eighths of its size
+#define HASH_MAX_LOAD 6
+/// Minimum number of slots in an open-addressing Hash Table
+#define HASH_MIN_SLOTS 8
+/// Number of old slots to move, each time a resizing Hash Table is changed
+#define HASH_MIGRATE_STEP 32
+
+/* Constants for the 64-bit hash, from xxHash */
+#define HASH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME64_3 0x165667B19E3779F9ULL
+#define HASH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define HASH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+/**
+ * struct HashSlot - A slot in a Hash Table with open addressing
+ */
+struct HashSlot
+{
+  uint64_t hash;       ///< Hash of the key
+  struct HashElem *he; ///< First element with this key, NULL if the slot is empty
+};
+
 /**
  * gen_string_hash - Generate a hash from a string - Implements hash_gen_hash_t
  */
@@ -102,17 +149,135 @@ static int cmp_int_key(union HashKey a, union HashKey b)
   return 1;
 }
 
+/**
+ * hash_rotl - Rotate a 64-bit number left
+ * @param x Number to rotate
+ * @param r Number of bits
+ * @retval num Rotated number
+ */
+static inline uint64_t hash_rotl(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+/**
+ * hash_round - Add 8 bytes of a key to a 64-bit hash
+ * @param hash Hash so far
+ * @param word 8 bytes of the key
+ * @retval num New hash
+ */
+static inline uint64_t hash_round(uint64_t hash, uint64_t word)
+{
+  hash ^= hash_rotl(word * HASH_PRIME64_2, 31) * HASH_PRIME64_1;
+  return hash_rotl(hash, 27) * HASH_PRIME64_1 + HASH_PRIME64_4;
+}
+
+/**
+ * hash_avalanche - Mix the bits of a 64-bit hash
+ * @param hash Hash
+ * @retval num Mixed hash
+ */
+static inline uint64_t hash_avalanche(uint64_t hash)
+{
+  hash ^= hash >> 33;
+  hash *= HASH_PRIME64_2;
+  hash ^= hash >> 29;
+  hash *= HASH_PRIME64_3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+/**
+ * gen_string_hash64 - Generate a 64-bit hash from a string - Implements hash_gen_hash64_t
+ *
+ * The string is read 8 bytes at a time.
+ */
+static uint64_t gen_string_hash64(union HashKey key)
+{
+  const char *s = key.strkey;
+  size_t len = strlen(s);
+  uint64_t hash = HASH_PRIME64_5 + len;
+  uint64_t word;
+
+  for (; len >= sizeof(word); s += sizeof(word), len -= sizeof(word))
+  {
+    memcpy(&word, s, sizeof(word));
+    hash = hash_round(hash, word);
+  }
+
+  if (len > 0)
+  {
+    word = 0;
+    memcpy(&word, s, len);
+    hash = hash_round(hash, word);
+  }
+
+  return hash_avalanche(hash);
+}
+
+/**
+ * gen_case_string_hash64 - Generate a 64-bit hash from a string (ignore the case) - Implements hash_gen_hash64_t
+ */
+static uint64_t gen_case_string_hash64(union HashKey key)
+{
+  const unsigned char *s = (const unsigned char *) key.strkey;
+  uint64_t hash = HASH_PRIME64_5;
+  unsigned char buf[sizeof(uint64_t)];
+  uint64_t word;
+  size_t len = 0;
+
+  for (; *s; s++)
+  {
+    buf[len++] = tolower(*s);
+    if (len == sizeof(buf))
+    {
+      memcpy(&word, buf, sizeof(word));
+      hash = hash_round(hash, word);
+      len = 0;
+    }
+  }
+
+  if (len > 0)
+  {
+    memset(buf + len, 0, sizeof(buf) - len);
+    memcpy(&word, buf, sizeof(word));
+    hash = hash_round(hash, word);
+  }
+
+  return hash_avalanche(hash);
+}
+
+/**
+ * gen_int_hash64 - Generate a 64-bit hash from an integer - Implements hash_gen_hash64_t
+ */
+static uint64_t gen_int_hash64(union HashKey key)
+{
+  return hash_avalanche(key.intkey + HASH_PRIME64_5);
+}
+
 /**
  * hash_new - Create a new Hash Table
  * @param num_elems Number of elements it should contain
+ * @param flags     Flags, see #HashFlags
  * @retval ptr New Hash Table
  *
  * The Hash Table can contain more elements than num_elems, but they will be
- * chained together.
+ * chained together.  If #MUTT_HASH_OPEN_ADDR is set, the table will grow.
  */
-static struct HashTable *hash_new(size_t num_elems)
+static struct HashTable *hash_new(size_t num_elems, HashFlags flags)
 {
   struct HashTable *table = mutt_mem_calloc(1, sizeof(struct HashTable));
+  if (flags & MUTT_HASH_OPEN_ADDR)
+  {
+    size_t num_slots = HASH_MIN_SLOTS;
+    while (num_slots < num_elems)
+      num_slots *= 2;
+    table->open_addr = true;
+    table->num_elems = num_slots;
+    table->slots = mutt_mem_calloc(num_slots, sizeof(struct HashSlot));
+    return table;
+  }
+
   if (num_elems == 0)
     num_elems = 2;
   table->num_elems = num_elems;
@@ -120,6 +285,239 @@ static struct HashTable *hash_new(size_t num_elems)
   return table;
 }
 
+/**
+ * slot_find - Find a key in an array of slots
+ * @param table     Hash Table
+ * @param slots     Array of slots
+ * @param num_slots Number of slots, a power of two
+ * @param hash      Hash of the key
+ * @param key       Key to find
+ * @retval ptr  Slot holding the key
+ * @retval NULL Not found
+ */
+static struct HashSlot *slot_find(const struct HashTable *table, struct HashSlot *slots,
+                                  size_t num_slots, uint64_t hash, union HashKey key)
+{
+  if (!slots)
+    return NULL;
+
+  const size_t mask = num_slots - 1;
+  for (size_t i = hash & mask; slots[i].he; i = (i + 1) & mask)
+  {
+    if ((slots[i].hash == hash) && (table->cmp_key(slots[i].he->key, key) == 0))
+      return &slots[i];
+  }
+
+  return NULL;
+}
+
+/**
+ * slot_place - Put a key in the first free slot
+ * @param slots     Array of slots
+ * @param num_slots Number of slots, a power of two
+ * @param hash      Hash of the key
+ * @param he        Element to store
+ */
+static void slot_place(struct HashSlot *slots, size_t num_slots, uint64_t hash,
+                       struct HashElem *he)
+{
+  const size_t mask = num_slots - 1;
+  size_t i = hash & mask;
+  while (slots[i].he)
+    i = (i + 1) & mask;
+
+  slots[i].hash = hash;
+  slots[i].he = he;
+}
+
+/**
+ * slot_remove - Empty a slot
+ * @param slots     Array of slots
+ * @param num_slots Number of slots, a power of two
+ * @param index     Slot to empty
+ *
+ * Any following keys that were displaced past the slot are moved back, so that
+ * they can still be found.
+ */
+static void slot_remove(struct HashSlot *slots, size_t num_slots, size_t index)
+{
+  const size_t mask = num_slots - 1;
+  size_t hole = index;
+
+  for (size_t i = (index + 1) & mask; slots[i].he; i = (i + 1) & mask)
+  {
+    /* Move the key back, unless that would put it before its home slot */
+    const size_t home = slots[i].hash & mask;
+    if (((i - home) & mask) >= ((i - hole) & mask))
+    {
+      slots[hole] = slots[i];
+      hole = i;
+    }
+  }
+
+  slots[hole].hash = 0;
+  slots[hole].he = NULL;
+}
+
+/**
+ * open_hash_migrate - Move some old slots into the new array
+ * @param table Hash Table
+ * @param num   Number of old slots to move
+ */
+static void open_hash_migrate(struct HashTable *table, size_t num)
+{
+  if (!table->old_slots)
+    return;
+
+  for (; (num > 0) && (table->migrate < table->old_num_slots); num--)
+  {
+    struct HashSlot *slot = &table->old_slots[table->migrate];
+    if (!slot->he)
+    {
+      table->migrate++;
+      continue;
+    }
+
+    /* Removing the slot may move another key into it, so don't advance */
+    slot_place(table->slots, table->num_elems, slot->hash, slot->he);
+    slot_remove(table->old_slots, table->old_num_slots, table->migrate);
+  }
+
+  if (table->migrate == table->old_num_slots)
+  {
+    FREE(&table->old_slots);
+    table->old_num_slots = 0;
+    table->migrate = 0;
+  }
+}
+
+/**
+ * open_hash_grow - Start moving the keys to an array twice the size
+ * @param table Hash Table
+ */
+static void open_hash_grow(struct HashTable *table)
+{
+  /* Finish any previous resize first */
+  open_hash_migrate(table, SIZE_MAX);
+
+  table->old_slots = table->slots;
+  table->old_num_slots = table->num_elems;
+  table->migrate = 0;
+
+  table->num_elems *= 2;
+  table->slots = mutt_mem_calloc(table->num_elems, sizeof(struct HashSlot));
+}
+
+/**
+ * open_hash_find_slot - Find the slot holding a key
+ * @param[in]  table     Hash Table
+ * @param[in]  key       Key to find
+ * @param[out] slots     Array containing the slot
+ * @param[out] num_slots Size of the array
+ * @retval ptr  Slot holding the key
+ * @retval NULL Not found
+ */
+static struct HashSlot *open_hash_find_slot(const struct HashTable *table, union HashKey key,
+                                            struct HashSlot **slots, size_t *num_slots)
+{
+  const uint64_t hash = table->gen_hash64(key);
+
+  struct HashSlot *slot = slot_find(table, table->slots, table->num_elems, hash, key);
+  if (slot)
+  {
+    if (slots)
+      *slots = table->slots;
+    if (num_slots)
+      *num_slots = table->num_elems;
+    return slot;
+  }
+
+  slot = slot_find(table, table->old_slots, table->old_num_slots, hash, key);
+  if (slot)
+  {
+    if (slots)
+      *slots = table->old_slots;
+    if (num_slots)
+      *num_slots = table->old_num_slots;
+  }
+  return slot;
+}
+
+/**
+ * open_hash_insert - Insert into a Hash Table with open addressing
+ * @param table Hash Table to update
+ * @param he    Element to insert
+ * @retval true  Success
+ * @retval false The key already exists (and duplicates aren't allowed)
+ */
+static bool open_hash_insert(struct HashTable *table, struct HashElem *he)
+{
+  open_hash_migrate(table, HASH_MIGRATE_STEP);
+
+  struct HashSlot *slot = open_hash_find_slot(table, he->key, NULL, NULL);
+  if (slot)
+  {
+    if (!table->allow_dups)
+      return false;
+
+    he->next = slot->he;
+    slot->he = he;
+    return true;
+  }
+
+  if (((table->num_keys + 1) * 8) > (table->num_elems * HASH_MAX_LOAD))
+    open_hash_grow(table);
+
+  slot_place(table->slots, table->num_elems, table->gen_hash64(he->key), he);
+  table->num_keys++;
+  return true;
+}
+
+/**
+ * open_hash_delete - Remove an element from a Hash Table with open addressing
+ * @param table Hash Table to use
+ * @param key   Key (either string or integer)
+ * @param data  Private data to match (or NULL for any match)
+ */
+static void open_hash_delete(struct HashTable *table, union HashKey key, const void *data)
+{
+  open_hash_migrate(table, HASH_MIGRATE_STEP);
+
+  struct HashSlot *slots = NULL;
+  size_t num_slots = 0;
+  struct HashSlot *slot = open_hash_find_slot(table, key, &slots, &num_slots);
+  if (!slot)
+    return;
+
+  struct HashElem **last = &slot->he;
+  struct HashElem *he = *last;
+  while (he)
+  {
+    if ((data == he->data) || !data)
+    {
+      *last = he->next;
+      if (table->hdata_free)
+        table->hdata_free(he->type, he->data, table->hdata);
+      if (table->strdup_keys)
+        FREE(&he->key.strkey);
+      FREE(&he);
+
+      he = *last;
+    }
+    else
+    {
+      last = &he->next;
+      he = he->next;
+    }
+  }
+
+  if (!slot->he)
+  {
+    slot_remove(slots, num_slots, slot - slots);
+    table->num_keys--;
+  }
+}
+
 /**
  * union_hash_insert - Insert into a hash table using a union as a key
  * @param table Hash Table to update
@@ -135,11 +533,22 @@ static struct HashElem *union_hash_insert(struct HashTable *table,
     return NULL; // LCOV_EXCL_LINE
 
   struct HashElem *he = mutt_mem_calloc(1, sizeof(struct HashElem));
-  size_t hash = table->gen_hash(key, table->num_elems);
   he->key = key;
   he->data = data;
   he->type = type;
 
+  if (table->open_addr)
+  {
+    if (open_hash_insert(table, he))
+      return he;
+
+    if (table->strdup_keys)
+      FREE(&he->key.strkey);
+    FREE(&he);
+    return NULL;
+  }
+
+  size_t hash = table->gen_hash(key, table->num_elems);
   if (table->allow_dups)
   {
     he->next = table->table[hash];
@@ -154,6 +563,8 @@ static struct HashElem *union_hash_insert(struct HashTable *table,
       const int rc = table->cmp_key(tmp->key, key);
       if (rc == 0)
       {
+        if (table->strdup_keys)
+          FREE(&he->key.strkey);
         FREE(&he);
         return NULL;
       }
@@ -180,6 +591,12 @@ static struct HashElem *union_hash_find_elem(const struct HashTable *table, unio
   if (!table)
     return NULL; // LCOV_EXCL_LINE
 
+  if (table->open_addr)
+  {
+    struct HashSlot *slot = open_hash_find_slot(table, key, NULL, NULL);
+    return slot ? slot->he : NULL;
+  }
+
   size_t hash = table->gen_hash(key, table->num_elems);
   struct HashElem *he = table->table[hash];
   for (; he; he = he->next)
@@ -217,6 +634,12 @@ static void union_hash_delete(struct HashTable *table, union HashKey key, const
   if (!table)
     return; // LCOV_EXCL_LINE
 
+  if (table->open_addr)
+  {
+    open_hash_delete(table, key, data);
+    return;
+  }
+
   size_t hash = table->gen_hash(key, table->num_elems);
   struct HashElem *he = table->table[hash];
   struct HashElem **last = &table->table[hash];
@@ -250,15 +673,17 @@ static void union_hash_delete(struct HashTable *table, union HashKey key, const
  */
 struct HashTable *mutt_hash_new(size_t num_elems, HashFlags flags)
 {
-  struct HashTable *table = hash_new(num_elems);
+  struct HashTable *table = hash_new(num_elems, flags);
   if (flags & MUTT_HASH_STRCASECMP)
   {
     table->gen_hash = gen_case_string_hash;
+    table->gen_hash64 = gen_case_string_hash64;
     table->cmp_key = cmp_case_string_key;
   }
   else
   {
     table->gen_hash = gen_string_hash;
+    table->gen_hash64 = gen_string_hash64;
     table->cmp_key = cmp_string_key;
   }
   if (flags & MUTT_HASH_STRDUP_KEYS)
@@ -276,8 +701,9 @@ struct HashTable *mutt_hash_new(size_t num_elems, HashFlags flags)
  */
 struct HashTable *mutt_hash_int_new(size_t num_elems, HashFlags flags)
 {
-  struct HashTable *table = hash_new(num_elems);
+  struct HashTable *table = hash_new(num_elems, flags);
   table->gen_hash = gen_int_hash;
+  table->gen_hash64 = gen_int_hash64;
   table->cmp_key = cmp_int_key;
   if (flags & MUTT_HASH_ALLOW_DUPS)
     table->allow_dups = true;
@@ -406,6 +832,9 @@ struct HashElem *mutt_hash_find_bucket(const struct HashTable *table, const char
   union HashKey key;
 
   key.strkey = strkey;
+  if (table->open_addr)
+    return union_hash_find_elem(table, key);
+
   size_t hash = table->gen_hash(key, table->num_elems);
   return table->table[hash];
 }
@@ -440,6 +869,27 @@ void mutt_hash_int_delete(struct HashTable *table, unsigned int intkey, const vo
   union_hash_delete(table, key, data);
 }
 
+/**
+ * hash_free_list - Free a list of HashElems
+ * @param table Hash Table
+ * @param elem  First HashElem of the list
+ */
+static void hash_free_list(struct HashTable *table, struct HashElem *elem)
+{
+  struct HashElem *tmp = NULL;
+
+  while (elem)
+  {
+    tmp = elem;
+    elem = elem->next;
+    if (table->hdata_free && tmp->data)
+      table->hdata_free(tmp->type, tmp->data, table->hdata);
+    if (table->strdup_keys)
+      FREE(&tmp->key.strkey);
+    FREE(&tmp);
+  }
+}
+
 /**
  * mutt_hash_free - Free a hash table
  * @param[out] ptr Hash Table to be freed
@@ -450,25 +900,36 @@ void mutt_hash_free(struct HashTable **ptr)
     return;
 
   struct HashTable *table = *ptr;
-  struct HashElem *elem = NULL, *tmp = NULL;
 
   for (size_t i = 0; i < table->num_elems; i++)
-  {
-    for (elem = table->table[i]; elem;)
-    {
-      tmp = elem;
-      elem = elem->next;
-      if (table->hdata_free && tmp->data)
-        table->hdata_free(tmp->type, tmp->data, table->hdata);
-      if (table->strdup_keys)
-        FREE(&tmp->key.strkey);
-      FREE(&tmp);
-    }
-  }
+    hash_free_list(table, table->open_addr ? table->slots[i].he : table->table[i]);
+
+  for (size_t i = 0; i < table->old_num_slots; i++)
+    hash_free_list(table, table->old_slots[i].he);
+
   FREE(&table->table);
+  FREE(&table->slots);
+  FREE(&table->old_slots);
   FREE(ptr);
 }
 
+/**
+ * hash_walk_list - Get the list of HashElems for a position in a Hash Table
+ * @param table Hash Table
+ * @param index Position, counting the buckets or slots, then any old slots
+ * @retval ptr First HashElem of the list, or NULL
+ */
+static struct HashElem *hash_walk_list(const struct HashTable *table, size_t index)
+{
+  if (!table->open_addr)
+    return table->table[index];
+
+  if (index < table->num_elems)
+    return table->slots[index].he;
+
+  return table->old_slots[index - table->num_elems].he;
+}
+
 /**
  * mutt_hash_walk - Iterate through all the HashElem's in a Hash Table
  * @param table Hash Table to search
@@ -490,11 +951,12 @@ struct HashElem *mutt_hash_walk(const struct HashTable *table, struct HashWalkSt
   if (state->last)
     state->index++;
 
-  while (state->index < table->num_elems)
+  while (state->index < (table->num_elems + table->old_num_slots))
   {
-    if (table->table[state->index])
+    struct HashElem *he = hash_walk_list(table, state->index);
+    if (he)
     {
-      state->last = table->table[state->index];
+      state->last = he;
       return state->last;
     }
     state->index++;
@@ -69,6 +69,15 @@ typedef void (*hash_hdata_free_t)(int type, void *obj, intptr_t data);
  */
 typedef size_t (*hash_gen_hash_t)(union HashKey key, size_t num_elems);
 
+/**
+ * typedef hash_gen_hash64_t - Prototype for a 64-bit Key hashing function
+ * @param key Key to hash
+ * @retval num Hash of the Key
+ *
+ * Used by the Hash Tables with open addressing, see #MUTT_HASH_OPEN_ADDR.
+ */
+typedef uint64_t (*hash_gen_hash64_t)(union HashKey key);
+
 /**
  * typedef hash_cmp_key_t - Prototype for a function to compare two Hash keys
  * @param a First key to compare
@@ -83,17 +92,29 @@ typedef int (*hash_cmp_key_t)(union HashKey a, union HashKey b);
 
 /**
  * struct HashTable - A Hash Table
+ *
+ * By default, the table is a fixed-size array of chained HashElems.
+ * If it's created with #MUTT_HASH_OPEN_ADDR, it uses open addressing instead
+ * and grows as the elements are added, see hash.c.
  */
 struct HashTable
 {
-  size_t num_elems;             ///< Number of elements in the Hash Table
+  size_t num_elems;             ///< Number of elements (or slots) in the Hash Table
   bool strdup_keys : 1;         ///< if set, the key->strkey is strdup()'d
   bool allow_dups  : 1;         ///< if set, duplicate keys are allowed
+  bool open_addr   : 1;         ///< if set, use open addressing
   struct HashElem **table;      ///< Array of Hash keys
   hash_gen_hash_t gen_hash;     ///< Function to generate hash id from the key
+  hash_gen_hash64_t gen_hash64; ///< Function to generate a 64-bit hash from the key
   hash_cmp_key_t cmp_key;       ///< Function to compare two Hash keys
   intptr_t hdata;               ///< Data to pass to the hdata_free() function
   hash_hdata_free_t hdata_free; ///< Function to free a Hash element
+
+  struct HashSlot *slots;       ///< Open addressing: Array of slots, a power of two
+  size_t num_keys;              ///< Open addressing: Number of distinct keys
+  struct HashSlot *old_slots;   ///< Open addressing: Slots being moved by a resize
+  size_t old_num_slots;         ///< Open addressing: Number of old slots
+  size_t migrate;               ///< Open addressing: Next old slot to move
 };
 
 typedef uint8_t HashFlags;             ///< Flags for mutt_hash_new(), e.g. #MUTT_HASH_STRCASECMP
@@ -101,6 +122,7 @@ typedef uint8_t HashFlags;             ///< Flags for mutt_hash_new(), e.g. #MUT
 #define MUTT_HASH_STRCASECMP  (1 << 0) ///< use strcasecmp() to compare keys
 #define MUTT_HASH_STRDUP_KEYS (1 << 1) ///< make a copy of the keys
 #define MUTT_HASH_ALLOW_DUPS  (1 << 2) ///< allow duplicate keys to be inserted
+#define MUTT_HASH_OPEN_ADDR   (1 << 3) ///< use open addressing and grow as needed
 
 void              mutt_hash_delete        (struct HashTable *table, const char *strkey, const void *data);
 struct HashElem * mutt_hash_find_bucket   (const struct HashTable *table, const char *strkey);
@@ -54,6 +54,7 @@
  * | mutt/signal.c    | @subpage mutt_signal    |
  * | mutt/state.c     | @subpage mutt_state     |
  * | mutt/string.c    | @subpage mutt_string    |
+ * | mutt/worker.c    | @subpage mutt_worker    |
  *
  * @note The library is self-contained -- some files may depend on others in
  *       the library, but none depends on source from outside.
@@ -93,6 +94,7 @@
 #include "slist.h"
 #include "state.h"
 #include "string2.h"
+#include "worker.h"
 // IWYU pragma: end_exports
 
 #endif /* MUTT_MUTT_LIB_H */
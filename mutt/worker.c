@@ -0,0 +1,196 @@
+/**
+ * @file
+ * Run a job across a pool of worker threads
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mutt_worker Run a job across a pool of worker threads
+ *
+ * Split a job of many independent items into chunks and process them on a
+ * short-lived pool of threads.  The calling thread takes part in the work and
+ * doesn't return until every chunk has been processed.
+ *
+ * If NeoMutt was built without thread support, or a thread can't be started,
+ * the remaining chunks are processed by the calling thread.  The caller sees
+ * the same result either way, so it never needs a separate serial path.
+ *
+ * Workers don't receive signals; they're left to the main thread.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "worker.h"
+#include "logging.h"
+#ifdef USE_PTHREAD
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+/// Upper limit on the number of threads in one run
+#define WORKER_MAX_THREADS 64
+
+#ifdef USE_PTHREAD
+/**
+ * struct WorkerJob - A job shared between the worker threads
+ */
+struct WorkerJob
+{
+  pthread_mutex_t lock; ///< Protects `next`
+  size_t next;          ///< Start of the next unclaimed chunk
+  size_t num_items;     ///< Total number of items
+  size_t chunk_size;    ///< Number of items per chunk
+  worker_t fn;          ///< Function to process a chunk
+  void *data;           ///< Private data for the function
+};
+
+/**
+ * worker_claim - Claim the next chunk of a job
+ * @param[in]  job   Job
+ * @param[out] start Index of the first item
+ * @param[out] end   Index one past the last item
+ * @retval true  A chunk was claimed
+ * @retval false The job is finished
+ */
+static bool worker_claim(struct WorkerJob *job, size_t *start, size_t *end)
+{
+  bool rc = false;
+
+  pthread_mutex_lock(&job->lock);
+  if (job->next < job->num_items)
+  {
+    *start = job->next;
+    *end = job->next + job->chunk_size;
+    if (*end > job->num_items)
+      *end = job->num_items;
+    job->next = *end;
+    rc = true;
+  }
+  pthread_mutex_unlock(&job->lock);
+
+  return rc;
+}
+
+/**
+ * worker_thread - Process chunks until the job is finished
+ * @param arg WorkerJob
+ * @retval NULL Always
+ */
+static void *worker_thread(void *arg)
+{
+  struct WorkerJob *job = arg;
+  size_t start = 0;
+  size_t end = 0;
+
+  while (worker_claim(job, &start, &end))
+    job->fn(job->data, start, end);
+
+  return NULL;
+}
+#endif
+
+/**
+ * mutt_worker_available - Can jobs be run in parallel?
+ * @retval true NeoMutt was built with thread support
+ */
+bool mutt_worker_available(void)
+{
+#ifdef USE_PTHREAD
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * mutt_worker_run - Process a job using a pool of threads
+ * @param num_items   Number of items in the job
+ * @param chunk_size  Number of items to pass to each call of `fn`, 0 for automatic
+ * @param num_threads Maximum number of threads, including the calling thread
+ * @param fn          Function to process a chunk of items
+ * @param data        Private data passed to `fn`
+ *
+ * The items are split into chunks of `chunk_size` and each chunk is passed to
+ * `fn` exactly once.  The order in which the chunks are processed is undefined.
+ */
+void mutt_worker_run(size_t num_items, size_t chunk_size, int num_threads,
+                     worker_t fn, void *data)
+{
+  if (!fn || (num_items == 0))
+    return;
+
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads > WORKER_MAX_THREADS)
+    num_threads = WORKER_MAX_THREADS;
+
+  if (chunk_size == 0)
+    chunk_size = (num_items + num_threads - 1) / num_threads;
+
+  size_t num_chunks = (num_items + chunk_size - 1) / chunk_size;
+  if ((size_t) num_threads > num_chunks)
+    num_threads = num_chunks;
+
+#ifdef USE_PTHREAD
+  if (num_threads > 1)
+  {
+    struct WorkerJob job = { 0 };
+    pthread_mutex_init(&job.lock, NULL);
+    job.num_items = num_items;
+    job.chunk_size = chunk_size;
+    job.fn = fn;
+    job.data = data;
+
+    /* The workers inherit this mask, so signals keep going to the main thread */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+
+    pthread_t tids[WORKER_MAX_THREADS];
+    int started = 0;
+    for (; started < (num_threads - 1); started++)
+    {
+      if (pthread_create(&tids[started], NULL, worker_thread, &job) != 0)
+      {
+        mutt_debug(LL_DEBUG1, "only started %d of %d threads\n", started, num_threads - 1);
+        break;
+      }
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    worker_thread(&job);
+
+    for (int i = 0; i < started; i++)
+      pthread_join(tids[i], NULL);
+
+    pthread_mutex_destroy(&job.lock);
+    return;
+  }
+#endif
+
+  for (size_t start = 0; start < num_items; start += chunk_size)
+  {
+    size_t end = start + chunk_size;
+    if (end > num_items)
+      end = num_items;
+    fn(data, start, end);
+  }
+}
@@ -0,0 +1,43 @@
+/**
+ * @file
+ * Run a job across a pool of worker threads
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_LIB_WORKER_H
+#define MUTT_LIB_WORKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * typedef worker_t - Prototype for a function run by mutt_worker_run()
+ * @param data  Private data passed to mutt_worker_run()
+ * @param start Index of the first item in this chunk
+ * @param end   Index one past the last item in this chunk
+ *
+ * The function may be called from any thread, concurrently with other chunks.
+ * It must only touch the items in its own chunk and thread-safe state.
+ */
+typedef void (*worker_t)(void *data, size_t start, size_t end);
+
+bool mutt_worker_available(void);
+void mutt_worker_run      (size_t num_items, size_t chunk_size, int num_threads, worker_t fn, void *data);
+
+#endif /* MUTT_LIB_WORKER_H */
@@ -393,6 +393,9 @@ static struct ConfigDef MainVars[] = {
   { "mail_check_stats_interval", DT_NUMBER|DT_NOT_NEGATIVE, 60, 0, NULL,
     "How often to check for new mail"
   },
+  { "mail_check_threads", DT_NUMBER|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "Number of threads to use when checking local mailboxes for new mail"
+  },
   { "mailcap_path", DT_SLIST|SLIST_SEP_COLON, IP "~/.mailcap:" PKGDATADIR "/mailcap:" SYSCONFDIR "/mailcap:/etc/mailcap:/usr/etc/mailcap:/usr/local/etc/mailcap", 0, NULL,
     "List of mailcap files (colon-separated)"
   },
@@ -426,6 +429,9 @@ static struct ConfigDef MainVars[] = {
   { "message_cache_clean", DT_BOOL, false, 0, NULL,
     "(imap/pop) Clean out obsolete entries from the message cache"
   },
+  { "message_cache_size", DT_LONG|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "(imap/pop) Maximum size of the message cache in bytes"
+  },
   { "message_cachedir", DT_PATH|DT_PATH_DIR, 0, 0, NULL,
     "(imap/pop) Directory for the message cache"
   },
@@ -605,6 +611,9 @@ static struct ConfigDef MainVars[] = {
   { "sort_browser", DT_SORT|DT_SORT_REVERSE, SORT_ALPHA, IP SortBrowserMethods, NULL,
     "Sort method for the browser"
   },
+  { "sort_parallel", DT_NUMBER|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "Number of threads to use when sorting the index"
+  },
   { "sort_re", DT_BOOL|R_INDEX|R_RESORT|R_RESORT_INIT, true, 0, pager_validator,
     "Sort method for the sidebar"
   },
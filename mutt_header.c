@@ -40,7 +40,6 @@
 #include "gui/lib.h"
 #include "mutt.h"
 #include "mutt_header.h"
-#include "index/lib.h"
 #include "ncrypt/lib.h"
 #include "send/lib.h"
 #include "muttlib.h"
@@ -153,7 +152,7 @@ int mutt_label_message(struct Mailbox *m, struct EmailList *el)
     if (label_message(m, en->email, new_label))
     {
       changed++;
-      mutt_set_header_color(m, en->email);
+      en->email->pair_valid = false;
     }
   }
 
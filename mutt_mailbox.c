@@ -38,24 +38,48 @@
 #include "muttlib.h"
 #include "mx.h"
 #include "protos.h"
+#ifdef USE_IMAP
+#include "imap/lib.h"
+#endif
 
 static time_t MailboxTime = 0; ///< last time we started checking for mail
 static time_t MailboxStatsTime = 0; ///< last time we check performed mail_check_stats
 static short MailboxCount = 0;  ///< how many boxes with new mail
 static short MailboxNotify = 0; ///< # of unnotified new boxes
 
+/**
+ * struct MailboxCheck - A Mailbox being checked for new mail
+ */
+struct MailboxCheck
+{
+  struct Mailbox *mailbox; ///< Mailbox to check
+  bool check_stats;        ///< Also count the total, new and flagged messages
+  bool deferred;           ///< Check later, with other Mailboxes
+  enum MxStatus status;    ///< Result of mx_mbox_check_stats()
+};
+ARRAY_HEAD(MailboxCheckArray, struct MailboxCheck);
+
 /**
  * mailbox_check - Check a mailbox for new mail
- * @param m_cur       Current Mailbox
- * @param m_check     Mailbox to check
- * @param ctx_sb      stat() info for the current Mailbox
- * @param check_stats If true, also count the total, new and flagged messages
+ * @param m_cur   Current Mailbox
+ * @param mc      Mailbox to check
+ * @param ctx_sb  stat() info for the current Mailbox
+ * @param threads If true, local Mailboxes may be checked by worker threads
+ * @retval true  The Mailbox exists
+ * @retval false The Mailbox doesn't exist
+ *
+ * IMAP Mailboxes, and local ones that can be checked in parallel, are only
+ * marked as deferred.  They're checked together by mutt_mailbox_check().
  */
-static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
-                          struct stat *ctx_sb, bool check_stats)
+static bool mailbox_check(struct Mailbox *m_cur, struct MailboxCheck *mc,
+                          struct stat *ctx_sb, bool threads)
 {
+  struct Mailbox *m_check = mc->mailbox;
   struct stat sb = { 0 };
 
+  mc->status = MX_STATUS_ERROR;
+  mc->deferred = false;
+
   enum MailboxType mb_type = mx_path_probe(mailbox_path(m_check));
 
   const bool c_mail_check_recent =
@@ -82,7 +106,7 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
         m_check->newly_created = true;
         m_check->type = MUTT_UNKNOWN;
         m_check->size = 0;
-        return;
+        return false;
       }
       break; // kept for consistency.
   }
@@ -104,11 +128,14 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
       case MUTT_MAILDIR:
       case MUTT_MH:
       case MUTT_NOTMUCH:
-        if ((mx_mbox_check_stats(m_check, check_stats) != MX_STATUS_ERROR) &&
-            m_check->has_new)
-        {
-          MailboxCount++;
-        }
+        if (threads && m_check->mx_ops && m_check->mx_ops->stats_threadsafe)
+          mc->deferred = true;
+#ifdef USE_IMAP
+        else if (m_check->type == MUTT_IMAP)
+          mc->deferred = true;
+#endif
+        else
+          mc->status = mx_mbox_check_stats(m_check, mc->check_stats);
         break;
       default:; /* do nothing */
     }
@@ -116,10 +143,69 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
   else if (c_check_mbox_size && m_cur && mutt_buffer_is_empty(&m_cur->pathbuf))
     m_check->size = (off_t) sb.st_size; /* update the size of current folder */
 
-  if (!m_check->has_new)
-    m_check->notified = false;
-  else if (!m_check->notified)
-    MailboxNotify++;
+  return true;
+}
+
+/**
+ * mailbox_check_run - Check a chunk of local Mailboxes - Implements ::worker_t
+ */
+static void mailbox_check_run(void *data, size_t start, size_t end)
+{
+  struct MailboxCheck **mcs = data;
+
+  for (size_t i = start; i < end; i++)
+    mcs[i]->status = mx_mbox_check_stats(mcs[i]->mailbox, mcs[i]->check_stats);
+}
+
+/**
+ * mailbox_check_deferred - Check the deferred Mailboxes
+ * @param mca         Mailboxes being checked
+ * @param num_threads Number of threads to use for local Mailboxes
+ *
+ * The IMAP Accounts are polled at the same time as each other, then the local
+ * Mailboxes are shared between the worker threads.
+ */
+static void mailbox_check_deferred(struct MailboxCheckArray *mca, int num_threads)
+{
+  const size_t num = ARRAY_SIZE(mca);
+  struct MailboxCheck **local = mutt_mem_calloc(num, sizeof(struct MailboxCheck *));
+  size_t num_local = 0;
+#ifdef USE_IMAP
+  struct Mailbox **imap = mutt_mem_calloc(num, sizeof(struct Mailbox *));
+  enum MxStatus *imap_status = mutt_mem_calloc(num, sizeof(enum MxStatus));
+  size_t num_imap = 0;
+#endif
+
+  struct MailboxCheck *mc = NULL;
+  ARRAY_FOREACH(mc, mca)
+  {
+    if (!mc->deferred)
+      continue;
+#ifdef USE_IMAP
+    if (mc->mailbox->type == MUTT_IMAP)
+    {
+      imap[num_imap++] = mc->mailbox;
+      continue;
+    }
+#endif
+    local[num_local++] = mc;
+  }
+
+#ifdef USE_IMAP
+  imap_mailbox_status_many(imap, num_imap, imap_status);
+
+  num_imap = 0;
+  ARRAY_FOREACH(mc, mca)
+  {
+    if (mc->deferred && (mc->mailbox->type == MUTT_IMAP))
+      mc->status = imap_status[num_imap++];
+  }
+  FREE(&imap);
+  FREE(&imap_status);
+#endif
+
+  mutt_worker_run(num_local, 1, num_threads, mailbox_check_run, local);
+  FREE(&local);
 }
 
 /**
@@ -157,6 +243,8 @@ int mutt_mailbox_check(struct Mailbox *m_cur, int force)
       cs_subset_bool(NeoMutt->sub, "mail_check_stats");
   const short c_mail_check_stats_interval =
       cs_subset_number(NeoMutt->sub, "mail_check_stats_interval");
+  const short c_mail_check_threads =
+      cs_subset_number(NeoMutt->sub, "mail_check_threads");
 
   t = mutt_date_epoch();
   if (!force && (t - MailboxTime < c_mail_check))
@@ -184,6 +272,9 @@ int mutt_mailbox_check(struct Mailbox *m_cur, int force)
     contex_sb.st_ino = 0;
   }
 
+  const bool threads = mutt_worker_available() && (c_mail_check_threads > 1);
+  struct MailboxCheckArray mca = ARRAY_HEAD_INITIALIZER;
+
   struct MailboxList ml = STAILQ_HEAD_INITIALIZER(ml);
   neomutt_mailboxlist_get_all(&ml, NeoMutt, MUTT_MAILBOX_ANY);
   struct MailboxNode *np = NULL;
@@ -192,12 +283,32 @@ int mutt_mailbox_check(struct Mailbox *m_cur, int force)
     if (np->mailbox->flags & MB_HIDDEN)
       continue;
 
-    mailbox_check(m_cur, np->mailbox, &contex_sb,
-                  check_stats || (!np->mailbox->first_check_stats_done && c_mail_check_stats));
+    struct MailboxCheck mc = { 0 };
+    mc.mailbox = np->mailbox;
+    mc.check_stats = check_stats ||
+                     (!np->mailbox->first_check_stats_done && c_mail_check_stats);
+    if (mailbox_check(m_cur, &mc, &contex_sb, threads))
+      ARRAY_ADD(&mca, mc);
     np->mailbox->first_check_stats_done = true;
   }
   neomutt_mailboxlist_clear(&ml);
 
+  mailbox_check_deferred(&mca, c_mail_check_threads);
+
+  struct MailboxCheck *mc = NULL;
+  ARRAY_FOREACH(mc, &mca)
+  {
+    struct Mailbox *m = mc->mailbox;
+    if ((mc->status != MX_STATUS_ERROR) && m->has_new)
+      MailboxCount++;
+
+    if (!m->has_new)
+      m->notified = false;
+    else if (!m->notified)
+      MailboxNotify++;
+  }
+  ARRAY_FREE(&mca);
+
   return MailboxCount;
 }
 
@@ -52,8 +52,11 @@ struct ThreadsContext
   struct Mailbox *mailbox; ///< Current mailbox
   struct MuttThread *tree; ///< Top of thread tree
   struct HashTable *hash;  ///< Hash table for threads
+  int msg_count;           ///< Number of Emails in the tree
 };
 
+ARRAY_HEAD(ThreadArray, struct MuttThread *);
+
 /**
  * is_visible - Is the message visible?
  * @param e   Email
@@ -75,8 +78,9 @@ static bool need_display_subject(struct Email *e)
   struct MuttThread *tree = e->thread;
 
   /* if the user disabled subject hiding, display it */
+  static struct ConfigHandle h_hide_thread_subject = { "hide_thread_subject" };
   const bool c_hide_thread_subject =
-      cs_subset_bool(NeoMutt->sub, "hide_thread_subject");
+      cs_handle_bool(NeoMutt->sub, &h_hide_thread_subject);
   if (!c_hide_thread_subject)
     return true;
 
@@ -304,8 +308,8 @@ void mutt_thread_ctx_free(struct ThreadsContext **tctx)
 }
 
 /**
- * mutt_draw_tree - Draw a tree of threaded emails
- * @param tctx Threading context
+ * draw_tree - Draw a list of threads
+ * @param tree First thread to draw
  *
  * Since the graphics characters have a value >255, I have to resort to using
  * escape sequences to pass the information to print_enriched_string().  These
@@ -315,7 +319,7 @@ void mutt_thread_ctx_free(struct ThreadsContext **tctx)
  * graphics chars on terminals which don't support them (see the man page for
  * curs_addch).
  */
-void mutt_draw_tree(struct ThreadsContext *tctx)
+static void draw_tree(struct MuttThread *tree)
 {
   char *pfx = NULL, *mypfx = NULL, *arrow = NULL, *myarrow = NULL, *new_tree = NULL;
   const short c_sort = cs_subset_sort(NeoMutt->sub, "sort");
@@ -325,8 +329,6 @@ void mutt_draw_tree(struct ThreadsContext *tctx)
   int depth = 0, start_depth = 0, max_depth = 0, width = c_narrow_tree ? 1 : 2;
   struct MuttThread *nextdisp = NULL, *pseudo = NULL, *parent = NULL;
 
-  struct MuttThread *tree = tctx->tree;
-
   /* Do the visibility calculations and free the old thread chars.
    * From now on we can simply ignore invisible subtrees */
   calculate_visibility(tree, &max_depth);
@@ -337,8 +339,10 @@ void mutt_draw_tree(struct ThreadsContext *tctx)
     if (depth != 0)
     {
       myarrow = arrow + (depth - start_depth - ((start_depth != 0) ? 0 : 1)) * width;
-      const bool c_hide_limited = cs_subset_bool(NeoMutt->sub, "hide_limited");
-      const bool c_hide_missing = cs_subset_bool(NeoMutt->sub, "hide_missing");
+      static struct ConfigHandle h_hide_limited = { "hide_limited" };
+      const bool c_hide_limited = cs_handle_bool(NeoMutt->sub, &h_hide_limited);
+      static struct ConfigHandle h_hide_missing = { "hide_missing" };
+      const bool c_hide_missing = cs_handle_bool(NeoMutt->sub, &h_hide_missing);
       if (start_depth == depth)
         myarrow[0] = nextdisp ? MUTT_TREE_LTEE : corner;
       else if (parent->message && !c_hide_limited)
@@ -433,6 +437,52 @@ void mutt_draw_tree(struct ThreadsContext *tctx)
   FREE(&arrow);
 }
 
+/**
+ * mutt_draw_tree - Draw a tree of threaded emails
+ * @param tctx Threading context
+ */
+void mutt_draw_tree(struct ThreadsContext *tctx)
+{
+  draw_tree(tctx->tree);
+}
+
+/**
+ * draw_touched - Redraw only the threads that have changed
+ * @param tctx    Threading context
+ * @param touched Touched threads
+ *
+ * The tree characters of a top-level thread don't depend on its siblings, so
+ * each touched thread is drawn on its own.  Only the siblings' summary of
+ * their visibility needs to be brought up to date afterwards.
+ */
+static void draw_touched(struct ThreadsContext *tctx, struct ThreadArray *touched)
+{
+  struct MuttThread **tp = NULL;
+  ARRAY_FOREACH(tp, touched)
+  {
+    struct MuttThread *thread = *tp;
+    if (thread->parent)
+      continue;
+
+    struct MuttThread *next = thread->next;
+    struct MuttThread *prev = thread->prev;
+    thread->next = NULL;
+    thread->prev = NULL;
+    draw_tree(thread);
+    thread->next = next;
+    thread->prev = prev;
+  }
+
+  struct MuttThread *last = tctx->tree;
+  while (last && last->next)
+    last = last->next;
+  for (; last; last = last->prev)
+  {
+    last->next_subtree_visible =
+        last->next && (last->next->next_subtree_visible || last->next->subtree_visible);
+  }
+}
+
 /**
  * make_subject_list - Create a sorted list of all subjects in a thread
  * @param[out] subjects String List of subjects
@@ -457,15 +507,17 @@ static void make_subject_list(struct ListHead *subjects, struct MuttThread *cur,
 
     if (dateptr)
     {
+      static struct ConfigHandle h_thread_received = { "thread_received" };
       const bool c_thread_received =
-          cs_subset_bool(NeoMutt->sub, "thread_received");
+          cs_handle_bool(NeoMutt->sub, &h_thread_received);
       thisdate = c_thread_received ? cur->message->received : cur->message->date_sent;
       if ((*dateptr == 0) || (thisdate < *dateptr))
         *dateptr = thisdate;
     }
 
     env = cur->message->env;
-    const bool c_sort_re = cs_subset_bool(NeoMutt->sub, "sort_re");
+    static struct ConfigHandle h_sort_re = { "sort_re" };
+    const bool c_sort_re = cs_handle_bool(NeoMutt->sub, &h_sort_re);
     if (env->real_subj && ((env->real_subj != env->subject) || !c_sort_re))
     {
       struct ListNode *np = NULL;
@@ -517,8 +569,9 @@ static struct MuttThread *find_subject(struct Mailbox *m, struct MuttThread *cur
   {
     for (ptr = mutt_hash_find_bucket(m->subj_hash, np->data); ptr; ptr = ptr->next)
     {
+      static struct ConfigHandle h_thread_received = { "thread_received" };
       const bool c_thread_received =
-          cs_subset_bool(NeoMutt->sub, "thread_received");
+          cs_handle_bool(NeoMutt->sub, &h_thread_received);
       tmp = ((struct Email *) ptr->data)->thread;
       if ((tmp != cur) &&                  /* don't match the same message */
           !tmp->fake_thread &&             /* don't match pseudo threads */
@@ -550,7 +603,8 @@ static struct HashTable *make_subj_hash(struct Mailbox *m)
   if (!m)
     return NULL;
 
-  struct HashTable *hash = mutt_hash_new(m->msg_count * 2, MUTT_HASH_ALLOW_DUPS);
+  struct HashTable *hash =
+      mutt_hash_new(m->msg_count * 2, MUTT_HASH_ALLOW_DUPS | MUTT_HASH_OPEN_ADDR);
 
   for (int i = 0; i < m->msg_count; i++)
   {
@@ -564,13 +618,36 @@ static struct HashTable *make_subj_hash(struct Mailbox *m)
   return hash;
 }
 
+/**
+ * touch_thread - Mark a thread as changed
+ * @param touched Touched threads
+ * @param thread  Thread, may be NULL
+ *
+ * The top of the thread is marked, so that it will be sorted and drawn again.
+ */
+static void touch_thread(struct ThreadArray *touched, struct MuttThread *thread)
+{
+  if (!thread)
+    return;
+
+  while (thread->parent)
+    thread = thread->parent;
+
+  if (thread->touched)
+    return;
+
+  thread->touched = true;
+  ARRAY_ADD(touched, thread);
+}
+
 /**
  * pseudo_threads - Thread messages by subject
- * @param tctx Threading context
+ * @param tctx    Threading context
+ * @param touched If not NULL, only thread these top-level threads
  *
  * Thread by subject things that didn't get threaded by message-id
  */
-static void pseudo_threads(struct ThreadsContext *tctx)
+static void pseudo_threads(struct ThreadsContext *tctx, struct ThreadArray *touched)
 {
   if (!tctx || !tctx->mailbox)
     return;
@@ -589,9 +666,13 @@ static void pseudo_threads(struct ThreadsContext *tctx)
   {
     cur = tree;
     tree = tree->next;
+    if (touched && !cur->touched)
+      continue;
     parent = find_subject(m, cur);
     if (parent)
     {
+      if (touched)
+        touch_thread(touched, parent);
       cur->fake_thread = true;
       unlink_message(&top, cur);
       insert_message(&parent->child, parent, cur);
@@ -657,6 +738,7 @@ void mutt_clear_threads(struct ThreadsContext *tctx)
     e->threaded = false;
   }
   tctx->tree = NULL;
+  tctx->msg_count = 0;
   mutt_hash_free(&tctx->hash);
 }
 
@@ -675,11 +757,12 @@ static int compare_threads(const void *a, const void *b)
 }
 
 /**
- * mutt_sort_subthreads - Sort the children of a thread
- * @param tctx Threading context
- * @param init If true, rebuild the thread
+ * sort_subthreads - Sort the children of a thread
+ * @param tctx         Threading context
+ * @param init         If true, rebuild the thread
+ * @param only_touched If true, don't look inside untouched top-level threads
  */
-void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
+static void sort_subthreads(struct ThreadsContext *tctx, bool init, bool only_touched)
 {
   struct MuttThread *thread = tctx->tree;
   if (!thread)
@@ -721,7 +804,12 @@ void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
         sort_top = 1;
     }
 
-    if (thread->child)
+    /* an untouched thread is still sorted, only its place among the
+     * top-level threads might change */
+    const bool skip = only_touched && !thread->parent && !thread->touched &&
+                      thread->sort_key;
+
+    if (thread->child && !skip)
     {
       thread = thread->child;
       continue;
@@ -729,7 +817,8 @@ void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
     else
     {
       /* if it has no children, it must be real. sort it on its own merits */
-      thread->sort_key = thread->message;
+      if (!thread->child)
+        thread->sort_key = thread->message;
 
       if (thread->next)
       {
@@ -827,6 +916,16 @@ void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
   }
 }
 
+/**
+ * mutt_sort_subthreads - Sort the children of a thread
+ * @param tctx Threading context
+ * @param init If true, rebuild the thread
+ */
+void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
+{
+  sort_subthreads(tctx, init, false);
+}
+
 /**
  * check_subjects - Find out which emails' subjects differ from their parent's
  * @param m    Mailbox
@@ -868,6 +967,119 @@ static void check_subjects(struct Mailbox *m, bool init)
   }
 }
 
+/**
+ * touch_new_emails - Find the threads that new Emails will change
+ * @param tctx    Threading context
+ * @param touched Touched threads
+ * @retval num Number of new Emails
+ *
+ * A new Email can fill in a missing message, become the parent or child of
+ * the Emails it refers to, or take part in the pseudo-threads of Emails with
+ * the same subject.
+ */
+static int touch_new_emails(struct ThreadsContext *tctx, struct ThreadArray *touched)
+{
+  struct Mailbox *m = tctx->mailbox;
+  struct ListNode *np = NULL;
+  int num = 0;
+
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e || e->thread)
+      continue;
+
+    num++;
+    if (e->env->message_id)
+      touch_thread(touched, mutt_hash_find(tctx->hash, e->env->message_id));
+    STAILQ_FOREACH(np, &e->env->in_reply_to, entries)
+    {
+      touch_thread(touched, mutt_hash_find(tctx->hash, np->data));
+    }
+    STAILQ_FOREACH(np, &e->env->references, entries)
+    {
+      touch_thread(touched, mutt_hash_find(tctx->hash, np->data));
+    }
+
+    if (!m->subj_hash || !e->env->real_subj)
+      continue;
+
+    for (struct HashElem *he = mutt_hash_find_bucket(m->subj_hash, e->env->real_subj);
+         he; he = he->next)
+    {
+      struct Email *e2 = he->data;
+      if (e2->thread && mutt_str_equal(e2->env->real_subj, e->env->real_subj))
+        touch_thread(touched, e2->thread);
+    }
+  }
+
+  return num;
+}
+
+/**
+ * unlink_pseudo_threads - Detach the pseudo-threads of the touched threads
+ * @param touched Touched threads, NULL for all threads
+ * @param top     Temporary top of the tree
+ *
+ * The pseudo-threads might be children of newly arrived messages, so they're
+ * moved to the top to be threaded again.
+ */
+static void unlink_pseudo_threads(struct ThreadArray *touched, struct MuttThread *top)
+{
+  struct ThreadArray all = ARRAY_HEAD_INITIALIZER;
+  if (!touched)
+  {
+    for (struct MuttThread *thread = top->child; thread; thread = thread->next)
+      ARRAY_ADD(&all, thread);
+    touched = &all;
+  }
+
+  /* the array grows as pseudo-threads are moved to the top */
+  for (size_t i = 0; i < ARRAY_SIZE(touched); i++)
+  {
+    struct MuttThread *root = *ARRAY_GET(touched, i);
+    struct MuttThread *thread = root;
+    while (thread)
+    {
+      for (struct MuttThread *child = thread->child, *next = NULL; child; child = next)
+      {
+        next = child->next;
+        if (!child->fake_thread)
+          continue;
+
+        unlink_message(&thread->child, child);
+        insert_message(&top->child, top, child);
+        child->fake_thread = false;
+        child->touched = true;
+        /* both have moved, so resort them and recheck the subject */
+        child->sort_key = NULL;
+        child->check_subject = true;
+        thread->sort_key = NULL;
+        ARRAY_ADD(touched, child);
+      }
+
+      if (thread->child)
+      {
+        thread = thread->child;
+        continue;
+      }
+      while ((thread != root) && !thread->next)
+        thread = thread->parent;
+      thread = (thread == root) ? NULL : thread->next;
+    }
+  }
+
+  if (touched == &all)
+  {
+    struct MuttThread **tp = NULL;
+    ARRAY_FOREACH(tp, &all)
+    {
+      (*tp)->touched = false;
+    }
+    ARRAY_FREE(&all);
+  }
+}
+
 /**
  * mutt_sort_threads - Sort email threads
  * @param tctx Threading context
@@ -901,10 +1113,15 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
 
   if (init)
   {
-    tctx->hash = mutt_hash_new(m->msg_count * 2, MUTT_HASH_ALLOW_DUPS);
+    tctx->hash = mutt_hash_new(m->msg_count * 2, MUTT_HASH_ALLOW_DUPS | MUTT_HASH_OPEN_ADDR);
     mutt_hash_set_destructor(tctx->hash, thread_hash_destructor, 0);
   }
 
+  /* Only the threads that the new Emails affect need to be rethreaded,
+   * resorted and redrawn.  Work out which they are before anything moves. */
+  struct ThreadArray touched = ARRAY_HEAD_INITIALIZER;
+  const bool incremental = !init && (touch_new_emails(tctx, &touched) > 0);
+
   /* we want a quick way to see if things are actually attached to the top of the
    * thread tree or if they're just dangling, so we attach everything to a top
    * node temporarily */
@@ -916,6 +1133,11 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
   for (thread = tctx->tree; thread; thread = thread->next)
     thread->parent = &top;
 
+  /* unlink pseudo-threads because they might be children of newly
+   * arrived messages.  Without new messages, subjects may have changed, so
+   * every pseudo-thread is rebuilt. */
+  unlink_pseudo_threads(incremental ? &touched : NULL, &top);
+
   /* put each new message together with the matching messageless MuttThread if it
    * exists.  otherwise, if there is a MuttThread that already has a message, thread
    * new message as an identical child.  if we didn't attach the message to a
@@ -979,6 +1201,11 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
         thread = mutt_mem_calloc(1, sizeof(struct MuttThread));
         thread->message = e;
         thread->check_subject = true;
+        if (incremental)
+        {
+          thread->touched = true;
+          ARRAY_ADD(&touched, thread);
+        }
         e->thread = thread;
         mutt_hash_insert(tctx->hash, e->env->message_id ? e->env->message_id : "", thread);
 
@@ -995,23 +1222,6 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
         }
       }
     }
-    else
-    {
-      /* unlink pseudo-threads because they might be children of newly
-       * arrived messages */
-      thread = e->thread;
-      for (tnew = thread->child; tnew;)
-      {
-        tmp = tnew->next;
-        if (tnew->fake_thread)
-        {
-          unlink_message(&thread->child, tnew);
-          insert_message(&top.child, &top, tnew);
-          tnew->fake_thread = false;
-        }
-        tnew = tmp;
-      }
-    }
   }
 
   /* thread by references */
@@ -1081,6 +1291,11 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
       {
         tnew = mutt_mem_calloc(1, sizeof(struct MuttThread));
         mutt_hash_insert(tctx->hash, ref->data, tnew);
+        if (incremental)
+        {
+          tnew->touched = true;
+          ARRAY_ADD(&touched, tnew);
+        }
       }
 
       if (thread->parent)
@@ -1102,15 +1317,20 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
   }
   tctx->tree = top.child;
 
+  /* threads may have been merged, so mark the new tops */
+  const size_t num_touched = ARRAY_SIZE(&touched);
+  for (size_t j = 0; j < num_touched; j++)
+    touch_thread(&touched, *ARRAY_GET(&touched, j));
+
   check_subjects(tctx->mailbox, init);
 
   const bool c_strict_threads = cs_subset_bool(NeoMutt->sub, "strict_threads");
   if (!c_strict_threads)
-    pseudo_threads(tctx);
+    pseudo_threads(tctx, incremental ? &touched : NULL);
 
   if (tctx->tree)
   {
-    mutt_sort_subthreads(tctx, init);
+    sort_subthreads(tctx, init, incremental);
 
     /* restore the oldsort order. */
     oldresort = OptNeedResort;
@@ -1121,10 +1341,55 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
     linearize_tree(tctx);
 
     /* Draw the thread tree. */
-    mutt_draw_tree(tctx);
+    if (incremental)
+      draw_touched(tctx, &touched);
+    else
+      mutt_draw_tree(tctx);
+  }
+
+  struct MuttThread **tp = NULL;
+  ARRAY_FOREACH(tp, &touched)
+  {
+    (*tp)->touched = false;
+  }
+  ARRAY_FREE(&touched);
+
+  tctx->msg_count = 0;
+  for (i = 0; i < m->msg_count; i++)
+  {
+    if (m->emails[i] && m->emails[i]->thread)
+      tctx->msg_count++;
   }
 }
 
+/**
+ * mutt_thread_can_update - Can the threads be updated, rather than rebuilt?
+ * @param tctx Threading context
+ * @retval true Emails have only been added since the Mailbox was threaded
+ *
+ * If so, the new Emails can be linked into the existing threads by calling
+ * mutt_sort_threads() without `init`.
+ */
+bool mutt_thread_can_update(struct ThreadsContext *tctx)
+{
+  if (!tctx || !tctx->mailbox || !tctx->tree || !tctx->hash)
+    return false;
+
+  struct Mailbox *m = tctx->mailbox;
+  int count = 0;
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e || !e->thread)
+      continue;
+    if (e->thread->message != e)
+      return false;
+    count++;
+  }
+
+  return count == tctx->msg_count;
+}
+
 /**
  * mutt_aside_thread - Find the next/previous (sub)thread
  * @param e          Search from this Email
@@ -1333,7 +1598,7 @@ int mutt_traverse_thread(struct Email *e_cur, MuttThreadFlags flag)
 
   if (flag & (MUTT_THREAD_COLLAPSE | MUTT_THREAD_UNCOLLAPSE))
   {
-    e_cur->pair = 0; /* force index entry's color to be re-evaluated */
+    e_cur->pair_valid = false; /* force index entry's color to be re-evaluated */
     e_cur->collapsed = flag & MUTT_THREAD_COLLAPSE;
     if (e_cur->vnum != -1)
     {
@@ -1367,7 +1632,7 @@ int mutt_traverse_thread(struct Email *e_cur, MuttThreadFlags flag)
     {
       if (flag & (MUTT_THREAD_COLLAPSE | MUTT_THREAD_UNCOLLAPSE))
       {
-        e_cur->pair = 0; /* force index entry's color to be re-evaluated */
+        e_cur->pair_valid = false; /* force index entry's color to be re-evaluated */
         e_cur->collapsed = flag & MUTT_THREAD_COLLAPSE;
         if (!e_root && e_cur->visible)
         {
@@ -1500,7 +1765,8 @@ int mutt_messages_in_thread(struct Mailbox *m, struct Email *e, enum MessageInTh
   struct MuttThread *threads[2];
   int rc;
 
-  const short c_sort = cs_subset_sort(NeoMutt->sub, "sort");
+  static struct ConfigHandle h_sort = { "sort" };
+  const short c_sort = cs_handle_sort(NeoMutt->sub, &h_sort);
   if (((c_sort & SORT_MASK) != SORT_THREADS) || !e->thread)
     return 1;
 
@@ -1537,7 +1803,7 @@ int mutt_messages_in_thread(struct Mailbox *m, struct Email *e, enum MessageInTh
  */
 struct HashTable *mutt_make_id_hash(struct Mailbox *m)
 {
-  struct HashTable *hash = mutt_hash_new(m->msg_count * 2, MUTT_HASH_NO_FLAGS);
+  struct HashTable *hash = mutt_hash_new(m->msg_count * 2, MUTT_HASH_OPEN_ADDR);
 
   for (int i = 0; i < m->msg_count; i++)
   {
@@ -1651,10 +1917,12 @@ void mutt_thread_collapse(struct ThreadsContext *tctx, bool collapse)
  */
 bool mutt_thread_can_collapse(struct Email *e)
 {
+  static struct ConfigHandle h_collapse_flagged = { "collapse_flagged" };
   const bool c_collapse_flagged =
-      cs_subset_bool(NeoMutt->sub, "collapse_flagged");
+      cs_handle_bool(NeoMutt->sub, &h_collapse_flagged);
+  static struct ConfigHandle h_collapse_unread = { "collapse_unread" };
   const bool c_collapse_unread =
-      cs_subset_bool(NeoMutt->sub, "collapse_unread");
+      cs_handle_bool(NeoMutt->sub, &h_collapse_unread);
   return (c_collapse_unread || !mutt_thread_contains_unread(e)) &&
          (c_collapse_flagged || !mutt_thread_contains_flagged(e));
 }
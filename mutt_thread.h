@@ -89,6 +89,7 @@ void                   mutt_thread_ctx_free          (struct ThreadsContext **tc
 void                   mutt_thread_collapse_collapsed(struct ThreadsContext *tctx);
 void                   mutt_thread_collapse          (struct ThreadsContext *tctx, bool collapse);
 bool                   mutt_thread_can_collapse      (struct Email *e);
+bool                   mutt_thread_can_update        (struct ThreadsContext *tctx);
 
 void                   mutt_clear_threads     (struct ThreadsContext *tctx);
 void                   mutt_draw_tree         (struct ThreadsContext *tctx);
@@ -1293,7 +1293,12 @@ int mx_tags_commit(struct Mailbox *m, struct Email *e, char *tags)
     return -1;
 
   if (m->mx_ops->tags_commit)
-    return m->mx_ops->tags_commit(m, e, tags);
+  {
+    int rc = m->mx_ops->tags_commit(m, e, tags);
+    if (rc == 0)
+      e->pair_valid = false; /* the colour may depend on the tags */
+    return rc;
+  }
 
   mutt_message(_("Folder doesn't support tagging, aborting"));
   return -1;
@@ -1545,6 +1550,22 @@ int mx_msg_padding_size(struct Mailbox *m)
   return m->mx_ops->msg_padding_size(m);
 }
 
+/**
+ * mx_msg_prefetch - Download an email into the body cache - Wrapper for MxOps::msg_prefetch()
+ * @param m Mailbox
+ * @param e Email
+ * @retval >0 Number of bytes downloaded
+ * @retval  0 The email was already cached
+ * @retval -1 Failure, or the Mailbox doesn't support prefetching
+ */
+long mx_msg_prefetch(struct Mailbox *m, struct Email *e)
+{
+  if (!m || !m->mx_ops || !m->mx_ops->msg_prefetch || !e)
+    return -1;
+
+  return m->mx_ops->msg_prefetch(m, e);
+}
+
 /**
  * mx_ac_find - Find the Account owning a Mailbox
  * @param m Mailbox
@@ -115,7 +115,7 @@ static void fix_uid(char *uid)
         memcpy(uid, buf, n);
     }
     FREE(&buf);
-    iconv_close(cd);
+    mutt_ch_iconv_close(cd);
   }
 }
 
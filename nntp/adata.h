@@ -44,6 +44,7 @@ struct NntpAccountData
   bool hasLISTGROUPrange  : 1;
   bool hasOVER            : 1;
   bool hasXOVER           : 1;
+  bool hasCOMPRESS        : 1; ///< Server supports COMPRESS DEFLATE, RFC8054
   unsigned int use_tls    : 3;
   unsigned int status     : 3;
   bool cacheable          : 1;
@@ -60,6 +60,11 @@ static struct ConfigDef NntpVars[] = {
   { "nntp_context", DT_NUMBER|DT_NOT_NEGATIVE, 1000, 0, NULL,
     "(nntp) Maximum number of articles to list (0 for all articles)"
   },
+#ifdef USE_ZLIB
+  { "nntp_deflate", DT_BOOL, true, 0, NULL,
+    "(nntp) Compress network traffic"
+  },
+#endif
   { "nntp_listgroup", DT_BOOL, true, 0, NULL,
     "(nntp) Check all articles when opening a newsgroup"
   },
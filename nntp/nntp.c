@@ -85,6 +85,9 @@ const char *OverviewFmt = "Subject:\0"
                           "Lines:\0"
                           "\0";
 
+/// Number of HEAD commands to send before reading the responses
+#define NNTP_PIPELINE_DEPTH 32
+
 /**
  * struct FetchCtx - Keep track when getting data from a server
  */
@@ -151,6 +154,7 @@ static int nntp_capabilities(struct NntpAccountData *adata)
   adata->hasLISTGROUP = false;
   adata->hasLISTGROUPrange = false;
   adata->hasOVER = false;
+  adata->hasCOMPRESS = false;
   FREE(&adata->authenticators);
 
   if ((mutt_socket_send(conn, "CAPABILITIES\r\n") < 0) ||
@@ -196,6 +200,12 @@ static int nntp_capabilities(struct NntpAccountData *adata)
 #endif
     else if (mutt_str_equal("OVER", buf))
       adata->hasOVER = true;
+    else if ((plen = mutt_str_startswith(buf, "COMPRESS ")))
+    {
+      mutt_str_cat(buf, sizeof(buf), " ");
+      if (strcasestr(buf + plen - 1, " DEFLATE "))
+        adata->hasCOMPRESS = true;
+    }
     else if (mutt_str_startswith(buf, "LIST "))
     {
       char *p = strstr(buf, " NEWSGROUPS");
@@ -773,9 +783,7 @@ static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen
   while (!done)
   {
     char buf[1024];
-    char *line = NULL;
     unsigned int lines = 0;
-    size_t off = 0;
     struct Progress *progress = NULL;
 
     mutt_str_copy(buf, query, sizeof(buf));
@@ -787,7 +795,6 @@ static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen
       return 1;
     }
 
-    line = mutt_mem_malloc(sizeof(buf));
     rc = 0;
 
     if (msg)
@@ -795,43 +802,30 @@ static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen
 
     while (true)
     {
-      char *p = NULL;
-      int chunk = mutt_socket_readln_d(buf, sizeof(buf), mdata->adata->conn, MUTT_SOCK_LOG_FULL);
-      if (chunk < 0)
+      char *line = NULL;
+      if (mutt_socket_readln_span(mdata->adata->conn, &line, MUTT_SOCK_LOG_FULL) < 0)
       {
         mdata->adata->status = NNTP_NONE;
         break;
       }
 
-      p = buf;
-      if (!off && (buf[0] == '.'))
+      if (line[0] == '.')
       {
-        if (buf[1] == '\0')
+        if (line[1] == '\0')
         {
           done = true;
           break;
         }
-        if (buf[1] == '.')
-          p++;
+        if (line[1] == '.')
+          line++;
       }
 
-      mutt_str_copy(line + off, p, sizeof(buf));
+      if (msg)
+        progress_update(progress, ++lines, -1);
 
-      if (chunk >= sizeof(buf))
-        off += strlen(p);
-      else
-      {
-        if (msg)
-          progress_update(progress, ++lines, -1);
-
-        if ((rc == 0) && (func(line, data) < 0))
-          rc = -2;
-        off = 0;
-      }
-
-      mutt_mem_realloc(&line, off + sizeof(buf));
+      if ((rc == 0) && (func(line, data) < 0))
+        rc = -2;
     }
-    FREE(&line);
     func(NULL, data);
     progress_free(&progress);
   }
@@ -1140,6 +1134,182 @@ static int parse_overview_line(char *line, void *data)
   return 0;
 }
 
+/**
+ * nntp_email_add - Add an Email to the Mailbox
+ * @param m       Mailbox
+ * @param e       Email, at the end of Mailbox::emails
+ * @param anum    Article number
+ * @param restore Restore message listed as deleted
+ */
+static void nntp_email_add(struct Mailbox *m, struct Email *e, anum_t anum, bool restore)
+{
+  struct NntpMboxData *mdata = m->mdata;
+
+  e->index = m->msg_count++;
+  e->read = false;
+  e->old = false;
+  e->deleted = false;
+  e->edata = nntp_edata_new();
+  e->edata_free = nntp_edata_free;
+  nntp_edata_get(e)->article_num = anum;
+  if (restore)
+    e->changed = true;
+  else
+  {
+    nntp_article_status(m, e, NULL, anum);
+    if (!e->read)
+      nntp_parse_xref(m, e);
+  }
+  if (anum > mdata->last_loaded)
+    mdata->last_loaded = anum;
+}
+
+/**
+ * nntp_fetch_heads - Fetch the headers of several articles at once
+ * @param m     Mailbox
+ * @param fc    Fetch context
+ * @param anums Article numbers
+ * @param num   Number of articles
+ * @retval  0 Success
+ * @retval  1 Bad response
+ * @retval -1 Failure
+ *
+ * All the HEAD commands are sent before any of the responses are read, so
+ * the articles only cost one round trip.  If the connection is lost, it's
+ * reopened and the HEAD commands that weren't answered are sent again.
+ */
+static int nntp_fetch_heads(struct Mailbox *m, struct FetchCtx *fc, anum_t *anums, int num)
+{
+  struct NntpMboxData *mdata = m->mdata;
+  struct NntpAccountData *adata = mdata->adata;
+  char buf[1024] = { 0 };
+  int rc = 0;
+  int done = 0;
+
+  while (done < num)
+  {
+    /* reconnect and select the group, if necessary */
+    if (adata->status != NNTP_OK)
+    {
+      buf[0] = '\0';
+      if (nntp_query(mdata, buf, sizeof(buf)) < 0)
+        return -1;
+    }
+
+    struct Buffer *cmd = mutt_buffer_pool_get();
+    for (int i = done; i < num; i++)
+      mutt_buffer_add_printf(cmd, "HEAD %u\r\n", anums[i]);
+    const int rc_send = mutt_socket_send(adata->conn, mutt_buffer_string(cmd));
+    mutt_buffer_pool_release(&cmd);
+    if (rc_send < 0)
+    {
+      adata->status = NNTP_NONE;
+      continue;
+    }
+
+    for (; done < num; done++)
+    {
+      char *line = NULL;
+      if (mutt_socket_readln_span(adata->conn, &line, MUTT_SOCK_LOG_CMD) < 0)
+        break;
+
+      if (!mutt_str_startswith(line, "221"))
+      {
+        /* no such article */
+        if (mutt_str_startswith(line, "423") || mutt_str_startswith(line, "430"))
+        {
+          if (mdata->bcache)
+          {
+            snprintf(buf, sizeof(buf), "%u", anums[done]);
+            mutt_debug(LL_DEBUG2, "#3 mutt_bcache_del %s\n", buf);
+            mutt_bcache_del(mdata->bcache, buf);
+          }
+          continue;
+        }
+
+        /* invalid response, stop, but read the responses still expected */
+        if (rc == 0)
+        {
+          mutt_error("HEAD: %s", line);
+          rc = 1;
+        }
+        continue;
+      }
+
+      FILE *fp = NULL;
+      if (rc == 0)
+      {
+        fp = mutt_file_mkstemp();
+        if (!fp)
+        {
+          mutt_perror(_("Can't create temporary file"));
+          rc = -1;
+        }
+      }
+
+      bool lost = false;
+      while (true)
+      {
+        if (mutt_socket_readln_span(adata->conn, &line, MUTT_SOCK_LOG_FULL) < 0)
+        {
+          lost = true;
+          break;
+        }
+        if (line[0] == '.')
+        {
+          if (line[1] == '\0')
+            break;
+          if (line[1] == '.')
+            line++;
+        }
+        if (fp)
+        {
+          fputs(line, fp);
+          fputc('\n', fp);
+        }
+      }
+      if (lost)
+      {
+        mutt_file_fclose(&fp);
+        break;
+      }
+      if (!fp)
+        continue;
+      rewind(fp);
+
+      /* parse header */
+      if (m->msg_count >= m->email_max)
+        mx_alloc_memory(m);
+      struct Email *e = email_new();
+      m->emails[m->msg_count] = e;
+      e->env = mutt_rfc822_read_header(fp, e, false, false);
+      e->received = e->date_sent;
+      mutt_file_fclose(&fp);
+
+#ifdef USE_HCACHE
+      if (fc->hc)
+      {
+        snprintf(buf, sizeof(buf), "%u", anums[done]);
+        mutt_debug(LL_DEBUG2, "mutt_hcache_store %s\n", buf);
+        mutt_hcache_store(fc->hc, buf, strlen(buf), e, 0);
+      }
+#endif
+
+      nntp_email_add(m, e, anums[done], fc->restore);
+    }
+
+    /* connection lost, send the rest again, unless we're stopping anyway */
+    if (done < num)
+    {
+      adata->status = NNTP_NONE;
+      if (rc != 0)
+        break;
+    }
+  }
+
+  return rc;
+}
+
 /**
  * nntp_fetch_headers - Fetch headers
  * @param m       Mailbox
@@ -1162,6 +1332,8 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
   int rc = 0;
   anum_t current;
   anum_t first_over = first;
+  anum_t pending[NNTP_PIPELINE_DEPTH];
+  int num_pending = 0;
 
   /* if empty group or nothing to do */
   if (!last || (first > last))
@@ -1176,6 +1348,9 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
   if (!fc.messages)
     return -1;
   fc.hc = hc;
+#ifdef USE_HCACHE
+  mutt_hcache_begin(fc.hc);
+#endif
 
   /* fetch list of articles */
   const bool c_nntp_listgroup = cs_subset_bool(NeoMutt->sub, "nntp_listgroup");
@@ -1250,6 +1425,20 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
     struct HCacheEntry hce = mutt_hcache_fetch(fc.hc, buf, strlen(buf), 0);
     if (hce.email)
     {
+      /* keep the articles in order */
+      if (num_pending > 0)
+      {
+        rc = nntp_fetch_heads(m, &fc, pending, num_pending);
+        num_pending = 0;
+        if (rc != 0)
+        {
+          email_free(&hce.email);
+          break;
+        }
+        if (m->msg_count >= m->email_max)
+          mx_alloc_memory(m);
+      }
+
       mutt_debug(LL_DEBUG2, "mutt_hcache_fetch %s\n", buf);
       e = hce.email;
       m->emails[m->msg_count] = e;
@@ -1287,72 +1476,27 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
         continue;
     }
 
-    /* fetch header from server */
+    /* fetch header from server, several at a time */
     else
     {
-      FILE *fp = mutt_file_mkstemp();
-      if (!fp)
-      {
-        mutt_perror(_("Can't create temporary file"));
-        rc = -1;
-        break;
-      }
-
-      snprintf(buf, sizeof(buf), "HEAD %u\r\n", current);
-      rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, fetch_tempfile, fp);
-      if (rc)
+      pending[num_pending++] = current;
+      first_over = current + 1;
+      if (num_pending == NNTP_PIPELINE_DEPTH)
       {
-        mutt_file_fclose(&fp);
-        if (rc < 0)
-          break;
-
-        /* invalid response */
-        if (!mutt_str_startswith(buf, "423"))
-        {
-          mutt_error("HEAD: %s", buf);
-          break;
-        }
-
-        /* no such article */
-        if (mdata->bcache)
-        {
-          snprintf(buf, sizeof(buf), "%u", current);
-          mutt_debug(LL_DEBUG2, "#3 mutt_bcache_del %s\n", buf);
-          mutt_bcache_del(mdata->bcache, buf);
-        }
-        rc = 0;
-        continue;
+        rc = nntp_fetch_heads(m, &fc, pending, num_pending);
+        num_pending = 0;
       }
-
-      /* parse header */
-      m->emails[m->msg_count] = email_new();
-      e = m->emails[m->msg_count];
-      e->env = mutt_rfc822_read_header(fp, e, false, false);
-      e->received = e->date_sent;
-      mutt_file_fclose(&fp);
+      continue;
     }
 
     /* save header in context */
-    e->index = m->msg_count++;
-    e->read = false;
-    e->old = false;
-    e->deleted = false;
-    e->edata = nntp_edata_new();
-    e->edata_free = nntp_edata_free;
-    nntp_edata_get(e)->article_num = current;
-    if (restore)
-      e->changed = true;
-    else
-    {
-      nntp_article_status(m, e, NULL, nntp_edata_get(e)->article_num);
-      if (!e->read)
-        nntp_parse_xref(m, e);
-    }
-    if (current > mdata->last_loaded)
-      mdata->last_loaded = current;
+    nntp_email_add(m, e, current, restore);
     first_over = current + 1;
   }
 
+  if ((num_pending > 0) && (rc == 0))
+    rc = nntp_fetch_heads(m, &fc, pending, num_pending);
+
   if (!c_nntp_listgroup || !mdata->adata->hasLISTGROUP)
     current = first_over;
 
@@ -1370,6 +1514,9 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
 
   FREE(&fc.messages);
   progress_free(&fc.progress);
+#ifdef USE_HCACHE
+  mutt_hcache_commit(fc.hc);
+#endif
   if (rc != 0)
     return -1;
   mutt_clear_error();
@@ -1511,7 +1658,7 @@ static enum MxStatus check_mailbox(struct Mailbox *m)
           messages[anum - first] = 1;
 
         snprintf(buf, sizeof(buf), "%u", anum);
-        struct HCacheEntry hce = mutt_hcache_fetch(hc, buf, strlen(buf), 0);
+        struct HCacheEntry hce = mutt_hcache_fetch_flags(hc, buf, strlen(buf), 0);
         if (hce.email)
         {
           bool deleted;
@@ -1577,7 +1724,7 @@ static enum MxStatus check_mailbox(struct Mailbox *m)
           continue;
         }
 
-        m->msg_count++;
+        e->index = m->msg_count++;
         e->read = false;
         e->old = false;
         e->edata = nntp_edata_new();
@@ -1860,6 +2007,25 @@ int nntp_open_connection(struct NntpAccountData *adata)
     }
   }
 
+#ifdef USE_ZLIB
+  /* RFC8054 */
+  const bool c_nntp_deflate = cs_subset_bool(NeoMutt->sub, "nntp_deflate");
+  if (adata->hasCOMPRESS && c_nntp_deflate)
+  {
+    if ((mutt_socket_send(conn, "COMPRESS DEFLATE\r\n") < 0) ||
+        (mutt_socket_readln(buf, sizeof(buf), conn) < 0))
+    {
+      return nntp_connect_error(adata);
+    }
+    if (mutt_str_startswith(buf, "206"))
+    {
+      mutt_debug(LL_DEBUG2, "NNTP compression is enabled on connection to %s\n",
+                 conn->account.host);
+      mutt_zstrm_wrap_conn(conn);
+    }
+  }
+#endif
+
   /* attempt features */
   if (nntp_attempt_features(adata) < 0)
     return -1;
@@ -2502,6 +2668,7 @@ static enum MxStatus nntp_mbox_sync(struct Mailbox *m)
 #ifdef USE_HCACHE
   mdata->last_cached = 0;
   struct HeaderCache *hc = nntp_hcache_open(mdata);
+  mutt_hcache_begin(hc);
 #endif
 
   for (int i = 0; i < m->msg_count; i++)
@@ -2533,6 +2700,7 @@ static enum MxStatus nntp_mbox_sync(struct Mailbox *m)
 #ifdef USE_HCACHE
   if (hc)
   {
+    mutt_hcache_commit(hc);
     mutt_hcache_close(hc);
     mdata->last_cached = mdata->last_loaded;
   }
@@ -2767,6 +2935,7 @@ struct MxOps MxNntpOps = {
   .msg_commit       = NULL,
   .msg_close        = nntp_msg_close,
   .msg_padding_size = NULL,
+  .msg_prefetch     = NULL,
   .msg_save_hcache  = NULL,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
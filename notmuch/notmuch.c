@@ -2403,7 +2403,7 @@ static int nm_tags_commit(struct Mailbox *m, struct Email *e, char *buf)
   update_tags(msg, buf);
   update_email_flags(m, e, buf);
   update_email_tags(e, msg);
-  mutt_set_header_color(m, e);
+  e->pair_valid = false;
 
   rc = 0;
   e->changed = true;
@@ -2476,6 +2476,7 @@ struct MxOps MxNotmuchOps = {
   .msg_commit       = nm_msg_commit,
   .msg_close        = nm_msg_close,
   .msg_padding_size = NULL,
+  .msg_prefetch     = NULL,
   .msg_save_hcache  = NULL,
   .tags_edit        = nm_tags_edit,
   .tags_commit      = nm_tags_commit,
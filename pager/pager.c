@@ -97,6 +97,9 @@ typedef uint8_t AnsiFlags;      ///< Flags, e.g. #ANSI_OFF
 #define ANSI_COLOR     (1 << 5) ///< Use colours
 // clang-format on
 
+/// Number of lines to index, while idle, between checks for a keypress
+#define PAGER_INDEX_STEP 1000
+
 /**
  * struct QClass - Style of quoted text
  */
@@ -134,6 +137,7 @@ struct Line
   struct TextSyntax *search;
   struct QClass *quote;
   unsigned int is_cont_hdr; ///< this line is a continuation of the previous header line
+  bool syntax_done;         ///< The colour patterns have been matched
 };
 
 /**
@@ -1005,19 +1009,19 @@ int mutt_is_quote_line(char *line, regmatch_t *pmatch)
  * @param[out] q_level      Quote level
  * @param[out] force_redraw Set to true if a screen redraw is needed
  * @param[in]  q_classify   If true, style the text
+ *
+ * The colour patterns aren't matched until the line is displayed,
+ * see resolve_syntax().
  */
 static void resolve_types(struct MuttWindow *win, char *buf, char *raw,
                           struct Line *line_info, int n, int last, struct QClass **quote_list,
                           int *q_level, bool *force_redraw, bool q_classify)
 {
   struct ColorLine *color_line = NULL;
-  struct ColorLineList *head = NULL;
   regmatch_t pmatch[1];
-  bool found;
-  bool null_rx;
   const bool c_header_color_partial =
       cs_subset_bool(NeoMutt->sub, "header_color_partial");
-  int offset, i = 0;
+  int i = 0;
 
   if ((n == 0) || mutt_color_is_header(line_info[n - 1].type) ||
       (check_protected_header_marker(raw) == 0))
@@ -1116,6 +1120,32 @@ static void resolve_types(struct MuttWindow *win, char *buf, char *raw,
   }
   else
     line_info[n].type = MT_COLOR_NORMAL;
+}
+
+/**
+ * resolve_syntax - Match the colour patterns against a line of text
+ * @param buf       Formatted text
+ * @param line_info Line info array
+ * @param n         Line number (index into line_info)
+ *
+ * This is only done for lines that are displayed.  resolve_types() must have
+ * been called first.
+ */
+static void resolve_syntax(char *buf, struct Line *line_info, int n)
+{
+  struct ColorLine *color_line = NULL;
+  struct ColorLineList *head = NULL;
+  regmatch_t pmatch[1];
+  bool found;
+  bool null_rx;
+  const bool c_header_color_partial =
+      cs_subset_bool(NeoMutt->sub, "header_color_partial");
+  int offset, i = 0;
+
+  if (line_info[n].type == -1)
+    return;
+
+  line_info[n].syntax_done = true;
 
   /* body patterns */
   if ((line_info[n].type == MT_COLOR_NORMAL) || (line_info[n].type == MT_COLOR_QUOTED) ||
@@ -1912,6 +1942,29 @@ static int display_line(FILE *fp, LOFF_T *last_pos, struct Line **line_info,
     goto out;
   }
 
+  /* match the colour patterns, now that the line will be seen */
+  m = (curr_line->continuation) ? (curr_line->syntax)[0].first : n;
+  if ((flags & MUTT_SHOWCOLOR) && !(*line_info)[m].syntax_done)
+  {
+    if (m == n)
+    {
+      resolve_syntax((char *) fmt, *line_info, n);
+    }
+    else
+    {
+      unsigned char *mbuf = NULL, *mfmt = NULL;
+      size_t mbuflen = 0;
+      int mbuf_ready = 0;
+      if (fill_buffer(fp, last_pos, (*line_info)[m].offset, &mbuf, &mfmt,
+                      &mbuflen, &mbuf_ready) >= 0)
+      {
+        resolve_syntax((char *) mfmt, *line_info, m);
+      }
+      FREE(&mbuf);
+      FREE(&mfmt);
+    }
+  }
+
   /* display the line */
   format_line(win_pager, line_info, n, buf, flags, &a, cnt, &ch, &vch, &col,
               &special, win_pager->state.cols);
@@ -2099,6 +2152,7 @@ static void pager_custom_redraw(struct Menu *pager_menu)
         rd->line_info[i].type = -1;
         rd->line_info[i].continuation = 0;
         rd->line_info[i].chunks = 0;
+        rd->line_info[i].syntax_done = false;
         rd->line_info[i].search_cnt = -1;
         rd->line_info[i].quote = NULL;
 
@@ -2120,8 +2174,7 @@ static void pager_custom_redraw(struct Menu *pager_menu)
       if (!rd->line_info[i].continuation && (++j == rd->lines))
       {
         rd->topline = i;
-        if (!rd->search_flag)
-          break;
+        break;
       }
     }
   }
@@ -2274,6 +2327,111 @@ static const struct Mapping *pager_resolve_help_mapping(enum PagerMode mode, enu
   return result;
 }
 
+/**
+ * pager_index_lines - Work out the type and wrapping of the following lines
+ * @param rd    PagerRedrawData
+ * @param count Number of lines to process, -1 for all of them
+ * @retval true The end of the file has been reached
+ *
+ * The lines aren't displayed, so their colour patterns aren't matched.
+ */
+static bool pager_index_lines(struct PagerRedrawData *rd, int count)
+{
+  for (int i = 0; (count < 0) || (i < count); i++)
+  {
+    if (display_line(rd->fp, &rd->last_pos, &rd->line_info, rd->last_line,
+                     &rd->last_line, &rd->max_line,
+                     rd->has_types | (rd->pview->flags & (MUTT_PAGER_NSKIP | MUTT_PAGER_NOWRAP)),
+                     &rd->quote_list, &rd->q_level, &rd->force_redraw,
+                     &rd->search_re, rd->pview->win_pager) != 0)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * pager_index_idle - Index the rest of the file, while the user is idle
+ * @param rd PagerRedrawData
+ *
+ * Moving to the bottom of a large file, or searching it, is quicker if the
+ * lines have already been indexed.
+ *
+ * This returns as soon as a key is pressed, or the end of the file is reached.
+ * The key is left for km_dokey().
+ */
+static void pager_index_idle(struct PagerRedrawData *rd)
+{
+  while (rd->line_info[rd->last_line].offset < rd->sb.st_size)
+  {
+    mutt_getch_timeout(0);
+    struct KeyEvent ch = mutt_getch();
+    mutt_getch_timeout(-1);
+
+    if (ch.ch != -2)
+    {
+      mutt_unget_event(ch.ch, ch.op);
+      return;
+    }
+
+    if (SigWinch)
+      return;
+
+    if (pager_index_lines(rd, PAGER_INDEX_STEP))
+      return;
+  }
+}
+
+/**
+ * pager_search_line - Find the next line that matches the search
+ * @param rd    PagerRedrawData
+ * @param start First line to check, INT_MAX for the bottom
+ * @param back  If true, search towards the top
+ * @retval num Line number of the match
+ * @retval -1  No match
+ *
+ * Searching forwards, the file is only read as far as the next match.
+ */
+static int pager_search_line(struct PagerRedrawData *rd, int start, bool back)
+{
+  const PagerFlags flags = MUTT_SEARCH | rd->has_types |
+                           (rd->pview->flags & (MUTT_PAGER_NSKIP | MUTT_PAGER_NOWRAP));
+  int i;
+
+  if (back && (start >= rd->last_line))
+  {
+    while (display_line(rd->fp, &rd->last_pos, &rd->line_info, rd->last_line,
+                        &rd->last_line, &rd->max_line, flags, &rd->quote_list,
+                        &rd->q_level, &rd->force_redraw, &rd->search_re,
+                        rd->pview->win_pager) == 0)
+    {
+      ; // do nothing
+    }
+    start = rd->last_line - 1;
+  }
+
+  for (i = back ? start : MIN(start, rd->last_line); i >= 0; i += back ? -1 : 1)
+  {
+    if (display_line(rd->fp, &rd->last_pos, &rd->line_info, i, &rd->last_line,
+                     &rd->max_line, flags, &rd->quote_list, &rd->q_level,
+                     &rd->force_redraw, &rd->search_re, rd->pview->win_pager) != 0)
+    {
+      break;
+    }
+
+    struct Line *line = &rd->line_info[i];
+    if ((back || (i >= start)) && (!rd->hide_quoted || (line->type != MT_COLOR_QUOTED)) &&
+        !line->continuation && (line->search_cnt > 0))
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
 /**
  * jump_to_bottom - make sure the bottom line is displayed
  * @param rd PagerRedrawData
@@ -2288,15 +2446,8 @@ static bool jump_to_bottom(struct PagerRedrawData *rd, struct PagerView *pview)
     return false;
   }
 
-  int line_num = rd->curline;
   /* make sure the types are defined to the end of file */
-  while (display_line(rd->fp, &rd->last_pos, &rd->line_info, line_num, &rd->last_line,
-                      &rd->max_line, rd->has_types | (pview->flags & MUTT_PAGER_NOWRAP),
-                      &rd->quote_list, &rd->q_level, &rd->force_redraw,
-                      &rd->search_re, rd->pview->win_pager) == 0)
-  {
-    line_num++;
-  }
+  pager_index_lines(rd, -1);
   rd->topline = up_n_lines(rd->pview->win_pager->state.rows, rd->line_info,
                            rd->last_line, rd->hide_quoted);
   return true;
@@ -2715,6 +2866,11 @@ int mutt_pager(struct PagerView *pview)
     // One of such functions is `mutt_enter_command()`
     // Some OP codes are not handled by pager, they cause pager to quit returning
     // OP code to index. Index hadles the operation and then restarts pager
+    pager_index_idle(&rd);
+    if (rd.force_redraw)
+      menu_queue_redraw(pager_menu, MENU_REDRAW_BODY);
+    if (pview->mode == PAGER_MODE_EMAIL)
+      index_prefetch(shared);
     op = km_dokey(MENU_PAGER);
 
     if (op >= 0)
@@ -2879,19 +3035,11 @@ int mutt_pager(struct PagerView *pview)
               (rd.search_back && (op == OP_SEARCH_OPPOSITE)))
           {
             /* searching forward */
-            int i;
-            for (i = wrapped ? 0 : rd.topline + searchctx + 1; i < rd.last_line; i++)
-            {
-              if ((!rd.hide_quoted || (rd.line_info[i].type != MT_COLOR_QUOTED)) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
+            const int i = pager_search_line(&rd, wrapped ? 0 : rd.topline + searchctx + 1, false);
 
             const bool c_wrap_search =
                 cs_subset_bool(NeoMutt->sub, "wrap_search");
-            if (i < rd.last_line)
+            if (i >= 0)
               rd.topline = i;
             else if (wrapped || !c_wrap_search)
               mutt_error(_("Not found"));
@@ -2905,16 +3053,7 @@ int mutt_pager(struct PagerView *pview)
           else
           {
             /* searching backward */
-            int i;
-            for (i = wrapped ? rd.last_line : rd.topline + searchctx - 1; i >= 0; i--)
-            {
-              if ((!rd.hide_quoted ||
-                   (rd.has_types && (rd.line_info[i].type != MT_COLOR_QUOTED))) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
+            const int i = pager_search_line(&rd, wrapped ? INT_MAX : rd.topline + searchctx - 1, true);
 
             const bool c_wrap_search =
                 cs_subset_bool(NeoMutt->sub, "wrap_search");
@@ -3010,58 +3149,16 @@ int mutt_pager(struct PagerView *pview)
         else
         {
           rd.search_compiled = true;
-          /* update the search pointers */
-          int line_num = 0;
-          while (display_line(rd.fp, &rd.last_pos, &rd.line_info, line_num,
-                              &rd.last_line, &rd.max_line,
-                              MUTT_SEARCH | (pview->flags & MUTT_PAGER_NSKIP) |
-                                  (pview->flags & MUTT_PAGER_NOWRAP),
-                              &rd.quote_list, &rd.q_level, &rd.force_redraw,
-                              &rd.search_re, rd.pview->win_pager) == 0)
-          {
-            line_num++;
-          }
-
-          if (!rd.search_back)
-          {
-            /* searching forward */
-            int i;
-            for (i = rd.topline; i < rd.last_line; i++)
-            {
-              if ((!rd.hide_quoted || (rd.line_info[i].type != MT_COLOR_QUOTED)) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
-
-            if (i < rd.last_line)
-              rd.topline = i;
-          }
-          else
-          {
-            /* searching backward */
-            int i;
-            for (i = rd.topline; i >= 0; i--)
-            {
-              if ((!rd.hide_quoted || (rd.line_info[i].type != MT_COLOR_QUOTED)) &&
-                  !rd.line_info[i].continuation && (rd.line_info[i].search_cnt > 0))
-              {
-                break;
-              }
-            }
-
-            if (i >= 0)
-              rd.topline = i;
-          }
-
-          if (rd.line_info[rd.topline].search_cnt == 0)
+          /* find the first match, reading no further than necessary */
+          const int i = pager_search_line(&rd, rd.topline, rd.search_back);
+          if (i < 0)
           {
             rd.search_flag = 0;
             mutt_error(_("Not found"));
           }
           else
           {
+            rd.topline = i;
             rd.search_flag = MUTT_SEARCH;
             /* give some context for search results */
             if (c_search_context < rd.pview->win_pager->state.rows)
@@ -122,7 +122,7 @@ static bool eat_regex(struct Pattern *pat, PatternCompFlags flags,
       FREE(&pat->p.regex);
       return false;
     }
-    FREE(&buf.data);
+    pat->regex_src = buf.data;
   }
 
   return true;
@@ -1057,6 +1057,7 @@ void mutt_pattern_free(struct PatternList **pat)
       regfree(np->p.regex);
       FREE(&np->p.regex);
     }
+    FREE(&np->regex_src);
 
     mutt_pattern_free(&np->child);
     FREE(&np);
@@ -1067,6 +1068,83 @@ void mutt_pattern_free(struct PatternList **pat)
   FREE(pat);
 }
 
+/**
+ * pattern_copy - Copy a Pattern
+ * @param pat Pattern to copy
+ * @retval ptr  New Pattern, which the caller must free
+ * @retval NULL The Pattern couldn't be copied
+ *
+ * The copy has its own compiled regexes, so it can be matched in another
+ * thread at the same time as the original.  Address groups are shared.
+ */
+struct PatternList *pattern_copy(const struct PatternList *pat)
+{
+  if (!pat)
+    return NULL;
+
+  struct PatternList *copy = mutt_mem_calloc(1, sizeof(struct PatternList));
+  SLIST_INIT(copy);
+
+  struct Pattern *last = NULL;
+  const struct Pattern *np = NULL;
+  SLIST_FOREACH(np, pat, entries)
+  {
+    struct Pattern *cp = mutt_mem_malloc(sizeof(struct Pattern));
+    *cp = *np;
+    cp->child = NULL;
+    cp->regex_src = NULL;
+    SLIST_NEXT(cp, entries) = NULL;
+
+    if (last)
+      SLIST_INSERT_AFTER(last, cp, entries);
+    else
+      SLIST_INSERT_HEAD(copy, cp, entries);
+    last = cp;
+
+    if (np->is_multi)
+    {
+      STAILQ_INIT(&cp->p.multi_cases);
+      struct ListNode *ln = NULL;
+      STAILQ_FOREACH(ln, &np->p.multi_cases, entries)
+      {
+        mutt_list_insert_tail(&cp->p.multi_cases, mutt_str_dup(ln->data));
+      }
+    }
+    else if (np->string_match || np->dynamic)
+    {
+      cp->p.str = mutt_str_dup(np->p.str);
+    }
+    else if (!np->group_match && np->p.regex)
+    {
+      cp->p.regex = NULL;
+      if (!np->regex_src)
+        goto fail;
+
+      cp->p.regex = mutt_mem_malloc(sizeof(regex_t));
+      uint16_t case_flags = mutt_mb_is_lower(np->regex_src) ? REG_ICASE : 0;
+      if (REG_COMP(cp->p.regex, np->regex_src, REG_NEWLINE | REG_NOSUB | case_flags) != 0)
+      {
+        FREE(&cp->p.regex);
+        goto fail;
+      }
+      cp->regex_src = mutt_str_dup(np->regex_src);
+    }
+
+    if (np->child)
+    {
+      cp->child = pattern_copy(np->child);
+      if (!cp->child)
+        goto fail;
+    }
+  }
+
+  return copy;
+
+fail:
+  mutt_pattern_free(&copy);
+  return NULL;
+}
+
 /**
  * mutt_pattern_node_new - Create a new list containing a Pattern
  * @retval ptr Newly created list containing a single node with a Pattern
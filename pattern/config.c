@@ -39,6 +39,9 @@ static struct ConfigDef PatternVars[] = {
   { "pattern_format", DT_STRING, IP "%2n %-15e  %d", 0, NULL,
     "printf-like format string for the pattern completion menu"
   },
+  { "pattern_threads", DT_NUMBER|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "Number of threads to use when matching patterns"
+  },
   { "thorough_search", DT_BOOL, true, 0, NULL,
     "Decode headers and messages before searching them"
   },
@@ -57,6 +57,22 @@
 #include <sys/stat.h>
 #endif
 
+/// Minimum number of emails to match in parallel
+#define PATTERN_PARALLEL_MIN 1024
+
+/**
+ * struct PatternJob - Match a Pattern against many Emails
+ */
+struct PatternJob
+{
+  struct PatternList **pats; ///< Copy of the Pattern for each chunk
+  size_t chunk_size;         ///< Number of Emails in each chunk
+  PatternExecFlags flags;    ///< Flags, e.g. #MUTT_MATCH_FULL_ADDRESS
+  struct Mailbox *m;         ///< Mailbox
+  struct Email **emails;     ///< Emails to match
+  bool *matches;             ///< Results, one per Email
+};
+
 static int pattern_exec(struct Pattern *pat, PatternExecFlags flags,
                         struct Mailbox *m, struct Email *e, struct Message *msg,
                         struct PatternCache *cache);
@@ -128,8 +144,9 @@ static bool msg_search(struct Pattern *pat, struct Mailbox *m, struct Email *e,
 
   const bool needs_head = (pat->op == MUTT_PAT_HEADER) || (pat->op == MUTT_PAT_WHOLE_MSG);
   const bool needs_body = (pat->op == MUTT_PAT_BODY) || (pat->op == MUTT_PAT_WHOLE_MSG);
+  static struct ConfigHandle h_thorough_search = { "thorough_search" };
   const bool c_thorough_search =
-      cs_subset_bool(NeoMutt->sub, "thorough_search");
+      cs_handle_bool(NeoMutt->sub, &h_thorough_search);
   if (c_thorough_search)
   {
     /* decode the header / body */
@@ -744,6 +761,9 @@ static int msg_search_sendmode(struct Email *e, struct Pattern *pat)
  */
 static bool pattern_needs_msg(const struct Mailbox *m, const struct Pattern *pat)
 {
+  if (pat->server_match)
+    return false;
+
   if ((pat->op == MUTT_PAT_MIMETYPE) || (pat->op == MUTT_PAT_MIMEATTACH))
   {
     return true;
@@ -793,6 +813,12 @@ static int pattern_exec(struct Pattern *pat, PatternExecFlags flags,
                         struct Mailbox *m, struct Email *e, struct Message *msg,
                         struct PatternCache *cache)
 {
+#ifdef USE_IMAP
+  /* imap_search() has already matched the whole of this Pattern */
+  if (pat->server_match && m && (m->type == MUTT_IMAP))
+    return e->matched;
+#endif
+
   switch (pat->op)
   {
     case MUTT_PAT_AND:
@@ -1103,6 +1129,142 @@ int mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags,
   return rc;
 }
 
+/**
+ * pattern_is_parallel - Can a Pattern be matched in a worker thread?
+ * @param m   Mailbox
+ * @param pat Pattern to check
+ * @retval true The Pattern only reads the Email's headers and flags
+ *
+ * Patterns that open the message, update themselves, print errors or log
+ * their matches must be run by the main thread.
+ */
+static bool pattern_is_parallel(const struct Mailbox *m, const struct PatternList *pat)
+{
+  const struct Pattern *p = NULL;
+  SLIST_FOREACH(p, pat, entries)
+  {
+    /* The result of the server-side search is already in e->matched */
+    if (p->server_match && m && (m->type == MUTT_IMAP))
+      continue;
+
+    if (pattern_needs_msg(m, p) || p->dynamic || p->sendmode || p->group_match)
+      return false;
+
+    switch (p->op)
+    {
+      case MUTT_PAT_BODY:
+      case MUTT_PAT_HEADER:
+      case MUTT_PAT_WHOLE_MSG:
+      case MUTT_PAT_SERVERSEARCH:
+#ifdef USE_IMAP
+        /* The results of the server-side search are already in e->matched */
+        if (!m || (m->type != MUTT_IMAP) || !p->string_match)
+          return false;
+        break;
+#else
+        return false;
+#endif
+      case MUTT_PAT_CRYPT_SIGN:
+      case MUTT_PAT_CRYPT_VERIFIED:
+      case MUTT_PAT_CRYPT_ENCRYPT:
+        if (!WithCrypto)
+          return false;
+        break;
+      case MUTT_PAT_PGP_KEY:
+        if (!(WithCrypto & APPLICATION_PGP))
+          return false;
+        break;
+      case MUTT_PAT_COLLAPSED: /* The limit resets e->collapsed as it goes */
+      case MUTT_PAT_LIST:
+      case MUTT_PAT_SUBSCRIBED_LIST:
+      case MUTT_PAT_PERSONAL_RECIP:
+      case MUTT_PAT_PERSONAL_FROM:
+        return false;
+    }
+
+    if (p->child && !pattern_is_parallel(m, p->child))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * pattern_exec_chunk - Match a Pattern against a chunk of Emails - Implements ::worker_t
+ */
+static void pattern_exec_chunk(void *data, size_t start, size_t end)
+{
+  struct PatternJob *job = data;
+  struct Pattern *pat = SLIST_FIRST(job->pats[start / job->chunk_size]);
+
+  for (size_t i = start; i < end; i++)
+  {
+    struct Email *e = job->emails[i];
+    job->matches[i] = e && (pattern_exec(pat, job->flags, job->m, e, NULL, NULL) != 0);
+  }
+}
+
+/**
+ * mutt_pattern_exec_many - Match a pattern against many emails in parallel
+ * @param[in]  pat     Pattern to match
+ * @param[in]  flags   Flags, e.g. #MUTT_MATCH_FULL_ADDRESS
+ * @param[in]  m       Mailbox
+ * @param[in]  emails  Emails to match, may contain NULLs
+ * @param[in]  num     Number of Emails
+ * @param[out] matches Results, one per Email
+ * @retval true  Success, `matches` has been filled in
+ * @retval false The emails must be matched one at a time with mutt_pattern_exec()
+ *
+ * The emails are shared between `$pattern_threads` threads, each with its own
+ * copy of the Pattern.  This is only done for Patterns that can be matched
+ * using the headers alone, and for enough emails to be worth it.
+ */
+bool mutt_pattern_exec_many(struct PatternList *pat, PatternExecFlags flags, struct Mailbox *m,
+                            struct Email **emails, size_t num, bool *matches)
+{
+  if (!pat || !emails || !matches || (num < PATTERN_PARALLEL_MIN) ||
+      !mutt_worker_available())
+  {
+    return false;
+  }
+
+  const short c_pattern_threads = cs_subset_number(NeoMutt->sub, "pattern_threads");
+  if ((c_pattern_threads < 2) || !pattern_is_parallel(m, pat))
+    return false;
+
+  struct PatternJob job = { 0 };
+  job.chunk_size = (num + c_pattern_threads - 1) / c_pattern_threads;
+  job.flags = flags;
+  job.m = m;
+  job.emails = emails;
+  job.matches = matches;
+
+  /* Matching a regex takes a lock on it, so each chunk needs its own copy */
+  const size_t num_chunks = (num + job.chunk_size - 1) / job.chunk_size;
+  job.pats = mutt_mem_calloc(num_chunks, sizeof(struct PatternList *));
+  job.pats[0] = pat;
+
+  bool rc = true;
+  for (size_t i = 1; i < num_chunks; i++)
+  {
+    job.pats[i] = pattern_copy(pat);
+    if (!job.pats[i])
+    {
+      rc = false;
+      break;
+    }
+  }
+
+  if (rc)
+    mutt_worker_run(num, job.chunk_size, c_pattern_threads, pattern_exec_chunk, &job);
+
+  for (size_t i = 1; i < num_chunks; i++)
+    mutt_pattern_free(&job.pats[i]);
+  FREE(&job.pats);
+
+  return rc;
+}
+
 /**
  * mutt_pattern_alias_exec - Match a pattern against an alias
  * @param pat   Pattern to match
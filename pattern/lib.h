@@ -77,6 +77,7 @@ struct Pattern
   bool dynamic      : 1;         ///< Evaluate date ranges at run time
   bool sendmode     : 1;         ///< Evaluate searches in send-mode
   bool is_multi     : 1;         ///< Multiple case (only for ~I pattern now)
+  bool server_match : 1;         ///< Matched by the server, the result is in Email::matched
   int min;                       ///< Minimum for range checks
   int max;                       ///< Maximum for range checks
   struct PatternList *child;     ///< Arguments to logical operation
@@ -86,6 +87,7 @@ struct Pattern
     char *str;                   ///< String, if string_match is set
     struct ListHead multi_cases; ///< Multiple strings for ~I pattern
   } p;
+  char *regex_src;               ///< Source of the regex, so it can be compiled again
   SLIST_ENTRY(Pattern) entries;  ///< Linked list
 };
 SLIST_HEAD(PatternList, Pattern);
@@ -172,6 +174,8 @@ enum PatternType
 
 int mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags, struct Mailbox *m,
                       struct Email *e, struct PatternCache *cache);
+bool mutt_pattern_exec_many(struct PatternList *pat, PatternExecFlags flags, struct Mailbox *m,
+                            struct Email **emails, size_t num, bool *matches);
 int mutt_pattern_alias_exec(struct Pattern *pat, PatternExecFlags flags,
                             struct AliasView *av, struct PatternCache *cache);
 
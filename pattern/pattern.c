@@ -331,6 +331,30 @@ bail:
   return rc;
 }
 
+/**
+ * pattern_exec_virtual - Match a Pattern against the visible emails in parallel
+ * @param pat Pattern to match
+ * @param m   Mailbox
+ * @retval ptr  Results, one per visible email, which the caller must free
+ * @retval NULL The emails must be matched one at a time
+ */
+static bool *pattern_exec_virtual(struct PatternList *pat, struct Mailbox *m)
+{
+  if (m->vcount <= 0)
+    return NULL;
+
+  struct Email **emails = mutt_mem_calloc(m->vcount, sizeof(struct Email *));
+  for (int i = 0; i < m->vcount; i++)
+    emails[i] = mutt_get_virt_email(m, i);
+
+  bool *matches = mutt_mem_calloc(m->vcount, sizeof(bool));
+  if (!mutt_pattern_exec_many(pat, MUTT_MATCH_FULL_ADDRESS, m, emails, m->vcount, matches))
+    FREE(&matches);
+
+  FREE(&emails);
+  return matches;
+}
+
 /**
  * mutt_pattern_func - Perform some Pattern matching
  * @param ctx    Current Mailbox
@@ -349,6 +373,7 @@ int mutt_pattern_func(struct Context *ctx, int op, char *prompt)
   struct Buffer err;
   int rc = -1;
   struct Progress *progress = NULL;
+  bool *matches = NULL;
   struct Buffer *buf = mutt_buffer_pool_get();
 
   mutt_buffer_strcpy(buf, NONULL(ctx->pattern));
@@ -395,6 +420,16 @@ int mutt_pattern_func(struct Context *ctx, int op, char *prompt)
 
   if (op == MUTT_LIMIT)
   {
+    if (!match_all)
+    {
+      matches = mutt_mem_calloc(m->msg_count, sizeof(bool));
+      if (!mutt_pattern_exec_many(pat, MUTT_MATCH_FULL_ADDRESS, m, m->emails,
+                                  m->msg_count, matches))
+      {
+        FREE(&matches);
+      }
+    }
+
     m->vcount = 0;
     ctx->vsize = 0;
     ctx->collapsed = false;
@@ -412,8 +447,8 @@ int mutt_pattern_func(struct Context *ctx, int op, char *prompt)
       e->visible = false;
       e->collapsed = false;
       e->num_hidden = 0;
-      if (match_all ||
-          mutt_pattern_exec(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
+      if (match_all || (matches ? matches[i] :
+                        mutt_pattern_exec(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, e, NULL)))
       {
         e->vnum = m->vcount;
         e->visible = true;
@@ -426,13 +461,16 @@ int mutt_pattern_func(struct Context *ctx, int op, char *prompt)
   }
   else
   {
+    matches = pattern_exec_virtual(pat, m);
+
     for (int i = 0; i < m->vcount; i++)
     {
       struct Email *e = mutt_get_virt_email(m, i);
       if (!e)
         continue;
       progress_update(progress, i, -1);
-      if (mutt_pattern_exec(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
+      if (matches ? matches[i] :
+                    mutt_pattern_exec(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
       {
         switch (op)
         {
@@ -451,6 +489,7 @@ int mutt_pattern_func(struct Context *ctx, int op, char *prompt)
     }
   }
   progress_free(&progress);
+  FREE(&matches);
 
   mutt_clear_error();
 
@@ -560,6 +599,21 @@ int mutt_search_command(struct Mailbox *m, struct Menu *menu, int cur, int op)
       return -1;
 #endif
     OptSearchInvalid = false;
+
+    /* If the pattern can be matched in parallel, fill in the search cache now */
+    bool *matches = pattern_exec_virtual(SearchPattern, m);
+    if (matches)
+    {
+      for (int i = 0; i < m->vcount; i++)
+      {
+        struct Email *e = mutt_get_virt_email(m, i);
+        if (!e)
+          continue;
+        e->searched = true;
+        e->matched = matches[i];
+      }
+      FREE(&matches);
+    }
   }
 
   int incr = OptSearchReverse ? -1 : 1;
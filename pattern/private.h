@@ -124,5 +124,6 @@ extern const struct PatternFlags Flags[];
 const struct PatternFlags *lookup_op(int op);
 const struct PatternFlags *lookup_tag(char tag);
 bool eval_date_minmax(struct Pattern *pat, const char *s, struct Buffer *err);
+struct PatternList *pattern_copy(const struct PatternList *pat);
 
 #endif /* MUTT_PATTERN_PRIVATE_H */
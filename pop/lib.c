@@ -508,55 +508,37 @@ int pop_fetch_data(struct PopAccountData *adata, const char *query,
 {
   char buf[1024];
   long pos = 0;
-  size_t lenbuf = 0;
 
   mutt_str_copy(buf, query, sizeof(buf));
   int rc = pop_query(adata, buf, sizeof(buf));
   if (rc < 0)
     return rc;
 
-  char *inbuf = mutt_mem_malloc(sizeof(buf));
-
   while (true)
   {
-    const int chunk =
-        mutt_socket_readln_d(buf, sizeof(buf), adata->conn, MUTT_SOCK_LOG_FULL);
-    if (chunk < 0)
+    char *line = NULL;
+    const int len = mutt_socket_readln_span(adata->conn, &line, MUTT_SOCK_LOG_FULL);
+    if (len < 0)
     {
       adata->status = POP_DISCONNECTED;
       rc = -1;
       break;
     }
 
-    char *p = buf;
-    if (!lenbuf && (buf[0] == '.'))
+    if (line[0] == '.')
     {
-      if (buf[1] != '.')
+      if (line[1] != '.')
         break;
-      p++;
-    }
-
-    mutt_str_copy(inbuf + lenbuf, p, sizeof(buf));
-    pos += chunk;
-
-    /* cast is safe since we break out of the loop when chunk<=0 */
-    if ((size_t) chunk >= sizeof(buf))
-    {
-      lenbuf += strlen(p);
-    }
-    else
-    {
-      if (progress)
-        progress_update(progress, pos, -1);
-      if ((rc == 0) && (callback(inbuf, data) < 0))
-        rc = -3;
-      lenbuf = 0;
+      line++;
     }
 
-    mutt_mem_realloc(&inbuf, lenbuf + sizeof(buf));
+    pos += len + 1;
+    if (progress)
+      progress_update(progress, pos, -1);
+    if ((rc == 0) && (callback(line, data) < 0))
+      rc = -3;
   }
 
-  FREE(&inbuf);
   return rc;
 }
 
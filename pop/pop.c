@@ -327,6 +327,7 @@ static int pop_fetch_headers(struct Mailbox *m)
 
 #ifdef USE_HCACHE
   struct HeaderCache *hc = pop_hcache_open(adata, mailbox_path(m));
+  mutt_hcache_begin(hc);
 #endif
 
   adata->check_time = mutt_date_epoch();
@@ -464,6 +465,7 @@ static int pop_fetch_headers(struct Mailbox *m)
   progress_free(&progress);
 
 #ifdef USE_HCACHE
+  mutt_hcache_commit(hc);
   mutt_hcache_close(hc);
 #endif
 
@@ -885,6 +887,7 @@ static enum MxStatus pop_mbox_sync(struct Mailbox *m)
 
 #ifdef USE_HCACHE
     hc = pop_hcache_open(adata, mailbox_path(m));
+    mutt_hcache_begin(hc);
 #endif
 
     struct Progress *progress = NULL;
@@ -923,6 +926,7 @@ static enum MxStatus pop_mbox_sync(struct Mailbox *m)
     progress_free(&progress);
 
 #ifdef USE_HCACHE
+    mutt_hcache_commit(hc);
     mutt_hcache_close(hc);
 #endif
 
@@ -1130,6 +1134,43 @@ cleanup:
   return success;
 }
 
+/**
+ * pop_msg_prefetch - Download an email into the cache - Implements MxOps::msg_prefetch()
+ */
+static long pop_msg_prefetch(struct Mailbox *m, struct Email *e)
+{
+  char buf[1024];
+  struct PopAccountData *adata = pop_adata_get(m);
+  struct PopEmailData *edata = pop_edata_get(e);
+
+  if (!adata || !edata)
+    return -1;
+
+  if (mutt_bcache_exists(adata->bcache, cache_id(edata->uid)) == 0)
+    return 0;
+
+  if ((pop_reconnect(m) < 0) || (edata->refno < 0))
+    return -1;
+
+  FILE *fp = mutt_bcache_put(adata->bcache, cache_id(edata->uid));
+  if (!fp)
+    return -1;
+
+  snprintf(buf, sizeof(buf), "RETR %d\r\n", edata->refno);
+  long bytes = -1;
+  if (pop_fetch_data(adata, buf, NULL, fetch_message, fp) == 0)
+    bytes = ftello(fp);
+  if (mutt_file_fclose(&fp) != 0)
+    bytes = -1;
+
+  if (bytes >= 0)
+    mutt_bcache_commit(adata->bcache, cache_id(edata->uid));
+  else
+    mutt_bcache_del(adata->bcache, cache_id(edata->uid));
+
+  return bytes;
+}
+
 /**
  * pop_msg_close - Close an email - Implements MxOps::msg_close()
  * @retval 0   Success
@@ -1218,6 +1259,7 @@ struct MxOps MxPopOps = {
   .msg_commit       = NULL,
   .msg_close        = pop_msg_close,
   .msg_padding_size = NULL,
+  .msg_prefetch     = pop_msg_prefetch,
   .msg_save_hcache  = pop_msg_save_hcache,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
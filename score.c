@@ -178,12 +178,15 @@ void mutt_score_message(struct Mailbox *m, struct Email *e, bool upd_mbox)
   if (e->score < 0)
     e->score = 0;
 
+  static struct ConfigHandle h_score_threshold_delete = { "score_threshold_delete" };
   const short c_score_threshold_delete =
-      cs_subset_number(NeoMutt->sub, "score_threshold_delete");
+      cs_handle_number(NeoMutt->sub, &h_score_threshold_delete);
+  static struct ConfigHandle h_score_threshold_flag = { "score_threshold_flag" };
   const short c_score_threshold_flag =
-      cs_subset_number(NeoMutt->sub, "score_threshold_flag");
+      cs_handle_number(NeoMutt->sub, &h_score_threshold_flag);
+  static struct ConfigHandle h_score_threshold_read = { "score_threshold_read" };
   const short c_score_threshold_read =
-      cs_subset_number(NeoMutt->sub, "score_threshold_read");
+      cs_handle_number(NeoMutt->sub, &h_score_threshold_read);
 
   if (e->score <= c_score_threshold_delete)
     mutt_set_flag_update(m, e, MUTT_DELETE, true, upd_mbox);
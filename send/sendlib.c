@@ -344,9 +344,9 @@ static size_t convert_file_to(FILE *fp, const char *fromcode, int ncodes,
 
   for (int i = 0; i < ncodes; i++)
     if (cd[i] != (iconv_t) (-1))
-      iconv_close(cd[i]);
+      mutt_ch_iconv_close(cd[i]);
 
-  iconv_close(cd1);
+  mutt_ch_iconv_close(cd1);
   FREE(&cd);
   FREE(&infos);
   FREE(&score);
@@ -72,6 +72,9 @@
 #define SMTP_AUTH_UNAVAIL 1
 #define SMTP_AUTH_FAIL -1
 
+#define SMTP_PIPELINE_MAX 100       ///< Maximum number of pipelined commands awaiting a response
+#define SMTP_CHUNK_SIZE (64 * 1024) ///< Size of a BDAT chunk
+
 // clang-format off
 /**
  * typedef SmtpCapFlags - SMTP server capabilities
@@ -83,8 +86,10 @@ typedef uint8_t SmtpCapFlags;          ///< Flags, e.g. #SMTP_CAP_STARTTLS
 #define SMTP_CAP_DSN          (1 << 2) ///< Server supports Delivery Status Notification
 #define SMTP_CAP_EIGHTBITMIME (1 << 3) ///< Server supports 8-bit MIME content
 #define SMTP_CAP_SMTPUTF8     (1 << 4) ///< Server accepts UTF-8 strings
+#define SMTP_CAP_PIPELINING   (1 << 5) ///< Server supports command pipelining (RFC2920)
+#define SMTP_CAP_CHUNKING     (1 << 6) ///< Server supports the BDAT command (RFC3030)
 
-#define SMTP_CAP_ALL         ((1 << 5) - 1)
+#define SMTP_CAP_ALL         ((1 << 7) - 1)
 // clang-format on
 
 /**
@@ -97,6 +102,8 @@ struct SmtpAccountData
   struct Connection *conn;   ///< Server Connection
   struct ConfigSubset *sub;  ///< Config scope
   const char *fqdn;          ///< Fully-qualified domain name
+  struct Buffer pipeline;    ///< Commands waiting to be sent (PIPELINING)
+  int pending;               ///< Number of commands in the pipeline
 };
 
 /**
@@ -174,6 +181,10 @@ static int smtp_get_resp(struct SmtpAccountData *adata)
       adata->capabilities |= SMTP_CAP_STARTTLS;
     else if (mutt_istr_startswith(s, "SMTPUTF8"))
       adata->capabilities |= SMTP_CAP_SMTPUTF8;
+    else if (mutt_istr_startswith(s, "PIPELINING"))
+      adata->capabilities |= SMTP_CAP_PIPELINING;
+    else if (mutt_istr_startswith(s, "CHUNKING"))
+      adata->capabilities |= SMTP_CAP_CHUNKING;
 
     if (!valid_smtp_code(buf, n, &n))
       return SMTP_ERR_CODE;
@@ -187,6 +198,64 @@ static int smtp_get_resp(struct SmtpAccountData *adata)
   return -1;
 }
 
+/**
+ * smtp_flush - Send the pipelined commands and check their responses
+ * @param adata SMTP Account data
+ * @retval  0 Success
+ * @retval <0 Error, e.g. #SMTP_ERR_WRITE
+ */
+static int smtp_flush(struct SmtpAccountData *adata)
+{
+  int pending = adata->pending;
+  adata->pending = 0;
+  if (pending == 0)
+    return 0;
+
+  int rc = mutt_socket_send(adata->conn, mutt_buffer_string(&adata->pipeline));
+  mutt_buffer_reset(&adata->pipeline);
+  if (rc == -1)
+    return SMTP_ERR_WRITE;
+
+  for (; pending > 0; pending--)
+  {
+    rc = smtp_get_resp(adata);
+    if (rc != 0)
+      return rc;
+  }
+
+  return 0;
+}
+
+/**
+ * smtp_send_cmd - Send a command to the SMTP server
+ * @param adata SMTP Account data
+ * @param cmd   Command, including the `\r\n`
+ * @retval  0 Success
+ * @retval <0 Error, e.g. #SMTP_ERR_WRITE
+ *
+ * If the server supports PIPELINING, the command is queued and its response
+ * will be checked by smtp_flush().  Otherwise, the command is sent and its
+ * response checked immediately.
+ */
+static int smtp_send_cmd(struct SmtpAccountData *adata, const char *cmd)
+{
+  if (!(adata->capabilities & SMTP_CAP_PIPELINING))
+  {
+    if (mutt_socket_send(adata->conn, cmd) == -1)
+      return SMTP_ERR_WRITE;
+    return smtp_get_resp(adata);
+  }
+
+  mutt_buffer_addstr(&adata->pipeline, cmd);
+  adata->pending++;
+
+  /* Don't let the server's responses back up too far */
+  if (adata->pending >= SMTP_PIPELINE_MAX)
+    return smtp_flush(adata);
+
+  return 0;
+}
+
 /**
  * smtp_rcpt_to - Set the recipient to an Address
  * @param adata SMTP Account data
@@ -214,9 +283,7 @@ static int smtp_rcpt_to(struct SmtpAccountData *adata, const struct AddressList
       snprintf(buf, sizeof(buf), "RCPT TO:<%s> NOTIFY=%s\r\n", a->mailbox, c_dsn_notify);
     else
       snprintf(buf, sizeof(buf), "RCPT TO:<%s>\r\n", a->mailbox);
-    if (mutt_socket_send(adata->conn, buf) == -1)
-      return SMTP_ERR_WRITE;
-    int rc = smtp_get_resp(adata);
+    int rc = smtp_send_cmd(adata, buf);
     if (rc != 0)
       return rc;
   }
@@ -224,6 +291,87 @@ static int smtp_rcpt_to(struct SmtpAccountData *adata, const struct AddressList
   return 0;
 }
 
+/**
+ * smtp_bdat - Send a message to an SMTP server in chunks
+ * @param adata    SMTP Account data
+ * @param fp       File containing the message
+ * @param progress Progress bar
+ * @retval  0 Success
+ * @retval <0 Error, e.g. #SMTP_ERR_WRITE
+ *
+ * RFC3030 chunks are sent verbatim, so unlike DATA, there's no dot-stuffing.
+ * The lines still need `\r\n` termination.
+ */
+static int smtp_bdat(struct SmtpAccountData *adata, FILE *fp, struct Progress *progress)
+{
+  char buf[8192];
+  char cmd[64];
+  char prev = '\0';
+  int pending = 0;
+  int rc = 0;
+  bool last = false;
+  struct Buffer chunk = mutt_buffer_make(SMTP_CHUNK_SIZE + (2 * sizeof(buf)));
+
+  while (!last)
+  {
+    const size_t len = fread(buf, 1, sizeof(buf), fp);
+    if (len == 0)
+    {
+      last = true;
+      /* terminate the last line */
+      if ((prev != '\0') && (prev != '\n'))
+        mutt_buffer_addstr(&chunk, "\r\n");
+    }
+
+    const char *end = buf + len;
+    for (const char *p = buf; p < end;)
+    {
+      const char *nl = memchr(p, '\n', end - p);
+      if (!nl)
+      {
+        mutt_buffer_addstr_n(&chunk, p, end - p);
+        prev = end[-1];
+        break;
+      }
+
+      mutt_buffer_addstr_n(&chunk, p, nl - p);
+      if (((nl > p) ? nl[-1] : prev) != '\r')
+        mutt_buffer_addch(&chunk, '\r');
+      mutt_buffer_addch(&chunk, '\n');
+      prev = '\n';
+      p = nl + 1;
+    }
+
+    if (!last && (mutt_buffer_len(&chunk) < SMTP_CHUNK_SIZE))
+      continue;
+
+    const size_t clen = mutt_buffer_len(&chunk);
+    snprintf(cmd, sizeof(cmd), "BDAT %zu%s\r\n", clen, last ? " LAST" : "");
+    if ((mutt_socket_send(adata->conn, cmd) == -1) ||
+        ((clen > 0) && (mutt_socket_write_d(adata->conn, chunk.data, clen,
+                                            MUTT_SOCK_LOG_FULL) == -1)))
+    {
+      rc = SMTP_ERR_WRITE;
+      break;
+    }
+    mutt_buffer_reset(&chunk);
+    pending++;
+    progress_update(progress, ftell(fp), -1);
+
+    /* With PIPELINING, we don't need to wait for each chunk to be accepted */
+    if (!(adata->capabilities & SMTP_CAP_PIPELINING) || last || (pending >= SMTP_PIPELINE_MAX))
+    {
+      for (; (pending > 0) && (rc == 0); pending--)
+        rc = smtp_get_resp(adata);
+      if (rc != 0)
+        break;
+    }
+  }
+
+  mutt_buffer_dealloc(&chunk);
+  return rc;
+}
+
 /**
  * smtp_data - Send data to an SMTP server
  * @param adata   SMTP Account data
@@ -250,6 +398,13 @@ static int smtp_data(struct SmtpAccountData *adata, const char *msgfile)
   unlink(msgfile);
   progress = progress_new(_("Sending message..."), MUTT_PROGRESS_NET, st.st_size);
 
+  if (adata->capabilities & SMTP_CAP_CHUNKING)
+  {
+    rc = smtp_bdat(adata, fp, progress);
+    mutt_file_fclose(&fp);
+    goto done;
+  }
+
   snprintf(buf, sizeof(buf), "DATA\r\n");
   if (mutt_socket_send(adata->conn, buf) == -1)
   {
@@ -942,12 +1097,7 @@ int mutt_smtp_send(const struct AddressList *from, const struct AddressList *to,
       snprintf(buf + len, sizeof(buf) - len, " SMTPUTF8");
     }
     mutt_strn_cat(buf, sizeof(buf), "\r\n", 3);
-    if (mutt_socket_send(adata.conn, buf) == -1)
-    {
-      rc = SMTP_ERR_WRITE;
-      break;
-    }
-    rc = smtp_get_resp(&adata);
+    rc = smtp_send_cmd(&adata, buf);
     if (rc != 0)
       break;
 
@@ -958,6 +1108,11 @@ int mutt_smtp_send(const struct AddressList *from, const struct AddressList *to,
       break;
     }
 
+    /* with PIPELINING, the sender and recipients are sent together */
+    rc = smtp_flush(&adata);
+    if (rc != 0)
+      break;
+
     /* send the message data */
     rc = smtp_data(&adata, msgfile);
     if (rc != 0)
@@ -970,6 +1125,7 @@ int mutt_smtp_send(const struct AddressList *from, const struct AddressList *to,
 
   mutt_socket_close(adata.conn);
   FREE(&adata.conn);
+  mutt_buffer_dealloc(&adata.pipeline);
 
   if (rc == SMTP_ERR_READ)
     mutt_error(_("SMTP session failed: read error"));
@@ -29,9 +29,12 @@
  */
 
 #include "config.h"
+#include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include "mutt/lib.h"
 #include "address/lib.h"
 #include "email/lib.h"
@@ -57,8 +60,10 @@ static sort_t AuxSort = NULL;
  */
 int sort_code(int rc)
 {
-  const short c_sort = cs_subset_sort(NeoMutt->sub, "sort");
-  const short c_sort_aux = cs_subset_sort(NeoMutt->sub, "sort_aux");
+  static struct ConfigHandle h_sort = { "sort" };
+  const short c_sort = cs_handle_sort(NeoMutt->sub, &h_sort);
+  static struct ConfigHandle h_sort_aux = { "sort_aux" };
+  const short c_sort_aux = cs_handle_sort(NeoMutt->sub, &h_sort_aux);
 
   return ((OptAuxSort ? c_sort_aux : c_sort) & SORT_REVERSE) ? -rc : rc;
 }
@@ -170,7 +175,8 @@ const char *mutt_get_name(const struct Address *a)
 
   if (a)
   {
-    const bool c_reverse_alias = cs_subset_bool(NeoMutt->sub, "reverse_alias");
+    static struct ConfigHandle h_reverse_alias = { "reverse_alias" };
+    const bool c_reverse_alias = cs_handle_bool(NeoMutt->sub, &h_reverse_alias);
     if (c_reverse_alias && (ali = alias_reverse_lookup(a)) && ali->personal)
       return ali->personal;
     if (a->personal)
@@ -368,6 +374,369 @@ sort_t mutt_get_sort_func(enum SortType method, enum MailboxType type)
   /* not reached */
 }
 
+/// Smallest number of Emails that's worth sorting in parallel
+#define SORT_PARALLEL_MIN 8192
+
+/**
+ * struct SortField - One part of the sort key of an Email
+ */
+struct SortField
+{
+  uint64_t prefix; ///< Start of the string, lower case, for quick comparisons
+  const char *str; ///< String, e.g. subject, or NULL
+  int64_t num;     ///< Number, e.g. date or size
+};
+
+/**
+ * struct SortKey - The sort key of an Email
+ *
+ * The key is extracted once per Email, so comparing two keys doesn't need to
+ * look up config or addresses.
+ */
+struct SortKey
+{
+  struct SortField primary; ///< Key for `$sort`
+  struct SortField aux;     ///< Key for `$sort_aux`
+  int index;                ///< Email's index, the final tie-break
+  struct Email *email;      ///< Email
+};
+
+/**
+ * struct SortKeyMethods - How sort keys are compared
+ */
+struct SortKeyMethods
+{
+  enum SortType primary; ///< Method of `$sort`
+  enum SortType aux;     ///< Method of `$sort_aux`
+  int primary_sign;      ///< -1 if `$sort` is reversed, otherwise 1
+  int aux_sign;          ///< -1 if `$sort_aux` is reversed, otherwise 1
+};
+
+/* Used by compare_keys(); it's read-only while the keys are being sorted */
+static struct SortKeyMethods KeyMethods;
+
+/**
+ * struct SortKeyJob - Sort keys being merged in parallel
+ */
+struct SortKeyJob
+{
+  struct SortKey *src; ///< Sorted runs
+  struct SortKey *dst; ///< Merged runs
+  size_t num;          ///< Number of keys
+  size_t width;        ///< Length of each sorted run
+};
+
+/**
+ * sort_key_supported - Can a sort method use sort keys?
+ * @param method Sort method, see #SortType
+ * @retval true The method can be sorted by key
+ */
+static bool sort_key_supported(enum SortType method)
+{
+  switch (method)
+  {
+    case SORT_DATE:
+    case SORT_FROM:
+    case SORT_ORDER:
+    case SORT_RECEIVED:
+    case SORT_SCORE:
+    case SORT_SIZE:
+    case SORT_SUBJECT:
+    case SORT_TO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * sort_key_prefix - Get the lower-case start of a string as a number
+ * @param str String
+ * @retval num Prefix, which compares like the string, ignoring case
+ */
+static uint64_t sort_key_prefix(const char *str)
+{
+  uint64_t prefix = 0;
+  for (int i = 0; i < 8; i++)
+  {
+    prefix <<= 8;
+    if (*str)
+      prefix |= (unsigned char) tolower((unsigned char) *str++);
+  }
+  return prefix;
+}
+
+/**
+ * sort_key_field - Extract one part of an Email's sort key
+ * @param[out] field  Sort field
+ * @param[in]  method Sort method, see #SortType
+ * @param[in]  e      Email
+ * @param[out] names  Storage for copies of names
+ * @param[out] len    Length of the names
+ * @param[out] size   Size of the names storage
+ *
+ * Names are copied, because mutt_get_name() may return a static buffer.
+ * The storage may move as it grows, so a name's field holds its offset until
+ * all the keys have been extracted.
+ */
+static void sort_key_field(struct SortField *field, enum SortType method,
+                           struct Email *e, char **names, size_t *len, size_t *size)
+{
+  switch (method)
+  {
+    case SORT_DATE:
+      field->num = e->date_sent;
+      break;
+    case SORT_RECEIVED:
+      field->num = e->received;
+      break;
+    case SORT_SCORE:
+      field->num = -e->score; /* note that this is reverse */
+      break;
+    case SORT_SIZE:
+      field->num = e->body ? e->body->length : 0;
+      break;
+    case SORT_SUBJECT:
+      /* emails without a subject are compared by date */
+      field->num = e->date_sent;
+      field->str = e->env->real_subj;
+      if (field->str)
+        field->prefix = sort_key_prefix(field->str);
+      break;
+    case SORT_FROM:
+    case SORT_TO:
+    {
+      const char *name = mutt_get_name(
+          TAILQ_FIRST((method == SORT_FROM) ? &e->env->from : &e->env->to));
+      size_t nlen = mutt_str_len(name);
+      if (nlen > 127)
+        nlen = 127;
+      if ((*len + nlen + 1) > *size)
+      {
+        *size = MAX(*size * 2, *len + nlen + 1);
+        mutt_mem_realloc(names, *size);
+      }
+      memcpy(*names + *len, name, nlen);
+      (*names)[*len + nlen] = '\0';
+      field->prefix = sort_key_prefix(name);
+      field->num = *len;
+      *len += nlen + 1;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+/**
+ * compare_field - Compare one part of two sort keys
+ * @param[in]  method Sort method, see #SortType
+ * @param[in]  a      First field
+ * @param[in]  b      Second field
+ * @param[out] sign   Set to false if the sort direction mustn't be applied
+ * @retval -1 a precedes b
+ * @retval  0 a and b are identical
+ * @retval  1 b precedes a
+ */
+static int compare_field(enum SortType method, const struct SortField *a,
+                         const struct SortField *b, bool *sign)
+{
+  switch (method)
+  {
+    case SORT_ORDER:
+      return 0;
+    case SORT_SUBJECT:
+      if (!a->str && !b->str)
+      {
+        /* like compare_subject(), which undoes the direction of its fallback */
+        *sign = false;
+        return (a->num > b->num) - (a->num < b->num);
+      }
+      if (!a->str)
+        return -1;
+      if (!b->str)
+        return 1;
+      /* fallthrough */
+    case SORT_FROM:
+    case SORT_TO:
+      if (a->prefix != b->prefix)
+        return (a->prefix < b->prefix) ? -1 : 1;
+      return strcasecmp(a->str, b->str);
+    default:
+      return (a->num > b->num) - (a->num < b->num);
+  }
+}
+
+/**
+ * compare_keys - Compare the sort keys of two emails - Implements ::sort_t
+ *
+ * This gives the same order as the Email comparison functions above, through
+ * perform_auxsort() and sort_code().
+ */
+static int compare_keys(const void *a, const void *b)
+{
+  const struct SortKey *ka = a;
+  const struct SortKey *kb = b;
+
+  if (KeyMethods.primary == SORT_ORDER)
+    return KeyMethods.primary_sign * (ka->index - kb->index);
+
+  bool sign = true;
+  int rc = compare_field(KeyMethods.primary, &ka->primary, &kb->primary, &sign);
+  if (rc == 0)
+  {
+    bool aux_sign = true;
+    rc = compare_field(KeyMethods.aux, &ka->aux, &kb->aux, &aux_sign);
+    if (rc == 0)
+      rc = ka->index - kb->index;
+    if (aux_sign)
+      rc *= KeyMethods.aux_sign;
+  }
+
+  return sign ? (KeyMethods.primary_sign * rc) : rc;
+}
+
+/**
+ * sort_keys_run - Sort a run of keys - Implements ::worker_t
+ */
+static void sort_keys_run(void *data, size_t start, size_t end)
+{
+  struct SortKeyJob *job = data;
+  qsort(job->src + start, end - start, sizeof(struct SortKey), compare_keys);
+}
+
+/**
+ * sort_keys_merge - Merge pairs of sorted runs - Implements ::worker_t
+ */
+static void sort_keys_merge(void *data, size_t start, size_t end)
+{
+  struct SortKeyJob *job = data;
+
+  for (size_t pair = start; pair < end; pair++)
+  {
+    size_t lo = pair * 2 * job->width;
+    size_t mid = MIN(lo + job->width, job->num);
+    size_t hi = MIN(lo + (2 * job->width), job->num);
+    size_t i = lo, j = mid, k = lo;
+
+    while ((i < mid) && (j < hi))
+    {
+      if (compare_keys(&job->src[j], &job->src[i]) < 0)
+        job->dst[k++] = job->src[j++];
+      else
+        job->dst[k++] = job->src[i++];
+    }
+    while (i < mid)
+      job->dst[k++] = job->src[i++];
+    while (j < hi)
+      job->dst[k++] = job->src[j++];
+  }
+}
+
+/**
+ * sort_keys - Sort an array of keys
+ * @param keys        Keys to sort
+ * @param num         Number of keys
+ * @param num_threads Number of threads to use
+ *
+ * Large arrays are split into one run per thread.  The runs are sorted, then
+ * merged in pairs, in parallel.
+ */
+static void sort_keys(struct SortKey *keys, size_t num, int num_threads)
+{
+  if ((num_threads < 2) || (num < SORT_PARALLEL_MIN) || !mutt_worker_available())
+  {
+    qsort(keys, num, sizeof(struct SortKey), compare_keys);
+    return;
+  }
+
+  struct SortKeyJob job = { 0 };
+  job.src = keys;
+  job.dst = mutt_mem_malloc(num * sizeof(struct SortKey));
+  job.num = num;
+  job.width = (num + num_threads - 1) / num_threads;
+
+  mutt_worker_run(num, job.width, num_threads, sort_keys_run, &job);
+
+  struct SortKey *tmp = job.dst;
+  for (; job.width < num; job.width *= 2)
+  {
+    size_t pairs = (num + (2 * job.width) - 1) / (2 * job.width);
+    mutt_worker_run(pairs, 1, num_threads, sort_keys_merge, &job);
+
+    struct SortKey *swap = job.src;
+    job.src = job.dst;
+    job.dst = swap;
+  }
+
+  if (job.src != keys)
+    memcpy(keys, job.src, num * sizeof(struct SortKey));
+  FREE(&tmp);
+}
+
+/**
+ * sort_by_key - Sort the emails of a Mailbox by their sort keys
+ * @param m        Mailbox
+ * @param sort     Sort method, `$sort`
+ * @param sort_aux Auxiliary sort method, `$sort_aux`
+ * @retval true  Emails have been sorted
+ * @retval false The sort methods can't use sort keys
+ */
+static bool sort_by_key(struct Mailbox *m, short sort, short sort_aux)
+{
+  const enum SortType primary = sort & SORT_MASK;
+  const enum SortType aux = sort_aux & SORT_MASK;
+  if (!sort_key_supported(primary) || !sort_key_supported(aux))
+    return false;
+#ifdef USE_NNTP
+  if ((m->type == MUTT_NNTP) && ((primary == SORT_ORDER) || (aux == SORT_ORDER)))
+    return false;
+#endif
+
+  struct SortKey *keys = mutt_mem_calloc(m->msg_count, sizeof(struct SortKey));
+  char *names = NULL;
+  size_t len = 0;
+  size_t size = 0;
+  size_t num = 0;
+
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e)
+      break;
+
+    struct SortKey *key = &keys[num++];
+    key->email = e;
+    key->index = e->index;
+    sort_key_field(&key->primary, primary, e, &names, &len, &size);
+    sort_key_field(&key->aux, aux, e, &names, &len, &size);
+  }
+
+  /* the names have stopped moving */
+  for (size_t i = 0; i < num; i++)
+  {
+    if ((primary == SORT_FROM) || (primary == SORT_TO))
+      keys[i].primary.str = names + keys[i].primary.num;
+    if ((aux == SORT_FROM) || (aux == SORT_TO))
+      keys[i].aux.str = names + keys[i].aux.num;
+  }
+
+  KeyMethods.primary = primary;
+  KeyMethods.aux = aux;
+  KeyMethods.primary_sign = (sort & SORT_REVERSE) ? -1 : 1;
+  KeyMethods.aux_sign = (sort_aux & SORT_REVERSE) ? -1 : 1;
+
+  const short c_sort_parallel = cs_subset_number(NeoMutt->sub, "sort_parallel");
+  sort_keys(keys, num, c_sort_parallel);
+
+  for (size_t i = 0; i < num; i++)
+    m->emails[i] = keys[i].email;
+
+  FREE(&names);
+  FREE(&keys);
+  return true;
+}
+
 /**
  * mutt_sort_headers - Sort emails by their headers
  * @param m       Mailbox
@@ -443,7 +812,7 @@ void mutt_sort_headers(struct Mailbox *m, struct ThreadsContext *threads,
     mutt_error(_("Could not find sorting function [report this bug]"));
     return;
   }
-  else
+  else if (!sort_by_key(m, c_sort, c_sort_aux))
   {
     qsort((void *) m->emails, m->msg_count, sizeof(struct Email *), sortfunc);
   }
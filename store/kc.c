@@ -33,6 +33,7 @@
 #include "config.h"
 #include <kclangc.h>
 #include <stdio.h>
+#include <string.h>
 #include "mutt/lib.h"
 #include "lib.h"
 
@@ -77,6 +78,50 @@ static void *store_kyotocabinet_fetch(void *store, const char *key, size_t klen,
   return kcdbget(db, key, klen, vlen);
 }
 
+/**
+ * store_kyotocabinet_fetch_many - Implements StoreOps::fetch_many()
+ */
+static int store_kyotocabinet_fetch_many(void *store, const char **keys, const size_t *klens,
+                                         size_t num, store_fetch_t cb, void *data)
+{
+  if (!store || !keys || !klens || !cb)
+    return -1;
+
+  KCDB *db = store;
+  KCCUR *cur = kcdbcursor(db);
+  if (!cur)
+    return -1;
+
+  /* A hash database only jumps to exact matches and a tree's comparator may
+   * not order the keys like memcmp(), so a failed jump doesn't mean that the
+   * remaining keys are missing */
+  int found = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    if (!kccurjumpkey(cur, keys[i], klens[i]))
+      continue; // Not found, or past the end of the store
+
+    size_t ksp = 0;
+    size_t vsp = 0;
+    const char *vbuf = NULL;
+    char *kbuf = kccurget(cur, &ksp, &vbuf, &vsp, 0);
+    if (!kbuf)
+      continue;
+
+    if ((ksp == klens[i]) && (memcmp(kbuf, keys[i], ksp) == 0))
+    {
+      cb(data, i, vbuf, vsp);
+      found++;
+    }
+
+    /* The key and value share one buffer */
+    kcfree(kbuf);
+  }
+
+  kccurdel(cur);
+  return found;
+}
+
 /**
  * store_kyotocabinet_free - Implements StoreOps::free()
  */
@@ -124,6 +169,43 @@ static int store_kyotocabinet_delete_record(void *store, const char *key, size_t
   return 0;
 }
 
+/**
+ * store_kyotocabinet_begin - Implements StoreOps::begin()
+ */
+static int store_kyotocabinet_begin(void *store)
+{
+  if (!store)
+    return -1;
+
+  KCDB *db = store;
+  /* A soft transaction is durable against a crash of NeoMutt, not of the OS */
+  if (!kcdbbegintran(db, 0))
+  {
+    int ecode = kcdbecode(db);
+    mutt_debug(LL_DEBUG2, "kcdbbegintran failed: %s (ecode %d)\n", kcdbemsg(db), ecode);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
+/**
+ * store_kyotocabinet_commit - Implements StoreOps::commit()
+ */
+static int store_kyotocabinet_commit(void *store)
+{
+  if (!store)
+    return -1;
+
+  KCDB *db = store;
+  if (!kcdbendtran(db, 1))
+  {
+    int ecode = kcdbecode(db);
+    mutt_debug(LL_DEBUG2, "kcdbendtran failed: %s (ecode %d)\n", kcdbemsg(db), ecode);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
 /**
  * store_kyotocabinet_close - Implements StoreOps::close()
  */
@@ -154,4 +236,4 @@ static const char *store_kyotocabinet_version(void)
   return version_cache;
 }
 
-STORE_BACKEND_OPS(kyotocabinet)
+STORE_BACKEND_OPS_BATCH(kyotocabinet)
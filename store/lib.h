@@ -55,6 +55,17 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+/**
+ * typedef store_fetch_t - Prototype for a callback from StoreOps::fetch_many()
+ * @param data  Private data passed to fetch_many()
+ * @param idx   Index of the Key in the list
+ * @param value Value associated with the Key
+ * @param vlen  Length of the Value
+ *
+ * @note The Value is only valid until the callback returns.
+ */
+typedef void (*store_fetch_t)(void *data, size_t idx, const void *value, size_t vlen);
+
 /**
  * struct StoreOps - Key Value Store API
  */
@@ -85,6 +96,25 @@ struct StoreOps
    */
   void *(*fetch)(void *store, const char *key, size_t klen, size_t *vlen);
 
+  /**
+   * fetch_many - Fetch the Values for a list of Keys
+   * @param[in] store Store retrieved via open()
+   * @param[in] keys  Keys identifying the records, sorted
+   * @param[in] klens Lengths of the Key strings
+   * @param[in] num   Number of Keys
+   * @param[in] cb    Function to call for each Key that's found
+   * @param[in] data  Private data passed to the callback
+   * @retval num Number of Keys found
+   * @retval -1  Error
+   *
+   * The backend may scan the Store in order, rather than looking up each Key
+   * separately.  Keys that aren't found are skipped.
+   *
+   * @note This function is optional.  If it's NULL, fetch() is used instead.
+   */
+  int (*fetch_many)(void *store, const char **keys, const size_t *klens,
+                    size_t num, store_fetch_t cb, void *data);
+
   /**
    * free - Free a Value returned by fetch()
    * @param[in]  store Store retrieved via open()
@@ -114,6 +144,31 @@ struct StoreOps
    */
   int (*delete_record)(void *store, const char *key, size_t klen);
 
+  /**
+   * begin - Start a batch of writes
+   * @param[in] store Store retrieved via open()
+   * @retval 0   Success
+   * @retval num Error, a backend-specific error code
+   *
+   * Until commit() is called, the backend may collect the calls to store()
+   * and delete_record(), then write them all at once.  fetch() must still
+   * see the pending changes.
+   *
+   * @note This function is optional.  Backends that don't support batches
+   *       leave it NULL and every write is committed immediately.
+   */
+  int (*begin)(void *store);
+
+  /**
+   * commit - Write a batch of changes to the Store
+   * @param[in] store Store retrieved via open()
+   * @retval 0   Success
+   * @retval num Error, a backend-specific error code
+   *
+   * @note This function is optional, but must be present if begin() is.
+   */
+  int (*commit)(void *store);
+
   /**
    * close - Close a Store connection
    * @param[in,out] ptr Store retrieved via open()
@@ -143,4 +198,19 @@ bool                   store_is_valid_backend(const char *str);
     .version        = store_##_name##_version,                                 \
   };
 
+#define STORE_BACKEND_OPS_BATCH(_name)                                         \
+  const struct StoreOps store_##_name##_ops = {                                \
+    .name           = #_name,                                                  \
+    .open           = store_##_name##_open,                                    \
+    .fetch          = store_##_name##_fetch,                                   \
+    .fetch_many     = store_##_name##_fetch_many,                              \
+    .free           = store_##_name##_free,                                    \
+    .store          = store_##_name##_store,                                   \
+    .delete_record  = store_##_name##_delete_record,                           \
+    .begin          = store_##_name##_begin,                                   \
+    .commit         = store_##_name##_commit,                                  \
+    .close          = store_##_name##_close,                                   \
+    .version        = store_##_name##_version,                                 \
+  };
+
 #endif /* MUTT_STORE_LIB_H */
@@ -213,6 +213,57 @@ static void *store_lmdb_fetch(void *store, const char *key, size_t klen, size_t
   return data.mv_data;
 }
 
+/**
+ * store_lmdb_fetch_many - Implements StoreOps::fetch_many()
+ */
+static int store_lmdb_fetch_many(void *store, const char **keys, const size_t *klens,
+                                 size_t num, store_fetch_t cb, void *data)
+{
+  if (!store || !keys || !klens || !cb)
+    return -1;
+
+  struct StoreLmdbCtx *ctx = store;
+
+  int rc = mdb_get_r_txn(ctx);
+  if (rc != MDB_SUCCESS)
+  {
+    ctx->txn = NULL;
+    mutt_debug(LL_DEBUG2, "txn_renew: %s\n", mdb_strerror(rc));
+    return -1;
+  }
+
+  MDB_cursor *cursor = NULL;
+  rc = mdb_cursor_open(ctx->txn, ctx->db, &cursor);
+  if (rc != MDB_SUCCESS)
+  {
+    mutt_debug(LL_DEBUG2, "mdb_cursor_open: %s\n", mdb_strerror(rc));
+    return -1;
+  }
+
+  /* The keys are sorted, so each lookup starts near the previous one */
+  int found = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    MDB_val dkey = { klens[i], (void *) keys[i] };
+    MDB_val value = { 0, NULL };
+
+    rc = mdb_cursor_get(cursor, &dkey, &value, MDB_SET_KEY);
+    if (rc == MDB_NOTFOUND)
+      continue;
+    if (rc != MDB_SUCCESS)
+    {
+      mutt_debug(LL_DEBUG2, "mdb_cursor_get: %s\n", mdb_strerror(rc));
+      break;
+    }
+
+    cb(data, i, value.mv_data, value.mv_size);
+    found++;
+  }
+
+  mdb_cursor_close(cursor);
+  return found;
+}
+
 /**
  * store_lmdb_free - Implements StoreOps::free()
  */
@@ -287,6 +338,46 @@ static int store_lmdb_delete_record(void *store, const char *key, size_t klen)
   return rc;
 }
 
+/**
+ * store_lmdb_begin - Implements StoreOps::begin()
+ */
+static int store_lmdb_begin(void *store)
+{
+  if (!store)
+    return -1;
+
+  struct StoreLmdbCtx *ctx = store;
+
+  int rc = mdb_get_w_txn(ctx);
+  if (rc != MDB_SUCCESS)
+    mutt_debug(LL_DEBUG2, "mdb_get_w_txn: %s\n", mdb_strerror(rc));
+
+  return rc;
+}
+
+/**
+ * store_lmdb_commit - Implements StoreOps::commit()
+ */
+static int store_lmdb_commit(void *store)
+{
+  if (!store)
+    return -1;
+
+  struct StoreLmdbCtx *ctx = store;
+
+  if (!ctx->txn || (ctx->txn_mode != TXN_WRITE))
+    return MDB_SUCCESS;
+
+  /* The transaction is freed, even if the commit fails */
+  int rc = mdb_txn_commit(ctx->txn);
+  if (rc != MDB_SUCCESS)
+    mutt_debug(LL_DEBUG2, "mdb_txn_commit: %s\n", mdb_strerror(rc));
+
+  ctx->txn_mode = TXN_UNINITIALIZED;
+  ctx->txn = NULL;
+  return rc;
+}
+
 /**
  * store_lmdb_close - Implements StoreOps::close()
  */
@@ -320,4 +411,4 @@ static const char *store_lmdb_version(void)
   return "lmdb " MDB_VERSION_STRING;
 }
 
-STORE_BACKEND_OPS(lmdb)
+STORE_BACKEND_OPS_BATCH(lmdb)
@@ -33,6 +33,9 @@
 #include "mutt/lib.h"
 #include "lib.h"
 
+/// Maximum number of Keys to look up in one call to rocksdb_multi_get()
+#define ROCKSDB_MULTI_GET_MAX 256
+
 /**
  * struct RocksDbCtx - Berkeley DB context
  */
@@ -42,6 +45,7 @@ struct RocksDbCtx
   rocksdb_options_t *options;
   rocksdb_readoptions_t *read_options;
   rocksdb_writeoptions_t *write_options;
+  rocksdb_writebatch_wi_t *batch; ///< Pending writes, between begin() and commit()
   char *err;
 };
 
@@ -57,6 +61,7 @@ static void *store_rocksdb_open(const char *path)
 
   /* RocksDB store errors in form of strings */
   ctx->err = NULL;
+  ctx->batch = NULL;
 
   /* setup generic options, create new db and limit log to one file */
   ctx->options = rocksdb_options_create();
@@ -96,7 +101,17 @@ static void *store_rocksdb_fetch(void *store, const char *key, size_t klen, size
 
   struct RocksDbCtx *ctx = store;
 
-  void *rv = rocksdb_get(ctx->db, ctx->read_options, key, klen, vlen, &ctx->err);
+  void *rv = NULL;
+  if (ctx->batch)
+  {
+    rv = rocksdb_writebatch_wi_get_from_batch_and_db(ctx->batch, ctx->db, ctx->read_options,
+                                                     key, klen, vlen, &ctx->err);
+  }
+  else
+  {
+    rv = rocksdb_get(ctx->db, ctx->read_options, key, klen, vlen, &ctx->err);
+  }
+
   if (ctx->err)
   {
     rocksdb_free(ctx->err);
@@ -107,6 +122,65 @@ static void *store_rocksdb_fetch(void *store, const char *key, size_t klen, size
   return rv;
 }
 
+/**
+ * store_rocksdb_fetch_many - Implements StoreOps::fetch_many()
+ */
+static int store_rocksdb_fetch_many(void *store, const char **keys, const size_t *klens,
+                                    size_t num, store_fetch_t cb, void *data)
+{
+  if (!store || !keys || !klens || !cb)
+    return -1;
+
+  struct RocksDbCtx *ctx = store;
+  int found = 0;
+
+  /* Pending writes aren't visible to MultiGet */
+  if (ctx->batch)
+  {
+    for (size_t i = 0; i < num; i++)
+    {
+      size_t vlen = 0;
+      void *value = store_rocksdb_fetch(ctx, keys[i], klens[i], &vlen);
+      if (!value)
+        continue;
+
+      cb(data, i, value, vlen);
+      FREE(&value);
+      found++;
+    }
+    return found;
+  }
+
+  char *values[ROCKSDB_MULTI_GET_MAX];
+  size_t vlens[ROCKSDB_MULTI_GET_MAX];
+  char *errs[ROCKSDB_MULTI_GET_MAX];
+
+  for (size_t start = 0; start < num; start += ROCKSDB_MULTI_GET_MAX)
+  {
+    size_t count = MIN(num - start, ROCKSDB_MULTI_GET_MAX);
+
+    rocksdb_multi_get(ctx->db, ctx->read_options, count, keys + start,
+                      klens + start, values, vlens, errs);
+
+    for (size_t i = 0; i < count; i++)
+    {
+      if (errs[i])
+      {
+        mutt_debug(LL_DEBUG2, "rocksdb_multi_get: %s\n", errs[i]);
+        rocksdb_free(errs[i]);
+      }
+      else if (values[i])
+      {
+        cb(data, start + i, values[i], vlens[i]);
+        found++;
+      }
+      FREE(&values[i]);
+    }
+  }
+
+  return found;
+}
+
 /**
  * store_rocksdb_free - Implements StoreOps::free()
  */
@@ -126,6 +200,12 @@ static int store_rocksdb_store(void *store, const char *key, size_t klen,
 
   struct RocksDbCtx *ctx = store;
 
+  if (ctx->batch)
+  {
+    rocksdb_writebatch_wi_put(ctx->batch, key, klen, value, vlen);
+    return 0;
+  }
+
   rocksdb_put(ctx->db, ctx->write_options, key, klen, value, vlen, &ctx->err);
   if (ctx->err)
   {
@@ -147,6 +227,12 @@ static int store_rocksdb_delete_record(void *store, const char *key, size_t klen
 
   struct RocksDbCtx *ctx = store;
 
+  if (ctx->batch)
+  {
+    rocksdb_writebatch_wi_delete(ctx->batch, key, klen);
+    return 0;
+  }
+
   rocksdb_delete(ctx->db, ctx->write_options, key, klen, &ctx->err);
   if (ctx->err)
   {
@@ -158,6 +244,50 @@ static int store_rocksdb_delete_record(void *store, const char *key, size_t klen
   return 0;
 }
 
+/**
+ * store_rocksdb_begin - Implements StoreOps::begin()
+ */
+static int store_rocksdb_begin(void *store)
+{
+  if (!store)
+    return -1;
+
+  struct RocksDbCtx *ctx = store;
+
+  if (!ctx->batch)
+    ctx->batch = rocksdb_writebatch_wi_create(0, 1);
+
+  return 0;
+}
+
+/**
+ * store_rocksdb_commit - Implements StoreOps::commit()
+ */
+static int store_rocksdb_commit(void *store)
+{
+  if (!store)
+    return -1;
+
+  struct RocksDbCtx *ctx = store;
+
+  if (!ctx->batch)
+    return 0;
+
+  rocksdb_write_writebatch_wi(ctx->db, ctx->write_options, ctx->batch, &ctx->err);
+  rocksdb_writebatch_wi_destroy(ctx->batch);
+  ctx->batch = NULL;
+
+  if (ctx->err)
+  {
+    mutt_debug(LL_DEBUG2, "rocksdb_write_writebatch_wi: %s\n", ctx->err);
+    rocksdb_free(ctx->err);
+    ctx->err = NULL;
+    return -1;
+  }
+
+  return 0;
+}
+
 /**
  * store_rocksdb_close - Implements StoreOps::close()
  */
@@ -168,6 +298,9 @@ static void store_rocksdb_close(void **ptr)
 
   struct RocksDbCtx *ctx = *ptr;
 
+  /* write any pending changes */
+  store_rocksdb_commit(ctx);
+
   /* close database and free resources */
   rocksdb_close(ctx->db);
   rocksdb_options_destroy(ctx->options);
@@ -188,4 +321,4 @@ static const char *store_rocksdb_version(void)
   return "RocksDB " RDBVER(ROCKSDB_MAJOR, ROCKSDB_MINOR, ROCKSDB_PATCH);
 }
 
-STORE_BACKEND_OPS(rocksdb)
+STORE_BACKEND_OPS_BATCH(rocksdb)
@@ -32,6 +32,7 @@
 
 #include "config.h"
 #include <stddef.h>
+#include <string.h>
 #include <tcbdb.h>
 #include <tcutil.h>
 #include "mutt/lib.h"
@@ -73,6 +74,46 @@ static void *store_tokyocabinet_fetch(void *store, const char *key, size_t klen,
   return rv;
 }
 
+/**
+ * store_tokyocabinet_fetch_many - Implements StoreOps::fetch_many()
+ */
+static int store_tokyocabinet_fetch_many(void *store, const char **keys, const size_t *klens,
+                                         size_t num, store_fetch_t cb, void *data)
+{
+  if (!store || !keys || !klens || !cb)
+    return -1;
+
+  TCBDB *db = store;
+  BDBCUR *cur = tcbdbcurnew(db);
+  if (!cur)
+    return -1;
+
+  /* The tree's comparator may not order the keys like memcmp(), so a failed
+   * jump doesn't mean that the remaining keys are missing */
+  int found = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    if (!tcbdbcurjump(cur, keys[i], klens[i]))
+      continue; // Not found, or past the end of the store
+
+    int ksp = 0;
+    const void *kbuf = tcbdbcurkey3(cur, &ksp);
+    if (!kbuf || ((size_t) ksp != klens[i]) || (memcmp(kbuf, keys[i], ksp) != 0))
+      continue;
+
+    int vsp = 0;
+    const void *vbuf = tcbdbcurval3(cur, &vsp);
+    if (!vbuf)
+      continue;
+
+    cb(data, i, vbuf, vsp);
+    found++;
+  }
+
+  tcbdbcurdel(cur);
+  return found;
+}
+
 /**
  * store_tokyocabinet_free - Implements StoreOps::free()
  */
@@ -116,6 +157,42 @@ static int store_tokyocabinet_delete_record(void *store, const char *key, size_t
   return 0;
 }
 
+/**
+ * store_tokyocabinet_begin - Implements StoreOps::begin()
+ */
+static int store_tokyocabinet_begin(void *store)
+{
+  if (!store)
+    return -1;
+
+  TCBDB *db = store;
+  if (!tcbdbtranbegin(db))
+  {
+    int ecode = tcbdbecode(db);
+    mutt_debug(LL_DEBUG2, "tcbdbtranbegin failed: %s (ecode %d)\n", tcbdberrmsg(ecode), ecode);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
+/**
+ * store_tokyocabinet_commit - Implements StoreOps::commit()
+ */
+static int store_tokyocabinet_commit(void *store)
+{
+  if (!store)
+    return -1;
+
+  TCBDB *db = store;
+  if (!tcbdbtrancommit(db))
+  {
+    int ecode = tcbdbecode(db);
+    mutt_debug(LL_DEBUG2, "tcbdbtrancommit failed: %s (ecode %d)\n", tcbdberrmsg(ecode), ecode);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
 /**
  * store_tokyocabinet_close - Implements StoreOps::close()
  */
@@ -142,4 +219,4 @@ static const char *store_tokyocabinet_version(void)
   return "tokyocabinet " _TC_VERSION;
 }
 
-STORE_BACKEND_OPS(tokyocabinet)
+STORE_BACKEND_OPS_BATCH(tokyocabinet)
@@ -0,0 +1,173 @@
+/**
+ * @file
+ * Test code for bcache_index_add()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "bcache/private.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "message_cache_size", DT_LONG, 0, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * create_file - Create a file in the cache
+ * @param dir Cache directory
+ * @param key Path, relative to the cache directory
+ */
+static void create_file(const char *dir, const char *key)
+{
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s/%s", dir, key);
+  char *slash = strrchr(path, '/');
+  *slash = '\0';
+  mutt_file_mkdir(path, S_IRWXU);
+  *slash = '/';
+
+  FILE *fp = fopen(path, "w");
+  if (TEST_CHECK(fp != NULL))
+  {
+    fputs("hello\n", fp);
+    fclose(fp);
+  }
+}
+
+/**
+ * file_exists - Does a file exist in the cache?
+ * @param dir Cache directory
+ * @param key Path, relative to the cache directory
+ * @retval true The file exists
+ */
+static bool file_exists(const char *dir, const char *key)
+{
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s/%s", dir, key);
+  return access(path, F_OK) == 0;
+}
+
+void test_bcache_index_add(void)
+{
+  // void bcache_index_add(struct BcacheIndex *idx, const char *key, long size);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+
+  char dir[] = "/tmp/neomutt-test-bcache-XXXXXX";
+  if (!TEST_CHECK(mkdtemp(dir) != NULL))
+    return;
+
+  static const char *keys[] = { "pop:a/.01/A", "pop:a/.02/B", "pop:a/.03/C",
+                                "pop:a/.04/D", "pop:a/.05/E" };
+  for (size_t i = 0; i < mutt_array_size(keys); i++)
+    create_file(dir, keys[i]);
+
+  {
+    TEST_CASE("Degenerate");
+    bcache_index_add(NULL, keys[0], 100);
+    TEST_CHECK_(1, "bcache_index_add(NULL, keys[0], 100)");
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    bcache_index_add(idx, NULL, 100);
+    TEST_CHECK_(1, "bcache_index_add(idx, NULL, 100)");
+    bcache_index_add(idx, "no-shard", 100);
+    TEST_CHECK(!bcache_index_find(idx, "no-shard"));
+    bcache_index_close(&idx);
+  }
+
+  {
+    TEST_CASE("Unlimited");
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    for (size_t i = 0; i < 3; i++)
+      bcache_index_add(idx, keys[i], 100);
+    for (size_t i = 0; i < 3; i++)
+      TEST_CHECK(bcache_index_find(idx, keys[i]));
+
+    /* A is now the most recently used */
+    TEST_CHECK(bcache_index_touch(idx, keys[0]));
+    TEST_CHECK(!bcache_index_touch(idx, keys[3]));
+    bcache_index_close(&idx);
+  }
+
+  {
+    TEST_CASE("Evict least recently used");
+    /* The order, B C A, comes from the journal */
+    cs_subset_str_native_set(NeoMutt->sub, "message_cache_size", 250, NULL);
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    bcache_index_add(idx, keys[3], 100);
+
+    TEST_CHECK(!bcache_index_find(idx, keys[1]));
+    TEST_CHECK(!bcache_index_find(idx, keys[2]));
+    TEST_CHECK(bcache_index_find(idx, keys[0]));
+    TEST_CHECK(bcache_index_find(idx, keys[3]));
+    TEST_CHECK(!file_exists(dir, keys[1]));
+    TEST_CHECK(!file_exists(dir, keys[2]));
+    TEST_CHECK(file_exists(dir, keys[0]));
+    TEST_CHECK(file_exists(dir, keys[3]));
+    bcache_index_close(&idx);
+
+    /* The evictions were recorded */
+    idx = bcache_index_open(dir);
+    TEST_CHECK(!bcache_index_find(idx, keys[1]));
+    TEST_CHECK(!bcache_index_find(idx, keys[2]));
+    bcache_index_close(&idx);
+  }
+
+  {
+    TEST_CASE("Replace");
+    /* A file that's replaced isn't counted twice */
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    bcache_index_add(idx, keys[0], 100);
+    bcache_index_add(idx, keys[0], 100);
+    TEST_CHECK(bcache_index_find(idx, keys[0]));
+    TEST_CHECK(bcache_index_find(idx, keys[3]));
+    bcache_index_close(&idx);
+  }
+
+  {
+    TEST_CASE("Never evict the new file");
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    bcache_index_add(idx, keys[4], 1000);
+
+    TEST_CHECK(!bcache_index_find(idx, keys[0]));
+    TEST_CHECK(!bcache_index_find(idx, keys[3]));
+    TEST_CHECK(bcache_index_find(idx, keys[4]));
+    TEST_CHECK(!file_exists(dir, keys[0]));
+    TEST_CHECK(!file_exists(dir, keys[3]));
+    TEST_CHECK(file_exists(dir, keys[4]));
+    bcache_index_close(&idx);
+  }
+
+  mutt_file_rmtree(dir);
+  test_neomutt_destroy(&NeoMutt);
+}
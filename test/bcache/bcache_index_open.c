@@ -0,0 +1,218 @@
+/**
+ * @file
+ * Test code for bcache_index_open()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "mutt/lib.h"
+#include "bcache/private.h"
+#include "test_common.h"
+
+#define MAGIC "neomutt bcache index 1\n"
+
+/**
+ * write_journal - Create a journal file
+ * @param dir   Cache directory
+ * @param text  Contents of the journal
+ * @param extra Number of extra 'a' records to append, for `key`
+ * @param key   Key of the extra records
+ */
+static void write_journal(const char *dir, const char *text, int extra, const char *key)
+{
+  char file[PATH_MAX];
+  snprintf(file, sizeof(file), "%s/.bcache-index", dir);
+  FILE *fp = fopen(file, "w");
+  if (!TEST_CHECK(fp != NULL))
+    return;
+
+  fputs(text, fp);
+  for (int i = 0; i < extra; i++)
+    fprintf(fp, "a %d %s\n", 1000 + i, key);
+  fclose(fp);
+}
+
+/**
+ * journal_lines - Count the records in a journal file
+ * @param dir Cache directory
+ * @retval num Number of lines, including the header
+ */
+static int journal_lines(const char *dir)
+{
+  char file[PATH_MAX];
+  snprintf(file, sizeof(file), "%s/.bcache-index", dir);
+  FILE *fp = fopen(file, "r");
+  if (!fp)
+    return -1;
+
+  int lines = 0;
+  int ch;
+  while ((ch = fgetc(fp)) != EOF)
+  {
+    if (ch == '\n')
+      lines++;
+  }
+  fclose(fp);
+  return lines;
+}
+
+/**
+ * count_id - Count the files in a directory - Implements ::bcache_list_t
+ */
+static int count_id(const char *id, struct BodyCache *bcache, void *data)
+{
+  (*(int *) data)++;
+  return 0;
+}
+
+void test_bcache_index_open(void)
+{
+  // struct BcacheIndex *bcache_index_open(const char *cachedir);
+
+  char dir[] = "/tmp/neomutt-test-bcache-XXXXXX";
+  if (!TEST_CHECK(mkdtemp(dir) != NULL))
+    return;
+
+  {
+    TEST_CASE("Replay");
+    write_journal(dir, MAGIC
+                  "+ 10 100 imap:a/INBOX/.01/1\n"
+                  "+ 20 200 imap:a/INBOX/.02/2\n"
+                  "+ 30 300 imap:a/INBOX/.03/3\n"
+                  "a 400 imap:a/INBOX/.01/1\n"
+                  "a 500 imap:a/INBOX/.09/9\n"
+                  "- imap:a/INBOX/.02/2\n"
+                  "- imap:a/INBOX/.08/8\n"
+                  "d imap:a/INBOX/\n"
+                  "garbage\n"
+                  "+ ten 100 imap:a/INBOX/.04/4\n"
+                  "+ 10 100 no-shard/5\n"
+                  "a imap:a/INBOX/.03/3\n"
+                  "\n"
+                  "+ 40 600 imap:a/Sent/.06/6\n",
+                  0, NULL);
+
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    TEST_CHECK(idx != NULL);
+    TEST_CHECK(bcache_index_find(idx, "imap:a/INBOX/.01/1"));
+    TEST_CHECK(!bcache_index_find(idx, "imap:a/INBOX/.02/2"));
+    TEST_CHECK(bcache_index_find(idx, "imap:a/INBOX/.03/3"));
+    TEST_CHECK(!bcache_index_find(idx, "imap:a/INBOX/.04/4"));
+    TEST_CHECK(!bcache_index_find(idx, "no-shard/5"));
+    TEST_CHECK(bcache_index_find(idx, "imap:a/Sent/.06/6"));
+    TEST_CHECK(!bcache_index_find(idx, "imap:a/INBOX/.09/9"));
+
+    TEST_CHECK(bcache_index_dir_complete(idx, "imap:a/INBOX/"));
+    TEST_CHECK(!bcache_index_dir_complete(idx, "imap:a/Sent/"));
+
+    int count = 0;
+    TEST_CHECK(bcache_index_list(idx, "imap:a/INBOX/", count_id, NULL, &count) == 2);
+    TEST_CHECK(count == 2);
+
+    /* A small journal is appended to, not rewritten */
+    TEST_CHECK(journal_lines(dir) == 15);
+    bcache_index_del(idx, "imap:a/INBOX/.03/3");
+    TEST_CHECK(journal_lines(dir) == 16);
+
+    bcache_index_close(&idx);
+    TEST_CHECK(idx == NULL);
+
+    idx = bcache_index_open(dir);
+    TEST_CHECK(!bcache_index_find(idx, "imap:a/INBOX/.03/3"));
+    TEST_CHECK(bcache_index_find(idx, "imap:a/INBOX/.01/1"));
+    bcache_index_close(&idx);
+  }
+
+  {
+    TEST_CASE("Shared");
+    struct BcacheIndex *idx1 = bcache_index_open(dir);
+    struct BcacheIndex *idx2 = bcache_index_open(dir);
+    TEST_CHECK((idx1 != NULL) && (idx1 == idx2));
+    TEST_CHECK(bcache_index_open("/some/other/dir") == NULL);
+    bcache_index_close(&idx1);
+    TEST_CHECK(bcache_index_find(idx2, "imap:a/INBOX/.01/1"));
+    bcache_index_close(&idx2);
+  }
+
+  {
+    TEST_CASE("Wrong magic");
+    write_journal(dir, "neomutt bcache index 0\n"
+                       "+ 10 100 imap:a/INBOX/.01/1\n"
+                       "d imap:a/INBOX/\n",
+                  0, NULL);
+
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    TEST_CHECK(!bcache_index_find(idx, "imap:a/INBOX/.01/1"));
+    TEST_CHECK(!bcache_index_dir_complete(idx, "imap:a/INBOX/"));
+    bcache_index_close(&idx);
+
+    /* The journal has been replaced by an empty one */
+    TEST_CHECK(journal_lines(dir) == 1);
+  }
+
+  {
+    TEST_CASE("No compaction");
+    /* 2 files, so rewrite after 2*2+1024 records */
+    write_journal(dir, MAGIC "+ 10 100 imap:a/INBOX/.01/1\n"
+                             "+ 20 200 imap:a/INBOX/.02/2\n"
+                             "d imap:a/INBOX/\n",
+                  1025, "imap:a/INBOX/.01/1");
+
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    TEST_CHECK(bcache_index_dir_complete(idx, "imap:a/INBOX/"));
+    bcache_index_close(&idx);
+    TEST_CHECK(journal_lines(dir) == 1029);
+  }
+
+  {
+    TEST_CASE("Compaction");
+    write_journal(dir, MAGIC "+ 10 100 imap:a/INBOX/.01/1\n"
+                             "+ 20 200 imap:a/INBOX/.02/2\n"
+                             "d imap:a/INBOX/\n",
+                  1026, "imap:a/INBOX/.01/1");
+
+    struct BcacheIndex *idx = bcache_index_open(dir);
+    TEST_CHECK(bcache_index_find(idx, "imap:a/INBOX/.01/1"));
+    TEST_CHECK(bcache_index_find(idx, "imap:a/INBOX/.02/2"));
+    TEST_CHECK(journal_lines(dir) == 3);
+    TEST_MSG("Lines: %d", journal_lines(dir));
+
+    /* Another process may have added files, so the directory must be rescanned */
+    TEST_CHECK(!bcache_index_dir_complete(idx, "imap:a/INBOX/"));
+    bcache_index_dir_set_complete(idx, "imap:a/INBOX/");
+    TEST_CHECK(bcache_index_dir_complete(idx, "imap:a/INBOX/"));
+    bcache_index_close(&idx);
+
+    /* The rewritten journal is in LRU order, ready to be replayed */
+    idx = bcache_index_open(dir);
+    TEST_CHECK(bcache_index_find(idx, "imap:a/INBOX/.01/1"));
+    TEST_CHECK(bcache_index_find(idx, "imap:a/INBOX/.02/2"));
+    TEST_CHECK(bcache_index_dir_complete(idx, "imap:a/INBOX/"));
+    bcache_index_close(&idx);
+    TEST_CHECK(journal_lines(dir) == 4);
+  }
+
+  mutt_file_rmtree(dir);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file
+ * Functions needed by the Body Cache tests
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* libbcache is linked on its own.  These stand in for the parts of
+ * mutt_account.c and muttlib.c that it uses. */
+
+#include "config.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "conn/lib.h"
+#include "mutt_account.h"
+#include "muttlib.h"
+
+void mutt_account_tourl(struct ConnAccount *cac, struct Url *url)
+{
+  url->scheme = U_POP;
+  url->host = cac->host;
+  url->user = cac->user;
+  url->pass = NULL;
+  url->port = 0;
+  url->path = NULL;
+}
+
+void mutt_encode_path(struct Buffer *buf, const char *src)
+{
+  mutt_buffer_strcpy(buf, NONULL(src));
+}
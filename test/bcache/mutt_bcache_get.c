@@ -0,0 +1,156 @@
+/**
+ * @file
+ * Test code for mutt_bcache_get()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "bcache/lib.h"
+#include "conn/lib.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "message_cache_size", DT_LONG, 0,    0, NULL, },
+  { "message_cachedir",   DT_PATH, 0,    0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * create_file - Create a file
+ * @param path Path to the file
+ */
+static void create_file(const char *path)
+{
+  FILE *fp = fopen(path, "w");
+  if (TEST_CHECK(fp != NULL))
+  {
+    fputs("hello\n", fp);
+    fclose(fp);
+  }
+}
+
+/**
+ * count_id - Count the files in the cache - Implements ::bcache_list_t
+ */
+static int count_id(const char *id, struct BodyCache *bcache, void *data)
+{
+  (*(int *) data)++;
+  return 0;
+}
+
+void test_mutt_bcache_get(void)
+{
+  // FILE *mutt_bcache_get(struct BodyCache *bcache, const char *id);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+
+  char dir[] = "/tmp/neomutt-test-bcache-XXXXXX";
+  if (!TEST_CHECK(mkdtemp(dir) != NULL))
+    return;
+  cs_subset_str_string_set(NeoMutt->sub, "message_cachedir", dir, NULL);
+
+  struct ConnAccount cac = { 0 };
+  mutt_str_copy(cac.host, "example.com", sizeof(cac.host));
+  mutt_str_copy(cac.user, "user", sizeof(cac.user));
+
+  {
+    TEST_CASE("Degenerate");
+    struct BodyCache *bcache = mutt_bcache_open(&cac, NULL);
+    TEST_CHECK(mutt_bcache_get(NULL, "1") == NULL);
+    TEST_CHECK(mutt_bcache_get(bcache, NULL) == NULL);
+    TEST_CHECK(mutt_bcache_get(bcache, "") == NULL);
+    TEST_CHECK(mutt_bcache_get(bcache, "missing") == NULL);
+    mutt_bcache_close(&bcache);
+  }
+
+  /* Files from older versions aren't sharded */
+  struct Buffer *mbox_dir = mutt_buffer_pool_get();
+  struct Buffer *legacy1 = mutt_buffer_pool_get();
+  struct Buffer *legacy2 = mutt_buffer_pool_get();
+  mutt_buffer_printf(mbox_dir, "%s/pop:user@example.com", dir);
+  mutt_buffer_printf(legacy1, "%s/L1", mutt_buffer_string(mbox_dir));
+  mutt_buffer_printf(legacy2, "%s/L2", mutt_buffer_string(mbox_dir));
+  TEST_CHECK(mutt_file_mkdir(mutt_buffer_string(mbox_dir), S_IRWXU) == 0);
+  create_file(mutt_buffer_string(legacy1));
+  create_file(mutt_buffer_string(legacy2));
+
+  {
+    TEST_CASE("Legacy files");
+    struct BodyCache *bcache = mutt_bcache_open(&cac, NULL);
+    TEST_CHECK(mutt_bcache_exists(bcache, "L1") == 0);
+    TEST_CHECK(mutt_bcache_exists(bcache, "L2") == 0);
+    TEST_CHECK(mutt_bcache_exists(bcache, "L3") == -1);
+
+    int count = 0;
+    TEST_CHECK(mutt_bcache_list(bcache, count_id, &count) == 2);
+    TEST_CHECK(count == 2);
+
+    /* Reading a file moves it into its shard */
+    FILE *fp = mutt_bcache_get(bcache, "L1");
+    TEST_CHECK(fp != NULL);
+    mutt_file_fclose(&fp);
+    TEST_CHECK(access(mutt_buffer_string(legacy1), F_OK) != 0);
+    TEST_CHECK(mutt_bcache_exists(bcache, "L1") == 0);
+
+    fp = mutt_bcache_get(bcache, "L1");
+    TEST_CHECK(fp != NULL);
+    mutt_file_fclose(&fp);
+
+    /* Each file is listed once, wherever it is */
+    count = 0;
+    TEST_CHECK(mutt_bcache_list(bcache, count_id, &count) == 2);
+    TEST_CHECK(count == 2);
+    mutt_bcache_close(&bcache);
+  }
+
+  {
+    TEST_CASE("Delete legacy files");
+    struct BodyCache *bcache = mutt_bcache_open(&cac, NULL);
+    TEST_CHECK(mutt_bcache_del(bcache, "L2") == 0);
+    TEST_CHECK(access(mutt_buffer_string(legacy2), F_OK) != 0);
+    TEST_CHECK(mutt_bcache_exists(bcache, "L2") == -1);
+
+    TEST_CHECK(mutt_bcache_del(bcache, "L1") == 0);
+    TEST_CHECK(mutt_bcache_exists(bcache, "L1") == -1);
+    TEST_CHECK(mutt_bcache_del(bcache, "L1") == -1);
+
+    int count = 0;
+    TEST_CHECK(mutt_bcache_list(bcache, count_id, &count) == 0);
+    mutt_bcache_close(&bcache);
+  }
+
+  mutt_buffer_pool_release(&mbox_dir);
+  mutt_buffer_pool_release(&legacy1);
+  mutt_buffer_pool_release(&legacy2);
+  mutt_file_rmtree(dir);
+  test_neomutt_destroy(&NeoMutt);
+}
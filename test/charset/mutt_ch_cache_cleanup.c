@@ -0,0 +1,55 @@
+/**
+ * @file
+ * Test code for mutt_ch_cache_cleanup()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <iconv.h>
+#include "mutt/lib.h"
+
+void test_mutt_ch_cache_cleanup(void)
+{
+  // void mutt_ch_cache_cleanup(void);
+
+  {
+    mutt_ch_cache_cleanup();
+    TEST_CHECK_(1, "mutt_ch_cache_cleanup()");
+  }
+
+  {
+    iconv_t cd1 = mutt_ch_iconv_open("utf-8", "iso-8859-2", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(cd1 != (iconv_t) -1);
+    iconv_t cd2 = mutt_ch_iconv_open("utf-8", "iso-8859-3", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(cd2 != (iconv_t) -1);
+    mutt_ch_iconv_close(cd1);
+
+    // A descriptor still in use is closed by its owner
+    mutt_ch_cache_cleanup();
+    mutt_ch_iconv_close(cd2);
+
+    char *s = mutt_str_dup("\xb1");
+    TEST_CHECK(mutt_ch_convert_string(&s, "iso-8859-2", "utf-8", MUTT_ICONV_NO_FLAGS) == 0);
+    TEST_CHECK(mutt_str_equal(s, "\xc4\x85"));
+    FREE(&s);
+    mutt_ch_cache_cleanup();
+  }
+}
@@ -49,4 +49,56 @@ void test_mutt_ch_convert_string(void)
     TEST_CHECK(mutt_ch_convert_string(&ps, "apple", NULL, MUTT_ICONV_NO_FLAGS) != 0);
     free(ps);
   }
+
+  {
+    // Pure ASCII is left alone
+    char *ps = strdup("apple");
+    char *orig = ps;
+    TEST_CHECK(mutt_ch_convert_string(&ps, "iso-8859-1", "utf-8", MUTT_ICONV_NO_FLAGS) == 0);
+    TEST_CHECK(ps == orig);
+    TEST_CHECK(mutt_str_equal(ps, "apple"));
+    free(ps);
+  }
+
+  {
+    // Valid UTF-8 is left alone
+    char *ps = strdup("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x8d\x8c");
+    char *orig = ps;
+    TEST_CHECK(mutt_ch_convert_string(&ps, "utf-8", "UTF8", MUTT_ICONV_NO_FLAGS) == 0);
+    TEST_CHECK(ps == orig);
+    free(ps);
+  }
+
+  {
+    // Invalid UTF-8 is still repaired
+    static const char *invalid[] = {
+      "caf\xc3",     // truncated
+      "\xc0\xaf",     // overlong
+      "\xed\xa0\x80", // surrogate
+    };
+    for (size_t i = 0; i < mutt_array_size(invalid); i++)
+    {
+      char *ps = strdup(invalid[i]);
+      mutt_ch_convert_string(&ps, "utf-8", "utf-8", MUTT_ICONV_NO_FLAGS);
+      TEST_CHECK(!mutt_str_equal(ps, invalid[i]));
+      TEST_MSG("Case %zu", i);
+      free(ps);
+    }
+  }
+
+  {
+    // Non-ASCII is converted
+    char *ps = strdup("apple caf\xe9");
+    TEST_CHECK(mutt_ch_convert_string(&ps, "iso-8859-1", "utf-8", MUTT_ICONV_NO_FLAGS) == 0);
+    TEST_CHECK(mutt_str_equal(ps, "apple caf\xc3\xa9"));
+    free(ps);
+  }
+
+  {
+    // ASCII isn't compatible with UTF-16
+    char *ps = strdup("apple");
+    TEST_CHECK(mutt_ch_convert_string(&ps, "us-ascii", "utf-16", MUTT_ICONV_NO_FLAGS) == 0);
+    TEST_CHECK(!mutt_str_equal(ps, "apple"));
+    free(ps);
+  }
 }
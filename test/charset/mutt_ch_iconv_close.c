@@ -0,0 +1,78 @@
+/**
+ * @file
+ * Test code for mutt_ch_iconv_close()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <iconv.h>
+#include "mutt/lib.h"
+
+void test_mutt_ch_iconv_close(void)
+{
+  // void mutt_ch_iconv_close(iconv_t cd);
+
+  {
+    mutt_ch_iconv_close((iconv_t) -1);
+    TEST_CHECK_(1, "mutt_ch_iconv_close((iconv_t) -1)");
+  }
+
+  {
+    // A closed descriptor is reused
+    iconv_t cd1 = mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(cd1 != (iconv_t) -1);
+    mutt_ch_iconv_close(cd1);
+    iconv_t cd2 = mutt_ch_iconv_open("UTF8", "ISO8859-1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(cd2 == cd1);
+
+    // A descriptor in use isn't shared
+    iconv_t cd3 = mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(cd3 != (iconv_t) -1);
+    TEST_CHECK(cd3 != cd2);
+
+    // A reused descriptor still converts
+    char in[] = "caf\xe9";
+    char out[16] = { 0 };
+    const char *ib = in;
+    size_t ibl = strlen(in);
+    char *ob = out;
+    size_t obl = sizeof(out) - 1;
+    TEST_CHECK(mutt_ch_iconv(cd2, &ib, &ibl, &ob, &obl, NULL, NULL, NULL) == 0);
+    TEST_CHECK(mutt_str_equal(out, "caf\xc3\xa9"));
+
+    mutt_ch_iconv_close(cd3);
+    mutt_ch_iconv_close(cd2);
+  }
+
+  {
+    // More descriptors than the cache holds
+    iconv_t cds[20];
+    for (size_t i = 0; i < mutt_array_size(cds); i++)
+    {
+      cds[i] = mutt_ch_iconv_open("utf-8", "us-ascii", MUTT_ICONV_NO_FLAGS);
+      TEST_CHECK(cds[i] != (iconv_t) -1);
+    }
+    for (size_t i = 0; i < mutt_array_size(cds); i++)
+      mutt_ch_iconv_close(cds[i]);
+  }
+
+  mutt_ch_cache_cleanup();
+}
@@ -24,11 +24,14 @@
 #include "config.h"
 #include "acutest.h"
 #include <locale.h>
+#include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include "mutt/lib.h"
+#include "address/lib.h"
 #include "config/lib.h"
+#include "email/lib.h"
 #include "core/lib.h"
 
 #define TEST_DIR "NEOMUTT_TEST_DIR"
@@ -128,6 +131,68 @@ void test_neomutt_destroy(struct NeoMutt **ptr)
   cs_free(&cs);
 }
 
+/* Few values, so that many Emails compare the same */
+static const char *TestSubjects[] = { "apple", "Apple", "Apple pie", "banana", "cherry pie", "cherry" };
+static const char *TestNames[] = { "alice", "Alice", "bob", "Bob Smith", "carol" };
+
+/**
+ * add_random_address - Maybe add a random address to a list
+ * @param al   Address list
+ * @param seed Random number seed
+ *
+ * One time in six, the list is left empty.
+ */
+static void add_random_address(struct AddressList *al, unsigned int *seed)
+{
+  const size_t num = rand_r(seed) % (mutt_array_size(TestNames) + 1);
+  if (num == mutt_array_size(TestNames))
+    return;
+
+  char mailbox[64];
+  snprintf(mailbox, sizeof(mailbox), "user%d@example.com", rand_r(seed) % 5);
+  mutt_addrlist_append(al, mutt_addr_create(TestNames[num], mailbox));
+}
+
+/**
+ * test_email_random - Create an Email with random headers and flags
+ * @param index Position of the Email in the Mailbox
+ * @param seed  Random number seed
+ * @retval ptr New Email
+ *
+ * The Subject, From and To are sometimes missing, on purpose.
+ */
+struct Email *test_email_random(int index, unsigned int *seed)
+{
+  struct Email *e = email_new();
+  e->env = mutt_env_new();
+  e->body = mutt_body_new();
+
+  e->index = index;
+  e->msgno = index;
+  e->vnum = index;
+  e->date_sent = 1600000000 + ((rand_r(seed) % 50) * 86400);
+  e->received = 1600000000 + ((rand_r(seed) % 50) * 86400);
+  e->score = (rand_r(seed) % 11) - 5;
+  e->body->length = rand_r(seed) % 50;
+  e->read = rand_r(seed) % 2;
+  e->old = rand_r(seed) % 2;
+  e->flagged = rand_r(seed) % 2;
+  e->replied = rand_r(seed) % 2;
+  e->tagged = rand_r(seed) % 2;
+
+  const size_t subj = rand_r(seed) % (mutt_array_size(TestSubjects) + 1);
+  if (subj < mutt_array_size(TestSubjects))
+  {
+    e->env->subject = mutt_str_dup(TestSubjects[subj]);
+    e->env->real_subj = e->env->subject;
+  }
+
+  add_random_address(&e->env->from, seed);
+  add_random_address(&e->env->to, seed);
+
+  return e;
+}
+
 struct IndexSharedData *index_shared_data_new(void)
 {
   return NULL;
@@ -23,6 +23,7 @@
 #define TEST_NO_MAIN
 #include "config.h"
 #include "acutest.h"
+#include <string.h>
 #include "mutt/lib.h"
 #include "compress/lib.h"
 #include "common.h"
@@ -34,7 +35,7 @@ void test_compress_zstd(void)
 {
   // void *open(short level);
   // void *compress(void *cctx, const char *data, size_t dlen, size_t *clen);
-  // void *decompress(void *cctx, const char *cbuf, size_t clen);
+  // void *decompress(void *cctx, const char *cbuf, size_t clen, size_t *dlen);
   // void  close(void **cctx);
 
   const struct ComprOps *cops = compress_get_ops("zstd");
@@ -44,7 +45,7 @@ void test_compress_zstd(void)
   {
     // Degenerate tests
     TEST_CHECK(cops->compress(NULL, NULL, 0, NULL) == NULL);
-    TEST_CHECK(cops->decompress(NULL, NULL, 0) == NULL);
+    TEST_CHECK(cops->decompress(NULL, NULL, 0, NULL) == NULL);
     void *cctx = NULL;
     cops->close(NULL);
     TEST_CHECK_(1, "cops->close(NULL)");
@@ -75,11 +76,74 @@ void test_compress_zstd(void)
 
     const char zeroes[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
                             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
-    void *result = cops->decompress(cctx, zeroes, sizeof(zeroes));
+    void *result = cops->decompress(cctx, zeroes, sizeof(zeroes), NULL);
     TEST_CHECK(result == NULL);
 
     cops->close(&cctx);
   }
 
+  {
+    // Dictionary
+    TEST_CHECK(cops->train(NULL, NULL, 0, 0, NULL) == NULL);
+    TEST_CHECK(!cops->set_dict(NULL, NULL, 0));
+
+    // Many small, similar samples, like email headers
+    struct Buffer samples = mutt_buffer_make(0);
+    size_t sizes[500];
+    for (int i = 0; i < 500; i++)
+    {
+      size_t before = mutt_buffer_len(&samples);
+      mutt_buffer_add_printf(&samples,
+                             "From: user%d@example.com\nTo: list@example.org\n"
+                             "Subject: Re: [list] topic number %d\n"
+                             "Message-ID: <%d.%d@mail.example.com>\n",
+                             i % 37, i % 11, i * 7919, i);
+      sizes[i] = mutt_buffer_len(&samples) - before;
+    }
+
+    size_t dlen = 0;
+    void *dict = cops->train(samples.data, sizes, 500, 4096, &dlen);
+    if (TEST_CHECK(dict != NULL))
+    {
+      void *cctx = cops->open(MIN_COMP_LEVEL);
+      void *plain = cops->open(MIN_COMP_LEVEL);
+      TEST_CHECK(!cops->set_dict(cctx, "not a dictionary", 16));
+      TEST_CHECK(cops->set_dict(cctx, dict, dlen));
+
+      const char *data = samples.data;
+      size_t clen = 0;
+      char *cdata = cops->compress(cctx, data, sizes[0], &clen);
+      if (TEST_CHECK(cdata != NULL))
+      {
+        char *copy = mutt_mem_malloc(clen);
+        memcpy(copy, cdata, clen);
+
+        size_t ulen = 0;
+        char *udata = cops->decompress(cctx, copy, clen, &ulen);
+        TEST_CHECK(udata != NULL);
+        TEST_CHECK(ulen == sizes[0]);
+        TEST_CHECK((udata != NULL) && (memcmp(udata, data, ulen) == 0));
+
+        // Without the dictionary, the data can't be decompressed
+        TEST_CHECK(cops->decompress(plain, copy, clen, NULL) == NULL);
+        FREE(&copy);
+      }
+
+      // Data compressed without a dictionary can still be read
+      cdata = cops->compress(plain, data, sizes[0], &clen);
+      if (TEST_CHECK(cdata != NULL))
+      {
+        size_t ulen = 0;
+        TEST_CHECK(cops->decompress(cctx, cdata, clen, &ulen) != NULL);
+        TEST_CHECK(ulen == sizes[0]);
+      }
+
+      cops->close(&plain);
+      cops->close(&cctx);
+      FREE(&dict);
+    }
+    mutt_buffer_dealloc(&samples);
+  }
+
   compress_data_tests(cops, MIN_COMP_LEVEL, MAX_COMP_LEVEL);
 }
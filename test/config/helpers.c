@@ -140,6 +140,51 @@ void test_config_helpers(void)
   TEST_CHECK(cs_subset_sort(sub, "Mango") == 1);
   TEST_CHECK(mutt_str_equal(cs_subset_string(sub, "Nectarine"), "nectarine"));
 
+  {
+    struct ConfigHandle h_address = { "Elderberry" };
+    struct ConfigHandle h_bool = { "Apple" };
+    struct ConfigHandle h_enum = { "Hawthorn" };
+    struct ConfigHandle h_long = { "Guava" };
+    struct ConfigHandle h_mbtable = { "Ilama" };
+    struct ConfigHandle h_number = { "Cherry" };
+    struct ConfigHandle h_path = { "Jackfruit" };
+    struct ConfigHandle h_quad = { "Kumquat" };
+    struct ConfigHandle h_regex = { "Lemon" };
+    struct ConfigHandle h_slist = { "Olive" };
+    struct ConfigHandle h_sort = { "Mango" };
+    struct ConfigHandle h_string = { "Nectarine" };
+
+    TEST_CHECK(cs_handle_address(sub, &h_address) != NULL);
+    TEST_CHECK(cs_handle_bool(sub, &h_bool) == false);
+    TEST_CHECK(cs_handle_enum(sub, &h_enum) == 2);
+    TEST_CHECK(cs_handle_long(sub, &h_long) == 0);
+    TEST_CHECK(
+        mutt_str_equal(cs_handle_mbtable(sub, &h_mbtable)->orig_str, "abcdef"));
+    TEST_CHECK(cs_handle_number(sub, &h_number) == 0);
+    TEST_CHECK(mutt_str_equal(cs_handle_path(sub, &h_path), "/etc/passwd"));
+    TEST_CHECK(cs_handle_quad(sub, &h_quad) == 0);
+    TEST_CHECK(cs_handle_regex(sub, &h_regex) == 0);
+    TEST_CHECK(cs_handle_slist(sub, &h_slist) != NULL);
+    TEST_CHECK(cs_handle_sort(sub, &h_sort) == 1);
+    TEST_CHECK(mutt_str_equal(cs_handle_string(sub, &h_string), "nectarine"));
+
+    // Changing the config updates the handle
+    cs_subset_str_native_set(sub, "Apple", true, NULL);
+    TEST_CHECK(cs_handle_bool(sub, &h_bool) == true);
+    cs_subset_str_string_set(sub, "Nectarine", "damson", NULL);
+    TEST_CHECK(mutt_str_equal(cs_handle_string(sub, &h_string), "damson"));
+
+    // Each Subset sees its own value
+    struct ConfigSubset *sub_a = cs_subset_new("apple", sub, NULL);
+    TEST_CHECK(cs_handle_number(sub_a, &h_number) == 0);
+    cs_subset_str_native_set(sub_a, "Cherry", 42, NULL);
+    TEST_CHECK(cs_handle_number(sub_a, &h_number) == 42);
+    TEST_CHECK(cs_handle_number(sub, &h_number) == 0);
+    TEST_CHECK(cs_handle_number(sub_a, &h_number) == 42);
+    cs_subset_free(&sub_a);
+    TEST_CHECK(cs_handle_number(sub, &h_number) == 0);
+  }
+
   neomutt_free(&NeoMutt);
   cs_subset_free(&sub);
   cs_free(&cs);
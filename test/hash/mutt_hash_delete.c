@@ -60,4 +60,51 @@ void test_mutt_hash_delete(void)
     mutt_hash_delete(table, "banana", NULL);
     mutt_hash_free(&table);
   }
+
+  {
+    // Open addressing: delete while the table is being resized
+    char buf[32];
+    struct HashTable *table = mutt_hash_new(8, MUTT_HASH_OPEN_ADDR | MUTT_HASH_STRDUP_KEYS);
+    for (int i = 0; i < 500; i++)
+    {
+      snprintf(buf, sizeof(buf), "apple%d", i);
+      mutt_hash_insert(table, buf, &dummy1);
+      if ((i % 3) == 0)
+      {
+        snprintf(buf, sizeof(buf), "apple%d", i / 2);
+        mutt_hash_delete(table, buf, NULL);
+      }
+    }
+
+    for (int i = 0; i < 500; i++)
+    {
+      snprintf(buf, sizeof(buf), "apple%d", i);
+      mutt_hash_delete(table, buf, &dummy2); // wrong data, nothing is deleted
+      const bool expected = (i >= 250) || ((i % 3) == 2);
+      TEST_CHECK((mutt_hash_find(table, buf) != NULL) == expected);
+      TEST_MSG("apple%d", i);
+    }
+
+    for (int i = 0; i < 500; i++)
+    {
+      snprintf(buf, sizeof(buf), "apple%d", i);
+      mutt_hash_delete(table, buf, NULL);
+    }
+    TEST_CHECK(table->num_keys == 0);
+    mutt_hash_free(&table);
+  }
+
+  {
+    struct HashTable *table = mutt_hash_new(8, MUTT_HASH_OPEN_ADDR | MUTT_HASH_ALLOW_DUPS);
+    mutt_hash_insert(table, "apple", &dummy1);
+    mutt_hash_insert(table, "apple", &dummy2);
+    mutt_hash_insert(table, "apple", &dummy3);
+    mutt_hash_delete(table, "apple", &dummy2);
+    struct HashElem *he = mutt_hash_find_bucket(table, "apple");
+    TEST_CHECK(he && (he->data == &dummy3) && he->next && (he->next->data == &dummy1) && !he->next->next);
+    mutt_hash_delete(table, "apple", NULL);
+    TEST_CHECK(!mutt_hash_find_bucket(table, "apple"));
+    TEST_CHECK(table->num_keys == 0);
+    mutt_hash_free(&table);
+  }
 }
@@ -44,4 +44,31 @@ void test_mutt_hash_insert(void)
     TEST_CHECK(mutt_hash_insert(table, "apple", NULL) != NULL);
     mutt_hash_free(&table);
   }
+
+  {
+    // Open addressing: the table grows, and every key can still be found
+    int data[1000];
+    char buf[32];
+    struct HashTable *table = mutt_hash_new(8, MUTT_HASH_OPEN_ADDR | MUTT_HASH_STRDUP_KEYS);
+    for (int i = 0; i < 1000; i++)
+    {
+      snprintf(buf, sizeof(buf), "apple%d", i);
+      TEST_CHECK(mutt_hash_insert(table, buf, &data[i]) != NULL);
+
+      snprintf(buf, sizeof(buf), "apple%d", i / 2);
+      TEST_CHECK(mutt_hash_find(table, buf) == &data[i / 2]);
+    }
+
+    TEST_CHECK(table->num_elems >= 1024);
+    TEST_CHECK(table->num_keys == 1000);
+    TEST_CHECK(mutt_hash_insert(table, "apple500", &data[0]) == NULL);
+
+    for (int i = 0; i < 1000; i++)
+    {
+      snprintf(buf, sizeof(buf), "apple%d", i);
+      TEST_CHECK(mutt_hash_find(table, buf) == &data[i]);
+    }
+    TEST_CHECK(!mutt_hash_find(table, "apple1000"));
+    mutt_hash_free(&table);
+  }
 }
@@ -38,4 +38,15 @@ void test_mutt_hash_int_insert(void)
     TEST_CHECK(mutt_hash_int_insert(table, 0, NULL) != NULL);
     mutt_hash_free(&table);
   }
+
+  {
+    int data[1000];
+    struct HashTable *table = mutt_hash_int_new(8, MUTT_HASH_OPEN_ADDR);
+    for (int i = 0; i < 1000; i++)
+      TEST_CHECK(mutt_hash_int_insert(table, i * 4, &data[i]) != NULL);
+    for (int i = 0; i < 1000; i++)
+      TEST_CHECK(mutt_hash_int_find(table, i * 4) == &data[i]);
+    TEST_CHECK(!mutt_hash_int_find(table, 1));
+    mutt_hash_free(&table);
+  }
 }
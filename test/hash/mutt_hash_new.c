@@ -64,4 +64,19 @@ void test_mutt_hash_new(void)
     mutt_hash_insert(table, "apple", &dummy3);
     mutt_hash_free(&table);
   }
+
+  {
+    struct HashTable *table = mutt_hash_new(0, MUTT_HASH_OPEN_ADDR);
+    TEST_CHECK(table->open_addr);
+    TEST_CHECK(table->num_elems == 8);
+    mutt_hash_free(&table);
+  }
+
+  {
+    struct HashTable *table = mutt_hash_new(100, MUTT_HASH_OPEN_ADDR | MUTT_HASH_STRCASECMP);
+    TEST_CHECK(table->num_elems == 128);
+    mutt_hash_insert(table, "Apple", &dummy1);
+    TEST_CHECK(mutt_hash_find(table, "aPPLE") == &dummy1);
+    mutt_hash_free(&table);
+  }
 }
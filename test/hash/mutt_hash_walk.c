@@ -38,4 +38,32 @@ void test_mutt_hash_walk(void)
     struct HashTable table = { 0 };
     TEST_CHECK(!mutt_hash_walk(&table, NULL));
   }
+
+  {
+    // Open addressing: every element is seen, even during a resize
+    int dummy = 42;
+    char buf[32];
+    struct HashTable *table = mutt_hash_new(8, MUTT_HASH_OPEN_ADDR |
+                                                   MUTT_HASH_STRDUP_KEYS |
+                                                   MUTT_HASH_ALLOW_DUPS);
+    for (int i = 0; i < 52; i++)
+      mutt_hash_insert(table, "banana", &dummy);
+
+    // The 49th key makes the table grow from 64 to 128 slots
+    for (int i = 0; i < 48; i++)
+    {
+      snprintf(buf, sizeof(buf), "apple%d", i);
+      mutt_hash_insert(table, buf, &dummy);
+    }
+    TEST_CHECK(table->old_slots != NULL);
+
+    struct HashWalkState walkstate = { 0 };
+    int count = 0;
+    while (mutt_hash_walk(table, &walkstate))
+      count++;
+    TEST_CHECK(count == 100);
+    TEST_MSG("Expected: %d", 100);
+    TEST_MSG("Actual:   %d", count);
+    mutt_hash_free(&table);
+  }
 }
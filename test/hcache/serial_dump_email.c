@@ -0,0 +1,185 @@
+/**
+ * @file
+ * Test code for serial_dump_email()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <string.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "hcache/serialize.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "auto_subscribe", DT_BOOL, 0, 0, NULL, },
+  { "charset", DT_STRING, 0, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+#define SUBJ_UTF8 "Caf\xc3\xa9"
+#define SUBJ_LATIN1 "Caf\xe9"
+
+static struct Email *create_email(const char *subject, const char *msgid)
+{
+  struct Email *e = email_new();
+  e->env = mutt_env_new();
+  e->env->subject = mutt_str_dup(subject);
+  e->env->message_id = mutt_str_dup(msgid);
+  e->body = mutt_body_new();
+  e->body->subtype = mutt_str_dup("plain");
+  e->received = 1234567890;
+  e->read = true;
+  return e;
+}
+
+static uint32_t record_flags(const unsigned char *d)
+{
+  struct SerialEmail se;
+  memcpy(&se, d, sizeof(se));
+  return se.flags;
+}
+
+/**
+ * round_trip - Dump an Email under one $charset and restore it under another
+ * @param subject    Subject to store
+ * @param dump_cs    $charset when the Email is dumped
+ * @param restore_cs $charset when the Email is restored
+ * @param flags      Expected record flags
+ * @retval ptr Restored Email
+ */
+static struct Email *round_trip(const char *subject, const char *dump_cs,
+                                const char *restore_cs, uint32_t flags)
+{
+  struct Email *e = create_email(subject, "<a@b>");
+
+  cs_subset_str_string_set(NeoMutt->sub, "charset", dump_cs, NULL);
+  size_t dlen = 0;
+  unsigned char *d = serial_dump_email(e, 0, !mutt_istr_equal(dump_cs, "utf-8"), &dlen);
+  email_free(&e);
+  TEST_CHECK(d != NULL);
+  TEST_CHECK(record_flags(d) == flags);
+
+  cs_subset_str_string_set(NeoMutt->sub, "charset", restore_cs, NULL);
+  e = serial_restore_email(d, dlen, !mutt_istr_equal(restore_cs, "utf-8"), false);
+  FREE(&d);
+  TEST_CHECK(e != NULL);
+  TEST_CHECK(e->read);
+  TEST_CHECK(e->received == 1234567890);
+  return e;
+}
+
+void test_serial_dump_email(void)
+{
+  // void *serial_dump_email(const struct Email *e, size_t hlen, bool convert, size_t *dlen);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+
+  {
+    TEST_CASE("ASCII");
+    struct Email *e = round_trip("Hello", "utf-8", "iso-8859-1", SERIAL_NO_FLAGS);
+    TEST_CHECK(mutt_str_equal(e->env->subject, "Hello"));
+    TEST_CHECK(mutt_str_equal(e->env->message_id, "<a@b>"));
+    TEST_CHECK(mutt_str_equal(e->body->subtype, "plain"));
+    email_free(&e);
+  }
+
+  {
+    TEST_CASE("Written as utf-8, read as iso-8859-1");
+    struct Email *e = round_trip(SUBJ_UTF8, "utf-8", "iso-8859-1", SERIAL_NON_ASCII);
+    TEST_CHECK(mutt_str_equal(e->env->subject, SUBJ_LATIN1));
+    TEST_MSG("Actual: %s", e->env->subject);
+    email_free(&e);
+  }
+
+  {
+    TEST_CASE("Written as iso-8859-1, read as utf-8");
+    struct Email *e = round_trip(SUBJ_LATIN1, "iso-8859-1", "utf-8", SERIAL_NON_ASCII);
+    TEST_CHECK(mutt_str_equal(e->env->subject, SUBJ_UTF8));
+    TEST_MSG("Actual: %s", e->env->subject);
+    email_free(&e);
+  }
+
+  {
+    TEST_CASE("Written and read as iso-8859-1");
+    struct Email *e = round_trip(SUBJ_LATIN1, "iso-8859-1", "iso-8859-1", SERIAL_NON_ASCII);
+    TEST_CHECK(mutt_str_equal(e->env->subject, SUBJ_LATIN1));
+    email_free(&e);
+  }
+
+  {
+    TEST_CASE("Non-ASCII in an unconverted field");
+    struct Email *e = create_email("Hello", "<caf\xc3\xa9@b>");
+    size_t dlen = 0;
+    unsigned char *d = serial_dump_email(e, 0, false, &dlen);
+    TEST_CHECK(record_flags(d) == SERIAL_NON_ASCII);
+    FREE(&d);
+    email_free(&e);
+  }
+
+  {
+    TEST_CASE("Numbers");
+    struct Email *e = create_email("Hello", "<a@b>");
+    e->index = 42;
+    e->msgno = 41;
+    e->vnum = 40;
+    e->score = -7;
+    e->attach_total = 3;
+    e->body->attach_count = 2;
+    size_t dlen = 0;
+    unsigned char *d = serial_dump_email(e, 0, false, &dlen);
+    email_free(&e);
+
+    e = serial_restore_email(d, dlen, false, false);
+    TEST_CHECK(e->index == 42);
+    TEST_CHECK(e->msgno == 41);
+    TEST_CHECK(e->vnum == 40);
+    TEST_CHECK(e->score == -7);
+    TEST_CHECK(e->attach_total == 3);
+    TEST_CHECK(e->body->attach_count == 2);
+    email_free(&e);
+
+    e = serial_restore_email(d, dlen, false, true);
+    TEST_CHECK(e->index == 42);
+    TEST_CHECK(e->score == -7);
+    TEST_CHECK(!e->env && !e->body);
+    email_free(&e);
+    FREE(&d);
+  }
+
+  {
+    TEST_CASE("Damaged record");
+    struct Email *e = create_email("Hello", "<a@b>");
+    size_t dlen = 0;
+    unsigned char *d = serial_dump_email(e, 0, false, &dlen);
+    email_free(&e);
+    TEST_CHECK(serial_restore_email(d, dlen - 1, false, false) == NULL);
+    TEST_CHECK(serial_restore_email(d, sizeof(struct SerialEmail) - 1, false, false) == NULL);
+    FREE(&d);
+  }
+
+  test_neomutt_destroy(&NeoMutt);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file
+ * Test code for cmd_parse_esearch()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "imap/adata.h"
+#include "imap/mdata.h"
+#include "imap/private.h"
+
+/**
+ * parse - Parse a search response and check the UIDs
+ * @param esearch  true for an ESEARCH response, false for SEARCH
+ * @param response Untagged response, without the leading "* "
+ * @param expected Expected UIDs, e.g. "2,10,11"
+ */
+static void parse(bool esearch, const char *response, const char *expected)
+{
+  struct ImapUidArray uids = ARRAY_HEAD_INITIALIZER;
+  struct ImapMboxData mdata = { 0 };
+  struct Mailbox m = { 0 };
+  struct ImapAccountData adata = { 0 };
+
+  m.mdata = &mdata;
+  adata.mailbox = &m;
+  mdata.search_uids = &uids;
+
+  if (esearch)
+    cmd_parse_esearch(&adata, response);
+  else
+    cmd_parse_search(&adata, response);
+
+  struct Buffer *buf = mutt_buffer_pool_get();
+  unsigned int *uid = NULL;
+  ARRAY_FOREACH(uid, &uids)
+  {
+    mutt_buffer_add_printf(buf, "%s%u", mutt_buffer_is_empty(buf) ? "" : ",", *uid);
+  }
+  TEST_CHECK(mutt_str_equal(mutt_buffer_string(buf), expected));
+  TEST_MSG("Expected: %s", expected);
+  TEST_MSG("Actual  : %s", mutt_buffer_string(buf));
+
+  mutt_buffer_pool_release(&buf);
+  ARRAY_FREE(&uids);
+}
+
+void test_cmd_parse_esearch(void)
+{
+  // void cmd_parse_esearch(struct ImapAccountData *adata, const char *s);
+
+  {
+    TEST_CASE("Not searching");
+    struct ImapMboxData mdata = { 0 };
+    struct Mailbox m = { 0 };
+    struct ImapAccountData adata = { 0 };
+    m.mdata = &mdata;
+    adata.mailbox = &m;
+    cmd_parse_esearch(&adata, "ESEARCH (TAG \"a1\") UID ALL 1:5");
+    TEST_CHECK(mdata.search_uids == NULL);
+  }
+
+  {
+    TEST_CASE("No matches");
+    parse(true, "ESEARCH (TAG \"a1\") UID", "");
+    parse(true, "ESEARCH (TAG \"a1\")", "");
+    parse(true, "ESEARCH", "");
+  }
+
+  {
+    TEST_CASE("Single UIDs and ranges");
+    parse(true, "ESEARCH (TAG \"a1\") UID ALL 2,10:15,21", "2,10,11,12,13,14,15,21");
+    parse(true, "ESEARCH (TAG \"a1\") UID ALL 7", "7");
+    parse(true, "ESEARCH (TAG \"a1\") UID ALL 5:3", "3,4,5");
+  }
+
+  {
+    TEST_CASE("No tag");
+    parse(true, "ESEARCH UID ALL 1:2", "1,2");
+  }
+
+  {
+    TEST_CASE("Other results");
+    parse(true, "ESEARCH (TAG \"a1\") UID MIN 4 COUNT 3 ALL 4,8:9", "4,8,9");
+    parse(true, "ESEARCH (TAG \"a1\") UID ALL 4,8:9 MAX 9", "4,8,9");
+    parse(true, "esearch (tag \"a1\") uid all 6", "6");
+  }
+
+  // void cmd_parse_search(struct ImapAccountData *adata, const char *s);
+
+  {
+    TEST_CASE("SEARCH");
+    parse(false, "SEARCH", "");
+    parse(false, "SEARCH 2 10 11 21", "2,10,11,21");
+  }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file
+ * IMAP functions needed by the search tests
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* imap/search.o is linked on its own.  These stand in for the parts of
+ * imap/util.c and imap/command.c that it uses, without the rest of libimap. */
+
+#include "config.h"
+#include <stdbool.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "imap/mdata.h"
+#include "imap/private.h"
+
+int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags flags)
+{
+  return IMAP_EXEC_ERROR;
+}
+
+struct ImapMboxData *imap_mdata_get(struct Mailbox *m)
+{
+  if (!m || (m->type != MUTT_IMAP) || !m->mdata)
+    return NULL;
+  return m->mdata;
+}
+
+char *imap_next_word(char *s)
+{
+  bool quoted = false;
+
+  while (*s)
+  {
+    if (*s == '\\')
+    {
+      s++;
+      if (*s)
+        s++;
+      continue;
+    }
+    if (*s == '\"')
+      quoted = !quoted;
+    if (!quoted && IS_SPACE(*s))
+      break;
+    s++;
+  }
+
+  SKIPWS(s);
+  return s;
+}
+
+void imap_quote_string(char *dest, size_t dlen, const char *src, bool quote_backtick)
+{
+  const char *quote = "`\"\\";
+  if (!quote_backtick)
+    quote++;
+
+  char *pt = dest;
+  const char *s = src;
+
+  *pt++ = '"';
+  /* save room for quote-chars */
+  dlen -= 3;
+
+  for (; *s && dlen; s++)
+  {
+    if (strchr(quote, *s))
+    {
+      if (dlen < 2)
+        break;
+      dlen -= 2;
+      *pt++ = '\\';
+      *pt++ = *s;
+    }
+    else
+    {
+      *pt++ = *s;
+      dlen--;
+    }
+  }
+  *pt++ = '"';
+  *pt = '\0';
+}
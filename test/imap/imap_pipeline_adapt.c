@@ -0,0 +1,218 @@
+/**
+ * @file
+ * Test code for imap_pipeline_adapt()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "imap/adata.h"
+#include "imap/private.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "imap_pipeline_depth", DT_NUMBER, 15, 0, NULL, },
+  { "imap_pipeline_max",   DT_NUMBER, 0,  0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * respond - Feed the responses to a run of commands to the pipeline
+ * @param adata Imap Account data
+ * @param num   Number of responses
+ * @param rtt   Round trip of each command, in microseconds
+ * @param count Number of commands waiting for each response
+ * @param now   Time, in microseconds, updated
+ */
+static void respond(struct ImapAccountData *adata, int num, uint64_t rtt,
+                    int count, uint64_t *now)
+{
+  for (int i = 0; i < num; i++)
+  {
+    *now += 100;
+    imap_pipeline_adapt(adata, *now - rtt, *now, count, false);
+  }
+}
+
+void test_imap_pipeline_adapt(void)
+{
+  // void imap_pipeline_adapt(struct ImapAccountData *adata, uint64_t sent, uint64_t now, int count, bool throttled);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+
+  {
+    TEST_CASE("Fixed depth");
+    struct ImapAccountData adata = { 0 };
+    imap_pipeline_reset(&adata);
+    TEST_CHECK(adata.pipeline_depth == 15);
+    TEST_CHECK(adata.pipeline_max == 0);
+
+    uint64_t now = 1000000;
+    respond(&adata, 50, 1000, 20, &now);
+    TEST_CHECK(adata.pipeline_depth == 15);
+    TEST_CHECK(adata.rtt_min == 0);
+    imap_pipeline_adapt(&adata, now - 1000, now, 20, true);
+    TEST_CHECK(adata.pipeline_depth == 15);
+  }
+
+  cs_subset_str_native_set(NeoMutt->sub, "imap_pipeline_depth", 4, NULL);
+  cs_subset_str_native_set(NeoMutt->sub, "imap_pipeline_max", 10, NULL);
+
+  {
+    TEST_CASE("Grow while there's no backlog");
+    struct ImapAccountData adata = { 0 };
+    imap_pipeline_reset(&adata);
+    TEST_CHECK(adata.pipeline_depth == 4);
+    TEST_CHECK(adata.pipeline_max == 10);
+
+    uint64_t now = 1000000;
+    respond(&adata, 3, 1000, 20, &now);
+    TEST_CHECK(adata.pipeline_depth == 7);
+    TEST_MSG("depth %d", adata.pipeline_depth);
+    TEST_CHECK(adata.rtt_min == 1000);
+    TEST_CHECK(adata.rtt_avg == 1000);
+
+    respond(&adata, 20, 1000, 20, &now);
+    TEST_CHECK(adata.pipeline_depth == 10);
+    TEST_MSG("depth %d", adata.pipeline_depth);
+  }
+
+  {
+    TEST_CASE("Don't grow unless the pipeline is full");
+    struct ImapAccountData adata = { 0 };
+    imap_pipeline_reset(&adata);
+
+    uint64_t now = 1000000;
+    respond(&adata, 20, 1000, 4, &now);
+    TEST_CHECK(adata.pipeline_depth == 4);
+    TEST_MSG("depth %d", adata.pipeline_depth);
+  }
+
+  {
+    TEST_CASE("Ignore lone commands");
+    struct ImapAccountData adata = { 0 };
+    imap_pipeline_reset(&adata);
+
+    uint64_t now = 1000000;
+    respond(&adata, 20, 500000, 1, &now);
+    TEST_CHECK(adata.pipeline_depth == 4);
+    TEST_CHECK(adata.rtt_min == 0);
+    TEST_CHECK(adata.rtt_avg == 0);
+
+    imap_pipeline_adapt(&adata, 0, now, 5, false);
+    TEST_CHECK(adata.rtt_min == 0);
+  }
+
+  {
+    TEST_CASE("Shrink when there's a backlog");
+    struct ImapAccountData adata = { 0 };
+    imap_pipeline_reset(&adata);
+
+    uint64_t now = 1000000;
+    respond(&adata, 6, 1000, 20, &now);
+    TEST_CHECK(adata.pipeline_depth == 10);
+
+    /* the commands start queueing at the server */
+    respond(&adata, 5, 4000, 10, &now);
+    TEST_CHECK(adata.pipeline_depth < 10);
+    TEST_MSG("depth %d", adata.pipeline_depth);
+    TEST_CHECK(adata.rtt_min == 1000);
+
+    respond(&adata, 200, 4000, 10, &now);
+    TEST_CHECK(adata.pipeline_depth >= 1);
+    TEST_CHECK(adata.pipeline_depth <= 5);
+    TEST_MSG("depth %d", adata.pipeline_depth);
+
+    /* a small backlog is tolerated */
+    const int depth = adata.pipeline_depth;
+    respond(&adata, 200, 4000, 10, &now);
+    TEST_CHECK(adata.pipeline_depth == depth);
+    TEST_MSG("depth %d, was %d", adata.pipeline_depth, depth);
+
+    /* the server catches up */
+    respond(&adata, 200, 1000, 20, &now);
+    TEST_CHECK(adata.pipeline_depth == 10);
+    TEST_MSG("depth %d", adata.pipeline_depth);
+  }
+
+  {
+    TEST_CASE("Back off when throttled");
+    struct ImapAccountData adata = { 0 };
+    imap_pipeline_reset(&adata);
+
+    uint64_t now = 1000000;
+    respond(&adata, 6, 1000, 20, &now);
+    TEST_CHECK(adata.pipeline_depth == 10);
+
+    /* several commands in flight are refused, only back off once */
+    imap_pipeline_adapt(&adata, now - 1000, now, 10, true);
+    TEST_CHECK(adata.pipeline_depth == 5);
+    imap_pipeline_adapt(&adata, now - 900, now + 100, 10, true);
+    TEST_CHECK(adata.pipeline_depth == 5);
+
+    /* a command sent after backing off is refused too */
+    imap_pipeline_adapt(&adata, now + 200, now + 1200, 5, true);
+    TEST_CHECK(adata.pipeline_depth == 2);
+    imap_pipeline_adapt(&adata, now + 1300, now + 2300, 5, true);
+    TEST_CHECK(adata.pipeline_depth == 1);
+    imap_pipeline_adapt(&adata, now + 2400, now + 3400, 5, true);
+    TEST_CHECK(adata.pipeline_depth == 1);
+  }
+
+  // void imap_pipeline_reset(struct ImapAccountData *adata);
+
+  {
+    TEST_CASE("Reset");
+    struct ImapAccountData adata = { 0 };
+    imap_pipeline_reset(&adata);
+
+    uint64_t now = 1000000;
+    respond(&adata, 6, 1000, 20, &now);
+    imap_pipeline_adapt(&adata, now - 1000, now, 10, true);
+    TEST_CHECK(adata.pipeline_depth == 5);
+
+    imap_pipeline_reset(&adata);
+    TEST_CHECK(adata.pipeline_depth == 4);
+    TEST_CHECK(adata.pipeline_max == 10);
+    TEST_CHECK(adata.rtt_min == 0);
+    TEST_CHECK(adata.rtt_avg == 0);
+    TEST_CHECK(adata.throttled == 0);
+
+    cs_subset_str_native_set(NeoMutt->sub, "imap_pipeline_max", 3, NULL);
+    imap_pipeline_reset(&adata);
+    TEST_CHECK(adata.pipeline_max == 0);
+
+    cs_subset_str_native_set(NeoMutt->sub, "imap_pipeline_depth", 0, NULL);
+    cs_subset_str_native_set(NeoMutt->sub, "imap_pipeline_max", 10, NULL);
+    imap_pipeline_reset(&adata);
+    TEST_CHECK(adata.pipeline_depth == 0);
+    TEST_CHECK(adata.pipeline_max == 0);
+  }
+
+  test_neomutt_destroy(&NeoMutt);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file
+ * Test code for imap_search_compile()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "imap/adata.h"
+#include "imap/mdata.h"
+#include "imap/private.h"
+#include "pattern/lib.h"
+
+/**
+ * compile - Compile a pattern and check the IMAP search
+ * @param m        Mailbox
+ * @param str      Pattern, e.g. "=b apple"
+ * @param expected Expected search criteria
+ * @param exact    true if the server's result should be exact
+ */
+static void compile(struct Mailbox *m, const char *str, const char *expected, bool exact)
+{
+  struct Buffer *err = mutt_buffer_pool_get();
+  struct PatternList *pat = mutt_pattern_comp(NULL, NULL, str, MUTT_PC_FULL_MSG, err);
+  TEST_CHECK(pat != NULL);
+  TEST_MSG("%s: %s", str, mutt_buffer_string(err));
+  mutt_buffer_pool_release(&err);
+  if (!pat)
+    return;
+
+  struct Buffer *buf = mutt_buffer_pool_get();
+  struct Pattern *root = NULL;
+  bool ok = imap_search_compile(m, pat, buf, &root);
+  if (expected)
+  {
+    TEST_CHECK(ok);
+    TEST_CHECK(mutt_str_equal(mutt_buffer_string(buf), expected));
+    TEST_MSG("Pattern : %s", str);
+    TEST_MSG("Expected: %s", expected);
+    TEST_MSG("Actual  : %s", mutt_buffer_string(buf));
+    TEST_CHECK((root != NULL) == exact);
+    TEST_MSG("%s: %s", str, exact ? "should be exact" : "shouldn't be exact");
+  }
+  else
+  {
+    TEST_CHECK(!ok);
+  }
+
+  mutt_buffer_pool_release(&buf);
+  mutt_pattern_free(&pat);
+}
+
+void test_imap_search_compile(void)
+{
+  // bool imap_search_compile(struct Mailbox *m, struct PatternList *pat, struct Buffer *buf, struct Pattern **root);
+
+  struct Account a = { 0 };
+  struct ImapAccountData adata = { 0 };
+  struct Mailbox m = { 0 };
+  a.adata = &adata;
+  m.account = &a;
+  m.type = MUTT_IMAP;
+  adata.mailbox = &m;
+
+  {
+    TEST_CASE("Server-side searches");
+    compile(&m, "=b apple", "BODY \"apple\"", true);
+    compile(&m, "=B apple", "TEXT \"apple\"", true);
+    compile(&m, "=h X-Fruit:apple", "HEADER \"X-Fruit\" \"apple\"", true);
+    compile(&m, "!=b apple", "NOT BODY \"apple\"", true);
+  }
+
+  {
+    TEST_CASE("Combined with local searches");
+    compile(&m, "=b apple ~s banana", "BODY \"apple\"", true);
+    compile(&m, "=b apple | ~s banana", "BODY \"apple\"", true);
+    compile(&m, "(=b apple | =B cherry) ~s banana", "(OR BODY \"apple\" TEXT \"cherry\")", true);
+    compile(&m, "=b apple =B cherry ~s banana", "(BODY \"apple\" TEXT \"cherry\")", false);
+  }
+
+  {
+    TEST_CASE("Translatable searches");
+    compile(&m, "=b apple =s banana", "(BODY \"apple\" SUBJECT \"banana\")", true);
+    compile(&m, "=b apple | =f banana", "(OR BODY \"apple\" FROM \"banana\")", true);
+    compile(&m, "=b apple ~F", "(BODY \"apple\" FLAGGED)", true);
+    compile(&m, "=b apple !~U", "(BODY \"apple\" NOT UNSEEN)", true);
+    compile(&m, "=b apple ~R", "(BODY \"apple\" SEEN)", true);
+  }
+
+  {
+    TEST_CASE("Case-sensitive searches");
+    compile(&m, "=b apple =s Banana", "BODY \"apple\"", true);
+  }
+
+  {
+    TEST_CASE("Unsynced flags");
+    m.changed = true;
+    compile(&m, "=b apple ~F", "BODY \"apple\"", true);
+    m.changed = false;
+  }
+
+  {
+    TEST_CASE("Sizes and dates are matched locally");
+    compile(&m, "=b apple ~z 10-", "BODY \"apple\"", true);
+    compile(&m, "=b apple ~z -1K", "BODY \"apple\"", true);
+    compile(&m, "=b apple ~d 01/01/2020-31/12/2020", "BODY \"apple\"", true);
+    compile(&m, "=b apple ~r 01/01/2020-31/12/2020", "BODY \"apple\"", true);
+    compile(&m, "=b apple ~z 10- =B cherry", "(BODY \"apple\" TEXT \"cherry\")", false);
+  }
+
+  {
+    TEST_CASE("Gmail search");
+    compile(&m, "=/ apple", NULL, false);
+    adata.capabilities |= IMAP_CAP_X_GM_EXT_1;
+    compile(&m, "=/ apple", "X-GM-RAW \"apple\"", true);
+    adata.capabilities = 0;
+  }
+}
@@ -84,6 +84,11 @@
   NEOMUTT_TEST_ITEM(test_mutt_b64_decode)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_b64_encode)                                      \
                                                                                \
+  /* bcache */                                                                 \
+  NEOMUTT_TEST_ITEM(test_bcache_index_add)                                     \
+  NEOMUTT_TEST_ITEM(test_bcache_index_open)                                    \
+  NEOMUTT_TEST_ITEM(test_mutt_bcache_get)                                      \
+                                                                               \
   /* body */                                                                   \
   NEOMUTT_TEST_ITEM(test_mutt_body_cmp_strict)                                 \
   NEOMUTT_TEST_ITEM(test_mutt_body_free)                                       \
@@ -115,6 +120,7 @@
   NEOMUTT_TEST_ITEM(test_mutt_buffer_substrcpy)                                \
                                                                                \
   /* charset */                                                                \
+  NEOMUTT_TEST_ITEM(test_mutt_ch_cache_cleanup)                                \
   NEOMUTT_TEST_ITEM(test_mutt_ch_canonical_charset)                            \
   NEOMUTT_TEST_ITEM(test_mutt_ch_charset_lookup)                               \
   NEOMUTT_TEST_ITEM(test_mutt_ch_check)                                        \
@@ -130,6 +136,7 @@
   NEOMUTT_TEST_ITEM(test_mutt_ch_get_default_charset)                          \
   NEOMUTT_TEST_ITEM(test_mutt_ch_get_langinfo_charset)                         \
   NEOMUTT_TEST_ITEM(test_mutt_ch_iconv)                                        \
+  NEOMUTT_TEST_ITEM(test_mutt_ch_iconv_close)                                  \
   NEOMUTT_TEST_ITEM(test_mutt_ch_iconv_lookup)                                 \
   NEOMUTT_TEST_ITEM(test_mutt_ch_iconv_open)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_ch_lookup_add)                                   \
@@ -163,6 +170,7 @@
   NEOMUTT_TEST_ITEM(test_mutt_date_check_month)                                \
   NEOMUTT_TEST_ITEM(test_mutt_date_epoch)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_date_epoch_ms)                                   \
+  NEOMUTT_TEST_ITEM(test_mutt_date_epoch_us)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_date_gmtime)                                     \
   NEOMUTT_TEST_ITEM(test_mutt_date_local_tz)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_date_localtime)                                  \
@@ -308,6 +316,11 @@
   NEOMUTT_TEST_ITEM(test_mutt_idna_print_version)                              \
   NEOMUTT_TEST_ITEM(test_mutt_idna_to_ascii_lz)                                \
                                                                                \
+  /* imap */                                                                   \
+  NEOMUTT_TEST_ITEM(test_cmd_parse_esearch)                                    \
+  NEOMUTT_TEST_ITEM(test_imap_pipeline_adapt)                                  \
+  NEOMUTT_TEST_ITEM(test_imap_search_compile)                                  \
+                                                                               \
   /* list */                                                                   \
   NEOMUTT_TEST_ITEM(test_mutt_list_clear)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_list_compare)                                    \
@@ -353,6 +366,9 @@
   NEOMUTT_TEST_ITEM(test_mutt_map_get_value)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_map_get_value_n)                                 \
                                                                                \
+  /* mbox */                                                                   \
+  NEOMUTT_TEST_ITEM(test_mbox_parse_mmap)                                      \
+                                                                               \
   /* mbyte */                                                                  \
   NEOMUTT_TEST_ITEM(test_mutt_mb_charlen)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_mb_filter_unprintable)                           \
@@ -443,6 +459,7 @@
                                                                                \
   /* pattern */                                                                \
   NEOMUTT_TEST_ITEM(test_mutt_pattern_comp)                                    \
+  NEOMUTT_TEST_ITEM(test_mutt_pattern_exec_many)                               \
                                                                                \
   /* prex */                                                                   \
   NEOMUTT_TEST_ITEM(test_mutt_prex_capture)                                    \
@@ -500,6 +517,9 @@
   NEOMUTT_TEST_ITEM(test_slist_remove_string)                                  \
   NEOMUTT_TEST_ITEM(test_slist_to_buffer)                                      \
                                                                                \
+  /* sort */                                                                   \
+  NEOMUTT_TEST_ITEM(test_mutt_sort_headers)                                    \
+                                                                               \
   /* string */                                                                 \
   NEOMUTT_TEST_ITEM(test_mutt_istr_equal)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_istr_find)                                       \
@@ -558,6 +578,7 @@
   NEOMUTT_TEST_ITEM(test_insert_message)                                       \
   NEOMUTT_TEST_ITEM(test_is_descendant)                                        \
   NEOMUTT_TEST_ITEM(test_mutt_break_thread)                                    \
+  NEOMUTT_TEST_ITEM(test_mutt_sort_threads)                                    \
   NEOMUTT_TEST_ITEM(test_thread_hash_destructor)                               \
   NEOMUTT_TEST_ITEM(test_unlink_message)                                       \
                                                                                \
@@ -568,7 +589,10 @@
   NEOMUTT_TEST_ITEM(test_url_pct_decode)                                       \
   NEOMUTT_TEST_ITEM(test_url_pct_encode)                                       \
   NEOMUTT_TEST_ITEM(test_url_tobuffer)                                         \
-  NEOMUTT_TEST_ITEM(test_url_tostring)
+  NEOMUTT_TEST_ITEM(test_url_tostring)                                         \
+                                                                               \
+  /* worker */                                                                 \
+  NEOMUTT_TEST_ITEM(test_mutt_worker_run)
 
 /******************************************************************************
  * You probably don't need to touch what follows.
@@ -582,6 +606,13 @@ NEOMUTT_TEST_LIST
 #ifdef USE_LZ4
   NEOMUTT_TEST_ITEM(test_compress_lz4)
 #endif
+#ifdef USE_HCACHE
+  NEOMUTT_TEST_ITEM(test_mbox_hcache_compare)
+  NEOMUTT_TEST_ITEM(test_serial_dump_email)
+#endif
+#ifdef USE_INOTIFY
+  NEOMUTT_TEST_ITEM(test_mutt_monitor_events)
+#endif
 #ifdef USE_NOTMUCH
   NEOMUTT_TEST_ITEM(test_nm_parse_type_from_query)
   NEOMUTT_TEST_ITEM(test_nm_query_type_to_string)
@@ -634,6 +665,13 @@ NEOMUTT_TEST_ITEM(test_compress_common)
 #ifdef USE_LZ4
   NEOMUTT_TEST_ITEM(test_compress_lz4)
 #endif
+#ifdef USE_HCACHE
+  NEOMUTT_TEST_ITEM(test_mbox_hcache_compare)
+  NEOMUTT_TEST_ITEM(test_serial_dump_email)
+#endif
+#ifdef USE_INOTIFY
+  NEOMUTT_TEST_ITEM(test_mutt_monitor_events)
+#endif
 #ifdef USE_NOTMUCH
   NEOMUTT_TEST_ITEM(test_nm_parse_type_from_query)
   NEOMUTT_TEST_ITEM(test_nm_query_type_to_string)
@@ -0,0 +1,41 @@
+/**
+ * @file
+ * Functions needed by the mbox tests
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* libmbox is linked on its own.  This stands in for the part of mx.c that
+ * the parsers use. */
+
+#include "config.h"
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "mx.h"
+
+void mx_alloc_memory(struct Mailbox *m)
+{
+  m->email_max += 25;
+  mutt_mem_realloc(&m->emails, sizeof(struct Email *) * m->email_max);
+  mutt_mem_realloc(&m->v2r, sizeof(int) * m->email_max);
+  for (int i = m->email_max - 25; i < m->email_max; i++)
+  {
+    m->emails[i] = NULL;
+    m->v2r[i] = -1;
+  }
+}
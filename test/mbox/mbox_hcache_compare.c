@@ -0,0 +1,187 @@
+/**
+ * @file
+ * Test code for mbox_hcache_compare()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "mbox/private.h"
+
+#define MESSAGE_B "From b@example.com Mon Jan  4 11:00:00 2021\nStatus: O\n\n"
+#define MESSAGE_C "From c@example.com Mon Jan  4 12:00:00 2021\n\nHello\n"
+
+/**
+ * create_folder - Create a folder of two messages, larger than the checksummed tail
+ * @param fp    File to write to
+ * @param flags Status flags of the first message, 2 chars
+ */
+static void create_folder(FILE *fp, const char *flags)
+{
+  rewind(fp);
+  fprintf(fp, "From a@example.com Mon Jan  4 10:00:00 2021\nStatus: %s\n\n", flags);
+  for (int i = 0; i < 64; i++)
+    fputs("The quick brown fox jumps over the lazy dog.\n", fp);
+  fputs("\n" MESSAGE_B, fp);
+  for (int i = 0; i < 64; i++)
+    fputs("Pack my box with five dozen liquor jugs.\n", fp);
+  fputs("\n", fp);
+  fflush(fp);
+}
+
+/**
+ * set_mtime - Set the mtime of a file, to the second, like utime() does
+ * @param fp    File
+ * @param mtime Time to set
+ */
+static void set_mtime(FILE *fp, time_t mtime)
+{
+  struct timespec times[2] = { { mtime, 0 }, { mtime, 0 } };
+  TEST_CHECK(futimens(fileno(fp), times) == 0);
+}
+
+void test_mbox_hcache_compare(void)
+{
+  // enum MboxHcacheState mbox_hcache_compare(const struct MboxIndex *idx, FILE *fp, enum MailboxType type);
+
+  const time_t mtime = 1609754400;
+
+  {
+    TEST_CASE("Degenerate");
+    struct MboxIndex idx = { 0 };
+    FILE *fp = tmpfile();
+    TEST_CHECK(mbox_hcache_compare(NULL, fp, MUTT_MBOX) == MBOX_HCACHE_CHANGED);
+    TEST_CHECK(mbox_hcache_compare(&idx, NULL, MUTT_MBOX) == MBOX_HCACHE_CHANGED);
+    TEST_CHECK(!mbox_hcache_describe(NULL, fp, MUTT_MBOX));
+    TEST_CHECK(!mbox_hcache_describe(&idx, NULL, MUTT_MBOX));
+    fclose(fp);
+  }
+
+  {
+    TEST_CASE("Unchanged");
+    FILE *fp = tmpfile();
+    create_folder(fp, "RO");
+    set_mtime(fp, mtime);
+
+    struct MboxIndex idx = { 0 };
+    TEST_CHECK(mbox_hcache_describe(&idx, fp, MUTT_MBOX));
+    TEST_CHECK(idx.version == MBOX_HCACHE_VERSION);
+    TEST_CHECK(mbox_hcache_compare(&idx, fp, MUTT_MBOX) == MBOX_HCACHE_UNCHANGED);
+    TEST_CHECK(mbox_hcache_compare(&idx, fp, MUTT_MMDF) == MBOX_HCACHE_CHANGED);
+
+    struct MboxIndex old = idx;
+    old.version = 0;
+    TEST_CHECK(mbox_hcache_compare(&old, fp, MUTT_MBOX) == MBOX_HCACHE_CHANGED);
+    fclose(fp);
+  }
+
+  {
+    TEST_CASE("Appended");
+    FILE *fp = tmpfile();
+    create_folder(fp, "RO");
+    struct MboxIndex idx = { 0 };
+    TEST_CHECK(mbox_hcache_describe(&idx, fp, MUTT_MBOX));
+
+    fseeko(fp, 0, SEEK_END);
+    fputs(MESSAGE_C, fp);
+    fflush(fp);
+    TEST_CHECK(mbox_hcache_compare(&idx, fp, MUTT_MBOX) == MBOX_HCACHE_APPENDED);
+    fclose(fp);
+  }
+
+  {
+    TEST_CASE("Appended, without a separator");
+    FILE *fp = tmpfile();
+    create_folder(fp, "RO");
+    struct MboxIndex idx = { 0 };
+    TEST_CHECK(mbox_hcache_describe(&idx, fp, MUTT_MBOX));
+
+    fseeko(fp, 0, SEEK_END);
+    fputs("More text\n", fp);
+    fflush(fp);
+    TEST_CHECK(mbox_hcache_compare(&idx, fp, MUTT_MBOX) == MBOX_HCACHE_CHANGED);
+    fclose(fp);
+  }
+
+  {
+    TEST_CASE("Rewritten, same size and mtime");
+    FILE *fp = tmpfile();
+    create_folder(fp, "RO");
+    set_mtime(fp, mtime);
+    struct MboxIndex idx = { 0 };
+    TEST_CHECK(mbox_hcache_describe(&idx, fp, MUTT_MBOX));
+
+    // The ctime may only have a resolution of one second
+    while (time(NULL) <= idx.ctime_sec)
+      mutt_date_sleep_ms(50);
+
+    // Change the flags outside of the checksummed tail, then reset the mtime
+    create_folder(fp, "OR");
+    set_mtime(fp, mtime);
+
+    struct stat sb;
+    TEST_CHECK(fstat(fileno(fp), &sb) == 0);
+    TEST_CHECK(sb.st_size == idx.size);
+    TEST_CHECK(sb.st_mtime == idx.mtime_sec);
+    TEST_CHECK(mbox_hcache_compare(&idx, fp, MUTT_MBOX) == MBOX_HCACHE_CHANGED);
+    fclose(fp);
+  }
+
+  {
+    TEST_CASE("Replaced by a copy");
+    FILE *fp = tmpfile();
+    create_folder(fp, "RO");
+    set_mtime(fp, mtime);
+    struct MboxIndex idx = { 0 };
+    TEST_CHECK(mbox_hcache_describe(&idx, fp, MUTT_MBOX));
+
+    FILE *fp_copy = tmpfile();
+    create_folder(fp_copy, "RO");
+    set_mtime(fp_copy, mtime);
+    TEST_CHECK(mbox_hcache_compare(&idx, fp_copy, MUTT_MBOX) == MBOX_HCACHE_CHANGED);
+    fclose(fp_copy);
+    fclose(fp);
+  }
+
+  {
+    TEST_CASE("Rewritten in the tail");
+    FILE *fp = tmpfile();
+    create_folder(fp, "RO");
+    struct MboxIndex idx = { 0 };
+    TEST_CHECK(mbox_hcache_describe(&idx, fp, MUTT_MBOX));
+
+    // Pretend the times are unchanged; only the tail can tell
+    fseeko(fp, -4, SEEK_END);
+    fputs("JUGS", fp);
+    fflush(fp);
+    struct MboxIndex cur = { 0 };
+    TEST_CHECK(mbox_hcache_describe(&cur, fp, MUTT_MBOX));
+    memcpy(cur.tail, idx.tail, sizeof(cur.tail));
+    TEST_CHECK(mbox_hcache_compare(&cur, fp, MUTT_MBOX) == MBOX_HCACHE_CHANGED);
+    fclose(fp);
+  }
+}
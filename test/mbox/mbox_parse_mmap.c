@@ -0,0 +1,238 @@
+/**
+ * @file
+ * Test code for mbox_parse_mmap()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "mbox/lib.h"
+#include "mbox/private.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "assumed_charset", DT_STRING, 0,                  0, NULL, },
+  { "auto_subscribe",  DT_BOOL,   false,              0, NULL, },
+  { "autocrypt",       DT_BOOL,   false,              0, NULL, },
+  { "charset",         DT_STRING, IP "utf-8",         0, NULL, },
+  { "mark_old",        DT_BOOL,   true,               0, NULL, },
+  { "reply_regex",     DT_REGEX,  IP "^re:[ \t]*",    0, NULL, },
+  { "spam_separator",  DT_STRING, IP ",",             0, NULL, },
+  { "weed",            DT_BOOL,   true,               0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+#define FROM_A "From a@example.com Mon Jan  4 10:00:00 2021\n"
+#define FROM_B "From b@example.com Mon Jan  4 11:00:00 2021\n"
+#define FROM_C "From c@example.com Mon Jan  4 12:00:00 2021\n"
+#define MMDF_SEP "\001\001\001\001\n"
+
+/**
+ * parse_folder - Find the messages in a folder
+ * @param text     Contents of the folder
+ * @param use_mmap Use mbox_parse_mmap(), rather than mbox_parse_stream()
+ * @param[out] end Position of the file afterwards
+ * @retval ptr Mailbox of the messages
+ */
+static struct Mailbox *parse_folder(const char *text, bool use_mmap, LOFF_T *end)
+{
+  struct MboxAccountData adata = { 0 };
+  adata.fp = tmpfile();
+  if (!TEST_CHECK(adata.fp != NULL))
+    return NULL;
+  fputs(text, adata.fp);
+  fflush(adata.fp);
+
+  struct Mailbox *m = mailbox_new();
+  m->type = MUTT_MBOX;
+  m->size = ftello(adata.fp);
+  rewind(adata.fp);
+
+  if (use_mmap)
+    TEST_CHECK(mbox_parse_mmap(m, &adata, NULL));
+  else
+    mbox_parse_stream(m, &adata, NULL);
+
+  *end = ftello(adata.fp);
+  mutt_file_fclose(&adata.fp);
+  return m;
+}
+
+/**
+ * check_folder - Check that both parsers find the same messages
+ * @param text  Contents of the folder
+ * @param count Expected number of messages
+ */
+static void check_folder(const char *text, int count)
+{
+  LOFF_T end_stream = 0;
+  LOFF_T end_mmap = 0;
+  struct Mailbox *m_stream = parse_folder(text, false, &end_stream);
+  struct Mailbox *m_mmap = parse_folder(text, true, &end_mmap);
+  if (!m_stream || !m_mmap)
+    goto done;
+
+  TEST_CHECK(m_stream->msg_count == count);
+  TEST_CHECK(m_mmap->msg_count == count);
+  TEST_MSG("Expected %d, stream %d, mmap %d", count, m_stream->msg_count, m_mmap->msg_count);
+  TEST_CHECK(end_stream == end_mmap);
+
+  for (int i = 0; (i < m_stream->msg_count) && (i < m_mmap->msg_count); i++)
+  {
+    const struct Email *es = m_stream->emails[i];
+    const struct Email *em = m_mmap->emails[i];
+    TEST_CHECK(es->offset == em->offset);
+    TEST_MSG("Email %d offset: stream %ld, mmap %ld", i, (long) es->offset, (long) em->offset);
+    TEST_CHECK(es->lines == em->lines);
+    TEST_MSG("Email %d lines: stream %d, mmap %d", i, es->lines, em->lines);
+    TEST_CHECK(es->body->offset == em->body->offset);
+    TEST_MSG("Email %d body offset: stream %ld, mmap %ld", i,
+             (long) es->body->offset, (long) em->body->offset);
+    TEST_CHECK(es->body->length == em->body->length);
+    TEST_MSG("Email %d length: stream %ld, mmap %ld", i,
+             (long) es->body->length, (long) em->body->length);
+    TEST_CHECK(es->received == em->received);
+    TEST_CHECK(mutt_str_equal(es->env->subject, em->env->subject));
+  }
+
+done:
+  for (int i = 0; m_stream && (i < m_stream->msg_count); i++)
+    email_free(&m_stream->emails[i]);
+  for (int i = 0; m_mmap && (i < m_mmap->msg_count); i++)
+    email_free(&m_mmap->emails[i]);
+  mailbox_free(&m_stream);
+  mailbox_free(&m_mmap);
+}
+
+void test_mbox_parse_mmap(void)
+{
+  // bool mbox_parse_mmap(struct Mailbox *m, struct MboxAccountData *adata, struct Progress *progress);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+
+  {
+    TEST_CASE("Plain");
+    check_folder(FROM_A "Subject: one\n\nHello\nWorld\n\n"
+                 FROM_B "Subject: two\n\nBye\n\n"
+                 FROM_C "Subject: three\n\nEnd\n",
+                 3);
+  }
+
+  {
+    TEST_CASE("Correct Content-Length");
+    check_folder(FROM_A "Subject: one\nContent-Length: 12\n\nHello\nWorld\n\n"
+                 FROM_B "Subject: two\nContent-Length: 4\n\nBye\n\n",
+                 2);
+  }
+
+  {
+    TEST_CASE("Content-Length and Lines");
+    check_folder(FROM_A "Subject: one\nContent-Length: 12\nLines: 2\n\nHello\nWorld\n\n"
+                 FROM_B "Subject: two\n\nBye\n",
+                 2);
+  }
+
+  {
+    TEST_CASE("Content-Length too short");
+    check_folder(FROM_A "Subject: one\nContent-Length: 5\n\nHello\nWorld\n\n"
+                 FROM_B "Subject: two\n\nBye\n",
+                 2);
+  }
+
+  {
+    TEST_CASE("Content-Length too long");
+    check_folder(FROM_A "Subject: one\nContent-Length: 500\n\nHello\nWorld\n\n"
+                 FROM_B "Subject: two\n\nBye\n",
+                 2);
+  }
+
+  {
+    TEST_CASE("Content-Length hides a From line");
+    check_folder(FROM_A "Subject: one\nContent-Length: 50\n\n" FROM_C "Hello\n\n"
+                 FROM_B "Subject: two\n\nBye\n",
+                 2);
+  }
+
+  {
+    TEST_CASE("No trailing newline");
+    check_folder(FROM_A "Subject: one\n\nHello\n\n"
+                 FROM_B "Subject: two\n\nBye\nno newline",
+                 2);
+  }
+
+  {
+    TEST_CASE("No trailing newline, with Content-Length");
+    check_folder(FROM_A "Subject: one\n\nHello\n\n"
+                 FROM_B "Subject: two\nContent-Length: 13\n\nBye\nno newline",
+                 2);
+  }
+
+  {
+    TEST_CASE("Quoted From line");
+    check_folder(FROM_A "Subject: one\n\nHello\n>" FROM_C "World\n\n"
+                 FROM_B "Subject: two\n\nBye\n",
+                 2);
+  }
+
+  {
+    TEST_CASE("Bare From line");
+    /* Not a valid separator, so it's part of the body */
+    check_folder(FROM_A "Subject: one\n\nHello\nFrom here to there\nWorld\n\n"
+                 FROM_B "Subject: two\n\nFrom me\n",
+                 2);
+  }
+
+  {
+    TEST_CASE("Unquoted From line");
+    /* A valid separator in a body starts a new message */
+    check_folder(FROM_A "Subject: one\n\nHello\n" FROM_C "World\n\n"
+                 FROM_B "Subject: two\n\nBye\n",
+                 3);
+  }
+
+  {
+    TEST_CASE("Empty messages");
+    check_folder(FROM_A "\n" FROM_B "Subject: two\n\n" FROM_C, 3);
+  }
+
+  {
+    TEST_CASE("Junk before the first message");
+    check_folder("junk\nmore junk\n" FROM_A "Subject: one\n\nHello\n", 1);
+  }
+
+  {
+    TEST_CASE("MMDF");
+    /* MMDF folders have their own parser, but the separators are harmless */
+    check_folder(MMDF_SEP FROM_A "Subject: one\n\nHello\n" MMDF_SEP
+                 MMDF_SEP FROM_B "Subject: two\n\nBye\n" MMDF_SEP,
+                 2);
+  }
+
+  test_neomutt_destroy(&NeoMutt);
+}
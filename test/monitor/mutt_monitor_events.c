@@ -0,0 +1,160 @@
+/**
+ * @file
+ * Test code for mutt_monitor_events()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "context.h"
+#include "monitor.h"
+
+extern struct Context *Context;
+
+static void maildir_path(struct Buffer *buf, const char *dir, const char *subdir,
+                         const char *name)
+{
+  mutt_buffer_printf(buf, "%s/%s/%s", dir, subdir, name);
+}
+
+static void free_events(struct MonitorEventArray *events)
+{
+  struct MonitorEvent *ev = NULL;
+  ARRAY_FOREACH(ev, events)
+  {
+    FREE(&ev->name);
+  }
+  ARRAY_FREE(events);
+}
+
+static bool check_event(struct MonitorEventArray *events, int idx,
+                        const char *name, bool cur, bool added)
+{
+  struct MonitorEvent *ev = ARRAY_GET(events, idx);
+  if (!TEST_CHECK(ev != NULL))
+    return false;
+  TEST_MSG("Expected: %s %d %d", name, cur, added);
+  TEST_MSG("Actual:   %s %d %d", ev->name, ev->cur, ev->added);
+  return mutt_str_equal(ev->name, name) && (ev->cur == cur) && (ev->added == added);
+}
+
+void test_mutt_monitor_events(void)
+{
+  // int mutt_monitor_events(struct Mailbox *m, struct MonitorEventArray *events);
+
+  char dir[] = "/tmp/neomutt-test-monitor-XXXXXX";
+  if (!TEST_CHECK(mkdtemp(dir) != NULL))
+    return;
+
+  struct Buffer *src = mutt_buffer_pool_get();
+  struct Buffer *dst = mutt_buffer_pool_get();
+  const char *subdirs[] = { "new", "cur", "tmp" };
+  for (size_t i = 0; i < mutt_array_size(subdirs); i++)
+  {
+    mutt_buffer_printf(src, "%s/%s", dir, subdirs[i]);
+    TEST_CHECK(mkdir(mutt_buffer_string(src), 0700) == 0);
+  }
+
+  struct Mailbox *m = mailbox_new();
+  m->type = MUTT_MAILDIR;
+  mutt_buffer_strcpy(&m->pathbuf, dir);
+  m->realpath = mutt_str_dup(dir);
+
+  struct Context ctx = { 0 };
+  ctx.mailbox = m;
+  Context = &ctx;
+
+  struct MonitorEventArray events = ARRAY_HEAD_INITIALIZER;
+
+  {
+    TEST_CASE("Not watched");
+    TEST_CHECK(mutt_monitor_events(NULL, &events) == -1);
+    TEST_CHECK(mutt_monitor_events(m, &events) == -1);
+  }
+
+  TEST_CHECK(mutt_monitor_add(NULL) == 0);
+
+  {
+    TEST_CASE("Start watching");
+    struct Mailbox *m2 = mailbox_new();
+    TEST_CHECK(mutt_monitor_events(m2, &events) == -1);
+    mailbox_free(&m2);
+
+    // The first call tells the caller to do a full scan
+    TEST_CHECK(mutt_monitor_events(m, &events) == -1);
+    TEST_CHECK(mutt_monitor_events(m, &events) == 0);
+    TEST_CHECK(ARRAY_EMPTY(&events));
+  }
+
+  {
+    TEST_CASE("Deliver and read, without polling");
+    maildir_path(src, dir, "tmp", "1.msg");
+    FILE *fp = fopen(mutt_buffer_string(src), "w");
+    TEST_CHECK(fp != NULL);
+    fputs("Subject: test\n\nHello\n", fp);
+    fclose(fp);
+
+    maildir_path(dst, dir, "new", "1.msg");
+    TEST_CHECK(rename(mutt_buffer_string(src), mutt_buffer_string(dst)) == 0);
+    mutt_buffer_copy(src, dst);
+    maildir_path(dst, dir, "cur", "1.msg:2,S");
+    TEST_CHECK(rename(mutt_buffer_string(src), mutt_buffer_string(dst)) == 0);
+
+    TEST_CHECK(mutt_monitor_events(m, &events) == 0);
+    TEST_CHECK(ARRAY_SIZE(&events) == 3);
+    TEST_CHECK(check_event(&events, 0, "1.msg", false, true));
+    TEST_CHECK(check_event(&events, 1, "1.msg", false, false));
+    TEST_CHECK(check_event(&events, 2, "1.msg:2,S", true, true));
+    free_events(&events);
+
+    // Each event is only reported once
+    TEST_CHECK(mutt_monitor_events(m, &events) == 0);
+    TEST_CHECK(ARRAY_EMPTY(&events));
+  }
+
+  {
+    TEST_CASE("Delete");
+    TEST_CHECK(unlink(mutt_buffer_string(dst)) == 0);
+    TEST_CHECK(mutt_monitor_events(m, &events) == 0);
+    TEST_CHECK(ARRAY_SIZE(&events) == 1);
+    TEST_CHECK(check_event(&events, 0, "1.msg:2,S", true, false));
+    free_events(&events);
+  }
+
+  {
+    TEST_CASE("Stop watching");
+    TEST_CHECK(mutt_monitor_remove(NULL) == 0);
+    TEST_CHECK(mutt_monitor_events(m, &events) == -1);
+  }
+
+  Context = NULL;
+  mailbox_free(&m);
+
+  mutt_buffer_strcpy(src, dir);
+  mutt_file_rmtree(mutt_buffer_string(src));
+  mutt_buffer_pool_release(&src);
+  mutt_buffer_pool_release(&dst);
+}
@@ -78,11 +78,6 @@ int crypt_valid_passphrase(int flags)
   return 0;
 }
 
-bool imap_search(struct Mailbox *m, const struct Pattern *pat)
-{
-  return false;
-}
-
 bool mutt_addr_is_user(struct Address *addr)
 {
   return g_addr_is_user;
@@ -246,10 +241,12 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
   return 0;
 }
 
+#ifndef USE_INOTIFY
 int mutt_monitor_poll(void)
 {
   return 0;
 }
+#endif
 
 int mutt_system(const char *cmd)
 {
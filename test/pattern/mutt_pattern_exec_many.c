@@ -0,0 +1,218 @@
+/**
+ * @file
+ * Test code for mutt_pattern_exec_many()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "pattern/lib.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "charset",                 DT_STRING, IP "utf-8", 0, NULL, },
+  { "external_search_command", DT_STRING, 0,          0, NULL, },
+  { "idn_decode",              DT_BOOL,   true,       0, NULL, },
+  { "pattern_threads",         DT_NUMBER, 0,          0, NULL, },
+  { "thorough_search",         DT_BOOL,   true,       0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/* Enough Emails to match in parallel */
+#define NUM_EMAILS 2000
+
+/**
+ * exec_serial - Match a Pattern against the Emails one at a time
+ * @param pat     Pattern
+ * @param m       Mailbox
+ * @param matches Results, one per Email
+ */
+static void exec_serial(struct PatternList *pat, struct Mailbox *m, bool *matches)
+{
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    matches[i] = (mutt_pattern_exec(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS,
+                                    m, m->emails[i], NULL) > 0);
+  }
+}
+
+/**
+ * compile - Compile a Pattern
+ * @param str   Pattern string
+ * @param flags Flags, e.g. #MUTT_PC_FULL_MSG
+ * @retval ptr Compiled Pattern
+ */
+static struct PatternList *compile(const char *str, PatternCompFlags flags)
+{
+  struct Buffer *err = mutt_buffer_pool_get();
+  struct PatternList *pat = mutt_pattern_comp(NULL, NULL, str, flags, err);
+  TEST_CHECK(pat != NULL);
+  TEST_MSG("%s: %s", str, mutt_buffer_string(err));
+  mutt_buffer_pool_release(&err);
+  return pat;
+}
+
+void test_mutt_pattern_exec_many(void)
+{
+  // bool mutt_pattern_exec_many(struct PatternList *pat, PatternExecFlags flags, struct Mailbox *m, struct Email **emails, size_t num, bool *matches);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+  mutt_grouplist_init();
+
+  struct Mailbox *m = mailbox_new();
+  m->type = MUTT_MBOX;
+  m->email_max = NUM_EMAILS;
+  m->emails = mutt_mem_calloc(NUM_EMAILS, sizeof(struct Email *));
+  m->v2r = mutt_mem_calloc(NUM_EMAILS, sizeof(int));
+  unsigned int seed = 1;
+  for (int i = 0; i < NUM_EMAILS; i++)
+  {
+    m->emails[i] = test_email_random(i, &seed);
+    m->v2r[i] = i;
+  }
+  m->msg_count = NUM_EMAILS;
+  m->vcount = NUM_EMAILS;
+
+  bool *serial = mutt_mem_calloc(NUM_EMAILS, sizeof(bool));
+  bool *parallel = mutt_mem_calloc(NUM_EMAILS, sizeof(bool));
+
+  {
+    TEST_CASE("Degenerate");
+    struct PatternList *pat = compile("~F", MUTT_PC_FULL_MSG);
+    cs_subset_str_native_set(NeoMutt->sub, "pattern_threads", 4, NULL);
+    TEST_CHECK(!mutt_pattern_exec_many(NULL, 0, m, m->emails, NUM_EMAILS, parallel));
+    TEST_CHECK(!mutt_pattern_exec_many(pat, 0, m, NULL, NUM_EMAILS, parallel));
+    TEST_CHECK(!mutt_pattern_exec_many(pat, 0, m, m->emails, NUM_EMAILS, NULL));
+
+    /* too few Emails to be worth it */
+    TEST_CHECK(!mutt_pattern_exec_many(pat, 0, m, m->emails, 10, parallel));
+
+    /* not enough threads */
+    cs_subset_str_native_set(NeoMutt->sub, "pattern_threads", 1, NULL);
+    TEST_CHECK(!mutt_pattern_exec_many(pat, 0, m, m->emails, NUM_EMAILS, parallel));
+    mutt_pattern_free(&pat);
+  }
+
+  cs_subset_str_native_set(NeoMutt->sub, "pattern_threads", 4, NULL);
+
+  {
+    /* Patterns that only read the headers and flags */
+    static const char *tests[] = {
+      "~F",
+      "~N",
+      "~U",
+      "~Q",
+      "~T",
+      "~s apple",
+      "=s apple",
+      "~f alice",
+      "~f user[12]@",
+      "~z <25",
+      "~n 1-3",
+      "~d 19/09/2020-",
+      "!~s apple ~F",
+      "~s apple | ~f bob",
+      "~(~F) | (~s cherry !~N)",
+    };
+
+    for (size_t i = 0; i < mutt_array_size(tests); i++)
+    {
+      TEST_CASE(tests[i]);
+      struct PatternList *pat = compile(tests[i], MUTT_PC_FULL_MSG);
+      if (!pat)
+        continue;
+
+      exec_serial(pat, m, serial);
+      memset(parallel, 0, NUM_EMAILS * sizeof(bool));
+      TEST_CHECK(mutt_pattern_exec_many(pat, MUTT_MATCH_FULL_ADDRESS, m,
+                                        m->emails, NUM_EMAILS, parallel));
+
+      int count = 0;
+      int j = 0;
+      for (; j < NUM_EMAILS; j++)
+      {
+        if (serial[j] != parallel[j])
+          break;
+        count += serial[j];
+      }
+      TEST_CHECK(j == NUM_EMAILS);
+      TEST_MSG("Email %d differs", j);
+
+      /* a pattern that matches everything, or nothing, proves little */
+      TEST_CHECK((count > 0) && (count < NUM_EMAILS));
+      TEST_MSG("%d matches", count);
+
+      mutt_pattern_free(&pat);
+    }
+  }
+
+  {
+    /* Patterns that must be matched by the main thread */
+    static const struct
+    {
+      const char *pattern;
+      PatternCompFlags flags;
+    } tests[] = {
+      // clang-format off
+      { "~v",                MUTT_PC_FULL_MSG },
+      { "~F ~v",             MUTT_PC_FULL_MSG },
+      { "~d <1d",            MUTT_PC_FULL_MSG | MUTT_PC_PATTERN_DYNAMIC },
+      { "%f friends",        MUTT_PC_FULL_MSG },
+      { "~F | %f friends",   MUTT_PC_FULL_MSG },
+      { "~l",                MUTT_PC_FULL_MSG },
+      { "~u",                MUTT_PC_FULL_MSG },
+      { "~p",                MUTT_PC_FULL_MSG },
+      { "~P",                MUTT_PC_FULL_MSG },
+      { "~b apple",          MUTT_PC_FULL_MSG },
+      { "~(~l)",             MUTT_PC_FULL_MSG },
+      // clang-format on
+    };
+
+    for (size_t i = 0; i < mutt_array_size(tests); i++)
+    {
+      TEST_CASE(tests[i].pattern);
+      struct PatternList *pat = compile(tests[i].pattern, tests[i].flags);
+      if (!pat)
+        continue;
+
+      TEST_CHECK(!mutt_pattern_exec_many(pat, MUTT_MATCH_FULL_ADDRESS, m,
+                                         m->emails, NUM_EMAILS, parallel));
+      mutt_pattern_free(&pat);
+    }
+  }
+
+  FREE(&serial);
+  FREE(&parallel);
+  for (int i = 0; i < m->msg_count; i++)
+    email_free(&m->emails[i]);
+  m->msg_count = 0;
+  mailbox_free(&m);
+
+  mutt_grouplist_free();
+  test_neomutt_destroy(&NeoMutt);
+}
@@ -0,0 +1,281 @@
+/**
+ * @file
+ * Test code for mutt_sort_headers()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "sort.h"
+#include "test_common.h"
+
+static const struct Mapping TestSortMethods[] = {
+  // clang-format off
+  { "date",          SORT_DATE },
+  { "date-received", SORT_RECEIVED },
+  { "from",          SORT_FROM },
+  { "mailbox-order", SORT_ORDER },
+  { "score",         SORT_SCORE },
+  { "size",          SORT_SIZE },
+  { "subject",       SORT_SUBJECT },
+  { "to",            SORT_TO },
+  { NULL,            0 },
+  // clang-format on
+};
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "charset",       DT_STRING,               IP "utf-8", 0,                  NULL, },
+  { "idn_decode",    DT_BOOL,                 true,       0,                  NULL, },
+  { "reverse_alias", DT_BOOL,                 false,      0,                  NULL, },
+  { "score",         DT_BOOL,                 false,      0,                  NULL, },
+  { "sort",          DT_SORT|DT_SORT_REVERSE, SORT_DATE,  IP TestSortMethods, NULL, },
+  { "sort_aux",      DT_SORT|DT_SORT_REVERSE, SORT_DATE,  IP TestSortMethods, NULL, },
+  { "sort_parallel", DT_NUMBER,               0,          0,                  NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/* The sort methods that can use sort keys */
+static const short Methods[] = {
+  SORT_DATE,  SORT_FROM, SORT_ORDER,   SORT_RECEIVED,
+  SORT_SCORE, SORT_SIZE, SORT_SUBJECT, SORT_TO,
+};
+
+/* Enough Emails to sort in parallel */
+#define NUM_EMAILS 10000
+
+/**
+ * add_address - Add an address to a list
+ * @param al   Address list
+ * @param name Display name, or NULL to use the mailbox
+ * @param num  Number to make the mailbox unique
+ */
+static void add_address(struct AddressList *al, const char *name, int num)
+{
+  char mailbox[64];
+  snprintf(mailbox, sizeof(mailbox), "user%d@example.com", num);
+  mutt_addrlist_append(al, mutt_addr_create(name, mailbox));
+}
+
+/**
+ * sort_emails - Sort the Emails of a Mailbox
+ * @param m        Mailbox
+ * @param orig     Unsorted Emails
+ * @param sort     Sort method, `$sort`
+ * @param sort_aux Auxiliary sort method, `$sort_aux`
+ * @param by_key   Sort by key, rather than using qsort()
+ *
+ * Both ways start from the same unsorted order.
+ */
+static void sort_emails(struct Mailbox *m, struct Email **orig, short sort,
+                        short sort_aux, bool by_key)
+{
+  memcpy(m->emails, orig, m->msg_count * sizeof(struct Email *));
+
+  cs_subset_str_native_set(NeoMutt->sub, "sort", sort, NULL);
+  cs_subset_str_native_set(NeoMutt->sub, "sort_aux", sort_aux, NULL);
+
+  /* This also sets the AuxSort function that the qsort() path relies on */
+  off_t vsize = 0;
+  mutt_sort_headers(m, NULL, false, &vsize);
+  if (by_key)
+    return;
+
+  memcpy(m->emails, orig, m->msg_count * sizeof(struct Email *));
+  qsort(m->emails, m->msg_count, sizeof(struct Email *),
+        mutt_get_sort_func(sort & SORT_MASK, m->type));
+}
+
+/**
+ * check_sort - Check that sorting by key matches qsort()
+ * @param m        Mailbox
+ * @param orig     Unsorted Emails
+ * @param sort     Sort method, `$sort`
+ * @param sort_aux Auxiliary sort method, `$sort_aux`
+ * @retval true The orders match
+ */
+static bool check_sort(struct Mailbox *m, struct Email **orig, short sort, short sort_aux)
+{
+  int *expected = mutt_mem_calloc(m->msg_count, sizeof(int));
+
+  sort_emails(m, orig, sort, sort_aux, false);
+  for (int i = 0; i < m->msg_count; i++)
+    expected[i] = m->emails[i]->index;
+
+  sort_emails(m, orig, sort, sort_aux, true);
+  int i = 0;
+  for (; i < m->msg_count; i++)
+  {
+    if (m->emails[i]->index != expected[i])
+      break;
+  }
+
+  const bool rc = (i == m->msg_count);
+  TEST_CHECK(rc);
+  if (!rc)
+  {
+    TEST_MSG("sort = %d, sort_aux = %d", sort, sort_aux);
+    TEST_MSG("Position %d: expected %d, got %d", i, expected[i], m->emails[i]->index);
+  }
+
+  FREE(&expected);
+  return rc;
+}
+
+static struct Mailbox *create_mailbox(int num)
+{
+  struct Mailbox *m = mailbox_new();
+  m->type = MUTT_MBOX;
+  m->email_max = num;
+  m->emails = mutt_mem_calloc(num, sizeof(struct Email *));
+  m->v2r = mutt_mem_calloc(num, sizeof(int));
+  m->msg_count = num;
+  return m;
+}
+
+static void destroy_mailbox(struct Mailbox **ptr)
+{
+  struct Mailbox *m = *ptr;
+  for (int i = 0; i < m->msg_count; i++)
+    email_free(&m->emails[i]);
+  m->msg_count = 0;
+  mailbox_free(ptr);
+}
+
+/**
+ * check_methods - Check that sorting by key matches qsort() for many methods
+ * @param num      Number of Emails
+ * @param parallel Value of `$sort_parallel`
+ * @param aux      Auxiliary sort methods to try
+ * @param num_aux  Number of auxiliary sort methods
+ *
+ * Every supported `$sort` is tried with each `$sort_aux`, both reversed and not.
+ */
+static void check_methods(int num, int parallel, const short *aux, size_t num_aux)
+{
+  cs_subset_str_native_set(NeoMutt->sub, "sort_parallel", parallel, NULL);
+
+  struct Mailbox *m = create_mailbox(num);
+  struct Email **orig = mutt_mem_calloc(num, sizeof(struct Email *));
+  unsigned int seed = 1;
+  for (int i = 0; i < num; i++)
+  {
+    orig[i] = test_email_random(i, &seed);
+    m->emails[i] = orig[i];
+  }
+
+  bool ok = true;
+  for (size_t i = 0; ok && (i < mutt_array_size(Methods)); i++)
+  {
+    for (size_t j = 0; ok && (j < num_aux); j++)
+    {
+      for (int rev = 0; ok && (rev < 4); rev++)
+      {
+        const short sort = Methods[i] | ((rev & 1) ? SORT_REVERSE : 0);
+        const short sort_aux = aux[j] | ((rev & 2) ? SORT_REVERSE : 0);
+        ok = check_sort(m, orig, sort, sort_aux);
+      }
+    }
+  }
+
+  /* put the Emails back, so they get freed */
+  memcpy(m->emails, orig, num * sizeof(struct Email *));
+  FREE(&orig);
+  destroy_mailbox(&m);
+  cs_subset_str_native_set(NeoMutt->sub, "sort_parallel", 0, NULL);
+}
+
+void test_mutt_sort_headers(void)
+{
+  // void mutt_sort_headers(struct Mailbox *m, struct ThreadsContext *threads, bool init, off_t *vsize);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+
+  {
+    TEST_CASE("All methods");
+    check_methods(500, 1, Methods, mutt_array_size(Methods));
+  }
+
+  /* Subjects tie often and some are missing */
+  static const short aux[] = { SORT_SUBJECT };
+  {
+    TEST_CASE("$sort_parallel = 1");
+    check_methods(NUM_EMAILS, 1, aux, mutt_array_size(aux));
+  }
+
+  {
+    TEST_CASE("$sort_parallel = 4");
+    check_methods(NUM_EMAILS, 4, aux, mutt_array_size(aux));
+  }
+
+  {
+    TEST_CASE("Long names");
+    /* Names are only compared up to 127 characters; the rest is ignored */
+    char name1[200] = { 0 };
+    char name2[200] = { 0 };
+    memset(name1, 'a', 150);
+    memset(name2, 'a', 150);
+    name1[140] = 'b';
+    name2[140] = 'c';
+
+    struct Mailbox *m = create_mailbox(3);
+    const char *names[] = { name2, name1, "b" };
+    for (int i = 0; i < 3; i++)
+    {
+      struct Email *e = email_new();
+      e->env = mutt_env_new();
+      e->body = mutt_body_new();
+      e->index = i;
+      e->vnum = i;
+      e->date_sent = 10 * (i + 1);
+      add_address(&e->env->from, names[i], i);
+      m->emails[i] = e;
+    }
+
+    cs_subset_str_native_set(NeoMutt->sub, "sort", SORT_FROM, NULL);
+    cs_subset_str_native_set(NeoMutt->sub, "sort_aux", SORT_DATE | SORT_REVERSE, NULL);
+    off_t vsize = 0;
+    mutt_sort_headers(m, NULL, false, &vsize);
+    TEST_CHECK(m->emails[0]->index == 1);
+    TEST_CHECK(m->emails[1]->index == 0);
+    TEST_CHECK(m->emails[2]->index == 2);
+
+    cs_subset_str_native_set(NeoMutt->sub, "sort_aux", SORT_DATE, NULL);
+    mutt_sort_headers(m, NULL, false, &vsize);
+    TEST_CHECK(m->emails[0]->index == 0);
+    TEST_CHECK(m->emails[1]->index == 1);
+    TEST_CHECK(m->emails[2]->index == 2);
+
+    destroy_mailbox(&m);
+  }
+
+  test_neomutt_destroy(&NeoMutt);
+}
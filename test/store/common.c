@@ -67,6 +67,12 @@ bool test_store_degenerate(const struct StoreOps *sops, const char *name)
   if (!TEST_CHECK(sops->delete_record(NULL, NULL, 0) != 0))
     return false;
 
+  if (sops->begin && !TEST_CHECK(sops->begin(NULL) != 0))
+    return false;
+
+  if (sops->commit && !TEST_CHECK(sops->commit(NULL) != 0))
+    return false;
+
   sops->close(NULL);
   TEST_CHECK_(1, "sops->close(NULL)");
 
@@ -79,6 +85,94 @@ bool test_store_degenerate(const struct StoreOps *sops, const char *name)
   return true;
 }
 
+static void test_store_fetch_cb(void *data, size_t idx, const void *value, size_t vlen)
+{
+  int *found = data;
+  found[idx] = (int) vlen;
+}
+
+/**
+ * test_store_db_fetch_many - Test the StoreOps::fetch_many() of a backend
+ * @param sops Backend
+ * @param db   Open Store
+ * @retval true Success
+ *
+ * The Keys are sorted, like the header cache does.  Missing Keys, at the start,
+ * in the middle and at the end, mustn't stop the others being found.
+ */
+static bool test_store_db_fetch_many(const struct StoreOps *sops, void *db)
+{
+  // clang-format off
+  static const char *keys[] = { "aardvark", "apple", "banana", "cherry", "cherryade", "date", "elder", "fig", "zebra", "zucchini" };
+  static const char *values[] = { NULL,     "one",   NULL,     "three",  NULL,        "four", NULL,    "five", NULL,    NULL       };
+  // clang-format on
+  const size_t num = mutt_array_size(keys);
+  size_t klens[mutt_array_size(keys)];
+  int found[mutt_array_size(keys)];
+
+  for (size_t i = 0; i < num; i++)
+  {
+    klens[i] = strlen(keys[i]);
+    if (!values[i])
+      continue;
+    if (!TEST_CHECK(sops->store(db, keys[i], klens[i], (void *) values[i],
+                                strlen(values[i])) == 0))
+    {
+      return false;
+    }
+  }
+
+  bool rc = true;
+  for (size_t n = 1; n <= num; n++)
+  {
+    /* Every prefix of the list, so that each one ends differently */
+    memset(found, 0, sizeof(found));
+    int want = 0;
+    for (size_t i = 0; i < n; i++)
+      want += (values[i] != NULL);
+
+    if (!TEST_CHECK(sops->fetch_many(db, keys, klens, n, test_store_fetch_cb, found) == want))
+    {
+      TEST_MSG("%zu keys", n);
+      rc = false;
+      break;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+      const int vlen = values[i] ? (int) strlen(values[i]) : 0;
+      if (!TEST_CHECK(found[i] == vlen))
+      {
+        TEST_MSG("%zu keys, %s: expected %d, got %d", n, keys[i], vlen, found[i]);
+        rc = false;
+      }
+    }
+  }
+
+  if (rc)
+    rc = TEST_CHECK(sops->fetch_many(db, keys + 2, klens + 2, 1, test_store_fetch_cb, found) == 0);
+
+  /* Records written in a batch must be found, too */
+  if (rc && sops->begin)
+  {
+    memset(found, 0, sizeof(found));
+    rc = TEST_CHECK(sops->begin(db) == 0) &&
+         TEST_CHECK(sops->store(db, keys[2], klens[2], "two", 3) == 0) &&
+         TEST_CHECK(sops->fetch_many(db, keys, klens, num, test_store_fetch_cb, found) == 5) &&
+         TEST_CHECK((found[1] == 3) && (found[2] == 3) && (found[9] == 0)) &&
+         TEST_CHECK(sops->commit(db) == 0);
+    sops->delete_record(db, keys[2], klens[2]);
+  }
+
+  for (size_t i = 0; i < num; i++)
+  {
+    if (values[i])
+      sops->delete_record(db, keys[i], klens[i]);
+  }
+
+  return rc;
+}
+
 bool test_store_db(const struct StoreOps *sops, void *db)
 {
   if (!sops || !db)
@@ -103,6 +197,39 @@ bool test_store_db(const struct StoreOps *sops, void *db)
   sops->free(db, &data);
   TEST_CHECK_(1, "sops->free(db, &data)");
 
+  rc = sops->delete_record(db, key, klen);
+  if (!TEST_CHECK(rc == 0))
+    return false;
+
+  if (sops->fetch_many && !test_store_db_fetch_many(sops, db))
+    return false;
+
+  if (!sops->begin)
+    return true;
+
+  // A batch must be visible before, and after, it's committed
+  rc = sops->begin(db);
+  if (!TEST_CHECK(rc == 0))
+    return false;
+
+  rc = sops->store(db, key, klen, value, strlen(value));
+  if (!TEST_CHECK(rc == 0))
+    return false;
+
+  data = sops->fetch(db, key, klen, &vlen);
+  if (!TEST_CHECK(data != NULL))
+    return false;
+  sops->free(db, &data);
+
+  rc = sops->commit(db);
+  if (!TEST_CHECK(rc == 0))
+    return false;
+
+  data = sops->fetch(db, key, klen, &vlen);
+  if (!TEST_CHECK(data != NULL))
+    return false;
+  sops->free(db, &data);
+
   rc = sops->delete_record(db, key, klen);
   if (!TEST_CHECK(rc == 0))
     return false;
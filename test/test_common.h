@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include "mutt/lib.h"
 
+struct Email;
 struct NeoMutt;
 
 void test_gen_path(char *buf, size_t buflen, const char *fmt);
@@ -35,6 +36,8 @@ void test_fini(void);
 struct NeoMutt *test_neomutt_create(void);
 void            test_neomutt_destroy(struct NeoMutt **ptr);
 
+struct Email *test_email_random(int index, unsigned int *seed);
+
 #define TEST_CHECK_STR_EQ(expected, actual)                                    \
   do                                                                           \
   {                                                                            \
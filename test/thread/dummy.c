@@ -0,0 +1,43 @@
+/**
+ * @file
+ * Dummy code for working around build problems
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include "core/lib.h"
+
+struct Email;
+
+enum MailboxType mx_type(struct Mailbox *m)
+{
+  return m ? m->type : MUTT_MAILBOX_ERROR;
+}
+
+void mutt_score_message(struct Mailbox *m, struct Email *e, bool upd_ctx)
+{
+}
+
+#ifdef USE_NNTP
+int nntp_compare_order(const void *a, const void *b)
+{
+  return 0;
+}
+#endif
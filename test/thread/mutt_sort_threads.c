@@ -0,0 +1,341 @@
+/**
+ * @file
+ * Test code for mutt_sort_threads()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <sys/types.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "mutt_thread.h"
+#include "sort.h"
+#include "test_common.h"
+
+static const struct Mapping TestSortMethods[] = {
+  // clang-format off
+  { "date",    SORT_DATE },
+  { "threads", SORT_THREADS },
+  { NULL,      0 },
+  // clang-format on
+};
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "duplicate_threads",   DT_BOOL,                  true,         0,                NULL, },
+  { "hide_limited",        DT_BOOL,                  false,        0,                NULL, },
+  { "hide_missing",        DT_BOOL,                  true,         0,                NULL, },
+  { "hide_thread_subject", DT_BOOL,                  true,         0,                NULL, },
+  { "hide_top_limited",    DT_BOOL,                  false,        0,                NULL, },
+  { "hide_top_missing",    DT_BOOL,                  true,         0,                NULL, },
+  { "narrow_tree",         DT_BOOL,                  false,        0,                NULL, },
+  { "score",               DT_BOOL,                  false,        0,                NULL, },
+  { "sort",                DT_SORT|DT_SORT_REVERSE,  SORT_THREADS, IP TestSortMethods, NULL, },
+  { "sort_aux",            DT_SORT|DT_SORT_REVERSE,  SORT_DATE,    IP TestSortMethods, NULL, },
+  { "sort_parallel",       DT_NUMBER,                0,            0,                NULL, },
+  { "sort_re",             DT_BOOL,                  true,         0,                NULL, },
+  { "strict_threads",      DT_BOOL,                  false,        0,                NULL, },
+  { "thread_received",     DT_BOOL,                  false,        0,                NULL, },
+  { NULL },
+  // clang-format on
+};
+
+#define MAX_EMAILS 16
+
+/**
+ * add_email - Append an Email to a Mailbox
+ * @param m       Mailbox
+ * @param msgid   Message-Id
+ * @param parent  Message-Id it's a reply to, may be NULL
+ * @param subject Subject
+ * @param date    Date sent
+ */
+static void add_email(struct Mailbox *m, const char *msgid, const char *parent,
+                      const char *subject, time_t date)
+{
+  struct Email *e = email_new();
+  e->body = mutt_body_new();
+  e->env = mutt_env_new();
+  e->env->message_id = mutt_str_dup(msgid);
+  if (parent)
+    mutt_list_insert_tail(&e->env->references, mutt_str_dup(parent));
+  e->env->subject = mutt_str_dup(subject);
+  e->env->real_subj = e->env->subject;
+  if (mutt_str_startswith(subject, "Re: "))
+    e->env->real_subj += 4;
+  e->date_sent = date;
+  e->received = date;
+  e->read = true;
+  e->index = m->msg_count;
+
+  m->emails[m->msg_count++] = e;
+}
+
+/**
+ * thread_mailbox - Thread a Mailbox, like ctx_update() does
+ * @param m    Mailbox
+ * @param tctx Threading context
+ * @param full Rethread from scratch
+ * @retval true The new Emails were linked into the existing threads
+ */
+static bool thread_mailbox(struct Mailbox *m, struct ThreadsContext *tctx, bool full)
+{
+  const bool update = !full && mutt_thread_can_update(tctx);
+  if (!update)
+  {
+    mutt_hash_free(&m->subj_hash);
+    mutt_hash_free(&m->id_hash);
+    mutt_clear_threads(tctx);
+  }
+
+  m->vcount = 0;
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    m->v2r[m->vcount] = i;
+    e->vnum = m->vcount++;
+    e->msgno = i;
+
+    if (!update || !e->thread)
+    {
+      if (m->id_hash && e->env->message_id)
+        mutt_hash_insert(m->id_hash, e->env->message_id, e);
+      if (m->subj_hash && e->env->real_subj)
+        mutt_hash_insert(m->subj_hash, e->env->real_subj, e);
+    }
+  }
+
+  off_t vsize = 0;
+  mutt_sort_headers(m, tctx, !update, &vsize);
+  return update;
+}
+
+/**
+ * describe_threads - Describe the threads of a Mailbox
+ * @param m   Mailbox
+ * @param buf Buffer for the result
+ *
+ * Each Email is listed in display order, with its parent and its tree.
+ */
+static void describe_threads(struct Mailbox *m, struct Buffer *buf)
+{
+  mutt_buffer_reset(buf);
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    struct MuttThread *parent = e->thread->parent;
+    const char *pid = "";
+    if (parent)
+      pid = parent->message ? parent->message->env->message_id : "(missing)";
+
+    mutt_buffer_add_printf(buf, "%s %s %s %d\n", e->env->message_id, pid,
+                           NONULL(e->tree), e->subject_changed);
+  }
+}
+
+/**
+ * check_update - Check that adding Emails gives the same threads as rethreading
+ * @param m     Mailbox
+ * @param tctx  Threading context
+ * @param count Number of Emails that were threaded first
+ *
+ * The Emails after @a count are hidden while the Mailbox is threaded.  Then
+ * they're added and linked into the threads.
+ */
+static void check_update(struct Mailbox *m, struct ThreadsContext *tctx, int count)
+{
+  struct Buffer *incremental = mutt_buffer_pool_get();
+  struct Buffer *full = mutt_buffer_pool_get();
+
+  const int total = m->msg_count;
+  m->msg_count = count;
+  thread_mailbox(m, tctx, true);
+  m->msg_count = total;
+
+  TEST_CHECK(thread_mailbox(m, tctx, false));
+  describe_threads(m, incremental);
+
+  TEST_CHECK(!thread_mailbox(m, tctx, true));
+  describe_threads(m, full);
+
+  TEST_CHECK(mutt_str_equal(mutt_buffer_string(incremental), mutt_buffer_string(full)));
+  TEST_MSG("Incremental:\n%s", mutt_buffer_string(incremental));
+  TEST_MSG("Full:\n%s", mutt_buffer_string(full));
+
+  mutt_buffer_pool_release(&incremental);
+  mutt_buffer_pool_release(&full);
+}
+
+static struct Email *find_email(struct Mailbox *m, const char *msgid)
+{
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    if (mutt_str_equal(m->emails[i]->env->message_id, msgid))
+      return m->emails[i];
+  }
+  return NULL;
+}
+
+static struct Mailbox *create_mailbox(void)
+{
+  struct Mailbox *m = mailbox_new();
+  m->email_max = MAX_EMAILS;
+  m->emails = mutt_mem_calloc(m->email_max, sizeof(struct Email *));
+  m->v2r = mutt_mem_calloc(m->email_max, sizeof(int));
+  return m;
+}
+
+static void destroy_mailbox(struct Mailbox **ptr, struct ThreadsContext **tctx)
+{
+  struct Mailbox *m = *ptr;
+  mutt_clear_threads(*tctx);
+  mutt_thread_ctx_free(tctx);
+  mutt_hash_free(&m->subj_hash);
+  mutt_hash_free(&m->id_hash);
+  for (int i = 0; i < m->msg_count; i++)
+    email_free(&m->emails[i]);
+  m->msg_count = 0;
+  mailbox_free(ptr);
+}
+
+void test_mutt_sort_threads(void)
+{
+  // void mutt_sort_threads(struct ThreadsContext *tctx, bool init);
+
+  NeoMutt = test_neomutt_create();
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, 0));
+
+  {
+    TEST_CASE("Nothing added");
+    struct Mailbox *m = create_mailbox();
+    struct ThreadsContext *tctx = mutt_thread_ctx_init(m);
+    add_email(m, "<a@x>", NULL, "Apple", 100);
+    add_email(m, "<b@x>", "<a@x>", "Re: Apple", 200);
+    check_update(m, tctx, 2);
+    destroy_mailbox(&m, &tctx);
+  }
+
+  {
+    TEST_CASE("Replies to existing threads");
+    struct Mailbox *m = create_mailbox();
+    struct ThreadsContext *tctx = mutt_thread_ctx_init(m);
+    add_email(m, "<a@x>", NULL, "Apple", 100);
+    add_email(m, "<b@x>", "<a@x>", "Re: Apple", 200);
+    add_email(m, "<c@x>", NULL, "Banana", 300);
+    add_email(m, "<d@x>", "<a@x>", "Re: Apple", 400);
+    add_email(m, "<e@x>", "<b@x>", "Re: Apple", 500);
+    add_email(m, "<f@x>", "<c@x>", "Something else", 600);
+    add_email(m, "<g@x>", NULL, "Cherry", 700);
+    check_update(m, tctx, 3);
+    destroy_mailbox(&m, &tctx);
+  }
+
+  {
+    TEST_CASE("Missing parent arrives");
+    struct Mailbox *m = create_mailbox();
+    struct ThreadsContext *tctx = mutt_thread_ctx_init(m);
+    add_email(m, "<b@x>", "<a@x>", "Re: Apple", 200);
+    add_email(m, "<c@x>", "<a@x>", "Re: Apple", 300);
+    add_email(m, "<z@x>", NULL, "Zebra", 50);
+    add_email(m, "<a@x>", NULL, "Apple", 100);
+    check_update(m, tctx, 3);
+    destroy_mailbox(&m, &tctx);
+  }
+
+  {
+    TEST_CASE("Subject changed");
+    struct Mailbox *m = create_mailbox();
+    struct ThreadsContext *tctx = mutt_thread_ctx_init(m);
+    add_email(m, "<a@x>", NULL, "Apple", 100);
+    add_email(m, "<b@x>", NULL, "Re: Apple", 200);
+    add_email(m, "<c@x>", NULL, "Banana", 150);
+    thread_mailbox(m, tctx, true);
+
+    /* like editing the message: the Email is replaced in the subject hash */
+    struct Email *e = find_email(m, "<b@x>");
+    TEST_CHECK(e->thread->fake_thread);
+    mutt_hash_delete(m->subj_hash, e->env->real_subj, e);
+    mutt_str_replace(&e->env->subject, "Re: Banana");
+    e->env->real_subj = e->env->subject + 4;
+    mutt_hash_insert(m->subj_hash, e->env->real_subj, e);
+
+    struct Buffer *update = mutt_buffer_pool_get();
+    struct Buffer *full = mutt_buffer_pool_get();
+
+    TEST_CHECK(thread_mailbox(m, tctx, false));
+    describe_threads(m, update);
+    TEST_CHECK(e->thread->parent &&
+               (e->thread->parent->message == find_email(m, "<c@x>")));
+    TEST_CHECK(!thread_mailbox(m, tctx, true));
+    describe_threads(m, full);
+
+    TEST_CHECK(mutt_str_equal(mutt_buffer_string(update), mutt_buffer_string(full)));
+    TEST_MSG("Update:\n%s", mutt_buffer_string(update));
+    TEST_MSG("Full:\n%s", mutt_buffer_string(full));
+
+    mutt_buffer_pool_release(&update);
+    mutt_buffer_pool_release(&full);
+    destroy_mailbox(&m, &tctx);
+  }
+
+  static const bool strict[] = { false, true };
+  for (size_t i = 0; i < mutt_array_size(strict); i++)
+  {
+    TEST_CASE(strict[i] ? "Pseudo-threads, $strict_threads set" :
+                          "Pseudo-threads, $strict_threads unset");
+    cs_subset_str_native_set(NeoMutt->sub, "strict_threads", strict[i], NULL);
+
+    struct Mailbox *m = create_mailbox();
+    struct ThreadsContext *tctx = mutt_thread_ctx_init(m);
+    add_email(m, "<a@x>", NULL, "Apple", 100);
+    add_email(m, "<b@x>", NULL, "Re: Apple", 200);
+    add_email(m, "<c@x>", NULL, "Banana", 300);
+    add_email(m, "<d@x>", NULL, "Re: Apple", 400);
+    add_email(m, "<e@x>", NULL, "Re: Banana", 500);
+    add_email(m, "<f@x>", "<e@x>", "Re: Banana", 600);
+    add_email(m, "<g@x>", NULL, "Re: Cherry", 700);
+    add_email(m, "<h@x>", NULL, "Cherry", 50);
+    check_update(m, tctx, 3);
+    destroy_mailbox(&m, &tctx);
+  }
+
+  cs_subset_str_native_set(NeoMutt->sub, "strict_threads", false, NULL);
+
+  {
+    TEST_CASE("Reversed");
+    cs_subset_str_native_set(NeoMutt->sub, "sort", SORT_THREADS | SORT_REVERSE, NULL);
+    struct Mailbox *m = create_mailbox();
+    struct ThreadsContext *tctx = mutt_thread_ctx_init(m);
+    add_email(m, "<a@x>", NULL, "Apple", 100);
+    add_email(m, "<b@x>", "<a@x>", "Re: Apple", 200);
+    add_email(m, "<c@x>", NULL, "Banana", 300);
+    add_email(m, "<d@x>", "<a@x>", "Re: Apple", 400);
+    add_email(m, "<e@x>", NULL, "Re: Banana", 500);
+    check_update(m, tctx, 3);
+    destroy_mailbox(&m, &tctx);
+    cs_subset_str_native_set(NeoMutt->sub, "sort", SORT_THREADS, NULL);
+  }
+
+  test_neomutt_destroy(&NeoMutt);
+}
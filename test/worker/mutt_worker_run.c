@@ -0,0 +1,71 @@
+/**
+ * @file
+ * Test code for mutt_worker_run()
+ *
+ * @authors
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+
+static void square_items(void *data, size_t start, size_t end)
+{
+  int *items = data;
+  for (size_t i = start; i < end; i++)
+    items[i] = items[i] * items[i] + 1;
+}
+
+void test_mutt_worker_run(void)
+{
+  // void mutt_worker_run(size_t num_items, size_t chunk_size, int num_threads, worker_t fn, void *data);
+
+  {
+    mutt_worker_run(10, 0, 4, NULL, NULL);
+    TEST_CHECK_(1, "mutt_worker_run(10, 0, 4, NULL, NULL)");
+  }
+
+  {
+    int items[4] = { 1, 2, 3, 4 };
+    mutt_worker_run(0, 0, 4, square_items, items);
+    TEST_CHECK(items[3] == 4);
+  }
+
+  static const int threads[] = { 0, 1, 2, 7, 100 };
+  static const size_t chunks[] = { 0, 1, 3, 1000, 5000 };
+
+  for (size_t t = 0; t < mutt_array_size(threads); t++)
+  {
+    for (size_t c = 0; c < mutt_array_size(chunks); c++)
+    {
+      int items[1234];
+      for (int i = 0; i < mutt_array_size(items); i++)
+        items[i] = i;
+
+      mutt_worker_run(mutt_array_size(items), chunks[c], threads[t], square_items, items);
+
+      bool ok = true;
+      for (int i = 0; i < mutt_array_size(items); i++)
+        ok = ok && (items[i] == (i * i + 1));
+      TEST_CHECK(ok);
+      TEST_MSG("threads = %d, chunk = %zu", threads[t], chunks[c]);
+    }
+  }
+}